@@ -0,0 +1,596 @@
+// Microbenchmarks dos caminhos críticos do sistema.
+//
+// Cobre os validadores de dominios.cpp, a conversão monetária do DatabaseManager,
+// a interpretação de linhas COTAHIST usada em criarOrdem, a validação de
+// combinação papel+data do InputValidator e cada consulta do DatabaseManager
+// sobre bancos semeados com 1 mil, 100 mil e 10 milhões de ordens. Também
+// compara os backends de leitura de arquivo (read, mmap e io_uring) com o cache
+// de páginas quente e frio, e a busca de preço do modo arquivo com e sem o
+// cache de preços.
+//
+// O resultado é impresso em JSON na saída padrão, para comparação entre versões.
+
+#include "CatalogoCotacoes.hpp"
+#include "DatabaseManager.hpp"
+#include "InputValidator.hpp"
+#include "LeitorArquivo.hpp"
+#include "LeitorCotahist.hpp"
+#include "jsonUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#ifndef BENCH_TIPO_BUILD
+#define BENCH_TIPO_BUILD ""
+#endif
+
+namespace
+{
+using Relogio = std::chrono::steady_clock;
+
+struct Resultado
+{
+    std::string nome;
+    long long iteracoes;
+    double nsPorOperacao;
+    double p50Ns;
+    double p99Ns;
+};
+
+struct Configuracao
+{
+    std::vector<long long> tamanhos = {1000, 100000, 10000000};
+    std::string diretorio = "/tmp";
+    std::string filtro;
+    std::string arquivoDados = "../data/DADOS_HISTORICOS.txt";
+    double segundosPorCaso = 0.3;
+};
+
+// Os códigos de 5 dígitos de 90000 a 99999 ficam livres para os casos que inserem e removem registros
+const long long LIMITE_CODIGOS_SEMEADOS = 90000;
+const char *CPF_SONDA = "123.456.789-09";
+const char *SENHA_SONDA = "A1b$2c";
+
+volatile long long sumidouro = 0;
+
+/**
+ * Executa a função em lotes até esgotar o tempo do caso. Cada lote tem tamanho
+ * suficiente para que o custo de ler o relógio seja desprezível, e os percentis
+ * são calculados sobre a média por operação de cada lote.
+ */
+Resultado medir(const std::string &nome, double segundos, const std::function<void()> &funcao)
+{
+    long long tamanhoLote = 1;
+    while (true)
+    {
+        auto inicio = Relogio::now();
+        for (long long i = 0; i < tamanhoLote; i++)
+        {
+            funcao();
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - inicio).count();
+        if (ns >= 20000 || tamanhoLote >= (1 << 20))
+        {
+            break;
+        }
+        tamanhoLote *= 2;
+    }
+
+    std::vector<double> porLote;
+    long long iteracoes = 0;
+    double totalNs = 0;
+    auto fim = Relogio::now() + std::chrono::duration_cast<Relogio::duration>(std::chrono::duration<double>(segundos));
+
+    do
+    {
+        auto inicio = Relogio::now();
+        for (long long i = 0; i < tamanhoLote; i++)
+        {
+            funcao();
+        }
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - inicio).count());
+        porLote.push_back(ns / static_cast<double>(tamanhoLote));
+        totalNs += ns;
+        iteracoes += tamanhoLote;
+    } while (Relogio::now() < fim || porLote.size() < 5);
+
+    std::sort(porLote.begin(), porLote.end());
+    Resultado resultado;
+    resultado.nome = nome;
+    resultado.iteracoes = iteracoes;
+    resultado.nsPorOperacao = totalNs / static_cast<double>(iteracoes);
+    resultado.p50Ns = porLote[porLote.size() / 2];
+    resultado.p99Ns = porLote[std::min(porLote.size() - 1, static_cast<size_t>(porLote.size() * 0.99))];
+    return resultado;
+}
+
+class Suite
+{
+  private:
+    const Configuracao &configuracao;
+
+  public:
+    std::vector<Resultado> resultados;
+
+    explicit Suite(const Configuracao &configuracao) : configuracao(configuracao)
+    {
+    }
+
+    void caso(const std::string &nome, const std::function<void()> &funcao)
+    {
+        if (!configuracao.filtro.empty() && nome.find(configuracao.filtro) == std::string::npos)
+        {
+            return;
+        }
+        resultados.push_back(medir(nome, configuracao.segundosPorCaso, funcao));
+        std::cerr << "  " << nome << ": " << resultados.back().nsPorOperacao << " ns/op" << std::endl;
+    }
+};
+
+template <typename Dominio> void casoDominio(Suite &suite, const std::string &nome, const std::string &valor)
+{
+    suite.caso("dominio/" + nome, [valor] {
+        Dominio dominio;
+        dominio.setValor(valor);
+        sumidouro += static_cast<long long>(dominio.getValor().size());
+    });
+}
+
+void benchmarksDominios(Suite &suite)
+{
+    casoDominio<Codigo>(suite, "Codigo", "12345");
+    casoDominio<CodigoNeg>(suite, "CodigoNeg", "PETR4       ");
+    casoDominio<Ncpf>(suite, "Ncpf", "123.456.789-09");
+    casoDominio<Data>(suite, "Data", "20250110");
+    casoDominio<Nome>(suite, "Nome", "Maria Clara");
+    casoDominio<TipoPerfil>(suite, "TipoPerfil", "Agressivo");
+    casoDominio<Dinheiro>(suite, "Dinheiro", "1.234.567,89");
+    casoDominio<Quantidade>(suite, "Quantidade", "5.000");
+    casoDominio<Senha>(suite, "Senha", "A1b$2c");
+}
+
+void benchmarksDinheiro(Suite &suite)
+{
+    suite.caso("dinheiro/centavosParaDinheiro", [] {
+        sumidouro += static_cast<long long>(DatabaseManager::centavosParaDinheiro(123456789).size());
+    });
+
+    Dinheiro dinheiro;
+    dinheiro.setValor("1.234.567,89");
+    suite.caso("dinheiro/dinheiroParaCentavos",
+               [dinheiro] { sumidouro += DatabaseManager::dinheiroParaCentavos(dinheiro); });
+}
+
+void benchmarksCotahist(Suite &suite)
+{
+    const std::string linha = "012025010202JBSS3            010JBS         ON            NM     R+ACQ-  "
+                              "0000000003650000000000374800000000035790000000003665\r";
+    suite.caso("cotahist/interpretarLinha", [linha] {
+        RegistroCotacao registro;
+        LeitorCotahist::interpretarLinha(linha, &registro);
+        sumidouro += registro.precoMedioCentavos;
+    });
+
+    CodigoNeg primeiroPapel;
+    primeiroPapel.setValor("JALL3       ");
+    suite.caso("cotahist/validarCombinacaoB3_inicio",
+               [primeiroPapel] { sumidouro += InputValidator::validarCombinacaoB3(primeiroPapel, "20250102"); });
+
+    CodigoNeg papelAusente;
+    papelAusente.setValor("ZZZZ9       ");
+    suite.caso("cotahist/validarCombinacaoB3_ausente",
+               [papelAusente] { sumidouro += InputValidator::validarCombinacaoB3(papelAusente, "20250102"); });
+
+    // Sugestões enquanto o operador digita: prefixo, código com letras trocadas e nome da empresa
+    for (const char *texto : {"PETR", "PERT4", "PETROBRAS"})
+    {
+        suite.caso(std::string("cotahist/sugerirCodigos_") + texto,
+                   [texto] { sumidouro += static_cast<long long>(InputValidator::sugerirCodigos(texto).size()); });
+    }
+
+    // Calendário do papel escolhido: fatias da série de datas do índice, sem percorrer o arquivo
+    suite.caso("cotahist/buscarDatasDisponiveis", [primeiroPapel] {
+        std::vector<DatasPapel> datas;
+        InputValidator::buscarDatasDisponiveis(primeiroPapel, datas);
+        sumidouro += static_cast<long long>(datas.size());
+    });
+}
+
+std::string codigoSemeado(long long i)
+{
+    if (i < LIMITE_CODIGOS_SEMEADOS)
+    {
+        std::string codigo = std::to_string(i);
+        return std::string(codigo.size() < 5 ? 5 - codigo.size() : 0, '0') + codigo;
+    }
+    // Acima do limite os códigos não são válidos no domínio; servem apenas para dar volume às tabelas
+    return "X" + std::to_string(i);
+}
+
+/**
+ * Semeia um banco com a quantidade de ordens pedida, uma carteira para cada 10
+ * ordens e uma conta para cada 5 carteiras. A conta CPF_SONDA é dona das
+ * carteiras 00000 a 00004, e a carteira 00000 recebe as ordens 00000 a 00009;
+ * essas linhas são as consultadas pelos benchmarks.
+ */
+bool semearBanco(const std::string &caminho, long long ordens)
+{
+    std::remove(caminho.c_str());
+    std::remove((caminho + "-wal").c_str());
+    std::remove((caminho + "-shm").c_str());
+
+    {
+        DatabaseManager criador(caminho);
+        if (!criador.inicializarBanco())
+        {
+            return false;
+        }
+    }
+
+    sqlite3 *db = nullptr;
+    if (sqlite3_open(caminho.c_str(), &db) != SQLITE_OK)
+    {
+        return false;
+    }
+    sqlite3_exec(db, "PRAGMA synchronous = OFF; BEGIN", nullptr, nullptr, nullptr);
+
+    long long carteiras = std::max(5LL, ordens / 10);
+    long long contas = std::max(1LL, carteiras / 5);
+
+    sqlite3_stmt *stmt = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO contas VALUES (?, ?, ?)", -1, &stmt, nullptr);
+    for (long long i = 0; i < contas; i++)
+    {
+        std::string cpf = i == 0 ? CPF_SONDA : "c" + std::to_string(i);
+        sqlite3_bind_text(stmt, 1, cpf.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, "Investidor", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, SENHA_SONDA, -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    sqlite3_prepare_v2(db, "INSERT INTO carteiras VALUES (?, ?, ?, ?)", -1, &stmt, nullptr);
+    for (long long i = 0; i < carteiras; i++)
+    {
+        std::string codigo = codigoSemeado(i);
+        std::string cpf = i < 5 ? CPF_SONDA : "c" + std::to_string(1 + i % std::max(1LL, contas - 1));
+        sqlite3_bind_text(stmt, 1, codigo.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, "Carteira", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, "Moderado", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, cpf.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    sqlite3_prepare_v2(db, "INSERT INTO ordens VALUES (?, ?, ?, ?, ?, ?)", -1, &stmt, nullptr);
+    for (long long i = 0; i < ordens; i++)
+    {
+        std::string codigo = codigoSemeado(i);
+        std::string carteira = i < 10 ? "00000" : codigoSemeado(1 + i % (carteiras - 1));
+        sqlite3_bind_text(stmt, 1, codigo.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, "JBSS3       ", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, "20250102", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, "3.665,00", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 5, "100", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 6, carteira.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    bool sucesso = sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) == SQLITE_OK;
+    sqlite3_close(db);
+    return sucesso;
+}
+
+void benchmarksBanco(Suite &suite, const Configuracao &configuracao, long long tamanho)
+{
+    std::string caminho = configuracao.diretorio + "/bench_" + std::to_string(tamanho) + ".db";
+    std::string prefixo = "banco_" + std::to_string(tamanho) + "/";
+
+    std::cerr << "Semeando " << caminho << " com " << tamanho << " ordens..." << std::endl;
+    if (!semearBanco(caminho, tamanho))
+    {
+        std::cerr << "Erro: Não foi possível semear " << caminho << std::endl;
+        return;
+    }
+
+    DatabaseManager db(caminho);
+    if (!db.conectar())
+    {
+        return;
+    }
+
+    Ncpf cpf;
+    Senha senha;
+    Codigo carteiraSonda;
+    Codigo ordemSonda;
+    Codigo codigoLivre;
+    cpf.setValor(CPF_SONDA);
+    senha.setValor(SENHA_SONDA);
+    carteiraSonda.setValor("00000");
+    ordemSonda.setValor("00005");
+    codigoLivre.setValor("99999");
+
+    suite.caso(prefixo + "buscarConta", [&] {
+        Conta conta;
+        sumidouro += db.buscarConta(cpf, &conta);
+    });
+    suite.caso(prefixo + "autenticarUsuario", [&] { sumidouro += db.autenticarUsuario(cpf, senha); });
+    suite.caso(prefixo + "listarCarteiras", [&] {
+        std::list<Carteira> carteiras;
+        sumidouro += db.listarCarteiras(cpf, &carteiras);
+    });
+    suite.caso(prefixo + "buscarCarteira", [&] {
+        Carteira carteira;
+        sumidouro += db.buscarCarteira(carteiraSonda, &carteira);
+    });
+    suite.caso(prefixo + "listarOrdens", [&] {
+        std::list<Ordem> ordens;
+        sumidouro += db.listarOrdens(carteiraSonda, &ordens);
+    });
+    suite.caso(prefixo + "buscarOrdem", [&] {
+        Ordem ordem;
+        sumidouro += db.buscarOrdem(ordemSonda, &ordem);
+    });
+    suite.caso(prefixo + "calcularSaldoCarteira", [&] {
+        Dinheiro saldo;
+        sumidouro += db.calcularSaldoCarteira(carteiraSonda, &saldo);
+    });
+
+    Conta conta;
+    Nome nome;
+    nome.setValor("Investidor");
+    conta.setNcpf(cpf);
+    conta.setNome(nome);
+    conta.setSenha(senha);
+    suite.caso(prefixo + "atualizarConta", [&] { sumidouro += db.atualizarConta(conta); });
+
+    Carteira carteira;
+    TipoPerfil perfil;
+    perfil.setValor("Moderado");
+    nome.setValor("Carteira");
+    carteira.setCodigo(carteiraSonda);
+    carteira.setNome(nome);
+    carteira.setTipoPerfil(perfil);
+    suite.caso(prefixo + "atualizarCarteira", [&] { sumidouro += db.atualizarCarteira(carteira); });
+
+    Ordem ordem;
+    CodigoNeg papel;
+    Data data;
+    Dinheiro valor;
+    Quantidade quantidade;
+    papel.setValor("JBSS3       ");
+    data.setValor("20250102");
+    valor.setValor("3.665,00");
+    quantidade.setValor("100");
+    ordem.setCodigo(codigoLivre);
+    ordem.setCodigoNeg(papel);
+    ordem.setData(data);
+    ordem.setDinheiro(valor);
+    ordem.setQuantidade(quantidade);
+    suite.caso(prefixo + "inserirOrdem+excluirOrdem", [&] {
+        sumidouro += db.inserirOrdem(ordem, carteiraSonda);
+        sumidouro += db.excluirOrdem(codigoLivre);
+    });
+
+    Carteira carteiraLivre = carteira;
+    carteiraLivre.setCodigo(codigoLivre);
+    suite.caso(prefixo + "inserirCarteira+excluirCarteira", [&] {
+        sumidouro += db.inserirCarteira(carteiraLivre, cpf);
+        sumidouro += db.excluirCarteira(codigoLivre);
+    });
+
+    Conta contaLivre = conta;
+    Ncpf cpfLivre;
+    cpfLivre.setValor("529.982.247-25");
+    contaLivre.setNcpf(cpfLivre);
+    suite.caso(prefixo + "inserirConta+excluirConta", [&] {
+        sumidouro += db.inserirConta(contaLivre);
+        sumidouro += db.excluirConta(cpfLivre);
+    });
+
+    db.desconectar();
+}
+
+/**
+ * Descarta do cache de páginas as páginas do arquivo. Sem privilégios não dá
+ * para usar drop_caches, mas POSIX_FADV_DONTNEED libera as páginas limpas e não
+ * mapeadas do arquivo, que é o caso entre duas leituras.
+ */
+void esfriarCache(const std::string &caminho)
+{
+    int fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+/**
+ * Cada operação lê o arquivo de dados inteiro e separa as linhas. No caso frio
+ * o cache do arquivo é descartado antes de cada leitura, e o descarte entra na
+ * medição (é pequeno perto da leitura do disco).
+ */
+void benchmarksLeitura(Suite &suite, const Configuracao &configuracao)
+{
+    if (access(configuracao.arquivoDados.c_str(), R_OK) != 0)
+    {
+        std::cerr << "  leitura: arquivo " << configuracao.arquivoDados << " não encontrado, casos pulados"
+                  << std::endl;
+        return;
+    }
+
+    for (BackendLeitura backend : {LEITURA_READ, LEITURA_MMAP, LEITURA_IO_URING})
+    {
+        std::string nome = LeitorArquivo::nomeBackend(backend);
+        auto ler = [&configuracao, backend] {
+            long long linhas = 0;
+            LeitorArquivo::lerLinhas(
+                configuracao.arquivoDados, 0, [&linhas](const std::string &) { linhas++; }, nullptr, nullptr, backend);
+            sumidouro += linhas;
+        };
+
+        suite.caso("leitura/" + nome + "_quente", ler);
+        suite.caso("leitura/" + nome + "_frio", [&configuracao, ler] {
+            esfriarCache(configuracao.arquivoDados);
+            ler();
+        });
+    }
+}
+
+/**
+ * Busca de preço do modo arquivo (--indice-arquivo) para oito combinações
+ * repetidas em rodízio, como um operador que cria ordens para poucos papéis.
+ * Sem cache, cada busca é um pread no arquivo; com cache, só a primeira de cada
+ * combinação.
+ */
+void benchmarksArquivo(Suite &suite, const Configuracao &configuracao)
+{
+    // Abrir o índice pode gerar o auxiliar .idx: só o faz se algum caso vai rodar
+    const std::string nomes = "arquivo/buscarPreco_semCache arquivo/buscarPreco_cache";
+    if (nomes.find(configuracao.filtro) == std::string::npos)
+    {
+        return;
+    }
+
+    auto deslocamentos = std::make_shared<IndiceDeslocamentos>();
+    if (access(configuracao.arquivoDados.c_str(), R_OK) != 0 || !deslocamentos->abrir(configuracao.arquivoDados))
+    {
+        std::cerr << "  arquivo: arquivo " << configuracao.arquivoDados << " não encontrado, casos pulados"
+                  << std::endl;
+        return;
+    }
+
+    auto combinacoes = std::make_shared<std::vector<std::pair<std::string, uint32_t>>>();
+    deslocamentos->percorrerDatas(0, 99999999, [&combinacoes](const RegistroCotacao &registro) {
+        if (combinacoes->size() < 8)
+        {
+            combinacoes->emplace_back(registro.codigoNegociacao, registro.data);
+        }
+    });
+
+    for (size_t capacidade : {static_cast<size_t>(0), CachePrecos::CAPACIDADE_PADRAO})
+    {
+        auto catalogo = std::make_shared<CatalogoCotacoes>();
+        catalogo->setCapacidadeCachePrecos(capacidade);
+        catalogo->setIndiceDeslocamentos(deslocamentos);
+        auto proxima = std::make_shared<size_t>(0);
+        suite.caso(capacidade == 0 ? "arquivo/buscarPreco_semCache" : "arquivo/buscarPreco_cache",
+                   [catalogo, combinacoes, proxima] {
+                       const auto &combinacao = (*combinacoes)[(*proxima)++ % combinacoes->size()];
+                       long long preco = 0;
+                       catalogo->buscarPreco(combinacao.first, combinacao.second, &preco);
+                       sumidouro += preco;
+                   });
+    }
+}
+
+void imprimirJson(const std::vector<Resultado> &resultados)
+{
+    std::ostringstream json;
+    json << "{\"build\":" << jsonUtils::texto(BENCH_TIPO_BUILD) << ",\"sqlite\":" << jsonUtils::texto(sqlite3_libversion())
+         << ",\"resultados\":[";
+    for (size_t i = 0; i < resultados.size(); i++)
+    {
+        const Resultado &r = resultados[i];
+        json << (i ? "," : "") << "\n  {\"nome\":" << jsonUtils::texto(r.nome) << ",\"iteracoes\":" << r.iteracoes
+             << ",\"ns_por_op\":" << r.nsPorOperacao << ",\"p50_ns\":" << r.p50Ns << ",\"p99_ns\":" << r.p99Ns << "}";
+    }
+    json << "\n]}";
+    std::cout << json.str() << std::endl;
+}
+
+std::vector<long long> lerTamanhos(const std::string &lista)
+{
+    std::vector<long long> tamanhos;
+    std::stringstream fluxo(lista);
+    std::string item;
+    while (std::getline(fluxo, item, ','))
+    {
+        if (!item.empty())
+        {
+            tamanhos.push_back(std::atoll(item.c_str()));
+        }
+    }
+    return tamanhos;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Configuracao configuracao;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string opcao = argv[i];
+        bool temValor = i + 1 < argc;
+
+        if (opcao == "--tamanhos" && temValor)
+        {
+            configuracao.tamanhos = lerTamanhos(argv[++i]);
+        }
+        else if (opcao == "--diretorio" && temValor)
+        {
+            configuracao.diretorio = argv[++i];
+        }
+        else if (opcao == "--filtro" && temValor)
+        {
+            configuracao.filtro = argv[++i];
+        }
+        else if (opcao == "--segundos" && temValor)
+        {
+            configuracao.segundosPorCaso = std::atof(argv[++i]);
+        }
+        else if (opcao == "--dados" && temValor)
+        {
+            configuracao.arquivoDados = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Uso: " << argv[0]
+                      << " [--tamanhos 1000,100000,10000000] [--diretorio DIR] [--filtro TEXTO] [--segundos S]"
+                      << " [--dados ARQUIVO.txt]" << std::endl;
+            return 1;
+        }
+    }
+
+    Suite suite(configuracao);
+    benchmarksDominios(suite);
+    benchmarksDinheiro(suite);
+    benchmarksCotahist(suite);
+    benchmarksLeitura(suite, configuracao);
+    benchmarksArquivo(suite, configuracao);
+
+    // Semear os bancos é caro: só o faz se o filtro puder casar com algum caso de banco
+    const std::string &filtro = configuracao.filtro;
+    bool filtroForaDoBanco = filtro.rfind("dominio", 0) == 0 || filtro.rfind("dinheiro", 0) == 0 ||
+                             filtro.rfind("cotahist", 0) == 0 || filtro.rfind("leitura", 0) == 0 ||
+                             filtro.rfind("arquivo", 0) == 0;
+    for (long long tamanho : configuracao.tamanhos)
+    {
+        std::string prefixo = "banco_" + std::to_string(tamanho) + "/";
+        bool outroTamanho = filtro.rfind("banco_", 0) == 0 && filtro.rfind(prefixo, 0) != 0 &&
+                            prefixo.rfind(filtro, 0) != 0;
+        if (!filtroForaDoBanco && !outroTamanho)
+        {
+            benchmarksBanco(suite, configuracao, tamanho);
+        }
+    }
+
+    imprimirJson(suite.resultados);
+    return 0;
+}
@@ -0,0 +1,569 @@
+// Gerador de carga sintética para a camada de serviço.
+//
+// Sintetiza contas com CPFs válidos, até 5 carteiras por conta e ordens sobre
+// combinações (papel, data) reais do arquivo de dados históricos, e dispara as
+// operações de várias threads a uma taxa configurável. Ao final, reporta a vazão
+// e as latências p50/p99/p999 de cada operação.
+//
+// Cada thread possui sua própria ControladoraServico (conexão SQLite própria), e
+// todas compartilham o mesmo índice de cotações, como no modo servidor. Com
+// --repositorio memoria, todas usam um único RepositorioMemoria, o que permite
+// comparar o custo do SQLite com o mesmo fluxo de operações. Com --fragmentos N,
+// cada thread abre os N arquivos SQLite e as escritas se espalham pelo hash do CPF.
+
+#include "IndiceCotacoes.hpp"
+#include "RepositorioFragmentado.hpp"
+#include "RepositorioMemoria.hpp"
+#include "controladorasServico.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Relogio = std::chrono::steady_clock;
+
+struct Configuracao
+{
+    std::string caminhoBanco = "carga.db";
+    bool repositorioMemoria = false;
+    int fragmentos = 1;
+    std::string caminhoDados = "../data/DADOS_HISTORICOS.txt";
+    int threads = 4;
+    int contas = 200;
+    long long operacoes = 20000;
+    double taxa = 0.0; // operações por segundo (todas as threads); 0 = sem limite
+    unsigned semente = 42;
+    bool saidaJson = false;
+};
+
+// Espaço de códigos de 5 dígitos é global no banco; é repartido entre as threads
+// por contadores atômicos para evitar colisões entre elas.
+const int MAXIMO_CODIGOS = 100000;
+
+struct Amostras
+{
+    std::map<std::string, std::vector<long long>> latenciasNs;
+    std::map<std::string, long long> falhas;
+
+    void registrar(const std::string &operacao, long long ns, bool sucesso)
+    {
+        latenciasNs[operacao].push_back(ns);
+        if (!sucesso)
+        {
+            falhas[operacao]++;
+        }
+    }
+
+    void juntar(Amostras &outra)
+    {
+        for (auto &item : outra.latenciasNs)
+        {
+            auto &destino = latenciasNs[item.first];
+            destino.insert(destino.end(), item.second.begin(), item.second.end());
+        }
+        for (auto &item : outra.falhas)
+        {
+            falhas[item.first] += item.second;
+        }
+    }
+};
+
+struct ContaSintetica
+{
+    Ncpf cpf;
+    Senha senha;
+    std::vector<Codigo> carteiras;
+};
+
+std::string gerarCpf(std::mt19937 &gerador)
+{
+    std::uniform_int_distribution<int> digito(0, 9);
+
+    while (true)
+    {
+        int numeros[11];
+        bool todosIguais = true;
+        for (int i = 0; i < 9; i++)
+        {
+            numeros[i] = digito(gerador);
+            todosIguais = todosIguais && numeros[i] == numeros[0];
+        }
+        if (todosIguais)
+        {
+            continue;
+        }
+
+        int soma = 0;
+        for (int i = 0; i < 9; i++)
+        {
+            soma += numeros[i] * (10 - i);
+        }
+        numeros[9] = (soma * 10) % 11 % 10;
+
+        soma = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            soma += numeros[i] * (11 - i);
+        }
+        numeros[10] = (soma * 10) % 11 % 10;
+
+        std::string cpf;
+        for (int i = 0; i < 11; i++)
+        {
+            if (i == 3 || i == 6)
+            {
+                cpf += '.';
+            }
+            else if (i == 9)
+            {
+                cpf += '-';
+            }
+            cpf += static_cast<char>('0' + numeros[i]);
+        }
+        return cpf;
+    }
+}
+
+std::string formatarCodigo(int valor)
+{
+    std::string texto = std::to_string(valor);
+    return std::string(5 - texto.size(), '0') + texto;
+}
+
+std::string formatarCodigoNegociacao(const std::string &codigo)
+{
+    return codigo + std::string(12 - std::min<size_t>(codigo.size(), 12), ' ');
+}
+
+class TrabalhadorCarga
+{
+  private:
+    const Configuracao &configuracao;
+    const IndiceCotacoes &indice;
+    std::atomic<int> &proximaCarteira;
+    std::atomic<int> &proximaOrdem;
+    std::atomic<long long> &operacoesRestantes;
+    ControladoraServico servico;
+    std::mt19937 gerador;
+    std::vector<ContaSintetica> contas;
+
+  public:
+    Amostras amostras;
+    bool inicializado = false;
+
+    TrabalhadorCarga(const Configuracao &configuracao, const IndiceCotacoes &indice,
+                     std::shared_ptr<const IndiceCotacoes> indiceCompartilhado, std::atomic<int> &proximaCarteira,
+                     std::atomic<int> &proximaOrdem, std::atomic<long long> &operacoesRestantes, unsigned semente,
+                     std::shared_ptr<IRepositorio> repositorio)
+        : configuracao(configuracao), indice(indice), proximaCarteira(proximaCarteira), proximaOrdem(proximaOrdem),
+          operacoesRestantes(operacoesRestantes), servico(std::move(repositorio)), gerador(semente)
+    {
+        inicializado = servico.inicializar();
+        servico.setIndiceCotacoes(std::move(indiceCompartilhado));
+    }
+
+    // Com --taxa, inicio é o disparo agendado e não o real: o atraso acumulado atrás de uma operação lenta
+    // entra na latência das seguintes, em vez de sumir do relatório (omissão coordenada)
+    template <typename Operacao>
+    bool medir(const std::string &nome, Operacao operacao, Relogio::time_point inicio = Relogio::now())
+    {
+        bool sucesso = false;
+        try
+        {
+            sucesso = operacao();
+        }
+        catch (const std::exception &e)
+        {
+            sucesso = false;
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - inicio).count();
+        amostras.registrar(nome, ns, sucesso);
+        return sucesso;
+    }
+
+    void prepararContas(int quantidade)
+    {
+        std::uniform_int_distribution<int> carteirasPorConta(1, 5);
+        const char *perfis[] = {"Conservador", "Moderado", "Agressivo"};
+
+        for (int i = 0; i < quantidade; i++)
+        {
+            ContaSintetica sintetica;
+            Conta conta;
+            Nome nome;
+            sintetica.cpf.setValor(gerarCpf(gerador));
+            sintetica.senha.setValor("A1b$2c");
+            nome.setValor("Investidor " + std::to_string(i));
+            conta.setNcpf(sintetica.cpf);
+            conta.setSenha(sintetica.senha);
+            conta.setNome(nome);
+
+            if (!medir("cadastrarConta", [&] { return servico.cadastrarConta(conta); }))
+            {
+                continue;
+            }
+
+            int totalCarteiras = carteirasPorConta(gerador);
+            for (int c = 0; c < totalCarteiras; c++)
+            {
+                int numero = proximaCarteira++;
+                if (numero >= MAXIMO_CODIGOS)
+                {
+                    break;
+                }
+
+                Carteira carteira;
+                Codigo codigo;
+                TipoPerfil perfil;
+                codigo.setValor(formatarCodigo(numero));
+                nome.setValor("Carteira " + std::to_string(c + 1));
+                perfil.setValor(perfis[numero % 3]);
+                carteira.setCodigo(codigo);
+                carteira.setNome(nome);
+                carteira.setTipoPerfil(perfil);
+
+                if (medir("criarCarteira", [&] { return servico.criarCarteira(sintetica.cpf, carteira); }))
+                {
+                    sintetica.carteiras.push_back(codigo);
+                }
+            }
+
+            if (!sintetica.carteiras.empty())
+            {
+                contas.push_back(sintetica);
+            }
+        }
+    }
+
+    void executarOperacoes(double taxaPorThread)
+    {
+        if (contas.empty())
+        {
+            return;
+        }
+
+        std::uniform_int_distribution<size_t> escolherConta(0, contas.size() - 1);
+        std::uniform_int_distribution<size_t> escolherRegistro(0, indice.quantidadeRegistros() - 1);
+        std::uniform_int_distribution<int> escolherOperacao(0, 99);
+        std::uniform_int_distribution<int> escolherQuantidade(1, 1000);
+
+        auto intervalo = std::chrono::nanoseconds(taxaPorThread > 0 ? static_cast<long long>(1e9 / taxaPorThread) : 0);
+        auto proximoDisparo = Relogio::now();
+
+        while (operacoesRestantes-- > 0)
+        {
+            auto disparo = Relogio::now();
+            if (intervalo.count() > 0)
+            {
+                std::this_thread::sleep_until(proximoDisparo);
+                disparo = proximoDisparo;
+                proximoDisparo += intervalo;
+            }
+
+            ContaSintetica &conta = contas[escolherConta(gerador)];
+            Codigo &carteira = conta.carteiras[gerador() % conta.carteiras.size()];
+            int sorteio = escolherOperacao(gerador);
+
+            if (sorteio < 40)
+            {
+                int numero = proximaOrdem++;
+                if (numero >= MAXIMO_CODIGOS)
+                {
+                    continue;
+                }
+
+                std::string papel;
+                uint32_t data = 0;
+                indice.obterRegistro(escolherRegistro(gerador), &papel, &data, nullptr);
+
+                Ordem ordem;
+                Codigo codigo;
+                CodigoNeg codigoNeg;
+                Data dataOrdem;
+                Quantidade quantidade;
+                Dinheiro valorTemporario;
+                codigo.setValor(formatarCodigo(numero));
+                codigoNeg.setValor(formatarCodigoNegociacao(papel));
+                dataOrdem.setValor(std::to_string(data));
+                quantidade.setValor(std::to_string(escolherQuantidade(gerador)));
+                valorTemporario.setValor("0,01");
+                ordem.setCodigo(codigo);
+                ordem.setCodigoNeg(codigoNeg);
+                ordem.setData(dataOrdem);
+                ordem.setQuantidade(quantidade);
+                ordem.setDinheiro(valorTemporario);
+
+                medir("criarOrdem", [&] { return servico.criarOrdem(carteira, ordem); }, disparo);
+            }
+            else if (sorteio < 60)
+            {
+                Carteira dados;
+                Dinheiro saldo;
+                medir(
+                    "consultarCarteira", [&] { return servico.consultarCarteira(carteira, &dados, &saldo); }, disparo);
+            }
+            else if (sorteio < 75)
+            {
+                std::list<Ordem> ordens;
+                medir("listarOrdens", [&] { return servico.listarOrdens(carteira, &ordens); }, disparo);
+            }
+            else if (sorteio < 85)
+            {
+                std::list<Carteira> carteiras;
+                medir(
+                    "listarCarteiras", [&] { return servico.listarCarteiras(conta.cpf, &carteiras); }, disparo);
+            }
+            else if (sorteio < 95)
+            {
+                medir("autenticar", [&] { return servico.autenticar(conta.cpf, conta.senha); }, disparo);
+            }
+            else
+            {
+                Conta dados;
+                Dinheiro saldo;
+                medir(
+                    "consultarConta", [&] { return servico.consultarConta(conta.cpf, &dados, &saldo); }, disparo);
+            }
+        }
+    }
+};
+
+double percentil(const std::vector<long long> &ordenado, double fracao)
+{
+    if (ordenado.empty())
+    {
+        return 0.0;
+    }
+    size_t posicao = static_cast<size_t>(fracao * static_cast<double>(ordenado.size() - 1) + 0.5);
+    return static_cast<double>(ordenado[posicao]) / 1000.0;
+}
+
+void imprimirRelatorio(Amostras &amostras, double segundos, const Configuracao &configuracao)
+{
+    long long total = 0;
+    for (auto &item : amostras.latenciasNs)
+    {
+        std::sort(item.second.begin(), item.second.end());
+        total += static_cast<long long>(item.second.size());
+    }
+
+    if (configuracao.saidaJson)
+    {
+        std::cout << "{\"threads\":" << configuracao.threads << ",\"segundos\":" << segundos
+                  << ",\"operacoes\":" << total << ",\"vazao\":" << (segundos > 0 ? total / segundos : 0.0)
+                  << ",\"operacoesPorTipo\":{";
+        bool primeira = true;
+        for (auto &item : amostras.latenciasNs)
+        {
+            std::cout << (primeira ? "" : ",") << "\"" << item.first << "\":{\"quantidade\":" << item.second.size()
+                      << ",\"falhas\":" << amostras.falhas[item.first]
+                      << ",\"vazao\":" << (segundos > 0 ? item.second.size() / segundos : 0.0)
+                      << ",\"p50_us\":" << percentil(item.second, 0.50)
+                      << ",\"p99_us\":" << percentil(item.second, 0.99)
+                      << ",\"p999_us\":" << percentil(item.second, 0.999) << "}";
+            primeira = false;
+        }
+        std::cout << "}}" << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n=== RESULTADO DA CARGA ===" << std::endl;
+    std::cout << "Threads: " << configuracao.threads << "  Duração: " << segundos << " s  Operações: " << total
+              << "  Vazão: " << (segundos > 0 ? total / segundos : 0.0) << " op/s" << std::endl;
+    std::cout << std::string(92, '-') << std::endl;
+    std::cout << std::left << std::setw(20) << "Operacao" << std::right << std::setw(10) << "Qtde" << std::setw(10)
+              << "Falhas" << std::setw(12) << "op/s" << std::setw(13) << "p50 (us)" << std::setw(13) << "p99 (us)"
+              << std::setw(14) << "p999 (us)" << std::endl;
+    std::cout << std::string(92, '-') << std::endl;
+    for (auto &item : amostras.latenciasNs)
+    {
+        std::cout << std::left << std::setw(20) << item.first << std::right << std::setw(10) << item.second.size()
+                  << std::setw(10) << amostras.falhas[item.first] << std::setw(12)
+                  << (segundos > 0 ? item.second.size() / segundos : 0.0) << std::setw(13)
+                  << percentil(item.second, 0.50) << std::setw(13) << percentil(item.second, 0.99) << std::setw(14)
+                  << percentil(item.second, 0.999) << std::endl;
+    }
+    std::cout << std::string(92, '-') << std::endl;
+}
+
+// Apaga o banco de destino, seus fragmentos e os arquivos WAL/SHM, para começar de tabelas vazias
+void recriarBanco(const Configuracao &configuracao)
+{
+    std::vector<std::string> caminhos = {configuracao.caminhoBanco};
+    for (int i = 0; configuracao.fragmentos > 1 && i <= configuracao.fragmentos; i++)
+    {
+        size_t fragmento = static_cast<size_t>(i);
+        caminhos.push_back(RepositorioFragmentado::caminhoFragmento(configuracao.caminhoBanco, fragmento));
+    }
+
+    for (const std::string &caminho : caminhos)
+    {
+        for (const char *sufixo : {"", "-wal", "-shm"})
+        {
+            std::remove((caminho + sufixo).c_str());
+        }
+    }
+}
+
+void exibirUso(const char *programa)
+{
+    std::cerr << "Uso: " << programa << " [opções]\n"
+              << "  --banco ARQUIVO      banco SQLite de destino, recriado a cada execução (padrão: carga.db)\n"
+              << "  --repositorio TIPO   sqlite ou memoria (padrão: sqlite)\n"
+              << "  --fragmentos N       distribui o banco SQLite em N arquivos (padrão: 1)\n"
+              << "  --dados ARQUIVO      arquivo de dados históricos (padrão: ../data/DADOS_HISTORICOS.txt)\n"
+              << "  --threads N          threads geradoras (padrão: 4)\n"
+              << "  --contas N           contas sintéticas a criar (padrão: 200)\n"
+              << "  --operacoes N        operações da fase principal (padrão: 20000)\n"
+              << "  --taxa N             operações por segundo somando as threads (padrão: sem limite)\n"
+              << "  --semente N          semente do gerador aleatório (padrão: 42)\n"
+              << "  --json               imprime o relatório em JSON" << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Configuracao configuracao;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string opcao = argv[i];
+        bool temValor = i + 1 < argc;
+
+        if (opcao == "--json")
+        {
+            configuracao.saidaJson = true;
+        }
+        else if (opcao == "--banco" && temValor)
+        {
+            configuracao.caminhoBanco = argv[++i];
+        }
+        else if (opcao == "--repositorio" && temValor && (std::string(argv[i + 1]) == "sqlite" ||
+                                                           std::string(argv[i + 1]) == "memoria"))
+        {
+            configuracao.repositorioMemoria = std::string(argv[++i]) == "memoria";
+        }
+        else if (opcao == "--fragmentos" && temValor)
+        {
+            configuracao.fragmentos = std::atoi(argv[++i]);
+        }
+        else if (opcao == "--dados" && temValor)
+        {
+            configuracao.caminhoDados = argv[++i];
+        }
+        else if (opcao == "--threads" && temValor)
+        {
+            configuracao.threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (opcao == "--contas" && temValor)
+        {
+            configuracao.contas = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (opcao == "--operacoes" && temValor)
+        {
+            configuracao.operacoes = std::atoll(argv[++i]);
+        }
+        else if (opcao == "--taxa" && temValor)
+        {
+            configuracao.taxa = std::atof(argv[++i]);
+        }
+        else if (opcao == "--semente" && temValor)
+        {
+            configuracao.semente = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            exibirUso(argv[0]);
+            return 1;
+        }
+    }
+
+    // Os códigos de carteira e ordem recomeçam em 00000 a cada execução: um banco de uma execução anterior
+    // faria toda criação falhar, e o relatório mediria só caminhos de erro
+    if (!configuracao.repositorioMemoria)
+    {
+        recriarBanco(configuracao);
+    }
+
+    auto indice = std::make_shared<IndiceCotacoes>();
+    if (!indice->carregar(configuracao.caminhoDados) || indice->quantidadeRegistros() == 0)
+    {
+        std::cerr << "Erro: Não foi possível carregar " << configuracao.caminhoDados << std::endl;
+        return 1;
+    }
+
+    std::atomic<int> proximaCarteira(0);
+    std::atomic<int> proximaOrdem(0);
+    std::atomic<long long> operacoesRestantes(configuracao.operacoes);
+
+    std::shared_ptr<IRepositorio> memoria;
+    if (configuracao.repositorioMemoria)
+    {
+        memoria = std::make_shared<RepositorioMemoria>();
+    }
+    auto diretorio = std::make_shared<DiretorioFragmentos>();
+
+    std::vector<std::unique_ptr<TrabalhadorCarga>> trabalhadores;
+    for (int t = 0; t < configuracao.threads; t++)
+    {
+        std::shared_ptr<IRepositorio> repositorio = memoria;
+        if (!repositorio && configuracao.fragmentos > 1)
+        {
+            repositorio = std::make_shared<RepositorioFragmentado>(configuracao.caminhoBanco,
+                                                                   configuracao.fragmentos, diretorio);
+        }
+        else if (!repositorio)
+        {
+            repositorio = std::make_shared<DatabaseManager>(configuracao.caminhoBanco);
+        }
+        trabalhadores.push_back(std::make_unique<TrabalhadorCarga>(
+            configuracao, *indice, indice, proximaCarteira, proximaOrdem, operacoesRestantes,
+            configuracao.semente + static_cast<unsigned>(t), std::move(repositorio)));
+        if (!trabalhadores.back()->inicializado)
+        {
+            std::cerr << "Erro: Não foi possível abrir o banco " << configuracao.caminhoBanco << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::thread> threads;
+    auto inicio = Relogio::now();
+    for (int t = 0; t < configuracao.threads; t++)
+    {
+        int contasDaThread =
+            configuracao.contas / configuracao.threads + (t < configuracao.contas % configuracao.threads ? 1 : 0);
+        threads.emplace_back([&, t, contasDaThread] {
+            trabalhadores[t]->prepararContas(contasDaThread);
+            trabalhadores[t]->executarOperacoes(configuracao.taxa / configuracao.threads);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    double segundos = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    Amostras total;
+    for (auto &trabalhador : trabalhadores)
+    {
+        total.juntar(trabalhador->amostras);
+    }
+
+    imprimirRelatorio(total, segundos, configuracao);
+    return 0;
+}
@@ -1,103 +1,60 @@
 #include "InputValidator.hpp"
+#include "CatalogoCotacoes.hpp"
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
 
-const std::string InputValidator::CAMINHO_ARQUIVO_B3 = "../data/DADOS_HISTORICOS.txt";
-
 /**
  * @brief Valida se uma combinação de código de negociação e data existe nos dados históricos da B3
  * @param codigoNegociacao Código de negociação a ser validado
  * @param data Data no formato AAAAMMDD a ser validada
  * @return true se a combinação existe nos dados históricos, false caso contrário
- * @details Abre o arquivo de dados históricos da B3 e verifica se existe uma entrada
- *          correspondente ao código de negociação e data fornecidos. Ignora linhas
- *          vazias e comentários iniciados com '#'.
- * @see CAMINHO_ARQUIVO_B3
- * @see extrairCodigoB3()
- * @see extrairDataB3()
+ * @details Consulta o catálogo de cotações do processo, que carrega apenas o
+ *          ano da data informada.
+ * @see CatalogoCotacoes::contem()
  */
 bool InputValidator::validarCombinacaoB3(const CodigoNeg &codigoNegociacao, const std::string &data)
 {
-    std::ifstream arquivoB3(CAMINHO_ARQUIVO_B3);
-    if (!arquivoB3.is_open())
-    {
-        return false;
-    }
-
-    std::string codigoLimpo = removerEspacosFinais(codigoNegociacao.getValor());
-    std::string linhaB3;
-
-    while (std::getline(arquivoB3, linhaB3))
-    {
-        if (linhaB3.empty() || linhaB3[0] == '#')
-        {
-            continue;
-        }
-
-        if (linhaB3.length() >= 24)
-        {
-            std::string codigoLinha = extrairCodigoB3(linhaB3);
-            std::string dataLinha = extrairDataB3(linhaB3);
-
-            if (codigoLinha == codigoLimpo && dataLinha == data)
-            {
-                arquivoB3.close();
-                return true;
-            }
-        }
-    }
-
-    arquivoB3.close();
-    return false;
+    uint32_t dataInteira = LeitorCotahist::dataParaInteiro(data);
+    return dataInteira != 0 &&
+           CatalogoCotacoes::instancia().contem(removerEspacosFinais(codigoNegociacao.getValor()), dataInteira);
 }
 
 /**
  * @brief Busca todas as datas disponíveis para um código de negociação específico
  * @param codigoNegociacao Código de negociação para buscar datas
- * @param datasDisponiveis Conjunto onde serão armazenadas as datas encontradas
+ * @param datasDisponiveis Fatias ordenadas das datas encontradas, uma por ano
+ * @param dataInicial Primeira data considerada
+ * @param dataFinal Última data considerada
  * @return true se encontrou pelo menos uma data, false caso contrário
- * @details Percorre o arquivo de dados históricos da B3 e coleta todas as datas
- *          disponíveis para o código de negociação fornecido. As datas são
- *          armazenadas em um conjunto para evitar duplicatas.
- * @see CAMINHO_ARQUIVO_B3
- * @see extrairCodigoB3()
- * @see extrairDataB3()
+ * @details As fatias apontam para a série de datas do papel no catálogo de
+ *          cotações; nenhum arquivo é percorrido e nada é copiado, exceto no
+ *          modo arquivo, em que as datas vêm do auxiliar de deslocamentos.
+ * @see CatalogoCotacoes::obterDatas()
  */
-bool InputValidator::buscarDatasDisponiveis(const CodigoNeg &codigoNegociacao, std::set<std::string> &datasDisponiveis)
+bool InputValidator::buscarDatasDisponiveis(const CodigoNeg &codigoNegociacao,
+                                            std::vector<DatasPapel> &datasDisponiveis, uint32_t dataInicial,
+                                            uint32_t dataFinal)
 {
-    std::ifstream arquivoB3(CAMINHO_ARQUIVO_B3);
-    if (!arquivoB3.is_open())
-    {
-        return false;
-    }
-
-    std::string codigoLimpo = removerEspacosFinais(codigoNegociacao.getValor());
-    std::string linhaB3;
-
-    while (std::getline(arquivoB3, linhaB3))
-    {
-        if (linhaB3.empty() || linhaB3[0] == '#')
-        {
-            continue;
-        }
-
-        if (linhaB3.length() >= 24)
-        {
-            std::string codigoLinha = extrairCodigoB3(linhaB3);
-
-            if (codigoLinha == codigoLimpo)
-            {
-                std::string dataLinha = extrairDataB3(linhaB3);
-                datasDisponiveis.insert(dataLinha);
-            }
-        }
-    }
-
-    arquivoB3.close();
+    datasDisponiveis = CatalogoCotacoes::instancia().obterDatas(removerEspacosFinais(codigoNegociacao.getValor()),
+                                                                dataInicial, dataFinal);
     return !datasDisponiveis.empty();
 }
 
+/**
+ * @brief Sugere códigos de negociação para um texto digitado
+ * @param texto Código ou nome da empresa, completo ou parcial
+ * @param maximo Quantidade máxima de sugestões
+ * @return Sugestões da melhor para a pior
+ * @details Consulta o índice de busca de papéis do catálogo, montado uma vez
+ *          por processo; não lê os arquivos de dados a cada chamada.
+ * @see BuscaPapeis::sugerir()
+ */
+std::vector<SugestaoPapel> InputValidator::sugerirCodigos(const std::string &texto, size_t maximo)
+{
+    return CatalogoCotacoes::instancia().obterBuscaPapeis()->sugerir(texto, maximo);
+}
+
 /**
  * @brief Extrai o código de negociação de uma linha do arquivo B3
  * @param linhaB3 Linha completa do arquivo de dados históricos
@@ -1,10 +1,12 @@
 #ifndef INPUTVALIDATOR_HPP_INCLUDED
 #define INPUTVALIDATOR_HPP_INCLUDED
 
+#include "BuscaPapeis.hpp"
+#include "IndiceCotacoes.hpp"
 #include "dominios/dominios.hpp"
 #include <fstream>
-#include <set>
 #include <string>
+#include <vector>
 
 /**
  * @brief Validador especializado para entradas do usuário
@@ -17,7 +19,7 @@ class InputValidator
 {
   public:
     /**
-     * @brief Valida se uma combinação código+data existe no arquivo B3
+     * @brief Valida se uma combinação código+data existe nos dados históricos da B3
      *
      * @param codigoNegociacao Código de negociação
      * @param data Data da ordem
@@ -29,10 +31,23 @@ class InputValidator
      * @brief Busca datas disponíveis para um código de negociação
      *
      * @param codigoNegociacao Código de negociação
-     * @param datasDisponiveis Set para armazenar as datas encontradas
+     * @param datasDisponiveis Fatias das datas encontradas, uma por ano, em ordem crescente
+     * @param dataInicial Primeira data considerada (AAAAMMDD), inclusive
+     * @param dataFinal Última data considerada (AAAAMMDD), inclusive
      * @return bool true se encontrou datas
      */
-    static bool buscarDatasDisponiveis(const CodigoNeg &codigoNegociacao, std::set<std::string> &datasDisponiveis);
+    static bool buscarDatasDisponiveis(const CodigoNeg &codigoNegociacao, std::vector<DatasPapel> &datasDisponiveis,
+                                       uint32_t dataInicial = 0, uint32_t dataFinal = 99999999);
+
+    /**
+     * @brief Sugere códigos de negociação para um texto digitado
+     *
+     * @param texto Código ou nome da empresa, completo ou parcial
+     * @param maximo Quantidade máxima de sugestões
+     * @return std::vector<SugestaoPapel> Sugestões ordenadas; vazio se não há dados carregados
+     */
+    static std::vector<SugestaoPapel> sugerirCodigos(const std::string &texto,
+                                                     size_t maximo = BuscaPapeis::MAXIMO_PADRAO);
 
     /**
      * @brief Extrai código de negociação de uma linha B3
@@ -89,12 +104,6 @@ class InputValidator
      * @return std::string Valor formatado
      */
     static std::string formatarValorMonetario(const std::string &valor);
-
-  private:
-    /**
-     * @brief Caminho para o arquivo de dados históricos
-     */
-    static const std::string CAMINHO_ARQUIVO_B3;
 };
 
 #endif // INPUTVALIDATOR_HPP_INCLUDED
\ No newline at end of file
@@ -1,7 +1,30 @@
 #include "OrdemController.hpp"
+#include "CatalogoCotacoes.hpp"
 #include "InputValidator.hpp"
+#include "Rastreamento.hpp"
+#include <algorithm>
 #include <limits>
 
+namespace
+{
+/**
+ * @brief Meses de histórico usados para estimar o volume típico do papel
+ */
+const uint32_t MESES_JANELA_LIQUIDEZ = 3;
+
+/**
+ * @brief Fração da quantidade média diária a partir da qual a ordem gera aviso
+ */
+const double LIMITE_PARTICIPACAO_VOLUME = 0.10;
+
+/**
+ * @brief Anos de histórico resumidos na tela de data da ordem
+ * @details Só os anos dessa janela são carregados; resumir o histórico inteiro
+ *          carregaria todas as partições a cada ordem.
+ */
+const uint32_t ANOS_RESUMO_DATAS = 1;
+} // namespace
+
 /**
  * @brief Construtor da controladora de ordens
  * @param servico Ponteiro para o serviço de investimento
@@ -103,6 +126,8 @@ void OrdemController::exibirMenu(const Carteira &carteiraAtual, const Dinheiro &
  */
 void OrdemController::criarOrdem(const Codigo &codigoCarteira)
 {
+    SpanRastreamento span("OrdemController::criarOrdem", "apresentacao");
+
     telaUtils::exibirCabecalho("CRIACAO DE NOVA ORDEM");
 
     Carteira carteiraAtual;
@@ -150,7 +175,7 @@ void OrdemController::criarOrdem(const Codigo &codigoCarteira)
         return;
     }
 
-    if (!solicitarQuantidade(quantidadeOrdem))
+    if (!solicitarQuantidade(quantidadeOrdem, codigoNegociacao, dataOrdem))
     {
         return;
     }
@@ -349,21 +374,25 @@ bool OrdemController::solicitarCodigoOrdem(Codigo &codigoOrdem)
  * @details Processo interativo para coleta do código de negociação com:
  *          - Validação de tamanho (até 12 caracteres)
  *          - Suporte a extração de códigos de linhas B3 completas
+ *          - Sugestões por prefixo, nome da empresa ou aproximação quando o
+ *            código não existe nos dados históricos, escolhidas pelo número
  *          - Formatação automática para 12 caracteres
  *          - Opção de cancelamento
  */
 bool OrdemController::solicitarCodigoNegociacao(CodigoNeg &codigoNegociacao)
 {
     std::cout << "\n📈 2. CÓDIGO DE NEGOCIAÇÃO - Código do ativo (ex: JBSS3, JALL3) - até 12 caracteres" << std::endl;
-    std::cout << "   💡 DICA: Digite o código do ativo que deseja negociar" << std::endl;
+    std::cout << "   💡 DICA: Digite o código do ativo que deseja negociar, ou parte dele ou do nome da empresa"
+              << std::endl;
 
+    std::vector<SugestaoPapel> sugestoes;
+    std::cin.ignore();
     while (true)
     {
         try
         {
             std::cout << "\nDigite o CÓDIGO DE NEGOCIAÇÃO (ex: JBSS3) ou '0' para cancelar: ";
             std::string entradaCodigo;
-            std::cin.ignore();
             std::getline(std::cin, entradaCodigo);
 
             if (entradaCodigo == "0")
@@ -393,6 +422,14 @@ bool OrdemController::solicitarCodigoNegociacao(CodigoNeg &codigoNegociacao)
                 }
             }
 
+            // Um número escolhe uma das sugestões exibidas na tentativa anterior
+            if (!sugestoes.empty() && InputValidator::contemApenasDigitos(entradaCodigo) &&
+                entradaCodigo.length() <= 2 && std::stoul(entradaCodigo) >= 1 &&
+                std::stoul(entradaCodigo) <= sugestoes.size())
+            {
+                entradaCodigo = sugestoes[std::stoul(entradaCodigo) - 1].codigoNegociacao;
+            }
+
             if (entradaCodigo.length() == 0 || entradaCodigo.length() > 12)
             {
                 std::cout << "❌ ERRO: Código de negociação deve ter até 12 caracteres." << std::endl;
@@ -400,6 +437,32 @@ bool OrdemController::solicitarCodigoNegociacao(CodigoNeg &codigoNegociacao)
                 continue;
             }
 
+            // Sem dados carregados não há sugestões, e o código segue para a validação da data
+            sugestoes = InputValidator::sugerirCodigos(entradaCodigo, 5);
+            if (!sugestoes.empty() && sugestoes.front().tipo != SUGESTAO_EXATA)
+            {
+                std::cout << "❌ Código '" << entradaCodigo << "' não encontrado nos dados históricos. Você quis dizer:"
+                          << std::endl;
+                for (size_t i = 0; i < sugestoes.size(); i++)
+                {
+                    std::cout << "   " << (i + 1) << ") " << std::left << std::setw(12)
+                              << sugestoes[i].codigoNegociacao << " " << std::setw(12) << sugestoes[i].nomeResumido
+                              << std::right << " (" << sugestoes[i].pregoes << " pregões)" << std::endl;
+                }
+                std::cout << "   Digite o número da sugestão ou outro código." << std::endl;
+                continue;
+            }
+            if (sugestoes.empty() && CatalogoCotacoes::instancia().obterBuscaPapeis()->quantidadePapeis() > 0)
+            {
+                std::cout << "❌ Código '" << entradaCodigo << "' não encontrado nos dados históricos." << std::endl;
+                std::cout << "   Exemplo: JBSS3, JALL3, HYPE3, IVVB11" << std::endl;
+                continue;
+            }
+            if (!sugestoes.empty())
+            {
+                entradaCodigo = sugestoes.front().codigoNegociacao;
+            }
+
             std::string codigoCompleto = InputValidator::formatarCodigoNegociacao(entradaCodigo);
             codigoNegociacao.setValor(codigoCompleto);
             std::cout << "✅ Código de negociação válido: '" << entradaCodigo << "'" << std::endl;
@@ -421,6 +484,7 @@ bool OrdemController::solicitarCodigoNegociacao(CodigoNeg &codigoNegociacao)
  * @details Processo interativo para coleta da data com validação contra dados históricos:
  *          - Formato AAAAMMDD obrigatório
  *          - Validação de existência da combinação código+data no arquivo B3
+ *          - Resumo das datas com cotação do papel no último ano do histórico (quantidade, primeira e última)
  *          - Feedback específico sobre disponibilidade dos dados
  *          - Opção de cancelamento
  */
@@ -429,6 +493,36 @@ bool OrdemController::solicitarDataOrdem(Data &dataOrdem, const CodigoNeg &codig
     std::cout << "\n📄 3. DATA               - Data da operação (ex: 20250110)" << std::endl;
     std::cout << "   💡 DICA: O sistema validará se a combinação código+data existe no arquivo B3" << std::endl;
 
+    // A janela termina na última data coberta pelos arquivos do catálogo; com datas desconhecidas (arquivo
+    // único), a única partição é a sem data, e a janela fica aberta
+    uint32_t ultimaData = 0;
+    for (const ArquivoCotahist &arquivo : CatalogoCotacoes::instancia().listarArquivos())
+    {
+        ultimaData = std::max(ultimaData, arquivo.dataFinal);
+    }
+    uint32_t dataInicial = ultimaData > ANOS_RESUMO_DATAS * 10000 ? ultimaData - ANOS_RESUMO_DATAS * 10000 : 0;
+    uint32_t dataFinal = ultimaData > 0 ? ultimaData : 99999999;
+
+    std::vector<DatasPapel> datasDisponiveis;
+    if (InputValidator::buscarDatasDisponiveis(codigoNegociacao, datasDisponiveis, dataInicial, dataFinal))
+    {
+        size_t pregoes = 0;
+        for (const DatasPapel &fatia : datasDisponiveis)
+        {
+            pregoes += fatia.size();
+        }
+        std::string primeira = std::to_string(datasDisponiveis.front()[0]);
+        std::string ultima = std::to_string(datasDisponiveis.back()[datasDisponiveis.back().size() - 1]);
+        std::cout << "   📅 Cotações";
+        if (ultimaData > 0)
+        {
+            std::cout << " nos últimos " << ANOS_RESUMO_DATAS * 12 << " meses do histórico";
+        }
+        std::cout << ": " << pregoes << " pregões, de " << primeira.substr(6, 2) << "/" << primeira.substr(4, 2)
+                  << "/" << primeira.substr(0, 4) << " a " << ultima.substr(6, 2) << "/" << ultima.substr(4, 2) << "/"
+                  << ultima.substr(0, 4) << std::endl;
+    }
+
     while (true)
     {
         try
@@ -487,8 +581,11 @@ bool OrdemController::solicitarDataOrdem(Data &dataOrdem, const CodigoNeg &codig
  * @return true se a quantidade foi inserida com sucesso, false se cancelado
  * @details Processo interativo para coleta da quantidade com validação automática
  *          do domínio Quantidade. Suporta formatação com pontos para milhares.
+ *          Uma quantidade válida passa pelo aviso de liquidez antes de ser aceita.
+ * @see avisarLiquidez()
  */
-bool OrdemController::solicitarQuantidade(Quantidade &quantidadeOrdem)
+bool OrdemController::solicitarQuantidade(Quantidade &quantidadeOrdem, const CodigoNeg &codigoNegociacao,
+                                          const Data &dataOrdem)
 {
     std::cout << "\n🔢 4. QUANTIDADE         - Quantos papéis (ex: 100, 1.000)" << std::endl;
     std::cout << "   💡 DICA: Digite números inteiros (ex: 1000 ou 1.000, 5000 ou 5.000)" << std::endl;
@@ -512,6 +609,7 @@ bool OrdemController::solicitarQuantidade(Quantidade &quantidadeOrdem)
 
             quantidadeOrdem.setValor(valorQuantidade);
             std::cout << "✅ Quantidade válida: " << valorQuantidade << std::endl;
+            avisarLiquidez(quantidadeOrdem, codigoNegociacao, dataOrdem);
             return true;
         }
         catch (const std::invalid_argument &exp)
@@ -522,6 +620,54 @@ bool OrdemController::solicitarQuantidade(Quantidade &quantidadeOrdem)
     }
 }
 
+/**
+ * @brief Avisa quando a quantidade é uma fração grande do volume típico do papel
+ * @details Compara a quantidade com a média diária negociada nos
+ *          MESES_JANELA_LIQUIDEZ meses até a data da ordem. Sem o layout
+ *          completo (QUATOT/VOLTOT) nos dados históricos, nada é exibido.
+ */
+void OrdemController::avisarLiquidez(const Quantidade &quantidadeOrdem, const CodigoNeg &codigoNegociacao,
+                                     const Data &dataOrdem)
+{
+    uint32_t dataFinal = LeitorCotahist::dataParaInteiro(dataOrdem.getValor());
+    uint32_t ano = dataFinal / 10000;
+    uint32_t mes = (dataFinal / 100) % 100;
+    if (mes <= MESES_JANELA_LIQUIDEZ)
+    {
+        ano--;
+        mes += 12;
+    }
+    uint32_t dataInicial = ano * 10000 + (mes - MESES_JANELA_LIQUIDEZ) * 100 + dataFinal % 100;
+
+    EstatisticasNegociacao estatisticas;
+    if (dataFinal == 0 ||
+        !CatalogoCotacoes::instancia().somarNegociacao(codigoNegociacao.getValor(), dataInicial, dataFinal,
+                                                       &estatisticas) ||
+        estatisticas.quantidadeMediaDiaria() <= 0.0)
+    {
+        return;
+    }
+
+    double participacao = static_cast<double>(quantidadeOrdem.getUnidades()) / estatisticas.quantidadeMediaDiaria();
+    if (participacao < LIMITE_PARTICIPACAO_VOLUME)
+    {
+        return;
+    }
+
+    std::ios_base::fmtflags formatoAnterior = std::cout.flags();
+    std::streamsize precisaoAnterior = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "⚠️  AVISO: a quantidade equivale a " << participacao * 100.0
+              << "% da quantidade média diária negociada do papel nos últimos " << MESES_JANELA_LIQUIDEZ << " meses ("
+              << estatisticas.quantidadeMediaDiaria() << " títulos/pregão)." << std::endl;
+    std::cout << "   VWAP do período: R$ "
+              << InputValidator::formatarValorMonetario(std::to_string(estatisticas.vwapCentavos()))
+              << " | Índice de negociabilidade: " << std::setprecision(3) << estatisticas.indiceNegociabilidade()
+              << std::endl;
+    std::cout.flags(formatoAnterior);
+    std::cout.precision(precisaoAnterior);
+}
+
 void OrdemController::exibirResumoOrdem(const Codigo &codigoOrdem, const CodigoNeg &codigoNegociacao,
                                         const Data &dataOrdem, const Quantidade &quantidadeOrdem,
                                         const Carteira &carteiraAtual)
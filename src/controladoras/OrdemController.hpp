@@ -115,9 +115,20 @@ class OrdemController
      * @brief Solicita e valida a quantidade
      *
      * @param quantidadeOrdem Quantidade a ser preenchida
+     * @param codigoNegociacao Papel da ordem, usado no aviso de liquidez
+     * @param dataOrdem Data da ordem, fim da janela do aviso de liquidez
      * @return bool true se válido
      */
-    bool solicitarQuantidade(Quantidade &quantidadeOrdem);
+    bool solicitarQuantidade(Quantidade &quantidadeOrdem, const CodigoNeg &codigoNegociacao, const Data &dataOrdem);
+
+    /**
+     * @brief Avisa quando a quantidade é uma fração grande do volume típico do papel
+     *
+     * @param quantidadeOrdem Quantidade informada
+     * @param codigoNegociacao Papel da ordem
+     * @param dataOrdem Data da ordem
+     */
+    void avisarLiquidez(const Quantidade &quantidadeOrdem, const CodigoNeg &codigoNegociacao, const Data &dataOrdem);
 
     /**
      * @brief Exibe resumo da ordem antes da confirmação
@@ -0,0 +1,568 @@
+#include "ProcessadorLote.hpp"
+#include "CatalogoCotacoes.hpp"
+#include "InputValidator.hpp"
+#include "Rastreamento.hpp"
+#include "RegistroMetricas.hpp"
+#include "jsonUtils.hpp"
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+ProcessadorLote::ProcessadorLote(IServicoAutenticacao *autenticacao, IServicoUsuario *usuario,
+                                 IServicoInvestimento *investimento)
+    : servicoAutenticacao(autenticacao), servicoUsuario(usuario), servicoInvestimento(investimento)
+{
+}
+
+/**
+ * @brief Executa todos os comandos de um fluxo de entrada
+ * @param entrada Fluxo com um comando por linha
+ * @param saida Fluxo onde as respostas JSON são escritas
+ * @return Quantidade de comandos que falharam
+ * @details Cada linha processada gera exatamente uma linha de saída, na mesma ordem
+ *          da entrada. Linhas vazias e comentários não geram saída.
+ */
+int ProcessadorLote::executar(std::istream &entrada, std::ostream &saida)
+{
+    std::string linha;
+    std::string resposta;
+    int falhas = 0;
+
+    while (std::getline(entrada, linha))
+    {
+        bool sucesso = processarLinha(linha, resposta);
+        if (resposta.empty())
+        {
+            continue;
+        }
+
+        if (!sucesso)
+        {
+            falhas++;
+        }
+        saida << resposta << '\n';
+    }
+
+    saida.flush();
+    return falhas;
+}
+
+/**
+ * @brief Processa uma linha de comando e monta a resposta JSON
+ * @param linha Linha de comando
+ * @param resposta Objeto JSON com o resultado, ou vazio se a linha foi ignorada
+ * @return true se o comando foi executado com sucesso, false caso contrário
+ * @details Erros de validação dos domínios e de uso são capturados e reportados
+ *          no campo "erro" da resposta, sem interromper o processamento.
+ */
+bool ProcessadorLote::processarLinha(const std::string &linha, std::string &resposta)
+{
+    resposta.clear();
+
+    std::vector<std::string> args = separarArgumentos(linha);
+    if (args.empty() || args[0][0] == '#')
+    {
+        return true;
+    }
+
+    return processarComando(std::move(args), resposta);
+}
+
+/**
+ * @brief Processa um comando já separado em argumentos
+ * @param args Nome do comando seguido de seus argumentos
+ * @param resposta Objeto JSON com o resultado
+ * @return true se o comando foi executado com sucesso, false caso contrário
+ */
+bool ProcessadorLote::processarComando(std::vector<std::string> args, std::string &resposta)
+{
+    SpanRastreamento span("ProcessadorLote::processarComando", "lote");
+
+    if (args.empty())
+    {
+        resposta = "{\"comando\":\"\",\"ok\":false,\"erro\":\"comando vazio\"}";
+        return false;
+    }
+
+    std::string comando = args[0];
+    args.erase(args.begin());
+
+    std::string campos;
+    std::string erro;
+    bool sucesso = false;
+
+    try
+    {
+        sucesso = despachar(comando, args, campos);
+        if (!sucesso)
+        {
+            erro = "operacao recusada pela camada de servico";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        sucesso = false;
+        erro = e.what();
+    }
+
+    std::ostringstream json;
+    json << "{\"comando\":" << jsonUtils::texto(comando) << ",\"ok\":" << (sucesso ? "true" : "false");
+    if (sucesso)
+    {
+        json << campos;
+    }
+    else
+    {
+        json << ",\"erro\":" << jsonUtils::texto(erro);
+    }
+    json << "}";
+
+    resposta = json.str();
+    return sucesso;
+}
+
+/**
+ * @brief Separa uma linha em argumentos
+ * @param linha Linha de comando
+ * @return Lista de argumentos
+ * @details Espaços e tabulações separam argumentos; trechos entre aspas duplas
+ *          formam um único argumento (usado para nomes com espaços).
+ */
+std::vector<std::string> ProcessadorLote::separarArgumentos(const std::string &linha)
+{
+    std::vector<std::string> args;
+    std::string atual;
+    bool entreAspas = false;
+    bool temArgumento = false;
+
+    for (char c : linha)
+    {
+        if (c == '"')
+        {
+            entreAspas = !entreAspas;
+            temArgumento = true;
+        }
+        else if (!entreAspas && (c == ' ' || c == '\t' || c == '\r' || c == '\n'))
+        {
+            if (temArgumento)
+            {
+                args.push_back(atual);
+                atual.clear();
+                temArgumento = false;
+            }
+        }
+        else
+        {
+            atual += c;
+            temArgumento = true;
+        }
+    }
+
+    if (temArgumento)
+    {
+        args.push_back(atual);
+    }
+
+    return args;
+}
+
+bool ProcessadorLote::despachar(const std::string &comando, const std::vector<std::string> &args,
+                                std::string &campos)
+{
+    if (comando == "create-account")
+    {
+        exigirArgumentos(args, 3, "create-account CPF SENHA NOME");
+        Conta conta;
+        Senha senha;
+        Nome nome;
+        senha.setValor(args[1]);
+        nome.setValor(args[2]);
+        conta.setNcpf(lerCpf(args[0]));
+        conta.setSenha(senha);
+        conta.setNome(nome);
+        return servicoUsuario->cadastrarConta(conta);
+    }
+
+    if (comando == "login")
+    {
+        exigirArgumentos(args, 2, "login CPF SENHA");
+        Senha senha;
+        senha.setValor(args[1]);
+        return servicoAutenticacao->autenticar(lerCpf(args[0]), senha);
+    }
+
+    if (comando == "get-account")
+    {
+        exigirArgumentos(args, 1, "get-account CPF");
+        Conta conta;
+        Dinheiro saldo;
+        if (!servicoUsuario->consultarConta(lerCpf(args[0]), &conta, &saldo))
+        {
+            return false;
+        }
+        campos = ",\"cpf\":" + jsonUtils::texto(conta.getNcpf().getValor()) +
+                 ",\"nome\":" + jsonUtils::texto(conta.getNome().getValor()) +
+                 ",\"saldo\":" + jsonUtils::texto(saldo.getValor());
+        return true;
+    }
+
+    if (comando == "update-account")
+    {
+        exigirArgumentos(args, 3, "update-account CPF SENHA NOME");
+        Conta conta;
+        Senha senha;
+        Nome nome;
+        senha.setValor(args[1]);
+        nome.setValor(args[2]);
+        conta.setNcpf(lerCpf(args[0]));
+        conta.setSenha(senha);
+        conta.setNome(nome);
+        return servicoUsuario->editarConta(conta);
+    }
+
+    if (comando == "delete-account")
+    {
+        exigirArgumentos(args, 1, "delete-account CPF");
+        return servicoUsuario->excluirConta(lerCpf(args[0]));
+    }
+
+    if (comando == "create-wallet")
+    {
+        exigirArgumentos(args, 4, "create-wallet CPF CODIGO PERFIL NOME");
+        Ncpf cpf = lerCpf(args[0]);
+
+        std::list<Carteira> existentes;
+        if (servicoInvestimento->listarCarteiras(cpf, &existentes) &&
+            existentes.size() >= static_cast<size_t>(MAXIMO_CARTEIRAS))
+        {
+            throw std::invalid_argument("limite de 5 carteiras por conta atingido");
+        }
+
+        Carteira carteira;
+        TipoPerfil perfil;
+        Nome nome;
+        perfil.setValor(args[2]);
+        nome.setValor(args[3]);
+        carteira.setCodigo(lerCodigo(args[1]));
+        carteira.setTipoPerfil(perfil);
+        carteira.setNome(nome);
+        return servicoInvestimento->criarCarteira(cpf, carteira);
+    }
+
+    if (comando == "list-wallets")
+    {
+        exigirArgumentos(args, 1, "list-wallets CPF");
+        std::list<Carteira> carteiras;
+        if (!servicoInvestimento->listarCarteiras(lerCpf(args[0]), &carteiras))
+        {
+            return false;
+        }
+
+        campos = ",\"carteiras\":[";
+        bool primeira = true;
+        for (const auto &carteira : carteiras)
+        {
+            campos += (primeira ? "" : ",") + carteiraJson(carteira);
+            primeira = false;
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "get-wallet")
+    {
+        exigirArgumentos(args, 1, "get-wallet CODIGO");
+        Carteira carteira;
+        Dinheiro saldo;
+        if (!servicoInvestimento->consultarCarteira(lerCodigo(args[0]), &carteira, &saldo))
+        {
+            return false;
+        }
+        campos = ",\"carteira\":" + carteiraJson(carteira) + ",\"saldo\":" + jsonUtils::texto(saldo.getValor());
+        return true;
+    }
+
+    if (comando == "update-wallet")
+    {
+        exigirArgumentos(args, 3, "update-wallet CODIGO PERFIL NOME");
+        Carteira carteira;
+        TipoPerfil perfil;
+        Nome nome;
+        perfil.setValor(args[1]);
+        nome.setValor(args[2]);
+        carteira.setCodigo(lerCodigo(args[0]));
+        carteira.setTipoPerfil(perfil);
+        carteira.setNome(nome);
+        return servicoInvestimento->editarCarteira(carteira);
+    }
+
+    if (comando == "delete-wallet")
+    {
+        exigirArgumentos(args, 1, "delete-wallet CODIGO");
+        return servicoInvestimento->excluirCarteira(lerCodigo(args[0]));
+    }
+
+    if (comando == "create-order")
+    {
+        exigirArgumentos(args, 5, "create-order CARTEIRA CODIGO PAPEL DATA QUANTIDADE");
+        if (args[2].empty() || args[2].length() > 12)
+        {
+            throw std::invalid_argument("codigo de negociacao deve ter de 1 a 12 caracteres");
+        }
+
+        Ordem ordem;
+        CodigoNeg codigoNeg;
+        Data data;
+        Quantidade quantidade;
+        Dinheiro valorTemporario;
+        codigoNeg.setValor(InputValidator::formatarCodigoNegociacao(args[2]));
+        data.setValor(args[3]);
+        quantidade.setValor(args[4]);
+        valorTemporario.setValor("0,01");
+
+        ordem.setCodigo(lerCodigo(args[1]));
+        ordem.setCodigoNeg(codigoNeg);
+        ordem.setData(data);
+        ordem.setQuantidade(quantidade);
+        ordem.setDinheiro(valorTemporario);
+        return servicoInvestimento->criarOrdem(lerCodigo(args[0]), ordem);
+    }
+
+    if (comando == "list-orders")
+    {
+        exigirArgumentos(args, 1, "list-orders CARTEIRA");
+        std::list<Ordem> ordens;
+        if (!servicoInvestimento->listarOrdens(lerCodigo(args[0]), &ordens))
+        {
+            return false;
+        }
+
+        campos = ",\"ordens\":[";
+        bool primeira = true;
+        for (const auto &ordem : ordens)
+        {
+            campos += (primeira ? "" : ",") + ordemJson(ordem);
+            primeira = false;
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "delete-order")
+    {
+        exigirArgumentos(args, 1, "delete-order CODIGO");
+        return servicoInvestimento->excluirOrdem(lerCodigo(args[0]));
+    }
+
+    if (comando == "balance")
+    {
+        exigirArgumentos(args, 1, "balance CPF|CARTEIRA");
+        Dinheiro saldo;
+        if (args[0].length() == 5)
+        {
+            Carteira carteira;
+            if (!servicoInvestimento->consultarCarteira(lerCodigo(args[0]), &carteira, &saldo))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            Conta conta;
+            if (!servicoUsuario->consultarConta(lerCpf(args[0]), &conta, &saldo))
+            {
+                return false;
+            }
+        }
+        campos = ",\"saldo\":" + jsonUtils::texto(saldo.getValor());
+        return true;
+    }
+
+    if (comando == "list")
+    {
+        exigirArgumentos(args, 1, "list CPF");
+        std::list<Carteira> carteiras;
+        if (!servicoInvestimento->listarCarteiras(lerCpf(args[0]), &carteiras))
+        {
+            return false;
+        }
+
+        campos = ",\"carteiras\":[";
+        bool primeira = true;
+        for (const auto &carteira : carteiras)
+        {
+            Carteira dados;
+            Dinheiro saldo;
+            std::list<Ordem> ordens;
+            if (!servicoInvestimento->consultarCarteira(carteira.getCodigo(), &dados, &saldo) ||
+                !servicoInvestimento->listarOrdens(carteira.getCodigo(), &ordens))
+            {
+                return false;
+            }
+
+            std::string json = carteiraJson(carteira);
+            json.pop_back();
+            json += ",\"saldo\":" + jsonUtils::texto(saldo.getValor()) + ",\"ordens\":[";
+            bool primeiraOrdem = true;
+            for (const auto &ordem : ordens)
+            {
+                json += (primeiraOrdem ? "" : ",") + ordemJson(ordem);
+                primeiraOrdem = false;
+            }
+            json += "]}";
+
+            campos += (primeira ? "" : ",") + json;
+            primeira = false;
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "suggest-ticker")
+    {
+        exigirArgumentos(args, 1, "suggest-ticker TEXTO");
+        static const char *TIPOS[] = {"exata", "prefixo", "nome", "aproximada"};
+        campos = ",\"sugestoes\":[";
+        bool primeira = true;
+        for (const SugestaoPapel &sugestao : InputValidator::sugerirCodigos(args[0]))
+        {
+            campos += std::string(primeira ? "" : ",") + "{\"papel\":" + jsonUtils::texto(sugestao.codigoNegociacao) +
+                      ",\"nome\":" + jsonUtils::texto(sugestao.nomeResumido) +
+                      ",\"tipo\":" + jsonUtils::texto(TIPOS[sugestao.tipo]) +
+                      ",\"distancia\":" + std::to_string(sugestao.distancia) +
+                      ",\"pregoes\":" + std::to_string(sugestao.pregoes) + "}";
+            primeira = false;
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "list-dates")
+    {
+        if (args.size() != 1 && args.size() != 3)
+        {
+            throw std::invalid_argument("uso: list-dates PAPEL [DATA_INICIAL DATA_FINAL]");
+        }
+        if (args[0].empty() || args[0].length() > 12)
+        {
+            throw std::invalid_argument("codigo de negociacao deve ter de 1 a 12 caracteres");
+        }
+
+        CodigoNeg codigoNeg;
+        codigoNeg.setValor(InputValidator::formatarCodigoNegociacao(args[0]));
+        uint32_t dataInicial = 0;
+        uint32_t dataFinal = 99999999;
+        if (args.size() == 3)
+        {
+            Data inicial;
+            Data final;
+            inicial.setValor(args[1]);
+            final.setValor(args[2]);
+            dataInicial = static_cast<uint32_t>(std::stoul(args[1]));
+            dataFinal = static_cast<uint32_t>(std::stoul(args[2]));
+        }
+
+        std::vector<DatasPapel> fatias;
+        InputValidator::buscarDatasDisponiveis(codigoNeg, fatias, dataInicial, dataFinal);
+        campos = ",\"datas\":[";
+        bool primeira = true;
+        for (const DatasPapel &fatia : fatias)
+        {
+            for (uint32_t data : fatia)
+            {
+                campos += std::string(primeira ? "\"" : ",\"") + std::to_string(data) + "\"";
+                primeira = false;
+            }
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "quality-report")
+    {
+        exigirArgumentos(args, 0, "quality-report");
+        const size_t MAXIMO_PAPEIS = 10;
+        RelatorioQualidade relatorio = CatalogoCotacoes::instancia().obterRelatorioQualidade();
+        campos = ",\"registros\":" + std::to_string(relatorio.registros) +
+                 ",\"registros_com_problema\":" + std::to_string(relatorio.registrosComProblema) +
+                 ",\"linhas_curtas\":" + std::to_string(relatorio.linhasCurtas) +
+                 ",\"linhas_invalidas\":" + std::to_string(relatorio.linhasInvalidas) +
+                 ",\"duplicados\":" + std::to_string(relatorio.duplicados) +
+                 ",\"minimo_acima_maximo\":" + std::to_string(relatorio.minimoAcimaMaximo) +
+                 ",\"preco_zero\":" + std::to_string(relatorio.precoZero) +
+                 ",\"nomes_invalidos\":" + std::to_string(relatorio.nomesInvalidos) +
+                 ",\"registros_com_lacuna\":" + std::to_string(relatorio.registrosComLacuna) +
+                 ",\"pregoes_ausentes\":" + std::to_string(relatorio.pregoesAusentes) +
+                 ",\"papeis_com_lacunas\":" + std::to_string(relatorio.lacunasPorPapel.size()) + ",\"lacunas\":[";
+        for (size_t i = 0; i < relatorio.lacunasPorPapel.size() && i < MAXIMO_PAPEIS; i++)
+        {
+            const LacunasPapel &lacunas = relatorio.lacunasPorPapel[i];
+            campos += std::string(i == 0 ? "" : ",") + "{\"papel\":" + jsonUtils::texto(lacunas.codigoNegociacao) +
+                      ",\"pregoes_ausentes\":" + std::to_string(lacunas.pregoesAusentes) +
+                      ",\"registros\":" + std::to_string(lacunas.registros) + "}";
+        }
+        campos += "]";
+        return true;
+    }
+
+    if (comando == "metrics")
+    {
+        exigirArgumentos(args, 0, "metrics");
+        std::ostringstream metricas;
+        RegistroMetricas::instancia().exportarPrometheus(metricas);
+        campos = ",\"prometheus\":" + jsonUtils::texto(metricas.str());
+        return true;
+    }
+
+    throw std::invalid_argument("comando desconhecido");
+}
+
+void ProcessadorLote::exigirArgumentos(const std::vector<std::string> &args, size_t quantidade,
+                                       const std::string &uso)
+{
+    if (args.size() != quantidade)
+    {
+        throw std::invalid_argument("uso: " + uso);
+    }
+}
+
+/**
+ * @brief Converte um argumento em CPF
+ * @details Aceita o CPF formatado (XXX.XXX.XXX-XX) ou apenas os 11 dígitos.
+ */
+Ncpf ProcessadorLote::lerCpf(const std::string &valor)
+{
+    std::string cpfFormatado = valor;
+    if (valor.length() == 11 && InputValidator::contemApenasDigitos(valor))
+    {
+        cpfFormatado = valor.substr(0, 3) + "." + valor.substr(3, 3) + "." + valor.substr(6, 3) + "-" +
+                       valor.substr(9, 2);
+    }
+
+    Ncpf cpf;
+    cpf.setValor(cpfFormatado);
+    return cpf;
+}
+
+Codigo ProcessadorLote::lerCodigo(const std::string &valor)
+{
+    Codigo codigo;
+    codigo.setValor(valor);
+    return codigo;
+}
+
+std::string ProcessadorLote::carteiraJson(const Carteira &carteira)
+{
+    return "{\"codigo\":" + jsonUtils::texto(carteira.getCodigo().getValor()) +
+           ",\"nome\":" + jsonUtils::texto(carteira.getNome().getValor()) +
+           ",\"perfil\":" + jsonUtils::texto(carteira.getTipoPerfil().getValor()) + "}";
+}
+
+std::string ProcessadorLote::ordemJson(const Ordem &ordem)
+{
+    return "{\"codigo\":" + jsonUtils::texto(ordem.getCodigo().getValor()) +
+           ",\"papel\":" + jsonUtils::texto(InputValidator::removerEspacosFinais(ordem.getCodigoNeg().getValor())) +
+           ",\"data\":" + jsonUtils::texto(ordem.getData().getValor()) +
+           ",\"quantidade\":" + jsonUtils::texto(ordem.getQuantidade().getValor()) +
+           ",\"valor\":" + jsonUtils::texto(ordem.getDinheiro().getValor()) + "}";
+}
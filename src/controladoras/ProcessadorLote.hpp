@@ -0,0 +1,109 @@
+#ifndef PROCESSADORLOTE_HPP_INCLUDED
+#define PROCESSADORLOTE_HPP_INCLUDED
+
+#include "interfaces.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Processador de comandos em lote (modo não interativo)
+ *
+ * @details Executa comandos textuais diretamente sobre as interfaces de serviço,
+ * sem renderização de telas nem limpeza de terminal. Cada comando gera uma linha
+ * de resposta em JSON, permitindo o uso em scripts, testes de carga e rotinas noturnas.
+ *
+ * Gramática (um comando por linha; argumentos com espaços entre aspas duplas;
+ * linhas vazias ou iniciadas com '#' são ignoradas):
+ * - create-account CPF SENHA "NOME"
+ * - login CPF SENHA
+ * - get-account CPF
+ * - update-account CPF SENHA "NOME"
+ * - delete-account CPF
+ * - create-wallet CPF CODIGO PERFIL "NOME"
+ * - list-wallets CPF
+ * - get-wallet CODIGO
+ * - update-wallet CODIGO PERFIL "NOME"
+ * - delete-wallet CODIGO
+ * - create-order CARTEIRA CODIGO PAPEL DATA QUANTIDADE
+ * - list-orders CARTEIRA
+ * - delete-order CODIGO
+ * - balance CPF|CARTEIRA
+ * - list CPF
+ * - list-dates PAPEL [DATA_INICIAL DATA_FINAL] (pregões do papel nos dados históricos, sem repetição)
+ * - suggest-ticker TEXTO (papéis cujo código ou nome casa com o texto, exata ou aproximadamente)
+ * - quality-report (resumo da qualidade dos dados históricos e papéis com mais pregões ausentes)
+ * - metrics (métricas do processo no formato texto do Prometheus)
+ */
+class ProcessadorLote
+{
+  private:
+    IServicoAutenticacao *servicoAutenticacao;
+    IServicoUsuario *servicoUsuario;
+    IServicoInvestimento *servicoInvestimento;
+
+  public:
+    /**
+     * @brief Limite de carteiras por conta, o mesmo aplicado pela interface interativa
+     */
+    static const int MAXIMO_CARTEIRAS = 5;
+
+    /**
+     * @brief Construtor
+     *
+     * @param autenticacao Serviço de autenticação
+     * @param usuario Serviço de usuário
+     * @param investimento Serviço de investimentos
+     */
+    ProcessadorLote(IServicoAutenticacao *autenticacao, IServicoUsuario *usuario, IServicoInvestimento *investimento);
+
+    /**
+     * @brief Executa todos os comandos de um fluxo de entrada
+     *
+     * @param entrada Fluxo com um comando por linha
+     * @param saida Fluxo onde as respostas JSON são escritas (uma por linha)
+     * @return int Quantidade de comandos que falharam
+     */
+    int executar(std::istream &entrada, std::ostream &saida);
+
+    /**
+     * @brief Processa um único comando
+     *
+     * @param linha Linha de comando na gramática do modo lote
+     * @param resposta Objeto JSON com o resultado (vazio se a linha foi ignorada)
+     * @return bool true se o comando foi executado com sucesso
+     */
+    bool processarLinha(const std::string &linha, std::string &resposta);
+
+    /**
+     * @brief Processa um comando já separado em argumentos
+     *
+     * @param args Nome do comando seguido de seus argumentos
+     * @param resposta Objeto JSON com o resultado
+     * @return bool true se o comando foi executado com sucesso
+     */
+    bool processarComando(std::vector<std::string> args, std::string &resposta);
+
+    /**
+     * @brief Separa uma linha em argumentos, respeitando aspas duplas
+     *
+     * @param linha Linha de comando
+     * @return std::vector<std::string> Argumentos encontrados
+     */
+    static std::vector<std::string> separarArgumentos(const std::string &linha);
+
+  private:
+    bool despachar(const std::string &comando, const std::vector<std::string> &args, std::string &campos);
+
+    static void exigirArgumentos(const std::vector<std::string> &args, size_t quantidade, const std::string &uso);
+
+    static Ncpf lerCpf(const std::string &valor);
+
+    static Codigo lerCodigo(const std::string &valor);
+
+    static std::string carteiraJson(const Carteira &carteira);
+
+    static std::string ordemJson(const Ordem &ordem);
+};
+
+#endif // PROCESSADORLOTE_HPP_INCLUDED
@@ -1,7 +1,9 @@
 #include "controladorasServico.hpp"
+#include "../cotacoes/CatalogoCotacoes.hpp"
 #include "../database/DatabaseManager.hpp"
+#include "../metricas/Rastreamento.hpp"
+#include "../metricas/RegistroMetricas.hpp"
 #include <algorithm>
-#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -24,14 +26,51 @@ std::string trim(const std::string &str)
     return str.substr(first, (last - first + 1));
 }
 
+/**
+ * @brief Histograma de latência de uma operação da camada de serviço
+ * @param operacao Nome do método
+ * @details Chamado uma única vez por método, para inicializar uma referência estática.
+ */
+static HistogramaLatencia &latenciaServico(const char *operacao)
+{
+    return RegistroMetricas::instancia().histograma("investimentos_servico_duracao_segundos",
+                                                    std::string("operacao=\"") + operacao + "\"",
+                                                    "Duração das operações da ControladoraServico.");
+}
+
+/**
+ * @brief Contador de buscas de cotação
+ * @param origem "indice" ou "catalogo"
+ * @param resultado "acerto" ou "falta"
+ */
+static std::atomic<uint64_t> &contadorCotacoes(const char *origem, const char *resultado)
+{
+    return RegistroMetricas::instancia().contador(
+        "investimentos_cotacoes_buscas_total",
+        std::string("origem=\"") + origem + "\",resultado=\"" + resultado + "\"",
+        "Buscas de preço histórico por origem e resultado.");
+}
+
 /**
  * @brief Construtor da controladora de serviço
  * @details Inicializa o gerenciador de banco de dados com o caminho padrão do arquivo SQLite.
  *          Utiliza smart pointer para gerenciamento automático de memória.
  */
-ControladoraServico::ControladoraServico()
+ControladoraServico::ControladoraServico() : ControladoraServico("../database/sistema_investimentos.db")
+{
+}
+
+/**
+ * @brief Construtor da controladora de serviço com caminho de banco explícito
+ * @param caminhoBanco Caminho do arquivo SQLite
+ */
+ControladoraServico::ControladoraServico(const std::string &caminhoBanco)
+    : ControladoraServico(std::make_shared<DatabaseManager>(caminhoBanco))
+{
+}
+
+ControladoraServico::ControladoraServico(std::shared_ptr<IRepositorio> repositorio) : repositorio(std::move(repositorio))
 {
-    dbManager = std::make_unique<DatabaseManager>("../database/sistema_investimentos.db");
 }
 
 /**
@@ -42,6 +81,50 @@ ControladoraServico::~ControladoraServico()
 {
 }
 
+/**
+ * @brief Busca o preço histórico de um papel em uma data
+ * @param codigoNegociacao Código de negociação sem espaços finais
+ * @param dataNegociacao Data no formato AAAAMMDD
+ * @param precoCentavos Ponteiro para armazenar o preço em centavos
+ * @return true se a combinação foi encontrada, false caso contrário
+ * @see IndiceCotacoes::buscarPreco()
+ * @see CatalogoCotacoes::buscarPreco()
+ */
+bool ControladoraServico::buscarPrecoHistorico(const std::string &codigoNegociacao, const std::string &dataNegociacao,
+                                               long long *precoCentavos)
+{
+    SpanRastreamento span("ControladoraServico::buscarPrecoHistorico", "cotacoes");
+
+    uint32_t data = LeitorCotahist::dataParaInteiro(dataNegociacao);
+
+    static std::atomic<uint64_t> &acertosIndice = contadorCotacoes("indice", "acerto");
+    static std::atomic<uint64_t> &faltasIndice = contadorCotacoes("indice", "falta");
+    static std::atomic<uint64_t> &acertosCatalogo = contadorCotacoes("catalogo", "acerto");
+    static std::atomic<uint64_t> &faltasCatalogo = contadorCotacoes("catalogo", "falta");
+
+    if (indiceCotacoes)
+    {
+        if (!indiceCotacoes->buscarPreco(codigoNegociacao, data, precoCentavos))
+        {
+            faltasIndice.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "Erro: Papel ou data não encontrados no arquivo de dados históricos!" << std::endl;
+            return false;
+        }
+        acertosIndice.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (!CatalogoCotacoes::instancia().buscarPreco(codigoNegociacao, data, precoCentavos))
+    {
+        faltasCatalogo.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Erro: Papel ou data não encontrados no arquivo de dados históricos!" << std::endl;
+        return false;
+    }
+
+    acertosCatalogo.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
 /**
  * @brief Inicializa o sistema de banco de dados
  * @return true se a inicialização foi bem-sucedida, false caso contrário
@@ -52,13 +135,13 @@ ControladoraServico::~ControladoraServico()
  */
 bool ControladoraServico::inicializar()
 {
-    if (!dbManager->conectar())
+    if (!repositorio->conectar())
     {
         std::cerr << "Erro: Não foi possível conectar ao banco de dados!" << std::endl;
         return false;
     }
 
-    if (!dbManager->inicializarBanco())
+    if (!repositorio->inicializarBanco())
     {
         std::cerr << "Erro: Não foi possível inicializar o banco de dados!" << std::endl;
         return false;
@@ -67,6 +150,27 @@ bool ControladoraServico::inicializar()
     return true;
 }
 
+/**
+ * @brief Define o índice em memória de cotações
+ * @param indice Índice carregado, compartilhado entre controladoras
+ */
+void ControladoraServico::setIndiceCotacoes(std::shared_ptr<const IndiceCotacoes> indice)
+{
+    indiceCotacoes = std::move(indice);
+}
+
+/**
+ * @brief Obtém as estatísticas do repositório
+ * @param formatoJson true para JSON, false para texto legível
+ * @return string com as estatísticas no formato pedido
+ * @see IRepositorio::obterEstatisticas()
+ * @see IRepositorio::obterEstatisticasJson()
+ */
+std::string ControladoraServico::obterEstatisticasBanco(bool formatoJson)
+{
+    return formatoJson ? repositorio->obterEstatisticasJson() : repositorio->obterEstatisticas();
+}
+
 /**
  * @brief Autentica um usuário no sistema
  * @param cpf CPF do usuário para autenticação
@@ -78,12 +182,15 @@ bool ControladoraServico::inicializar()
  */
 bool ControladoraServico::autenticar(const Ncpf &cpf, const Senha &senha)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("autenticar");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->autenticarUsuario(cpf, senha);
+    return repositorio->autenticarUsuario(cpf, senha);
 }
 
 /**
@@ -97,19 +204,22 @@ bool ControladoraServico::autenticar(const Ncpf &cpf, const Senha &senha)
  */
 bool ControladoraServico::cadastrarConta(const Conta &conta)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("cadastrarConta");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
     Conta contaExistente;
-    if (dbManager->buscarConta(conta.getNcpf(), &contaExistente))
+    if (repositorio->buscarConta(conta.getNcpf(), &contaExistente))
     {
-        std::cout << "Erro: Conta com este CPF já existe!" << std::endl;
+        std::cerr << "Erro: Conta com este CPF já existe!" << std::endl;
         return false;
     }
 
-    return dbManager->inserirConta(conta);
+    return repositorio->inserirConta(conta);
 }
 
 /**
@@ -126,18 +236,21 @@ bool ControladoraServico::cadastrarConta(const Conta &conta)
  */
 bool ControladoraServico::consultarConta(const Ncpf &cpf, Conta *conta, Dinheiro *saldo)
 {
-    if (!dbManager->estaConectado() || !conta || !saldo)
+    static HistogramaLatencia &latencia = latenciaServico("consultarConta");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado() || !conta || !saldo)
     {
         return false;
     }
 
-    if (!dbManager->buscarConta(cpf, conta))
+    if (!repositorio->buscarConta(cpf, conta))
     {
         return false;
     }
 
     std::list<Carteira> carteiras;
-    if (!dbManager->listarCarteiras(cpf, &carteiras))
+    if (!repositorio->listarCarteiras(cpf, &carteiras))
     {
         try
         {
@@ -155,7 +268,7 @@ bool ControladoraServico::consultarConta(const Ncpf &cpf, Conta *conta, Dinheiro
     for (const auto &carteira : carteiras)
     {
         Dinheiro saldoCarteira;
-        if (dbManager->calcularSaldoCarteira(carteira.getCodigo(), &saldoCarteira))
+        if (repositorio->calcularSaldoCarteira(carteira.getCodigo(), &saldoCarteira))
         {
             try
             {
@@ -189,12 +302,15 @@ bool ControladoraServico::consultarConta(const Ncpf &cpf, Conta *conta, Dinheiro
  */
 bool ControladoraServico::editarConta(const Conta &conta)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("editarConta");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->atualizarConta(conta);
+    return repositorio->atualizarConta(conta);
 }
 
 /**
@@ -207,12 +323,15 @@ bool ControladoraServico::editarConta(const Conta &conta)
  */
 bool ControladoraServico::excluirConta(const Ncpf &cpf)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("excluirConta");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->excluirConta(cpf);
+    return repositorio->excluirConta(cpf);
 }
 
 /**
@@ -228,26 +347,29 @@ bool ControladoraServico::excluirConta(const Ncpf &cpf)
  */
 bool ControladoraServico::criarCarteira(const Ncpf &cpf, const Carteira &carteira)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("criarCarteira");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
     Conta conta;
-    if (!dbManager->buscarConta(cpf, &conta))
+    if (!repositorio->buscarConta(cpf, &conta))
     {
-        std::cout << "Erro: Conta não encontrada!" << std::endl;
+        std::cerr << "Erro: Conta não encontrada!" << std::endl;
         return false;
     }
 
     Carteira carteiraExistente;
-    if (dbManager->buscarCarteira(carteira.getCodigo(), &carteiraExistente))
+    if (repositorio->buscarCarteira(carteira.getCodigo(), &carteiraExistente))
     {
-        std::cout << "Erro: Já existe uma carteira com este código!" << std::endl;
+        std::cerr << "Erro: Já existe uma carteira com este código!" << std::endl;
         return false;
     }
 
-    return dbManager->inserirCarteira(carteira, cpf);
+    return repositorio->inserirCarteira(carteira, cpf);
 }
 
 /**
@@ -260,12 +382,15 @@ bool ControladoraServico::criarCarteira(const Ncpf &cpf, const Carteira &carteir
  */
 bool ControladoraServico::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras)
 {
-    if (!dbManager->estaConectado() || !listaCarteiras)
+    static HistogramaLatencia &latencia = latenciaServico("listarCarteiras");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado() || !listaCarteiras)
     {
         return false;
     }
 
-    return dbManager->listarCarteiras(cpf, listaCarteiras);
+    return repositorio->listarCarteiras(cpf, listaCarteiras);
 }
 
 /**
@@ -280,17 +405,20 @@ bool ControladoraServico::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *
  */
 bool ControladoraServico::consultarCarteira(const Codigo &codigo, Carteira *carteira, Dinheiro *saldo)
 {
-    if (!dbManager->estaConectado() || !carteira || !saldo)
+    static HistogramaLatencia &latencia = latenciaServico("consultarCarteira");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado() || !carteira || !saldo)
     {
         return false;
     }
 
-    if (!dbManager->buscarCarteira(codigo, carteira))
+    if (!repositorio->buscarCarteira(codigo, carteira))
     {
         return false;
     }
 
-    return dbManager->calcularSaldoCarteira(codigo, saldo);
+    return repositorio->calcularSaldoCarteira(codigo, saldo);
 }
 
 /**
@@ -302,12 +430,15 @@ bool ControladoraServico::consultarCarteira(const Codigo &codigo, Carteira *cart
  */
 bool ControladoraServico::editarCarteira(const Carteira &carteira)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("editarCarteira");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->atualizarCarteira(carteira);
+    return repositorio->atualizarCarteira(carteira);
 }
 
 /**
@@ -320,12 +451,15 @@ bool ControladoraServico::editarCarteira(const Carteira &carteira)
  */
 bool ControladoraServico::excluirCarteira(const Codigo &codigo)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("excluirCarteira");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->excluirCarteira(codigo);
+    return repositorio->excluirCarteira(codigo);
 }
 
 /**
@@ -346,120 +480,64 @@ bool ControladoraServico::excluirCarteira(const Codigo &codigo)
  */
 bool ControladoraServico::criarOrdem(const Codigo &codigoCarteira, const Ordem &ordem)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("criarOrdem");
+    MedidorLatencia medidor(latencia);
+    SpanRastreamento span("ControladoraServico::criarOrdem", "servico");
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
     Carteira carteira;
-    if (!dbManager->buscarCarteira(codigoCarteira, &carteira))
+    if (!repositorio->buscarCarteira(codigoCarteira, &carteira))
     {
-        std::cout << "Erro: Carteira não encontrada!" << std::endl;
+        std::cerr << "Erro: Carteira não encontrada!" << std::endl;
         return false;
     }
 
     Ordem ordemExistente;
-    if (dbManager->buscarOrdem(ordem.getCodigo(), &ordemExistente))
-    {
-        std::cout << "Erro: Já existe uma ordem com este código!" << std::endl;
-        return false;
-    }
-
-    std::ifstream arquivo("../data/DADOS_HISTORICOS.txt");
-    if (!arquivo.is_open())
+    if (repositorio->buscarOrdem(ordem.getCodigo(), &ordemExistente))
     {
-        std::cout << "Erro: Não foi possível abrir o arquivo ../data/DADOS_HISTORICOS.txt!" << std::endl;
+        std::cerr << "Erro: Já existe uma ordem com este código!" << std::endl;
         return false;
     }
 
-    std::string linha;
-    double precoMedioArquivo = 0.0;
-    bool encontrouPapel = false;
-
     std::string codigoNegociacao = trim(ordem.getCodigoNeg().getValor());
     std::string dataNegociacao = trim(ordem.getData().getValor());
 
-    while (std::getline(arquivo, linha))
-    {
-        if (linha.length() < 126)
-        {
-            continue;
-        }
-
-        std::string dataArquivo = trim(linha.substr(2, 8));
-        std::string codigoPapelArquivo = trim(linha.substr(12, 12));
-
-        if (codigoPapelArquivo == codigoNegociacao && dataArquivo == dataNegociacao)
-        {
-            try
-            {
-                std::string precoStr = linha.substr(113, 13);
-                precoMedioArquivo = std::stod(precoStr) / 100.0;
-                encontrouPapel = true;
-                break;
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Erro ao converter preco da linha: " << linha << std::endl;
-                encontrouPapel = false;
-                break;
-            }
-        }
-    }
-    arquivo.close();
-
-    if (!encontrouPapel)
+    long long precoCentavos = 0;
+    if (!buscarPrecoHistorico(codigoNegociacao, dataNegociacao, &precoCentavos))
     {
-        std::cout << "Erro: Papel ou data não encontrados no arquivo de dados históricos!" << std::endl;
         return false;
     }
 
     try
     {
-        std::string quantidadeStr = ordem.getQuantidade().getValor();
-        std::string quantidadeLimpa;
-        for (char c : quantidadeStr)
-        {
-            if (c != '.')
-            {
-                quantidadeLimpa += c;
-            }
-        }
-        long long quantidade = std::stoll(quantidadeLimpa);
-
-        double precoFinal = precoMedioArquivo * quantidade;
-
-        std::ostringstream oss;
-        oss.precision(2);
-        oss << std::fixed << precoFinal;
-        std::string precoFinalStr = oss.str();
-
-        size_t ponto = precoFinalStr.find('.');
-        if (ponto != std::string::npos)
+        Ordem novaOrdem = ordem;
         {
-            precoFinalStr[ponto] = ',';
+            SpanRastreamento spanValor("ControladoraServico::calcularValorOrdem", "servico");
 
-            std::string parteInteira = precoFinalStr.substr(0, ponto);
-            std::string parteDecimal = precoFinalStr.substr(ponto);
+            long long quantidade = ordem.getQuantidade().getUnidades();
 
-            for (int i = parteInteira.length() - 3; i > 0; i -= 3)
+            long long precoFinalCentavos = precoCentavos * quantidade;
+            if (precoFinalCentavos <= 0)
             {
-                parteInteira.insert(i, ".");
+                throw std::invalid_argument("Preco historico zerado para o papel na data informada.");
             }
 
-            precoFinalStr = parteInteira + parteDecimal;
-        }
+            std::string precoFinalStr = DatabaseManager::centavosParaDinheiro(precoFinalCentavos);
 
-        Ordem novaOrdem = ordem;
-        Dinheiro precoFinalObj;
-        precoFinalObj.setValor(precoFinalStr);
-        novaOrdem.setDinheiro(precoFinalObj);
+            Dinheiro precoFinalObj;
+            precoFinalObj.setValor(precoFinalStr);
+            novaOrdem.setDinheiro(precoFinalObj);
+        }
 
-        return dbManager->inserirOrdem(novaOrdem, codigoCarteira);
+        return repositorio->inserirOrdem(novaOrdem, codigoCarteira);
     }
     catch (const std::exception &e)
     {
-        std::cout << "Erro no cálculo do preço: " << e.what() << std::endl;
+        std::cerr << "Erro no cálculo do preço: " << e.what() << std::endl;
         return false;
     }
 }
@@ -474,12 +552,15 @@ bool ControladoraServico::criarOrdem(const Codigo &codigoCarteira, const Ordem &
  */
 bool ControladoraServico::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens)
 {
-    if (!dbManager->estaConectado() || !listaOrdens)
+    static HistogramaLatencia &latencia = latenciaServico("listarOrdens");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado() || !listaOrdens)
     {
         return false;
     }
 
-    return dbManager->listarOrdens(codigoCarteira, listaOrdens);
+    return repositorio->listarOrdens(codigoCarteira, listaOrdens);
 }
 
 /**
@@ -491,10 +572,13 @@ bool ControladoraServico::listarOrdens(const Codigo &codigoCarteira, std::list<O
  */
 bool ControladoraServico::excluirOrdem(const Codigo &codigo)
 {
-    if (!dbManager->estaConectado())
+    static HistogramaLatencia &latencia = latenciaServico("excluirOrdem");
+    MedidorLatencia medidor(latencia);
+
+    if (!repositorio->estaConectado())
     {
         return false;
     }
 
-    return dbManager->excluirOrdem(codigo);
+    return repositorio->excluirOrdem(codigo);
 }
@@ -1,9 +1,11 @@
 #ifndef CONTROLADORASSERVICO_HPP_INCLUDED
 #define CONTROLADORASSERVICO_HPP_INCLUDED
 
+#include "IndiceCotacoes.hpp"
 #include "database/DatabaseManager.hpp"
 #include "interfaces.hpp"
 #include <memory>
+#include <string>
 
 /**
  * @class ControladoraServico
@@ -15,12 +17,25 @@
  * @see IServicoAutenticacao
  * @see IServicoUsuario
  * @see IServicoInvestimento
- * @see DatabaseManager
+ * @see IRepositorio
  */
 class ControladoraServico : public IServicoAutenticacao, public IServicoUsuario, public IServicoInvestimento
 {
   private:
-    std::unique_ptr<DatabaseManager> dbManager;
+    std::shared_ptr<IRepositorio> repositorio;
+    std::shared_ptr<const IndiceCotacoes> indiceCotacoes;
+
+    /**
+     * @brief Busca o preço histórico de um papel em uma data
+     * @param codigoNegociacao Código de negociação sem espaços finais
+     * @param dataNegociacao Data no formato AAAAMMDD
+     * @param precoCentavos Ponteiro para armazenar o preço em centavos
+     * @return true se a combinação foi encontrada, false caso contrário
+     * @details Usa o índice em memória quando configurado; caso contrário,
+     *          consulta o CatalogoCotacoes do processo.
+     */
+    bool buscarPrecoHistorico(const std::string &codigoNegociacao, const std::string &dataNegociacao,
+                              long long *precoCentavos);
 
   public:
     /**
@@ -30,6 +45,20 @@ class ControladoraServico : public IServicoAutenticacao, public IServicoUsuario,
      */
     ControladoraServico();
 
+    /**
+     * @brief Construtor com caminho de banco explícito
+     * @param caminhoBanco Caminho do arquivo SQLite a ser utilizado
+     * @details Usado pelos modos não interativos, que podem apontar para bancos de teste.
+     */
+    explicit ControladoraServico(const std::string &caminhoBanco);
+
+    /**
+     * @brief Construtor com repositório já criado
+     * @param repositorio Backend de persistência (SQLite, memória...), possivelmente compartilhado
+     * @details O repositório ainda precisa ser aberto por inicializar().
+     */
+    explicit ControladoraServico(std::shared_ptr<IRepositorio> repositorio);
+
     /**
      * @brief Destrutor da controladora de serviço
      * @details Destrutor padrão que garante limpeza automática dos recursos.
@@ -44,6 +73,22 @@ class ControladoraServico : public IServicoAutenticacao, public IServicoUsuario,
      */
     bool inicializar();
 
+    /**
+     * @brief Define o índice em memória usado para consultar cotações
+     * @param indice Índice já carregado, compartilhável entre controladoras
+     * @details Sem índice, as cotações vêm do CatalogoCotacoes do processo, que
+     *          carrega cada ano sob demanda.
+     */
+    void setIndiceCotacoes(std::shared_ptr<const IndiceCotacoes> indice);
+
+    /**
+     * @brief Obtém as estatísticas do banco de dados desta controladora
+     * @param formatoJson true para JSON, false para texto legível
+     * @return Estatísticas formatadas
+     * @see DatabaseManager::obterEstatisticas()
+     */
+    std::string obterEstatisticasBanco(bool formatoJson);
+
     /**
      * @brief Autentica um usuário no sistema
      * @param cpf CPF do usuário para autenticação
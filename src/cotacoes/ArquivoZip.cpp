@@ -0,0 +1,309 @@
+#include "ArquivoZip.hpp"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace
+{
+const uint32_t ASSINATURA_LOCAL = 0x04034b50;
+const uint32_t ASSINATURA_CENTRAL = 0x02014b50;
+const uint32_t ASSINATURA_FIM = 0x06054b50;
+const size_t TAMANHO_FIM = 22;
+const size_t TAMANHO_CENTRAL = 46;
+const size_t TAMANHO_LOCAL = 30;
+const size_t TAMANHO_LEITURA = 64 * 1024;
+
+uint16_t lerU16(const unsigned char *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t lerU32(const unsigned char *p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief Par de buffers trocados entre a thread de descompactação e a chamadora
+ */
+struct BuffersDuplos
+{
+    std::vector<char> dados[2];
+    size_t tamanho[2] = {0, 0};
+    bool cheio[2] = {false, false};
+    bool fim = false;
+    bool erro = false;
+    std::mutex mutex;
+    std::condition_variable condicao;
+};
+
+/**
+ * @brief Descompacta a entrada para os buffers, alternando entre eles
+ * @details Executada na thread de descompactação. Ao terminar, com ou sem
+ *          erro, marca fim para liberar a thread chamadora.
+ */
+void descompactar(std::ifstream &arquivo, const EntradaZip &entrada, BuffersDuplos &buffers)
+{
+    z_stream fluxo;
+    std::memset(&fluxo, 0, sizeof(fluxo));
+    bool deflate = entrada.metodo == 8;
+    bool sucesso = !deflate || inflateInit2(&fluxo, -MAX_WBITS) == Z_OK;
+
+    std::vector<unsigned char> compactado(TAMANHO_LEITURA);
+    uint64_t restante = entrada.tamanhoCompactado;
+    uLong crc = crc32(0L, Z_NULL, 0);
+    int atual = 0;
+    bool terminou = false;
+
+    while (sucesso && !terminou)
+    {
+        {
+            std::unique_lock<std::mutex> trava(buffers.mutex);
+            buffers.condicao.wait(trava, [&] { return !buffers.cheio[atual]; });
+        }
+
+        char *saida = buffers.dados[atual].data();
+        size_t capacidade = buffers.dados[atual].size();
+        size_t produzido = 0;
+
+        while (sucesso && !terminou && produzido < capacidade)
+        {
+            if (fluxo.avail_in == 0 && restante > 0)
+            {
+                size_t pedir = static_cast<size_t>(std::min<uint64_t>(restante, compactado.size()));
+                arquivo.read(reinterpret_cast<char *>(compactado.data()), static_cast<std::streamsize>(pedir));
+                if (static_cast<size_t>(arquivo.gcount()) != pedir)
+                {
+                    sucesso = false;
+                    break;
+                }
+                restante -= pedir;
+                fluxo.next_in = compactado.data();
+                fluxo.avail_in = static_cast<uInt>(pedir);
+            }
+
+            if (!deflate)
+            {
+                size_t copiar = std::min<size_t>(fluxo.avail_in, capacidade - produzido);
+                std::memcpy(saida + produzido, fluxo.next_in, copiar);
+                fluxo.next_in += copiar;
+                fluxo.avail_in -= static_cast<uInt>(copiar);
+                produzido += copiar;
+                terminou = restante == 0 && fluxo.avail_in == 0;
+                continue;
+            }
+
+            fluxo.next_out = reinterpret_cast<Bytef *>(saida + produzido);
+            fluxo.avail_out = static_cast<uInt>(capacidade - produzido);
+            int resultado = inflate(&fluxo, Z_NO_FLUSH);
+            produzido = capacidade - fluxo.avail_out;
+
+            if (resultado == Z_STREAM_END)
+            {
+                terminou = true;
+            }
+            else if (resultado != Z_OK && !(resultado == Z_BUF_ERROR && fluxo.avail_out == 0))
+            {
+                sucesso = false;
+            }
+            else if (fluxo.avail_in == 0 && restante == 0 && fluxo.avail_out > 0)
+            {
+                sucesso = false; // dados compactados acabaram antes do fim do fluxo
+            }
+        }
+
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(saida), static_cast<uInt>(produzido));
+
+        std::lock_guard<std::mutex> trava(buffers.mutex);
+        buffers.tamanho[atual] = produzido;
+        buffers.cheio[atual] = true;
+        buffers.condicao.notify_all();
+        atual = 1 - atual;
+    }
+
+    if (deflate)
+    {
+        inflateEnd(&fluxo);
+    }
+
+    std::lock_guard<std::mutex> trava(buffers.mutex);
+    buffers.erro = !sucesso || crc != entrada.crc;
+    buffers.fim = true;
+    buffers.condicao.notify_all();
+}
+} // namespace
+
+bool ArquivoZip::ehZip(const std::string &caminho)
+{
+    if (caminho.length() < 4)
+    {
+        return false;
+    }
+
+    std::string extensao = caminho.substr(caminho.length() - 4);
+    std::transform(extensao.begin(), extensao.end(), extensao.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extensao == ".zip";
+}
+
+/**
+ * @brief Localiza a primeira entrada de um arquivo ZIP
+ * @details Procura o registro de fim do diretório central nos últimos 64 KB do
+ *          arquivo (ele pode ser seguido por um comentário) e lê a primeira
+ *          entrada do diretório central, que traz tamanhos e CRC confiáveis
+ *          mesmo quando o cabeçalho local usa descritor de dados.
+ */
+bool ArquivoZip::primeiraEntrada(const std::string &caminho, EntradaZip *entrada)
+{
+    std::ifstream arquivo(caminho, std::ios::binary);
+    if (!arquivo.is_open() || !entrada)
+    {
+        return false;
+    }
+
+    arquivo.seekg(0, std::ios::end);
+    uint64_t tamanhoArquivo = static_cast<uint64_t>(arquivo.tellg());
+    size_t cauda = static_cast<size_t>(std::min<uint64_t>(tamanhoArquivo, TAMANHO_FIM + 0xFFFF));
+    std::vector<unsigned char> final(cauda);
+    arquivo.seekg(static_cast<std::streamoff>(tamanhoArquivo - cauda));
+    if (cauda < TAMANHO_FIM || !arquivo.read(reinterpret_cast<char *>(final.data()), static_cast<std::streamsize>(cauda)))
+    {
+        return false;
+    }
+
+    const unsigned char *fim = nullptr;
+    for (size_t i = cauda - TAMANHO_FIM + 1; i-- > 0;)
+    {
+        if (lerU32(&final[i]) == ASSINATURA_FIM)
+        {
+            fim = &final[i];
+            break;
+        }
+    }
+    if (!fim || lerU16(fim + 10) == 0 || lerU32(fim + 16) == 0xFFFFFFFF)
+    {
+        return false;
+    }
+
+    unsigned char central[TAMANHO_CENTRAL];
+    arquivo.seekg(static_cast<std::streamoff>(lerU32(fim + 16)));
+    if (!arquivo.read(reinterpret_cast<char *>(central), TAMANHO_CENTRAL) ||
+        lerU32(central) != ASSINATURA_CENTRAL || (lerU16(central + 8) & 0x0001))
+    {
+        return false;
+    }
+
+    entrada->metodo = lerU16(central + 10);
+    entrada->crc = lerU32(central + 16);
+    entrada->tamanhoCompactado = lerU32(central + 20);
+    entrada->tamanhoOriginal = lerU32(central + 24);
+    entrada->deslocamentoCabecalho = lerU32(central + 42);
+    entrada->nome.resize(lerU16(central + 28));
+    if (!entrada->nome.empty() && !arquivo.read(&entrada->nome[0], static_cast<std::streamsize>(entrada->nome.size())))
+    {
+        return false;
+    }
+
+    bool zip64 = entrada->tamanhoCompactado == 0xFFFFFFFF || entrada->tamanhoOriginal == 0xFFFFFFFF ||
+                 entrada->deslocamentoCabecalho == 0xFFFFFFFF;
+    return !zip64 && (entrada->metodo == 0 || entrada->metodo == 8);
+}
+
+/**
+ * @brief Descompacta a primeira entrada e entrega suas linhas
+ * @details A thread chamadora consome os buffers na mesma ordem em que foram
+ *          preenchidos. Uma linha que atravessa a fronteira entre dois buffers
+ *          é remontada em um acumulador; a última linha do arquivo é entregue
+ *          mesmo sem '\n'.
+ */
+bool ArquivoZip::lerLinhas(const std::string &caminho, const std::function<void(const std::string &)> &consumir)
+{
+    EntradaZip entrada;
+    if (!primeiraEntrada(caminho, &entrada))
+    {
+        std::cerr << "Erro: " << caminho << " não é um ZIP suportado!" << std::endl;
+        return false;
+    }
+
+    std::ifstream arquivo(caminho, std::ios::binary);
+    unsigned char local[TAMANHO_LOCAL];
+    arquivo.seekg(static_cast<std::streamoff>(entrada.deslocamentoCabecalho));
+    if (!arquivo.read(reinterpret_cast<char *>(local), TAMANHO_LOCAL) || lerU32(local) != ASSINATURA_LOCAL)
+    {
+        std::cerr << "Erro: cabeçalho local inválido em " << caminho << "!" << std::endl;
+        return false;
+    }
+    arquivo.seekg(lerU16(local + 26) + lerU16(local + 28), std::ios::cur);
+
+    BuffersDuplos buffers;
+    buffers.dados[0].resize(TAMANHO_BUFFER);
+    buffers.dados[1].resize(TAMANHO_BUFFER);
+    std::thread descompactacao(descompactar, std::ref(arquivo), std::cref(entrada), std::ref(buffers));
+
+    std::string acumulado;
+    std::string linha;
+    int atual = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> trava(buffers.mutex);
+            buffers.condicao.wait(trava, [&] { return buffers.cheio[atual] || buffers.fim; });
+            if (!buffers.cheio[atual])
+            {
+                break;
+            }
+        }
+
+        const char *inicio = buffers.dados[atual].data();
+        const char *limite = inicio + buffers.tamanho[atual];
+        while (inicio < limite)
+        {
+            const char *quebra = static_cast<const char *>(std::memchr(inicio, '\n', static_cast<size_t>(limite - inicio)));
+            if (!quebra)
+            {
+                acumulado.append(inicio, limite);
+                break;
+            }
+
+            if (acumulado.empty())
+            {
+                linha.assign(inicio, quebra);
+            }
+            else
+            {
+                acumulado.append(inicio, quebra);
+                linha.swap(acumulado);
+                acumulado.clear();
+            }
+            consumir(linha);
+            inicio = quebra + 1;
+        }
+
+        std::lock_guard<std::mutex> trava(buffers.mutex);
+        buffers.cheio[atual] = false;
+        buffers.condicao.notify_all();
+        atual = 1 - atual;
+    }
+
+    descompactacao.join();
+    if (buffers.erro)
+    {
+        std::cerr << "Erro: falha ao descompactar " << caminho << " (dados corrompidos ou CRC divergente)!"
+                  << std::endl;
+        return false;
+    }
+
+    if (!acumulado.empty())
+    {
+        consumir(acumulado);
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef ARQUIVOZIP_HPP_INCLUDED
+#define ARQUIVOZIP_HPP_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Entrada de um arquivo ZIP, lida do diretório central
+ */
+struct EntradaZip
+{
+    std::string nome;                ///< Nome da entrada dentro do ZIP
+    uint16_t metodo = 0;             ///< 0 (armazenado) ou 8 (deflate)
+    uint32_t crc = 0;                ///< CRC-32 do conteúdo descompactado
+    uint64_t tamanhoCompactado = 0;  ///< Bytes compactados
+    uint64_t tamanhoOriginal = 0;    ///< Bytes descompactados
+    uint64_t deslocamentoCabecalho = 0; ///< Posição do cabeçalho local no arquivo
+};
+
+/**
+ * @brief Leitura em fluxo de arquivos ZIP da B3 (ex.: COTAHIST_A2023.ZIP)
+ *
+ * @details Descompacta a primeira entrada do arquivo diretamente para o
+ * interpretador de linhas, sem gravar o texto em disco. Uma thread lê e
+ * descompacta (zlib) enquanto a thread chamadora separa e interpreta as linhas;
+ * as duas alternam entre dois buffers, de modo que a descompactação do próximo
+ * bloco acontece durante a interpretação do atual. O CRC-32 da entrada é
+ * conferido no final.
+ *
+ * Só o formato ZIP clássico é suportado (sem ZIP64 e sem criptografia), o que
+ * cobre os arquivos distribuídos pela B3.
+ */
+class ArquivoZip
+{
+  public:
+    /**
+     * @brief Tamanho de cada um dos dois buffers de texto descompactado
+     */
+    static const size_t TAMANHO_BUFFER = 1 << 20;
+
+    /**
+     * @brief Indica se o caminho tem extensão .zip (sem diferenciar maiúsculas)
+     */
+    static bool ehZip(const std::string &caminho);
+
+    /**
+     * @brief Localiza a primeira entrada de um arquivo ZIP
+     *
+     * @param caminho Caminho do arquivo ZIP
+     * @param entrada Estrutura onde a entrada é armazenada
+     * @return bool true se o arquivo é um ZIP válido com ao menos uma entrada
+     */
+    static bool primeiraEntrada(const std::string &caminho, EntradaZip *entrada);
+
+    /**
+     * @brief Descompacta a primeira entrada e entrega suas linhas
+     *
+     * @param caminho Caminho do arquivo ZIP
+     * @param consumir Chamada para cada linha, sem o '\n' final, na thread chamadora
+     * @return bool true se a entrada foi lida por inteiro e o CRC confere
+     */
+    static bool lerLinhas(const std::string &caminho, const std::function<void(const std::string &)> &consumir);
+};
+
+#endif // ARQUIVOZIP_HPP_INCLUDED
@@ -0,0 +1,387 @@
+#include "BuscaPapeis.hpp"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace
+{
+struct Candidato
+{
+    uint32_t papel;
+    TipoSugestao tipo;
+    unsigned distancia;
+};
+
+std::string normalizar(const std::string &texto)
+{
+    size_t inicio = texto.find_first_not_of(" \t\r\n");
+    size_t fim = texto.find_last_not_of(" \t\r\n");
+    if (inicio == std::string::npos)
+    {
+        return "";
+    }
+
+    std::string normalizado = texto.substr(inicio, fim - inicio + 1);
+    std::transform(normalizado.begin(), normalizado.end(), normalizado.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return normalizado;
+}
+
+// CODNEG tem 12 posições no COTAHIST
+const size_t TAMANHO_CODIGO = 12;
+
+unsigned limiteEdicoes(size_t tamanho)
+{
+    return tamanho <= 2 ? 0 : (tamanho <= 5 ? 1 : 2);
+}
+} // namespace
+
+void BuscaPapeis::adicionar(const std::string &codigoNegociacao, const std::string &nomeResumido, size_t pregoes)
+{
+    papeis.push_back(Papel{normalizar(codigoNegociacao), normalizar(nomeResumido), pregoes});
+}
+
+/**
+ * @brief Ordena os papéis, junta códigos repetidos e monta os índices
+ * @details Códigos repetidos vêm de anos diferentes do catálogo: os pregões
+ *          são somados e prevalece o primeiro nome não vazio.
+ */
+void BuscaPapeis::montar()
+{
+    std::stable_sort(papeis.begin(), papeis.end(),
+                     [](const Papel &a, const Papel &b) { return a.codigo < b.codigo; });
+
+    std::vector<Papel> unicos;
+    for (Papel &papel : papeis)
+    {
+        if (papel.codigo.empty())
+        {
+            continue;
+        }
+        if (!unicos.empty() && unicos.back().codigo == papel.codigo)
+        {
+            unicos.back().pregoes += papel.pregoes;
+            if (unicos.back().nome.empty())
+            {
+                unicos.back().nome = std::move(papel.nome);
+            }
+            continue;
+        }
+        unicos.push_back(std::move(papel));
+    }
+    papeis = std::move(unicos);
+
+    codigos.chaves.clear();
+    nomes.chaves.clear();
+    for (size_t i = 0; i < papeis.size(); i++)
+    {
+        codigos.chaves.emplace_back(papeis[i].codigo, static_cast<uint32_t>(i));
+        if (!papeis[i].nome.empty())
+        {
+            nomes.chaves.emplace_back(papeis[i].nome, static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(nomes.chaves.begin(), nomes.chaves.end());
+
+    montarTrie(&codigos);
+    montarTrie(&nomes);
+}
+
+/**
+ * @brief Ordem dos papéis dentro de um mesmo tipo e distância
+ * @details Código mais curto primeiro (o papel à vista antes de termo, opções
+ *          e fracionário), depois o mais negociado.
+ */
+bool BuscaPapeis::melhorPapel(uint32_t a, uint32_t b) const
+{
+    if (papeis[a].codigo.size() != papeis[b].codigo.size())
+    {
+        return papeis[a].codigo.size() < papeis[b].codigo.size();
+    }
+    if (papeis[a].pregoes != papeis[b].pregoes)
+    {
+        return papeis[a].pregoes > papeis[b].pregoes;
+    }
+    return a < b;
+}
+
+/**
+ * @brief Monta uma trie a partir das chaves ordenadas
+ * @details Os filhos de um nó são reservados juntos, antes de descer em
+ *          qualquer um deles, para que fiquem contíguos no vetor. Como as
+ *          chaves estão ordenadas, as de cada nó formam uma faixa. Os melhores
+ *          papéis são calculados de baixo para cima (filhos têm índice maior
+ *          que o pai), juntando as listas dos filhos às chaves que terminam no nó.
+ */
+void BuscaPapeis::montarTrie(Trie *trie) const
+{
+    const std::vector<std::pair<std::string, uint32_t>> &chaves = trie->chaves;
+    std::vector<No> &nos = trie->nos;
+    nos.clear();
+    trie->melhores.clear();
+    nos.push_back(No{0, 0, 0, static_cast<uint32_t>(chaves.size()), 0, 0, '\0'});
+
+    std::function<void(uint32_t, size_t)> montarFilhos = [&](uint32_t indice, size_t profundidade) {
+        uint32_t inicio = nos[indice].inicioFaixa;
+        uint32_t fim = nos[indice].fimFaixa;
+
+        // A chave que termina neste nó vem antes das que continuam
+        while (inicio < fim && chaves[inicio].first.size() == profundidade)
+        {
+            inicio++;
+        }
+
+        uint32_t primeiroFilho = static_cast<uint32_t>(nos.size());
+        for (uint32_t i = inicio; i < fim;)
+        {
+            char letra = chaves[i].first[profundidade];
+            uint32_t j = i;
+            while (j < fim && chaves[j].first[profundidade] == letra)
+            {
+                j++;
+            }
+            nos.push_back(No{0, 0, i, j, 0, 0, letra});
+            i = j;
+        }
+
+        uint32_t quantidade = static_cast<uint32_t>(nos.size()) - primeiroFilho;
+        nos[indice].primeiroFilho = primeiroFilho;
+        nos[indice].quantidadeFilhos = quantidade;
+        for (uint32_t filho = primeiroFilho; filho < primeiroFilho + quantidade; filho++)
+        {
+            montarFilhos(filho, profundidade + 1);
+        }
+    };
+
+    if (chaves.empty())
+    {
+        return;
+    }
+    montarFilhos(0, 0);
+
+    std::vector<uint32_t> juntos;
+    for (size_t indice = nos.size(); indice-- > 0;)
+    {
+        No &no = nos[indice];
+        juntos.clear();
+        uint32_t fimTerminais = no.quantidadeFilhos > 0 ? nos[no.primeiroFilho].inicioFaixa : no.fimFaixa;
+        for (uint32_t chave = no.inicioFaixa; chave < fimTerminais; chave++)
+        {
+            juntos.push_back(chaves[chave].second);
+        }
+        for (uint32_t filho = no.primeiroFilho; filho < no.primeiroFilho + no.quantidadeFilhos; filho++)
+        {
+            juntos.insert(juntos.end(), trie->melhores.begin() + nos[filho].inicioMelhores,
+                          trie->melhores.begin() + nos[filho].inicioMelhores + nos[filho].quantidadeMelhores);
+        }
+
+        size_t quantidade = std::min(juntos.size(), MAXIMO_PADRAO);
+        std::partial_sort(juntos.begin(), juntos.begin() + static_cast<std::ptrdiff_t>(quantidade), juntos.end(),
+                          [this](uint32_t a, uint32_t b) { return melhorPapel(a, b); });
+        no.inicioMelhores = static_cast<uint32_t>(trie->melhores.size());
+        no.quantidadeMelhores = static_cast<uint32_t>(quantidade);
+        trie->melhores.insert(trie->melhores.end(), juntos.begin(),
+                              juntos.begin() + static_cast<std::ptrdiff_t>(quantidade));
+    }
+}
+
+/**
+ * @brief Nó da trie que corresponde ao prefixo, ou UINT32_MAX se nenhuma chave começa por ele
+ */
+uint32_t BuscaPapeis::descer(const Trie &trie, const std::string &prefixo)
+{
+    if (trie.nos.empty())
+    {
+        return UINT32_MAX;
+    }
+
+    uint32_t no = 0;
+    for (size_t i = 0; i < prefixo.size() && no != UINT32_MAX; i++)
+    {
+        const No &atual = trie.nos[no];
+        uint32_t proximo = UINT32_MAX;
+        for (uint32_t filho = atual.primeiroFilho; filho < atual.primeiroFilho + atual.quantidadeFilhos; filho++)
+        {
+            if (trie.nos[filho].letra == prefixo[i])
+            {
+                proximo = filho;
+                break;
+            }
+        }
+        no = proximo;
+    }
+    return no;
+}
+
+bool BuscaPapeis::contem(const std::string &codigoNegociacao) const
+{
+    std::string codigo = normalizar(codigoNegociacao);
+    auto encontrado =
+        std::lower_bound(papeis.begin(), papeis.end(), codigo,
+                         [](const Papel &papel, const std::string &chave) { return papel.codigo < chave; });
+    return encontrado != papeis.end() && encontrado->codigo == codigo;
+}
+
+/**
+ * @brief Sugere papéis para um texto digitado
+ * @details Junta três buscas: prefixo do código e prefixo do nome (descida nas
+ *          tries) e código aproximado (percurso podado da trie de códigos).
+ *          Cada nó alcançado contribui só com seus melhores papéis, então o
+ *          custo não depende de quantos papéis têm o prefixo. Um papel
+ *          encontrado por mais de uma busca fica com o melhor tipo.
+ */
+std::vector<SugestaoPapel> BuscaPapeis::sugerir(const std::string &texto, size_t maximo) const
+{
+    std::vector<SugestaoPapel> sugestoes;
+    std::string consulta = normalizar(texto);
+    if (consulta.empty() || papeis.empty() || maximo == 0)
+    {
+        return sugestoes;
+    }
+
+    std::vector<Candidato> candidatos;
+
+    // Os melhores de um nó bastam para até MAXIMO_PADRAO sugestões; acima disso a faixa é expandida
+    auto coletar = [&](const Trie &trie, uint32_t indice, TipoSugestao tipo, unsigned distancia) {
+        const No &no = trie.nos[indice];
+        if (maximo <= MAXIMO_PADRAO || no.fimFaixa - no.inicioFaixa == no.quantidadeMelhores)
+        {
+            for (uint32_t i = no.inicioMelhores; i < no.inicioMelhores + no.quantidadeMelhores; i++)
+            {
+                candidatos.push_back(Candidato{trie.melhores[i], tipo, distancia});
+            }
+            return;
+        }
+        for (uint32_t chave = no.inicioFaixa; chave < no.fimFaixa; chave++)
+        {
+            candidatos.push_back(Candidato{trie.chaves[chave].second, tipo, distancia});
+        }
+    };
+
+    bool podeSerCodigo = consulta.size() <= TAMANHO_CODIGO && consulta.find(' ') == std::string::npos;
+    if (podeSerCodigo)
+    {
+        // Prefixo: a primeira chave da faixa é o próprio texto, se ele for um código
+        uint32_t no = descer(codigos, consulta);
+        if (no != UINT32_MAX)
+        {
+            const std::pair<std::string, uint32_t> &primeira = codigos.chaves[codigos.nos[no].inicioFaixa];
+            if (primeira.first == consulta)
+            {
+                candidatos.push_back(Candidato{primeira.second, SUGESTAO_EXATA, 0});
+            }
+            coletar(codigos, no, SUGESTAO_PREFIXO, 0);
+        }
+
+        // Aproximado: uma linha da distância por profundidade, reaproveitada entre irmãos. Só a faixa
+        // |j - profundidade| <= limite é calculada: fora dela a distância já passa do limite e vale teto.
+        unsigned limite = limiteEdicoes(consulta.size());
+        if (limite > 0)
+        {
+            const std::vector<No> &nos = codigos.nos;
+            size_t m = consulta.size();
+            unsigned teto = limite + 1;
+            unsigned linhas[TAMANHO_CODIGO + 2][TAMANHO_CODIGO + 1];
+            for (size_t j = 0; j <= m; j++)
+            {
+                linhas[0][j] = static_cast<unsigned>(j);
+            }
+
+            std::function<void(uint32_t, size_t, char)> percorrer = [&](uint32_t indice, size_t profundidade,
+                                                                       char letraPai) {
+                const No &pai = nos[indice];
+                size_t i = profundidade + 1;
+                size_t inicio = i > limite ? i - limite : 1;
+                size_t fim = std::min(m, i + limite);
+                for (uint32_t filho = pai.primeiroFilho; filho < pai.primeiroFilho + pai.quantidadeFilhos; filho++)
+                {
+                    char letra = nos[filho].letra;
+                    const unsigned *anterior = linhas[profundidade];
+                    unsigned *linha = linhas[profundidade + 1];
+                    linha[0] = static_cast<unsigned>(i);
+                    if (inicio > 1 && inicio - 1 <= m)
+                    {
+                        linha[inicio - 1] = teto;
+                    }
+                    unsigned menor = linha[0];
+                    for (size_t j = inicio; j <= fim; j++)
+                    {
+                        unsigned custo = consulta[j - 1] == letra ? 0 : 1;
+                        linha[j] = std::min({anterior[j] + 1, linha[j - 1] + 1, anterior[j - 1] + custo});
+                        if (profundidade >= 1 && j >= 2 && letra == consulta[j - 2] && letraPai == consulta[j - 1])
+                        {
+                            linha[j] = std::min(linha[j], linhas[profundidade - 1][j - 2] + 1);
+                        }
+                        menor = std::min(menor, linha[j]);
+                    }
+                    if (fim < m)
+                    {
+                        linha[fim + 1] = teto;
+                    }
+
+                    // Prefixo do código casou: os papéis do nó são candidatos com essa distância
+                    unsigned distancia = inicio <= m && fim == m ? linha[m] : teto;
+                    if (distancia <= limite && distancia > 0)
+                    {
+                        coletar(codigos, filho, SUGESTAO_APROXIMADA, distancia);
+                    }
+
+                    // Só desce se algum descendente ainda pode ficar dentro do limite e melhorar a distância
+                    bool podeMelhorar = distancia > limite ? menor <= limite : menor < distancia;
+                    if (podeMelhorar && profundidade + 2 < TAMANHO_CODIGO + 2)
+                    {
+                        percorrer(filho, profundidade + 1, letra);
+                    }
+                }
+            };
+            percorrer(0, 0, '\0');
+        }
+    }
+
+    // Nome resumido: papéis cujo nome começa pelo texto
+    uint32_t noNome = descer(nomes, consulta);
+    if (noNome != UINT32_MAX)
+    {
+        coletar(nomes, noNome, SUGESTAO_NOME, 0);
+    }
+
+    // Melhor ocorrência de cada papel, depois ordenação por relevância
+    std::sort(candidatos.begin(), candidatos.end(), [](const Candidato &a, const Candidato &b) {
+        if (a.papel != b.papel)
+        {
+            return a.papel < b.papel;
+        }
+        return a.tipo != b.tipo ? a.tipo < b.tipo : a.distancia < b.distancia;
+    });
+    candidatos.erase(std::unique(candidatos.begin(), candidatos.end(),
+                                 [](const Candidato &a, const Candidato &b) { return a.papel == b.papel; }),
+                     candidatos.end());
+
+    auto relevancia = [this](const Candidato &a, const Candidato &b) {
+        if (a.tipo != b.tipo)
+        {
+            return a.tipo < b.tipo;
+        }
+        if (a.distancia != b.distancia)
+        {
+            return a.distancia < b.distancia;
+        }
+        return melhorPapel(a.papel, b.papel);
+    };
+    size_t quantidade = std::min(maximo, candidatos.size());
+    std::partial_sort(candidatos.begin(), candidatos.begin() + static_cast<std::ptrdiff_t>(quantidade),
+                      candidatos.end(), relevancia);
+
+    for (size_t i = 0; i < quantidade; i++)
+    {
+        const Papel &papel = papeis[candidatos[i].papel];
+        SugestaoPapel sugestao;
+        sugestao.codigoNegociacao = papel.codigo;
+        sugestao.nomeResumido = papel.nome;
+        sugestao.tipo = candidatos[i].tipo;
+        sugestao.distancia = candidatos[i].distancia;
+        sugestao.pregoes = papel.pregoes;
+        sugestoes.push_back(std::move(sugestao));
+    }
+    return sugestoes;
+}
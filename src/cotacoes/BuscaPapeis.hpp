@@ -0,0 +1,133 @@
+#ifndef BUSCAPAPEIS_HPP_INCLUDED
+#define BUSCAPAPEIS_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Como uma sugestão casou com o texto digitado, da melhor para a pior
+ */
+enum TipoSugestao
+{
+    SUGESTAO_EXATA,      ///< O código é o texto digitado
+    SUGESTAO_PREFIXO,    ///< O código começa pelo texto digitado
+    SUGESTAO_NOME,       ///< O nome resumido da empresa começa pelo texto digitado
+    SUGESTAO_APROXIMADA, ///< Algum prefixo do código está a poucas edições do texto digitado
+};
+
+/**
+ * @brief Papel sugerido para um texto digitado
+ */
+struct SugestaoPapel
+{
+    std::string codigoNegociacao;
+    std::string nomeResumido;
+    TipoSugestao tipo = SUGESTAO_EXATA;
+    unsigned distancia = 0; ///< Edições (troca, inserção, remoção ou transposição); 0 exceto em SUGESTAO_APROXIMADA
+    size_t pregoes = 0;     ///< Datas com cotação do papel nos dados carregados, usadas para desempate
+};
+
+/**
+ * @brief Índice de busca de papéis por código (CODNEG) e nome resumido (NOMRES)
+ *
+ * @details Feito para completar o código enquanto o operador digita e para
+ * sugerir o código certo quando ele erra, sem varrer os dados históricos.
+ *
+ * Códigos e nomes ficam em duas tries compactas (nós em um vetor, filhos
+ * contíguos); cada nó guarda a faixa das chaves com aquele prefixo na lista
+ * ordenada e, calculados na montagem, os MAXIMO_PADRAO melhores papéis da
+ * faixa. Assim um prefixo curto como "PE", que cobre milhares de opções, não
+ * é expandido na consulta. Completar por prefixo é descer na trie; a busca
+ * aproximada percorre a trie de códigos calculando uma linha da distância de
+ * Damerau-Levenshtein (com transposição de vizinhos) por nó e poda os ramos
+ * em que toda a linha passa do limite. O limite cresce com o tamanho do
+ * texto: 0 até 2 caracteres, 1 até 5 e 2 acima.
+ *
+ * As sugestões são ordenadas por tipo, distância, tamanho do código (o papel
+ * à vista antes de termo, opções e fracionário) e quantidade de pregões
+ * (papéis mais negociados primeiro). Depois de montado, o índice é somente
+ * leitura e pode ser consultado por várias threads.
+ */
+class BuscaPapeis
+{
+  private:
+    struct Papel
+    {
+        std::string codigo;
+        std::string nome;
+        size_t pregoes;
+    };
+
+    struct No
+    {
+        uint32_t primeiroFilho;
+        uint32_t quantidadeFilhos;
+        uint32_t inicioFaixa;       ///< Primeira chave com o prefixo do nó
+        uint32_t fimFaixa;          ///< Um depois da última chave com o prefixo do nó
+        uint32_t inicioMelhores;    ///< Posição dos melhores papéis da faixa em Trie::melhores
+        uint32_t quantidadeMelhores;
+        char letra;
+    };
+
+    struct Trie
+    {
+        std::vector<std::pair<std::string, uint32_t>> chaves; ///< (chave, papel), ordenadas pela chave
+        std::vector<No> nos;                                  ///< nos[0] é a raiz
+        std::vector<uint32_t> melhores;                       ///< Listas de melhores papéis dos nós
+    };
+
+    std::vector<Papel> papeis; ///< Ordenados por código
+    Trie codigos;
+    Trie nomes;
+
+    void montarTrie(Trie *trie) const;
+    bool melhorPapel(uint32_t a, uint32_t b) const;
+    static uint32_t descer(const Trie &trie, const std::string &prefixo);
+
+  public:
+    /**
+     * @brief Quantidade de sugestões devolvida quando o chamador não informa outra
+     */
+    static constexpr size_t MAXIMO_PADRAO = 8;
+
+    /**
+     * @brief Acrescenta um papel antes de montar()
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param nomeResumido Nome resumido da empresa (pode ser vazio)
+     * @param pregoes Quantidade de datas com cotação do papel
+     * @details Um código repetido soma os pregões e mantém o primeiro nome não vazio.
+     */
+    void adicionar(const std::string &codigoNegociacao, const std::string &nomeResumido, size_t pregoes);
+
+    /**
+     * @brief Ordena os papéis acrescentados e monta a trie e a lista de nomes
+     */
+    void montar();
+
+    /**
+     * @brief Sugere papéis para um texto digitado
+     *
+     * @param texto Código ou nome, completo ou parcial (maiúsculas e minúsculas são equivalentes)
+     * @param maximo Quantidade máxima de sugestões
+     * @return std::vector<SugestaoPapel> Sugestões, da melhor para a pior, sem papéis repetidos
+     */
+    std::vector<SugestaoPapel> sugerir(const std::string &texto, size_t maximo = MAXIMO_PADRAO) const;
+
+    /**
+     * @brief Verifica se o código existe exatamente
+     */
+    bool contem(const std::string &codigoNegociacao) const;
+
+    /**
+     * @brief Quantidade de papéis no índice
+     */
+    size_t quantidadePapeis() const
+    {
+        return papeis.size();
+    }
+};
+
+#endif // BUSCAPAPEIS_HPP_INCLUDED
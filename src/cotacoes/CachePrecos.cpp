@@ -0,0 +1,177 @@
+#include "CachePrecos.hpp"
+#include "ImpressaoArquivo.hpp"
+#include "LeitorCotahist.hpp"
+#include "RegistroMetricas.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+std::atomic<uint64_t> &contadorCache(const char *resultado)
+{
+    return RegistroMetricas::instancia().contador("investimentos_cotacoes_cache_total",
+                                                  std::string("resultado=\"") + resultado + "\"",
+                                                  "Consultas ao cache de preços do modo arquivo.");
+}
+} // namespace
+
+bool CachePrecos::Chave::operator==(const Chave &outra) const
+{
+    return data == outra.data && std::memcmp(codigo, outra.codigo, sizeof(codigo)) == 0;
+}
+
+/**
+ * @brief FNV-1a de 64 bits sobre o código e a data
+ */
+uint64_t CachePrecos::somarChave(const Chave &chave)
+{
+    uint64_t hash = ImpressaoArquivo::somarFnv(chave.codigo, sizeof(chave.codigo));
+    return ImpressaoArquivo::somarFnv(&chave.data, sizeof(chave.data), hash);
+}
+
+size_t CachePrecos::HashChave::operator()(const Chave &chave) const
+{
+    return static_cast<size_t>(somarChave(chave));
+}
+
+/**
+ * @brief Fatia de uma chave, pelos 32 bits altos do hash
+ * @details Os bits baixos escolhem o balde dentro do unordered_map da fatia;
+ *          usar os altos aqui evita que todas as chaves de uma fatia caiam nos
+ *          mesmos baldes. O hash é sempre de 64 bits, também onde size_t tem 32.
+ */
+CachePrecos::Fatia &CachePrecos::fatiaDe(const Chave &chave)
+{
+    return fatias[static_cast<size_t>((somarChave(chave) >> 32) % QUANTIDADE_FATIAS)];
+}
+
+CachePrecos::CachePrecos(size_t capacidade)
+    : fatias(new Fatia[QUANTIDADE_FATIAS]), capacidade(0), acertos(0), faltas(0), descartes(0)
+{
+    size_t porFatia = std::max<size_t>(1, capacidade / QUANTIDADE_FATIAS);
+    for (size_t i = 0; i < QUANTIDADE_FATIAS; i++)
+    {
+        fatias[i].limite = porFatia;
+        fatias[i].entradas.reserve(porFatia);
+        fatias[i].posicoes.reserve(porFatia);
+    }
+    this->capacidade = porFatia * QUANTIDADE_FATIAS;
+}
+
+bool CachePrecos::montarChave(const std::string &codigoNegociacao, uint32_t data, Chave *chave)
+{
+    std::string codigo = LeitorCotahist::limparCampo(codigoNegociacao);
+    if (codigo.empty() || codigo.size() > sizeof(chave->codigo))
+    {
+        return false;
+    }
+
+    std::memset(chave->codigo, 0, sizeof(chave->codigo));
+    std::memcpy(chave->codigo, codigo.data(), codigo.size());
+    chave->data = data;
+    return true;
+}
+
+bool CachePrecos::consultar(const std::string &codigoNegociacao, uint32_t data, bool *encontrado,
+                            long long *precoCentavos)
+{
+    static std::atomic<uint64_t> &acertosGlobais = contadorCache("acerto");
+    static std::atomic<uint64_t> &faltasGlobais = contadorCache("falta");
+
+    Chave chave;
+    if (!encontrado || !montarChave(codigoNegociacao, data, &chave))
+    {
+        return false;
+    }
+
+    Fatia &fatia = fatiaDe(chave);
+    {
+        std::lock_guard<std::mutex> trava(fatia.trava);
+        auto it = fatia.posicoes.find(chave);
+        if (it != fatia.posicoes.end())
+        {
+            Entrada &entrada = fatia.entradas[it->second];
+            entrada.referenciada = true;
+            *encontrado = entrada.encontrado;
+            if (entrada.encontrado && precoCentavos)
+            {
+                *precoCentavos = entrada.precoCentavos;
+            }
+            acertos.fetch_add(1, std::memory_order_relaxed);
+            acertosGlobais.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    faltas.fetch_add(1, std::memory_order_relaxed);
+    faltasGlobais.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Guarda uma combinação, descartando pelo CLOCK se a fatia está cheia
+ * @details Entradas novas começam sem referência: uma combinação consultada
+ *          uma única vez é a primeira a sair, e só as que voltam a ser
+ *          consultadas ganham a segunda chance.
+ */
+void CachePrecos::guardar(const std::string &codigoNegociacao, uint32_t data, bool encontrado,
+                          long long precoCentavos)
+{
+    static std::atomic<uint64_t> &descartesGlobais = RegistroMetricas::instancia().contador(
+        "investimentos_cotacoes_cache_descartes_total", "", "Entradas descartadas do cache de preços do modo arquivo.");
+
+    Chave chave;
+    if (!montarChave(codigoNegociacao, data, &chave))
+    {
+        return;
+    }
+
+    Fatia &fatia = fatiaDe(chave);
+    std::lock_guard<std::mutex> trava(fatia.trava);
+
+    Entrada nova = {chave, encontrado ? precoCentavos : 0, encontrado, false};
+    auto it = fatia.posicoes.find(chave);
+    if (it != fatia.posicoes.end())
+    {
+        nova.referenciada = fatia.entradas[it->second].referenciada;
+        fatia.entradas[it->second] = nova;
+        return;
+    }
+
+    if (fatia.entradas.size() < fatia.limite)
+    {
+        fatia.posicoes.emplace(chave, static_cast<uint32_t>(fatia.entradas.size()));
+        fatia.entradas.push_back(nova);
+        return;
+    }
+
+    // Segunda chance: limpa as marcas até achar uma entrada não referenciada
+    while (fatia.entradas[fatia.ponteiro].referenciada)
+    {
+        fatia.entradas[fatia.ponteiro].referenciada = false;
+        fatia.ponteiro = (fatia.ponteiro + 1) % fatia.entradas.size();
+    }
+
+    size_t posicao = fatia.ponteiro;
+    fatia.posicoes.erase(fatia.entradas[posicao].chave);
+    fatia.entradas[posicao] = nova;
+    fatia.posicoes.emplace(chave, static_cast<uint32_t>(posicao));
+    fatia.ponteiro = (posicao + 1) % fatia.entradas.size();
+    descartes.fetch_add(1, std::memory_order_relaxed);
+    descartesGlobais.fetch_add(1, std::memory_order_relaxed);
+}
+
+EstatisticasCachePrecos CachePrecos::obterEstatisticas() const
+{
+    EstatisticasCachePrecos estatisticas;
+    estatisticas.acertos = acertos.load(std::memory_order_relaxed);
+    estatisticas.faltas = faltas.load(std::memory_order_relaxed);
+    estatisticas.descartes = descartes.load(std::memory_order_relaxed);
+    estatisticas.capacidade = capacidade;
+    for (size_t i = 0; i < QUANTIDADE_FATIAS; i++)
+    {
+        std::lock_guard<std::mutex> trava(fatias[i].trava);
+        estatisticas.ocupacao += fatias[i].entradas.size();
+    }
+    return estatisticas;
+}
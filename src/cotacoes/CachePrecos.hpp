@@ -0,0 +1,146 @@
+#ifndef CACHEPRECOS_HPP_INCLUDED
+#define CACHEPRECOS_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Contadores de um CachePrecos
+ */
+struct EstatisticasCachePrecos
+{
+    uint64_t acertos = 0;
+    uint64_t faltas = 0;
+    uint64_t descartes = 0; ///< Entradas substituídas pelo CLOCK por falta de espaço
+    size_t ocupacao = 0;    ///< Entradas guardadas no momento
+    size_t capacidade = 0;
+
+    /**
+     * @brief Fração das consultas respondidas pelo cache, de 0 a 1
+     */
+    double taxaAcerto() const
+    {
+        uint64_t total = acertos + faltas;
+        return total == 0 ? 0.0 : static_cast<double>(acertos) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @brief Cache limitado de (papel, data) → preço médio, seguro entre threads
+ *
+ * @details Fica na frente do índice de deslocamentos (--indice-arquivo), em
+ * que cada preço custa um pread no arquivo original. Operadores costumam criar
+ * ordens para poucos papéis e datas seguidos, e a mesma combinação é
+ * consultada pela validação e pelo cálculo do valor da ordem.
+ *
+ * As entradas são divididas em QUANTIDADE_FATIAS fatias pelo hash da chave,
+ * cada uma com sua trava, para que threads do servidor não disputem uma trava
+ * única. Dentro da fatia, a substituição é CLOCK (segunda chance): um acerto
+ * só marca o bit de referência da entrada, e o ponteiro do relógio descarta a
+ * primeira entrada não referenciada, limpando as marcas por onde passa. É uma
+ * aproximação de LRU sem lista encadeada para reordenar a cada acerto.
+ *
+ * Combinações inexistentes também são guardadas, para que a mesma digitação
+ * errada repetida não volte ao arquivo; por isso o catálogo troca o cache por
+ * um vazio a cada nova versão dos dados. Acertos, faltas e descartes são
+ * contados aqui e na família investimentos_cotacoes_cache_total do
+ * RegistroMetricas.
+ */
+class CachePrecos
+{
+  private:
+    struct Chave
+    {
+        char codigo[12];
+        uint32_t data;
+
+        bool operator==(const Chave &outra) const;
+    };
+
+    struct HashChave
+    {
+        size_t operator()(const Chave &chave) const;
+    };
+
+    struct Entrada
+    {
+        Chave chave;
+        long long precoCentavos;
+        bool encontrado;
+        bool referenciada;
+    };
+
+    struct Fatia
+    {
+        std::mutex trava;
+        std::unordered_map<Chave, uint32_t, HashChave> posicoes;
+        std::vector<Entrada> entradas;
+        size_t limite = 0;
+        size_t ponteiro = 0;
+    };
+
+    std::unique_ptr<Fatia[]> fatias;
+    size_t capacidade;
+    std::atomic<uint64_t> acertos;
+    std::atomic<uint64_t> faltas;
+    std::atomic<uint64_t> descartes;
+
+    static bool montarChave(const std::string &codigoNegociacao, uint32_t data, Chave *chave);
+    static uint64_t somarChave(const Chave &chave);
+    Fatia &fatiaDe(const Chave &chave);
+
+  public:
+    /**
+     * @brief Entradas guardadas quando a capacidade não é informada
+     */
+    static const size_t CAPACIDADE_PADRAO = 65536;
+
+    /**
+     * @brief Quantidade de fatias independentes, cada uma com sua trava
+     */
+    static const size_t QUANTIDADE_FATIAS = 16;
+
+    /**
+     * @brief Cria um cache vazio
+     *
+     * @param capacidade Total de entradas, dividido igualmente entre as fatias (no mínimo uma por fatia)
+     */
+    explicit CachePrecos(size_t capacidade = CAPACIDADE_PADRAO);
+
+    CachePrecos(const CachePrecos &) = delete;
+    CachePrecos &operator=(const CachePrecos &) = delete;
+
+    /**
+     * @brief Consulta uma combinação
+     *
+     * @param codigoNegociacao Código de negociação sem espaços finais
+     * @param data Data no formato AAAAMMDD
+     * @param encontrado Ponteiro para indicar se a combinação existe nos dados
+     * @param precoCentavos Ponteiro para o preço, preenchido se a combinação existe (opcional)
+     * @return bool true se a combinação está no cache (acerto)
+     */
+    bool consultar(const std::string &codigoNegociacao, uint32_t data, bool *encontrado, long long *precoCentavos);
+
+    /**
+     * @brief Guarda o resultado de uma busca no arquivo
+     *
+     * @param codigoNegociacao Código de negociação sem espaços finais
+     * @param data Data no formato AAAAMMDD
+     * @param encontrado Se a combinação existe nos dados
+     * @param precoCentavos Preço em centavos (ignorado se não encontrado)
+     */
+    void guardar(const std::string &codigoNegociacao, uint32_t data, bool encontrado, long long precoCentavos);
+
+    /**
+     * @brief Contadores e ocupação atuais
+     */
+    EstatisticasCachePrecos obterEstatisticas() const;
+};
+
+#endif // CACHEPRECOS_HPP_INCLUDED
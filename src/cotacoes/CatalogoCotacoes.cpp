@@ -0,0 +1,976 @@
+#include "CatalogoCotacoes.hpp"
+#include "ArquivoZip.hpp"
+#include "CheckpointCotahist.hpp"
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <dirent.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const std::string CatalogoCotacoes::CAMINHO_PADRAO = "../data/DADOS_HISTORICOS.txt";
+
+CatalogoCotacoes::CatalogoCotacoes()
+    : particoes(std::make_shared<const MapaParticoes>()), capacidadeCachePrecos(CachePrecos::CAPACIDADE_PADRAO),
+      versaoCatalogo(0), versaoBusca(0), orcamentoMemoria(ORCAMENTO_PADRAO), memoriaCarregada(0), relogioAcesso(0),
+      aberto(false), fdInotify(-1), fdEvento(-1)
+{
+}
+
+CatalogoCotacoes::~CatalogoCotacoes()
+{
+    pararObservacao();
+}
+
+CatalogoCotacoes &CatalogoCotacoes::instancia()
+{
+    static CatalogoCotacoes catalogo;
+    static std::once_flag aberturaPadrao;
+    std::call_once(aberturaPadrao, [] { catalogo.abrir(CAMINHO_PADRAO); });
+    return catalogo;
+}
+
+/**
+ * @brief Lê uma quantidade fixa de dígitos
+ * @return true se todos os caracteres a partir de inicio são dígitos
+ */
+static bool lerDigitos(const std::string &texto, size_t inicio, size_t quantidade, uint32_t *valor)
+{
+    if (inicio + quantidade > texto.length())
+    {
+        return false;
+    }
+
+    *valor = 0;
+    for (size_t i = inicio; i < inicio + quantidade; i++)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(texto[i])))
+        {
+            return false;
+        }
+        *valor = *valor * 10 + static_cast<uint32_t>(texto[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta o nome de um arquivo da B3
+ * @details Padrões da série histórica da B3 (sem diferenciar maiúsculas), sem
+ *          extensão ou com .TXT/.ZIP:
+ *          - COTAHIST_A2023: ano inteiro
+ *          - COTAHIST_M012023: mês (MMAAAA)
+ *          - COTAHIST_D02012023: dia (DDMMAAAA)
+ */
+bool CatalogoCotacoes::interpretarNome(const std::string &nome, ArquivoCotahist *arquivo)
+{
+    std::string base = nome;
+    std::transform(base.begin(), base.end(), base.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    // Só .TXT, .ZIP ou nenhuma extensão; checkpoints (".TXT.ckpt") e temporários ficam de fora
+    size_t ponto = base.find('.');
+    std::string extensao = ponto == std::string::npos ? "" : base.substr(ponto);
+    base = base.substr(0, ponto);
+    if (!extensao.empty() && extensao != ".TXT" && extensao != ".ZIP")
+    {
+        return false;
+    }
+
+    const std::string PREFIXO = "COTAHIST_";
+    if (base.compare(0, PREFIXO.length(), PREFIXO) != 0 || base.length() <= PREFIXO.length() || !arquivo)
+    {
+        return false;
+    }
+
+    char tipo = base[PREFIXO.length()];
+    size_t inicio = PREFIXO.length() + 1;
+    size_t digitos = base.length() - inicio;
+    uint32_t dia = 0;
+    uint32_t mes = 0;
+    uint32_t ano = 0;
+
+    if (tipo == 'A' && digitos == 4 && lerDigitos(base, inicio, 4, &ano))
+    {
+        arquivo->dataInicial = ano * 10000 + 101;
+        arquivo->dataFinal = ano * 10000 + 1231;
+    }
+    else if (tipo == 'M' && digitos == 6 && lerDigitos(base, inicio, 2, &mes) && lerDigitos(base, inicio + 2, 4, &ano))
+    {
+        arquivo->dataInicial = ano * 10000 + mes * 100 + 1;
+        arquivo->dataFinal = ano * 10000 + mes * 100 + 31;
+    }
+    else if (tipo == 'D' && digitos == 8 && lerDigitos(base, inicio, 2, &dia) &&
+             lerDigitos(base, inicio + 2, 2, &mes) && lerDigitos(base, inicio + 4, 4, &ano))
+    {
+        arquivo->dataInicial = ano * 10000 + mes * 100 + dia;
+        arquivo->dataFinal = arquivo->dataInicial;
+    }
+    else
+    {
+        return false;
+    }
+
+    return ano > 0 && mes <= 12 && dia <= 31;
+}
+
+/**
+ * @brief Descobre os arquivos de um diretório ou registra um arquivo único
+ * @details Em um diretório, só entram os arquivos com nome no padrão COTAHIST.
+ *          Um arquivo passado diretamente entra mesmo fora do padrão, na
+ *          partição sem data. Os arquivos de um mesmo ano são lidos em ordem de
+ *          data inicial, então o arquivo anual tem precedência sobre os
+ *          mensais e diários daquele ano em registros repetidos. Arquivos .ZIP
+ *          são lidos compactados, a menos que a versão descompactada também esteja
+ *          no diretório.
+ */
+bool CatalogoCotacoes::abrir(const std::string &caminho)
+{
+    std::vector<ArquivoCotahist> encontrados;
+
+    struct stat informacoes;
+    if (stat(caminho.c_str(), &informacoes) == 0 && S_ISDIR(informacoes.st_mode))
+    {
+        DIR *diretorio = opendir(caminho.c_str());
+        if (diretorio)
+        {
+            while (dirent *entrada = readdir(diretorio))
+            {
+                ArquivoCotahist arquivo;
+                std::string completo = caminho + "/" + entrada->d_name;
+                if (interpretarNome(entrada->d_name, &arquivo) && stat(completo.c_str(), &informacoes) == 0 &&
+                    S_ISREG(informacoes.st_mode))
+                {
+                    arquivo.caminho = completo;
+                    encontrados.push_back(arquivo);
+                }
+            }
+            closedir(diretorio);
+        }
+    }
+    else if (stat(caminho.c_str(), &informacoes) == 0)
+    {
+        ArquivoCotahist arquivo;
+        size_t barra = caminho.find_last_of('/');
+        interpretarNome(barra == std::string::npos ? caminho : caminho.substr(barra + 1), &arquivo);
+        arquivo.caminho = caminho;
+        encontrados.push_back(arquivo);
+    }
+
+    // Um ZIP já descompactado ao lado dele (mesmo nome, outra extensão) é ignorado
+    auto semExtensao = [](const std::string &caminhoArquivo) {
+        std::string base = caminhoArquivo.substr(0, caminhoArquivo.find_last_of('.'));
+        std::transform(base.begin(), base.end(), base.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return base;
+    };
+    std::set<std::string> descompactados;
+    for (const ArquivoCotahist &arquivo : encontrados)
+    {
+        if (!ArquivoZip::ehZip(arquivo.caminho))
+        {
+            descompactados.insert(semExtensao(arquivo.caminho));
+        }
+    }
+    encontrados.erase(std::remove_if(encontrados.begin(), encontrados.end(),
+                                     [&](const ArquivoCotahist &arquivo) {
+                                         return ArquivoZip::ehZip(arquivo.caminho) &&
+                                                descompactados.count(semExtensao(arquivo.caminho));
+                                     }),
+                      encontrados.end());
+
+    std::sort(encontrados.begin(), encontrados.end(), [](const ArquivoCotahist &a, const ArquivoCotahist &b) {
+        return a.dataInicial != b.dataInicial ? a.dataInicial < b.dataInicial : a.caminho < b.caminho;
+    });
+
+    auto mapa = std::make_shared<MapaParticoes>();
+    for (const ArquivoCotahist &arquivo : encontrados)
+    {
+        std::shared_ptr<Particao> &particao = (*mapa)[arquivo.dataInicial / 10000];
+        if (!particao)
+        {
+            particao = std::make_shared<Particao>();
+        }
+        particao->arquivos.push_back(arquivo.caminho);
+    }
+
+    pararObservacao();
+
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    caminhoRaiz = caminho;
+    catalogo = encontrados;
+    memoriaCarregada = 0;
+    std::atomic_store(&particoes, std::shared_ptr<const MapaParticoes>(mapa));
+    versaoCatalogo++;
+    std::atomic_store(&buscaPapeis, std::shared_ptr<const BuscaPapeis>());
+    renovarCachePrecos();
+    aberto = !catalogo.empty();
+    return aberto;
+}
+
+void CatalogoCotacoes::setDiretorioCheckpoints(const std::string &diretorio)
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    diretorioCheckpoints = diretorio;
+}
+
+/**
+ * @brief Cria e carrega o índice de uma partição
+ * @return Índice carregado, ou nulo se algum arquivo não pôde ser lido
+ * @details Não toca o catálogo; o diretório de checkpoints é copiado por quem
+ *          chama, sob mutexCatalogo.
+ */
+std::shared_ptr<IndiceCotacoes> CatalogoCotacoes::indexar(const std::vector<std::string> &arquivos,
+                                                          const std::string &diretorio)
+{
+    auto indice = std::make_shared<IndiceCotacoes>();
+    indice->setDiretorioCheckpoints(diretorio);
+    return indice->carregar(arquivos) ? indice : nullptr;
+}
+
+void CatalogoCotacoes::setOrcamentoMemoria(size_t bytes)
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    orcamentoMemoria = bytes;
+    descartarExcedente(nullptr);
+}
+
+/**
+ * @brief Descarta as partições menos usadas até caber no orçamento
+ * @param preservada Partição que acabou de ser carregada e não pode sair
+ * @details Deve ser chamado com mutexCatalogo travado.
+ */
+void CatalogoCotacoes::descartarExcedente(const Particao *preservada)
+{
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    while (memoriaCarregada > orcamentoMemoria)
+    {
+        Particao *menosUsada = nullptr;
+        for (const auto &par : *mapa)
+        {
+            Particao *particao = par.second.get();
+            if (particao != preservada && std::atomic_load(&particao->indice) &&
+                (!menosUsada || particao->ultimoAcesso < menosUsada->ultimoAcesso))
+            {
+                menosUsada = particao;
+            }
+        }
+
+        if (!menosUsada)
+        {
+            return;
+        }
+
+        memoriaCarregada -= menosUsada->memoria;
+        std::atomic_store(&menosUsada->indice, std::shared_ptr<const IndiceCotacoes>());
+        menosUsada->memoria = 0;
+    }
+}
+
+/**
+ * @brief Publica uma nova versão da partição de um ano a partir de catalogo
+ * @details Se a versão anterior estava carregada, a nova é indexada antes da
+ *          troca, para que nenhuma consulta encontre o ano vazio ou pela metade.
+ *          A indexação corre fora de mutexCatalogo, e consultas e cargas de
+ *          outros anos não esperam por ela; sob a trava só o mapa é trocado.
+ *          Se o catálogo mudou enquanto isso (versaoCatalogo), o ano é montado
+ *          de novo a partir da lista atual.
+ *          Deve ser chamado sem mutexCatalogo travado.
+ */
+void CatalogoCotacoes::republicarAno(uint32_t ano)
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> trava(mutexCatalogo);
+        uint64_t versao = versaoCatalogo.load();
+        auto nova = std::make_shared<Particao>();
+        for (const ArquivoCotahist &arquivo : catalogo)
+        {
+            if (arquivo.dataInicial / 10000 == ano)
+            {
+                nova->arquivos.push_back(arquivo.caminho);
+            }
+        }
+        std::shared_ptr<const MapaParticoes> anterior = std::atomic_load(&particoes);
+        auto it = anterior->find(ano);
+        bool carregada = it != anterior->end() && std::atomic_load(&it->second->indice);
+        std::string diretorio = diretorioCheckpoints;
+        trava.unlock();
+
+        std::shared_ptr<IndiceCotacoes> indice;
+        if (carregada && !nova->arquivos.empty())
+        {
+            indice = indexar(nova->arquivos, diretorio);
+        }
+
+        trava.lock();
+        if (versaoCatalogo.load() != versao)
+        {
+            continue;
+        }
+
+        anterior = std::atomic_load(&particoes);
+        auto mapa = std::make_shared<MapaParticoes>(*anterior);
+        it = mapa->find(ano);
+        if (it != mapa->end())
+        {
+            if (indice)
+            {
+                nova->memoria = indice->memoriaEstimada();
+                nova->ultimoAcesso = it->second->ultimoAcesso.load();
+                memoriaCarregada += nova->memoria;
+                std::atomic_store(&nova->indice, std::shared_ptr<const IndiceCotacoes>(indice));
+            }
+            memoriaCarregada -= it->second->memoria;
+        }
+
+        if (nova->arquivos.empty())
+        {
+            mapa->erase(ano);
+        }
+        else
+        {
+            (*mapa)[ano] = nova;
+        }
+
+        std::atomic_store(&particoes, std::shared_ptr<const MapaParticoes>(mapa));
+        versaoCatalogo++;
+        renovarCachePrecos();
+        descartarExcedente(nova.get());
+        return;
+    }
+}
+
+/**
+ * @brief Registra, atualiza ou remove um arquivo do diretório aberto
+ * @details O arquivo entra se existe e é regular, e sai caso contrário; nos
+ *          dois casos o ano dele é republicado. A mudança na lista conta como
+ *          nova versão do catálogo, para que uma republicação em andamento
+ *          com a lista anterior seja refeita.
+ */
+bool CatalogoCotacoes::atualizarArquivo(const std::string &nome)
+{
+    ArquivoCotahist arquivo;
+    if (!interpretarNome(nome, &arquivo))
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> trava(mutexCatalogo);
+        arquivo.caminho = caminhoRaiz + "/" + nome;
+        catalogo.erase(std::remove_if(catalogo.begin(), catalogo.end(),
+                                      [&arquivo](const ArquivoCotahist &a) { return a.caminho == arquivo.caminho; }),
+                       catalogo.end());
+
+        struct stat informacoes;
+        if (stat(arquivo.caminho.c_str(), &informacoes) == 0 && S_ISREG(informacoes.st_mode))
+        {
+            auto posicao = std::upper_bound(catalogo.begin(), catalogo.end(), arquivo,
+                                            [](const ArquivoCotahist &a, const ArquivoCotahist &b) {
+                                                return a.dataInicial != b.dataInicial ? a.dataInicial < b.dataInicial
+                                                                                      : a.caminho < b.caminho;
+                                            });
+            catalogo.insert(posicao, arquivo);
+        }
+        versaoCatalogo++;
+        aberto = !catalogo.empty();
+    }
+
+    republicarAno(arquivo.dataInicial / 10000);
+    return true;
+}
+
+bool CatalogoCotacoes::iniciarObservacao()
+{
+    std::string diretorio = getCaminho();
+    struct stat informacoes;
+    if (threadObservacao.joinable() || stat(diretorio.c_str(), &informacoes) != 0 || !S_ISDIR(informacoes.st_mode))
+    {
+        return false;
+    }
+
+    fdInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    fdEvento = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fdInotify < 0 || fdEvento < 0 ||
+        inotify_add_watch(fdInotify, diretorio.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0)
+    {
+        pararObservacao();
+        return false;
+    }
+
+    // A thread nasce com todos os sinais bloqueados, para que SIGINT/SIGTERM
+    // continuem chegando a quem os trata (ex.: signalfd do servidor)
+    sigset_t todos;
+    sigset_t anteriores;
+    sigfillset(&todos);
+    pthread_sigmask(SIG_BLOCK, &todos, &anteriores);
+    threadObservacao = std::thread(&CatalogoCotacoes::executarObservacao, this);
+    pthread_sigmask(SIG_SETMASK, &anteriores, nullptr);
+    return true;
+}
+
+void CatalogoCotacoes::pararObservacao()
+{
+    if (threadObservacao.joinable())
+    {
+        uint64_t um = 1;
+        if (write(fdEvento, &um, sizeof(um)) < 0)
+        {
+            std::cerr << "Erro: Não foi possível sinalizar a observação de cotações!" << std::endl;
+        }
+        threadObservacao.join();
+    }
+
+    if (fdInotify >= 0)
+    {
+        close(fdInotify);
+        fdInotify = -1;
+    }
+    if (fdEvento >= 0)
+    {
+        close(fdEvento);
+        fdEvento = -1;
+    }
+}
+
+/**
+ * @brief Laço da thread de observação
+ * @details IN_CLOSE_WRITE só chega depois que quem gravou fechou o arquivo, e
+ *          IN_MOVED_TO cobre a cópia para um nome temporário seguida de rename;
+ *          nenhum dos dois indexa um arquivo ainda pela metade.
+ */
+void CatalogoCotacoes::executarObservacao()
+{
+    alignas(inotify_event) char buffer[4096];
+    pollfd descritores[2] = {{fdInotify, POLLIN, 0}, {fdEvento, POLLIN, 0}};
+
+    while (true)
+    {
+        if (poll(descritores, 2, -1) < 0)
+        {
+            continue;
+        }
+        if (descritores[1].revents & POLLIN)
+        {
+            return;
+        }
+
+        ssize_t lidos;
+        while ((lidos = read(fdInotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (char *p = buffer; p < buffer + lidos;)
+            {
+                const inotify_event *evento = reinterpret_cast<const inotify_event *>(p);
+                if (evento->len > 0 && atualizarArquivo(evento->name))
+                {
+                    std::cerr << "Cotações atualizadas: " << evento->name << std::endl;
+                }
+                p += sizeof(inotify_event) + evento->len;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Obtém o índice de um ano, carregando-o se necessário
+ * @details Para um ano já carregado, apenas duas leituras atômicas. A carga
+ *          acontece sob mutexCatalogo, e quem pedir o mesmo ano durante ela
+ *          encontra o índice pronto ao obter a trava, sem ler o arquivo de novo.
+ */
+std::shared_ptr<const IndiceCotacoes> CatalogoCotacoes::obterParticao(uint32_t ano)
+{
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    auto it = mapa->find(ano);
+    if (it == mapa->end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<const IndiceCotacoes> indice = std::atomic_load(&it->second->indice);
+    if (indice)
+    {
+        it->second->ultimoAcesso.store(++relogioAcesso, std::memory_order_relaxed);
+        return indice;
+    }
+
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    mapa = std::atomic_load(&particoes);
+    it = mapa->find(ano);
+    if (it == mapa->end())
+    {
+        return nullptr;
+    }
+
+    Particao &particao = *it->second;
+    indice = std::atomic_load(&particao.indice);
+    if (!indice)
+    {
+        std::shared_ptr<IndiceCotacoes> novo = indexar(particao.arquivos, diretorioCheckpoints);
+        if (!novo)
+        {
+            std::cerr << "Erro: Não foi possível carregar os dados históricos de " << ano << "!" << std::endl;
+            return nullptr;
+        }
+
+        indice = novo;
+        particao.memoria = novo->memoriaEstimada();
+        memoriaCarregada += particao.memoria;
+        std::atomic_store(&particao.indice, indice);
+    }
+
+    particao.ultimoAcesso.store(++relogioAcesso, std::memory_order_relaxed);
+    descartarExcedente(&particao);
+    return indice;
+}
+
+/**
+ * @brief Registra o índice de deslocamentos, com um cache de preços vazio na frente dele
+ * @details O cache é trocado antes do índice: uma consulta em andamento com o
+ *          índice anterior pode no máximo guardar no cache novo um preço que
+ *          ele também teria.
+ */
+void CatalogoCotacoes::setIndiceDeslocamentos(std::shared_ptr<const IndiceDeslocamentos> indice)
+{
+    size_t capacidade = capacidadeCachePrecos.load();
+    std::shared_ptr<CachePrecos> cache = indice && capacidade > 0 ? std::make_shared<CachePrecos>(capacidade) : nullptr;
+    std::atomic_store(&cachePrecos, std::move(cache));
+    std::atomic_store(&indiceArquivo, std::move(indice));
+    std::atomic_store(&buscaPapeisArquivo, std::shared_ptr<const BuscaPapeis>());
+}
+
+void CatalogoCotacoes::setCapacidadeCachePrecos(size_t entradas)
+{
+    capacidadeCachePrecos.store(entradas);
+    renovarCachePrecos();
+}
+
+/**
+ * @brief Troca o cache de preços por um vazio (ou nenhum, fora do modo arquivo)
+ * @details Chamado também a cada nova versão dos dados: o cache guarda
+ *          combinações inexistentes, e uma delas pode ter passado a existir.
+ */
+void CatalogoCotacoes::renovarCachePrecos()
+{
+    size_t capacidade = capacidadeCachePrecos.load();
+    std::shared_ptr<CachePrecos> cache =
+        std::atomic_load(&indiceArquivo) && capacidade > 0 ? std::make_shared<CachePrecos>(capacidade) : nullptr;
+    std::atomic_store(&cachePrecos, std::move(cache));
+}
+
+std::shared_ptr<const CachePrecos> CatalogoCotacoes::obterCachePrecos() const
+{
+    return std::atomic_load(&cachePrecos);
+}
+
+std::shared_ptr<const IndiceDeslocamentos> CatalogoCotacoes::obterIndiceDeslocamentos() const
+{
+    return std::atomic_load(&indiceArquivo);
+}
+
+void CatalogoCotacoes::setCotacoesCompartilhadas(std::shared_ptr<const CotacoesCompartilhadas> cotacoes)
+{
+    std::atomic_store(&cotacoesCompartilhadas, std::move(cotacoes));
+    std::atomic_store(&buscaPapeisArquivo, std::shared_ptr<const BuscaPapeis>());
+}
+
+bool CatalogoCotacoes::buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos)
+{
+    std::shared_ptr<const CotacoesCompartilhadas> compartilhadas = std::atomic_load(&cotacoesCompartilhadas);
+    if (compartilhadas)
+    {
+        return compartilhadas->buscarPreco(codigoNegociacao, data, precoCentavos);
+    }
+
+    std::shared_ptr<const IndiceDeslocamentos> deslocamentos = std::atomic_load(&indiceArquivo);
+    if (deslocamentos)
+    {
+        std::shared_ptr<CachePrecos> cache = std::atomic_load(&cachePrecos);
+        bool encontrado = false;
+        if (cache && cache->consultar(codigoNegociacao, data, &encontrado, precoCentavos))
+        {
+            return encontrado;
+        }
+
+        long long preco = 0;
+        encontrado = deslocamentos->buscarPreco(codigoNegociacao, data, &preco);
+        // Falha de leitura de uma combinação que o índice conhece não é guardada como inexistente
+        if (cache && (encontrado || !deslocamentos->contem(codigoNegociacao, data)))
+        {
+            cache->guardar(codigoNegociacao, data, encontrado, preco);
+        }
+        if (encontrado && precoCentavos)
+        {
+            *precoCentavos = preco;
+        }
+        return encontrado;
+    }
+
+    std::shared_ptr<const IndiceCotacoes> indice = obterParticao(data / 10000);
+    if (indice && indice->buscarPreco(codigoNegociacao, data, precoCentavos))
+    {
+        return true;
+    }
+
+    indice = obterParticao(ANO_SEM_DATA);
+    return indice && indice->buscarPreco(codigoNegociacao, data, precoCentavos);
+}
+
+bool CatalogoCotacoes::contem(const std::string &codigoNegociacao, uint32_t data)
+{
+    std::shared_ptr<const CotacoesCompartilhadas> compartilhadas = std::atomic_load(&cotacoesCompartilhadas);
+    if (compartilhadas)
+    {
+        return compartilhadas->contem(codigoNegociacao, data);
+    }
+
+    // Com cache, a validação já lê e guarda o preço que a criação da ordem vai pedir em seguida
+    std::shared_ptr<const IndiceDeslocamentos> deslocamentos = std::atomic_load(&indiceArquivo);
+    if (deslocamentos && !std::atomic_load(&cachePrecos))
+    {
+        return deslocamentos->contem(codigoNegociacao, data);
+    }
+
+    long long preco;
+    return buscarPreco(codigoNegociacao, data, &preco);
+}
+
+bool CatalogoCotacoes::somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial, uint32_t dataFinal,
+                                       EstatisticasNegociacao *estatisticas)
+{
+    if (!estatisticas)
+    {
+        return false;
+    }
+
+    // No modo arquivo, só os trechos da janela no índice esparso por data são lidos
+    std::shared_ptr<const IndiceDeslocamentos> deslocamentos = std::atomic_load(&indiceArquivo);
+    if (deslocamentos)
+    {
+        return deslocamentos->somarNegociacao(codigoNegociacao, dataInicial, dataFinal, estatisticas);
+    }
+
+    *estatisticas = EstatisticasNegociacao();
+    bool encontrado = false;
+    for (uint32_t ano = dataInicial / 10000; ano <= dataFinal / 10000 && ano != ANO_SEM_DATA; ano++)
+    {
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(ano);
+        EstatisticasNegociacao janela;
+        if (indice && indice->somarNegociacao(codigoNegociacao, dataInicial, dataFinal, &janela))
+        {
+            estatisticas->acumular(janela);
+            encontrado = true;
+        }
+    }
+
+    if (!encontrado)
+    {
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(ANO_SEM_DATA);
+        encontrado = indice && indice->somarNegociacao(codigoNegociacao, dataInicial, dataFinal, estatisticas);
+    }
+    return encontrado;
+}
+
+std::vector<DatasPapel> CatalogoCotacoes::obterDatas(const std::string &codigoNegociacao, uint32_t dataInicial,
+                                                     uint32_t dataFinal)
+{
+    std::vector<DatasPapel> fatias;
+    auto acrescentar = [&](DatasPapel datas) {
+        datas = datas.janela(dataInicial, dataFinal);
+        while (!datas.empty())
+        {
+            // Repetições são raras: a fatia só é dividida onde há uma, sem copiar as datas
+            const uint32_t *repetida = std::adjacent_find(datas.inicio, datas.fim);
+            DatasPapel trecho = datas;
+            trecho.fim = repetida == datas.fim ? datas.fim : repetida + 1;
+            datas.inicio = trecho.fim;
+            fatias.push_back(std::move(trecho));
+
+            while (datas.inicio != datas.fim && *datas.inicio == *(datas.inicio - 1))
+            {
+                datas.inicio++;
+            }
+        }
+    };
+
+    std::shared_ptr<const CotacoesCompartilhadas> compartilhadas = std::atomic_load(&cotacoesCompartilhadas);
+    if (compartilhadas)
+    {
+        DatasPapel datas;
+        if (compartilhadas->obterDatas(codigoNegociacao, &datas))
+        {
+            datas.dono = compartilhadas;
+            acrescentar(std::move(datas));
+        }
+        return fatias;
+    }
+
+    std::shared_ptr<const IndiceDeslocamentos> deslocamentos = std::atomic_load(&indiceArquivo);
+    if (deslocamentos)
+    {
+        auto copia = std::make_shared<const std::vector<uint32_t>>(deslocamentos->listarDatas(codigoNegociacao));
+        DatasPapel datas;
+        datas.inicio = copia->data();
+        datas.fim = copia->data() + copia->size();
+        datas.dono = copia;
+        acrescentar(std::move(datas));
+        return fatias;
+    }
+
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    for (auto it = mapa->lower_bound(dataInicial / 10000); it != mapa->end() && it->first <= dataFinal / 10000; ++it)
+    {
+        std::shared_ptr<const IndiceCotacoes> indice =
+            it->first == ANO_SEM_DATA ? nullptr : obterParticao(it->first);
+        DatasPapel datas;
+        if (indice && indice->obterDatas(codigoNegociacao, &datas))
+        {
+            datas.dono = indice;
+            acrescentar(std::move(datas));
+        }
+    }
+
+    if (fatias.empty())
+    {
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(ANO_SEM_DATA);
+        DatasPapel datas;
+        if (indice && indice->obterDatas(codigoNegociacao, &datas))
+        {
+            datas.dono = indice;
+            acrescentar(std::move(datas));
+        }
+    }
+    return fatias;
+}
+
+/**
+ * @brief Monta (ou devolve o já montado) índice de busca de papéis
+ * @details Só um chamador remonta por vez; os outros recebem o índice anterior,
+ *          se houver, em vez de esperar. Os papéis de cada ano ficam em
+ *          papeisPorAno e só são relidos quando a partição do ano foi trocada.
+ *          Um índice montado enquanto o catálogo mudou é devolvido a quem o
+ *          pediu, mas não é publicado; a próxima chamada monta outro.
+ */
+std::shared_ptr<const BuscaPapeis> CatalogoCotacoes::obterBuscaPapeis()
+{
+    if (std::atomic_load(&cotacoesCompartilhadas) || std::atomic_load(&indiceArquivo))
+    {
+        return obterBuscaPapeisArquivo();
+    }
+
+    std::shared_ptr<const BuscaPapeis> busca = std::atomic_load(&buscaPapeis);
+    if (busca && versaoBusca.load() == versaoCatalogo.load())
+    {
+        return busca;
+    }
+
+    std::unique_lock<std::mutex> trava(mutexBusca, std::defer_lock);
+    if (!busca)
+    {
+        trava.lock();
+    }
+    else if (!trava.try_lock())
+    {
+        return busca;
+    }
+    busca = std::atomic_load(&buscaPapeis);
+    if (busca && versaoBusca.load() == versaoCatalogo.load())
+    {
+        return busca;
+    }
+
+    uint64_t versao = versaoCatalogo.load();
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    for (auto it = papeisPorAno.begin(); it != papeisPorAno.end();)
+    {
+        it = mapa->count(it->first) ? std::next(it) : papeisPorAno.erase(it);
+    }
+
+    for (const auto &particao : *mapa)
+    {
+        PapeisAno &ano = papeisPorAno[particao.first];
+        if (ano.particao.lock() == particao.second)
+        {
+            continue;
+        }
+
+        ano.codigos.clear();
+        ano.nomes.clear();
+        ano.pregoes.clear();
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(particao.first);
+        std::string codigo;
+        std::string nome;
+        size_t pregoes;
+        for (size_t papel = 0; indice && indice->obterPapel(papel, &codigo, &nome, &pregoes); papel++)
+        {
+            ano.codigos.push_back(codigo);
+            ano.nomes.push_back(nome);
+            ano.pregoes.push_back(pregoes);
+        }
+        // Um ano que não pôde ser lido é tentado de novo na próxima montagem
+        ano.particao = indice ? particao.second : std::weak_ptr<Particao>();
+    }
+
+    auto nova = std::make_shared<BuscaPapeis>();
+    for (const auto &ano : papeisPorAno)
+    {
+        for (size_t i = 0; i < ano.second.codigos.size(); i++)
+        {
+            nova->adicionar(ano.second.codigos[i], ano.second.nomes[i], ano.second.pregoes[i]);
+        }
+    }
+    nova->montar();
+
+    busca = nova;
+    if (versaoCatalogo.load() == versao)
+    {
+        std::atomic_store(&buscaPapeis, busca);
+        versaoBusca = versao;
+    }
+    return busca;
+}
+
+/**
+ * @brief Índice de busca montado da tabela de códigos do segmento ou do auxiliar
+ * @details A ordem de preferência é a de buscarPreco(). Os dois são imutáveis
+ *          depois de abertos, então o índice é montado uma vez e só é
+ *          descartado quando outro segmento ou auxiliar é registrado. O
+ *          auxiliar dá o nome lendo uma linha por papel; o segmento não o tem.
+ */
+std::shared_ptr<const BuscaPapeis> CatalogoCotacoes::obterBuscaPapeisArquivo()
+{
+    std::shared_ptr<const BuscaPapeis> busca = std::atomic_load(&buscaPapeisArquivo);
+    if (busca)
+    {
+        return busca;
+    }
+
+    std::lock_guard<std::mutex> trava(mutexBusca);
+    busca = std::atomic_load(&buscaPapeisArquivo);
+    if (busca)
+    {
+        return busca;
+    }
+
+    std::shared_ptr<const CotacoesCompartilhadas> compartilhadas = std::atomic_load(&cotacoesCompartilhadas);
+    std::shared_ptr<const IndiceDeslocamentos> deslocamentos = std::atomic_load(&indiceArquivo);
+    auto lerPapel = [&](size_t papel, std::string *codigo, std::string *nome, size_t *pregoes) {
+        nome->clear();
+        return compartilhadas ? compartilhadas->obterPapel(papel, codigo, pregoes)
+                              : deslocamentos && deslocamentos->obterPapel(papel, codigo, nome, pregoes);
+    };
+
+    auto nova = std::make_shared<BuscaPapeis>();
+    std::string codigo;
+    std::string nome;
+    size_t pregoes;
+    for (size_t papel = 0; lerPapel(papel, &codigo, &nome, &pregoes); papel++)
+    {
+        nova->adicionar(codigo, nome, pregoes);
+    }
+    nova->montar();
+
+    busca = nova;
+    std::atomic_store(&buscaPapeisArquivo, busca);
+    return busca;
+}
+
+RelatorioQualidade CatalogoCotacoes::obterRelatorioQualidade()
+{
+    RelatorioQualidade relatorio;
+    if (std::atomic_load(&cotacoesCompartilhadas) || std::atomic_load(&indiceArquivo))
+    {
+        // Sem partições carregadas: uma passada pelos arquivos guarda só papel, data e marcas de cada registro
+        AcumuladorQualidade acumulador;
+        ContagemLinhas descartadas;
+        for (const ArquivoCotahist &arquivo : listarArquivos())
+        {
+            ContagemLinhas doArquivo;
+            auto adicionar = [&acumulador](const RegistroCotacao &registro) { acumulador.adicionar(registro); };
+            if (!CheckpointCotahist::ler(arquivo.caminho, "", adicionar, nullptr, &doArquivo))
+            {
+                std::cerr << "Erro: Não foi possível ler " << arquivo.caminho << " para o relatório de qualidade!"
+                          << std::endl;
+                continue;
+            }
+            descartadas.curtas += doArquivo.curtas;
+            descartadas.invalidas += doArquivo.invalidas;
+        }
+        relatorio = acumulador.montar();
+        relatorio.linhasCurtas = descartadas.curtas;
+        relatorio.linhasInvalidas = descartadas.invalidas;
+        return relatorio;
+    }
+
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    for (const auto &particao : *mapa)
+    {
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(particao.first);
+        if (indice)
+        {
+            relatorio.acumular(indice->obterRelatorioQualidade());
+        }
+    }
+    return relatorio;
+}
+
+void CatalogoCotacoes::percorrerParticoes(uint32_t dataInicial, uint32_t dataFinal,
+                                          const std::function<void(const IndiceCotacoes &)> &visitar)
+{
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    for (const auto &particao : *mapa)
+    {
+        bool foraDaJanela = particao.first < dataInicial / 10000 || particao.first > dataFinal / 10000;
+        if (particao.first != ANO_SEM_DATA && foraDaJanela)
+        {
+            continue;
+        }
+
+        std::shared_ptr<const IndiceCotacoes> indice = obterParticao(particao.first);
+        if (indice)
+        {
+            visitar(*indice);
+        }
+    }
+}
+
+std::vector<ArquivoCotahist> CatalogoCotacoes::listarArquivos()
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    return catalogo;
+}
+
+std::set<uint32_t> CatalogoCotacoes::anosCarregados() const
+{
+    std::shared_ptr<const MapaParticoes> mapa = std::atomic_load(&particoes);
+    std::set<uint32_t> anos;
+    for (const auto &par : *mapa)
+    {
+        if (std::atomic_load(&par.second->indice))
+        {
+            anos.insert(par.first);
+        }
+    }
+    return anos;
+}
+
+size_t CatalogoCotacoes::getMemoriaCarregada()
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    return memoriaCarregada;
+}
+
+bool CatalogoCotacoes::estaAberto()
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    return aberto;
+}
+
+std::string CatalogoCotacoes::getCaminho()
+{
+    std::lock_guard<std::mutex> trava(mutexCatalogo);
+    return caminhoRaiz;
+}
@@ -0,0 +1,371 @@
+#ifndef CATALOGOCOTACOES_HPP_INCLUDED
+#define CATALOGOCOTACOES_HPP_INCLUDED
+
+#include "IndiceCotacoes.hpp"
+#include "BuscaPapeis.hpp"
+#include "CachePrecos.hpp"
+#include "CotacoesCompartilhadas.hpp"
+#include "IndiceDeslocamentos.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Arquivo de dados históricos conhecido pelo catálogo
+ */
+struct ArquivoCotahist
+{
+    std::string caminho;      ///< Caminho do arquivo
+    uint32_t dataInicial = 0; ///< Primeira data coberta (AAAAMMDD), 0 se desconhecida
+    uint32_t dataFinal = 0;   ///< Última data coberta (AAAAMMDD), 0 se desconhecida
+};
+
+/**
+ * @brief Catálogo de dados históricos particionado por ano
+ *
+ * @details Aponta para um arquivo único (ex.: DADOS_HISTORICOS.txt) ou para um
+ * diretório com arquivos da B3 nos padrões COTAHIST_AAAAA (anual),
+ * COTAHIST_MMMAAAA (mensal) e COTAHIST_DDDMMAAAA (diário), sem extensão ou com
+ * .TXT/.ZIP. O período de cada arquivo é deduzido do nome; arquivos fora desses
+ * padrões formam uma partição sem data, consultada para qualquer ano.
+ *
+ * Cada ano vira um IndiceCotacoes carregado na primeira consulta a uma data
+ * daquele ano. Quando a soma das partições carregadas passa do orçamento de
+ * memória, as menos usadas recentemente são descartadas. Assim, décadas de
+ * histórico não precisam ser lidas na inicialização.
+ *
+ * As versões são publicadas no estilo RCU: o mapa de partições e o índice de
+ * cada partição são trocados inteiros por atomic_store, e a consulta a um ano
+ * já carregado só faz atomic_load, sem trava. Quem ainda segura uma versão
+ * antiga continua com ela até soltar o shared_ptr. As escritas (carga,
+ * descarte, troca do mapa) são serializadas por mutexCatalogo; a recarga de
+ * um ano observado é indexada fora da trava e só publicada sob ela.
+ *
+ * Com um IndiceDeslocamentos registrado (modo arquivo), preços e existência
+ * de cotações são respondidos por ele, lendo linhas do arquivo original, e
+ * nenhuma partição é carregada para essas consultas. Um CachePrecos na frente
+ * do índice guarda as combinações consultadas, para que a mesma combinação
+ * não seja lida do arquivo de novo. Com CotacoesCompartilhadas
+ * registradas, essas consultas vão ao segmento de memória compartilhada.
+ *
+ * O catálogo do processo (instancia()) é usado pela camada de serviço e pelo
+ * validador de entradas.
+ */
+class CatalogoCotacoes
+{
+  private:
+    /**
+     * @brief Ano da partição formada por arquivos sem período no nome
+     */
+    static const uint32_t ANO_SEM_DATA = 0;
+
+    struct Particao
+    {
+        std::vector<std::string> arquivos; ///< Imutável depois de publicada
+        std::shared_ptr<const IndiceCotacoes> indice; ///< Acessado só por atomic_load/atomic_store
+        size_t memoria = 0; ///< Protegido por mutexCatalogo
+        std::atomic<uint64_t> ultimoAcesso{0};
+    };
+
+    using MapaParticoes = std::map<uint32_t, std::shared_ptr<Particao>>;
+
+    /**
+     * @brief Papéis de um ano, guardados para remontar a busca sem reler os anos que não mudaram
+     */
+    struct PapeisAno
+    {
+        std::weak_ptr<Particao> particao; ///< Versão da partição lida; outra no mapa significa que o ano mudou
+        std::vector<std::string> codigos;
+        std::vector<std::string> nomes;
+        std::vector<size_t> pregoes;
+    };
+
+    std::mutex mutexCatalogo;
+    std::shared_ptr<const MapaParticoes> particoes; ///< Acessado só por atomic_load/atomic_store
+    std::shared_ptr<const IndiceDeslocamentos> indiceArquivo; ///< Acessado só por atomic_load/atomic_store
+    std::shared_ptr<CachePrecos> cachePrecos; ///< Acessado só por atomic_load/atomic_store; nulo fora do modo arquivo
+    std::atomic<size_t> capacidadeCachePrecos;
+    std::shared_ptr<const CotacoesCompartilhadas> cotacoesCompartilhadas; ///< Acessado só por atomic_load/atomic_store
+    std::shared_ptr<const BuscaPapeis> buscaPapeis; ///< Acessado só por atomic_load/atomic_store; nulo até ser montado
+    std::shared_ptr<const BuscaPapeis> buscaPapeisArquivo; ///< Acessado só por atomic_load/atomic_store; modos arquivo
+    std::mutex mutexBusca;
+    std::map<uint32_t, PapeisAno> papeisPorAno; ///< Protegido por mutexBusca
+    std::atomic<uint64_t> versaoCatalogo;
+    std::atomic<uint64_t> versaoBusca; ///< versaoCatalogo de quando buscaPapeis foi montado
+    std::string caminhoRaiz;
+    std::vector<ArquivoCotahist> catalogo;
+    std::string diretorioCheckpoints;
+    size_t orcamentoMemoria;
+    size_t memoriaCarregada;
+    std::atomic<uint64_t> relogioAcesso;
+    bool aberto;
+
+    std::thread threadObservacao;
+    int fdInotify;
+    int fdEvento;
+
+    static std::shared_ptr<IndiceCotacoes> indexar(const std::vector<std::string> &arquivos,
+                                                   const std::string &diretorio);
+    void descartarExcedente(const Particao *preservada);
+    void republicarAno(uint32_t ano);
+    void renovarCachePrecos();
+    std::shared_ptr<const BuscaPapeis> obterBuscaPapeisArquivo();
+    void executarObservacao();
+
+  public:
+    /**
+     * @brief Caminho usado quando nenhum outro foi aberto
+     */
+    static const std::string CAMINHO_PADRAO;
+
+    /**
+     * @brief Orçamento de memória padrão das partições carregadas, em bytes
+     */
+    static const size_t ORCAMENTO_PADRAO = 512u * 1024u * 1024u;
+
+    CatalogoCotacoes();
+    ~CatalogoCotacoes();
+
+    CatalogoCotacoes(const CatalogoCotacoes &) = delete;
+    CatalogoCotacoes &operator=(const CatalogoCotacoes &) = delete;
+
+    /**
+     * @brief Acessa o catálogo do processo
+     *
+     * @return CatalogoCotacoes& Instância única; abre CAMINHO_PADRAO se ninguém abriu outro
+     */
+    static CatalogoCotacoes &instancia();
+
+    /**
+     * @brief Interpreta o nome de um arquivo da B3
+     *
+     * @param nome Nome do arquivo, sem diretório (ex.: "COTAHIST_A2023.TXT")
+     * @param arquivo Estrutura onde o período é armazenado
+     * @return bool true se o nome segue um dos padrões COTAHIST
+     */
+    static bool interpretarNome(const std::string &nome, ArquivoCotahist *arquivo);
+
+    /**
+     * @brief Descobre os arquivos de um diretório ou registra um arquivo único
+     *
+     * @param caminho Diretório com arquivos COTAHIST ou caminho de um arquivo
+     * @return bool true se algum arquivo foi encontrado
+     * @details Encerra a observação anterior e descarta as partições carregadas.
+     * Nenhum dado é lido aqui.
+     */
+    bool abrir(const std::string &caminho);
+
+    /**
+     * @brief Passa a observar o diretório aberto com inotify
+     *
+     * @return bool true se a observação começou (o caminho aberto precisa ser um diretório)
+     * @details Arquivos COTAHIST criados, regravados, movidos para o diretório ou
+     * removidos dele atualizam o catálogo em segundo plano. O ano afetado é
+     * reindexado se já estava carregado e publicado de uma vez; consultas em
+     * andamento terminam com a versão anterior.
+     * Um catálogo aberto a partir de um arquivo único não é observado: as
+     * mudanças nele valem a partir da próxima abertura, que com checkpoints
+     * interpreta só os bytes acrescentados.
+     */
+    bool iniciarObservacao();
+
+    /**
+     * @brief Encerra a observação do diretório, se houver
+     */
+    void pararObservacao();
+
+    /**
+     * @brief Registra, atualiza ou remove um arquivo do diretório aberto
+     *
+     * @param nome Nome do arquivo dentro do diretório
+     * @return bool true se o nome é de um arquivo COTAHIST e o catálogo foi atualizado
+     * @details Chamado pela observação; pode ser chamado diretamente por quem
+     * sabe que um arquivo mudou.
+     */
+    bool atualizarArquivo(const std::string &nome);
+
+    /**
+     * @brief Ativa os checkpoints de leitura incremental nas partições
+     *
+     * @param diretorio Diretório dos checkpoints; vazio desativa
+     * @details Com checkpoints, recarregar um ano cujo arquivo diário cresceu
+     * interpreta apenas as linhas acrescentadas.
+     * @see CheckpointCotahist
+     */
+    void setDiretorioCheckpoints(const std::string &diretorio);
+
+    /**
+     * @brief Passa a responder preços pelo índice de deslocamentos do arquivo
+     *
+     * @param indice Índice já aberto; nulo volta a usar as partições em memória
+     */
+    void setIndiceDeslocamentos(std::shared_ptr<const IndiceDeslocamentos> indice);
+
+    /**
+     * @brief Índice de deslocamentos registrado, ou nulo fora do modo arquivo
+     */
+    std::shared_ptr<const IndiceDeslocamentos> obterIndiceDeslocamentos() const;
+
+    /**
+     * @brief Define a quantidade de entradas do cache de preços do modo arquivo
+     *
+     * @param entradas Capacidade do cache; 0 desativa (padrão: CachePrecos::CAPACIDADE_PADRAO)
+     * @details Um cache novo e vazio substitui o atual, se houver índice de deslocamentos.
+     */
+    void setCapacidadeCachePrecos(size_t entradas);
+
+    /**
+     * @brief Cache de preços do modo arquivo, ou nulo se não há índice de deslocamentos ou cache
+     */
+    std::shared_ptr<const CachePrecos> obterCachePrecos() const;
+
+    /**
+     * @brief Passa a responder preços pelo segmento de memória compartilhada
+     *
+     * @param cotacoes Segmento já anexado; nulo volta a usar as partições em memória
+     */
+    void setCotacoesCompartilhadas(std::shared_ptr<const CotacoesCompartilhadas> cotacoes);
+
+    /**
+     * @brief Define o orçamento de memória das partições carregadas
+     *
+     * @param bytes Limite em bytes; a partição em uso nunca é descartada, mesmo acima dele
+     */
+    void setOrcamentoMemoria(size_t bytes);
+
+    /**
+     * @brief Obtém o índice de um ano, carregando-o se necessário
+     *
+     * @param ano Ano com quatro dígitos
+     * @return std::shared_ptr<const IndiceCotacoes> Índice do ano, ou nulo se não há arquivos para ele
+     */
+    std::shared_ptr<const IndiceCotacoes> obterParticao(uint32_t ano);
+
+    /**
+     * @brief Busca o preço de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param data Data no formato AAAAMMDD
+     * @param precoCentavos Ponteiro para armazenar o preço em centavos
+     * @return bool true se a combinação existe
+     */
+    bool buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos);
+
+    /**
+     * @brief Verifica se existe cotação para um papel em uma data
+     */
+    bool contem(const std::string &codigoNegociacao, uint32_t data);
+
+    /**
+     * @brief Soma a negociação de um papel em uma janela de datas
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param estatisticas Estrutura onde as somas da janela são armazenadas
+     * @return bool true se algum ano da janela tem o layout completo e conhece o papel
+     * @details Carrega os anos da janela que ainda não estavam em memória e
+     * acumula a janela de cada um; a partição sem data só é usada se nenhum ano
+     * respondeu. No modo arquivo, o índice de deslocamentos lê só os trechos
+     * da janela, sem carregar partições.
+     */
+    bool somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial, uint32_t dataFinal,
+                         EstatisticasNegociacao *estatisticas);
+
+    /**
+     * @brief Datas em que um papel tem cotação, dentro de uma janela
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @return std::vector<DatasPapel> Fatias com as datas na janela, em ordem e sem repetição; vazio se não há nenhuma
+     * @details As fatias apontam para as colunas de datas já carregadas (ou
+     * para o segmento compartilhado), sem cópia; só os anos da janela são
+     * carregados. No modo arquivo, as datas do papel são copiadas do auxiliar
+     * para uma única fatia. A partição sem data só é usada se nenhum ano
+     * respondeu. As colunas guardam os registros repetidos do mesmo papel e
+     * data (QUALIDADE_DUPLICADO); a fatia de um ano é dividida em volta de cada
+     * repetição, de modo que cada data aparece uma vez.
+     */
+    std::vector<DatasPapel> obterDatas(const std::string &codigoNegociacao, uint32_t dataInicial = 0,
+                                       uint32_t dataFinal = 99999999);
+
+    /**
+     * @brief Índice de busca de papéis de todos os anos do catálogo
+     *
+     * @return std::shared_ptr<const BuscaPapeis> Índice montado, nunca nulo
+     * @details Montado na primeira chamada, lendo cada ano pelo mesmo caminho
+     * das consultas (anos fora do orçamento de memória são descartados em
+     * seguida). Depois de uma republicação, a chamada seguinte relê só os anos
+     * que mudaram e remonta as tries; enquanto isso, as demais threads
+     * continuam recebendo o índice anterior. Abrir outro diretório descarta o
+     * índice, e a próxima chamada espera a montagem.
+     *
+     * Com índice de deslocamentos ou memória compartilhada registrados, nenhum
+     * ano é carregado: o índice é montado uma vez a partir da tabela de códigos
+     * do auxiliar ou do segmento. O auxiliar obtém o nome de cada papel lendo
+     * uma linha do arquivo; o segmento não guarda nomes, e nesse modo a busca
+     * por nome não encontra nada.
+     */
+    std::shared_ptr<const BuscaPapeis> obterBuscaPapeis();
+
+    /**
+     * @brief Resumo da qualidade dos dados de todos os anos do catálogo
+     *
+     * @return RelatorioQualidade Soma dos relatórios das partições, com as lacunas ordenadas
+     * @details Lê cada ano pelo mesmo caminho das consultas, como obterBuscaPapeis().
+     * Cada ano é indexado à parte, então pregões ausentes na virada do ano não são contados.
+     * Com índice de deslocamentos ou memória compartilhada registrados, os arquivos
+     * são percorridos por AcumuladorQualidade, sem carregar as partições.
+     */
+    RelatorioQualidade obterRelatorioQualidade();
+
+    /**
+     * @brief Visita, em ordem de ano, as partições que podem ter cotações em uma janela
+     *
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param visitar Chamada com o índice de cada partição; a partição sem data vem primeiro
+     * @details Cada ano é lido pelo mesmo caminho das consultas e solto depois
+     * da visita, então o orçamento de memória vale também para percorrer todo o
+     * histórico. Sempre usa as partições, mesmo com índice de deslocamentos ou
+     * memória compartilhada registrados: quem visita precisa de IndiceCotacoes.
+     * A exportação, única usuária, roda antes de qualquer um desses modos.
+     */
+    void percorrerParticoes(uint32_t dataInicial, uint32_t dataFinal,
+                            const std::function<void(const IndiceCotacoes &)> &visitar);
+
+    /**
+     * @brief Arquivos descobertos, ordenados por data inicial
+     */
+    std::vector<ArquivoCotahist> listarArquivos();
+
+    /**
+     * @brief Anos com partição carregada no momento
+     */
+    std::set<uint32_t> anosCarregados() const;
+
+    /**
+     * @brief Memória estimada das partições carregadas, em bytes
+     */
+    size_t getMemoriaCarregada();
+
+    /**
+     * @brief Indica se abrir() encontrou algum arquivo
+     */
+    bool estaAberto();
+
+    /**
+     * @brief Caminho passado a abrir()
+     */
+    std::string getCaminho();
+};
+
+#endif // CATALOGOCOTACOES_HPP_INCLUDED
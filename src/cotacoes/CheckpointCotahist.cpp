@@ -0,0 +1,484 @@
+#include "CheckpointCotahist.hpp"
+#include "ArquivoZip.hpp"
+#include "ImpressaoArquivo.hpp"
+#include "LeitorArquivo.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+const char ASSINATURA[8] = {'C', 'K', 'P', 'T', 'C', 'O', 'T', '5'};
+
+/**
+ * @brief Cabeçalho de tamanho fixo no início do checkpoint
+ * @details Gravado campo a campo, sem preenchimento, no formato nativo da máquina;
+ *          um checkpoint de outra arquitetura simplesmente não confere.
+ */
+struct Cabecalho
+{
+    uint64_t dispositivo = 0;
+    uint64_t inode = 0;
+    uint64_t deslocamento = 0;
+    uint64_t registros = 0;
+    uint64_t bytesRegistros = 0;
+    uint64_t somaInicio = 0;
+    uint64_t somaFim = 0;
+    uint64_t linhasCurtas = 0;
+    uint64_t linhasInvalidas = 0;
+};
+
+const std::streamoff TAMANHO_CABECALHO = sizeof(ASSINATURA) + 9 * sizeof(uint64_t);
+
+template <typename T> void escreverCampo(std::ostream &saida, T valor)
+{
+    saida.write(reinterpret_cast<const char *>(&valor), sizeof(valor));
+}
+
+template <typename T> bool lerCampo(std::istream &entrada, T *valor)
+{
+    return static_cast<bool>(entrada.read(reinterpret_cast<char *>(valor), sizeof(*valor)));
+}
+
+void escreverCabecalho(std::ostream &saida, const Cabecalho &cabecalho)
+{
+    saida.write(ASSINATURA, sizeof(ASSINATURA));
+    escreverCampo(saida, cabecalho.dispositivo);
+    escreverCampo(saida, cabecalho.inode);
+    escreverCampo(saida, cabecalho.deslocamento);
+    escreverCampo(saida, cabecalho.registros);
+    escreverCampo(saida, cabecalho.bytesRegistros);
+    escreverCampo(saida, cabecalho.somaInicio);
+    escreverCampo(saida, cabecalho.somaFim);
+    escreverCampo(saida, cabecalho.linhasCurtas);
+    escreverCampo(saida, cabecalho.linhasInvalidas);
+}
+
+bool lerCabecalho(std::istream &entrada, Cabecalho *cabecalho)
+{
+    char assinatura[sizeof(ASSINATURA)];
+    return entrada.read(assinatura, sizeof(assinatura)) &&
+           std::memcmp(assinatura, ASSINATURA, sizeof(ASSINATURA)) == 0 &&
+           lerCampo(entrada, &cabecalho->dispositivo) && lerCampo(entrada, &cabecalho->inode) &&
+           lerCampo(entrada, &cabecalho->deslocamento) && lerCampo(entrada, &cabecalho->registros) &&
+           lerCampo(entrada, &cabecalho->bytesRegistros) && lerCampo(entrada, &cabecalho->somaInicio) &&
+           lerCampo(entrada, &cabecalho->somaFim) && lerCampo(entrada, &cabecalho->linhasCurtas) &&
+           lerCampo(entrada, &cabecalho->linhasInvalidas);
+}
+
+/**
+ * @brief Grava um texto curto precedido do tamanho em um byte
+ */
+uint64_t escreverTexto(std::ostream &saida, const std::string &texto)
+{
+    uint8_t tamanho = static_cast<uint8_t>(std::min<size_t>(texto.size(), 255));
+    escreverCampo(saida, tamanho);
+    saida.write(texto.data(), tamanho);
+    return sizeof(tamanho) + tamanho;
+}
+
+bool lerTexto(std::istream &entrada, std::string *texto)
+{
+    uint8_t tamanho;
+    if (!lerCampo(entrada, &tamanho))
+    {
+        return false;
+    }
+
+    texto->resize(tamanho);
+    return tamanho == 0 || static_cast<bool>(entrada.read(&(*texto)[0], tamanho));
+}
+
+/**
+ * @brief Grava um registro no corpo do checkpoint
+ * @details Todos os campos de RegistroCotacao são gravados, já com os preços
+ *          por unidade, para que a carga a partir do checkpoint seja idêntica
+ *          à leitura do arquivo.
+ * @return Quantidade de bytes gravados
+ */
+uint64_t escreverRegistro(std::ostream &saida, const RegistroCotacao &registro)
+{
+    escreverCampo(saida, registro.data);
+    escreverCampo(saida, static_cast<uint8_t>(registro.completo ? 1 : 0));
+    escreverCampo(saida, static_cast<int64_t>(registro.precoAberturaCentavos));
+    escreverCampo(saida, static_cast<int64_t>(registro.precoMaximoCentavos));
+    escreverCampo(saida, static_cast<int64_t>(registro.precoMinimoCentavos));
+    escreverCampo(saida, static_cast<int64_t>(registro.precoMedioCentavos));
+    uint64_t bytes = sizeof(uint32_t) + sizeof(uint8_t) + 4 * sizeof(int64_t);
+
+    if (registro.completo)
+    {
+        escreverCampo(saida, static_cast<int64_t>(registro.precoUltimoCentavos));
+        escreverCampo(saida, static_cast<int64_t>(registro.precoOfertaCompraCentavos));
+        escreverCampo(saida, static_cast<int64_t>(registro.precoOfertaVendaCentavos));
+        escreverCampo(saida, static_cast<int64_t>(registro.quantidadeTotal));
+        escreverCampo(saida, static_cast<int64_t>(registro.volumeTotalCentavos));
+        escreverCampo(saida, static_cast<int64_t>(registro.precoExercicioCentavos));
+        escreverCampo(saida, registro.totalNegocios);
+        escreverCampo(saida, registro.dataVencimento);
+        escreverCampo(saida, registro.fatorCotacao);
+        escreverCampo(saida, registro.numeroDistribuicao);
+        escreverCampo(saida, registro.indicadorCorrecao);
+        bytes += 6 * sizeof(int64_t) + 3 * sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t);
+        bytes += escreverTexto(saida, registro.codigoIsin);
+    }
+
+    bytes += escreverTexto(saida, registro.nomeResumido);
+    return bytes + escreverTexto(saida, registro.codigoNegociacao);
+}
+
+bool lerRegistro(std::istream &entrada, RegistroCotacao *registro)
+{
+    uint8_t completo;
+    int64_t precos[4];
+    *registro = RegistroCotacao();
+    if (!lerCampo(entrada, &registro->data) || !lerCampo(entrada, &completo) || !lerCampo(entrada, &precos))
+    {
+        return false;
+    }
+
+    registro->completo = completo != 0;
+    registro->precoAberturaCentavos = precos[0];
+    registro->precoMaximoCentavos = precos[1];
+    registro->precoMinimoCentavos = precos[2];
+    registro->precoMedioCentavos = precos[3];
+
+    if (registro->completo)
+    {
+        int64_t valores[6];
+        if (!lerCampo(entrada, &valores) || !lerCampo(entrada, &registro->totalNegocios) ||
+            !lerCampo(entrada, &registro->dataVencimento) || !lerCampo(entrada, &registro->fatorCotacao) ||
+            !lerCampo(entrada, &registro->numeroDistribuicao) || !lerCampo(entrada, &registro->indicadorCorrecao) ||
+            !lerTexto(entrada, &registro->codigoIsin))
+        {
+            return false;
+        }
+
+        registro->precoUltimoCentavos = valores[0];
+        registro->precoOfertaCompraCentavos = valores[1];
+        registro->precoOfertaVendaCentavos = valores[2];
+        registro->quantidadeTotal = valores[3];
+        registro->volumeTotalCentavos = valores[4];
+        registro->precoExercicioCentavos = valores[5];
+    }
+
+    return lerTexto(entrada, &registro->nomeResumido) && lerTexto(entrada, &registro->codigoNegociacao);
+}
+
+/**
+ * @brief Interpreta o corpo de um checkpoint já carregado em memória
+ * @param consumir Chamada para cada registro; nula apenas confere o corpo
+ * @return bool true se há exatamente quantidade registros bem formados e nada sobra depois deles
+ */
+bool lerRegistros(const std::string &corpo, uint64_t quantidade,
+                  const std::function<void(const RegistroCotacao &)> *consumir)
+{
+    std::istringstream entrada(corpo);
+    RegistroCotacao registro;
+    for (uint64_t i = 0; i < quantidade; i++)
+    {
+        if (!lerRegistro(entrada, &registro))
+        {
+            return false;
+        }
+        if (consumir)
+        {
+            (*consumir)(registro);
+        }
+    }
+    return entrada.peek() == std::char_traits<char>::eof();
+}
+
+/**
+ * @brief Trava exclusiva em "<checkpoint>.lock" enquanto o objeto existir
+ * @details A trava fica em um arquivo à parte porque o checkpoint pode ser
+ *          trocado por rename no meio da leitura; sem arquivo de trava (ex.:
+ *          diretório sem escrita) a leitura segue sem ela, e o checkpoint
+ *          também não poderá ser gravado.
+ */
+class TravaCheckpoint
+{
+  private:
+    int fd;
+
+  public:
+    explicit TravaCheckpoint(const std::string &caminhoCkpt)
+        : fd(open((caminhoCkpt + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+    {
+        while (fd >= 0 && flock(fd, LOCK_EX) != 0 && errno == EINTR)
+        {
+        }
+    }
+
+    TravaCheckpoint(const TravaCheckpoint &) = delete;
+    TravaCheckpoint &operator=(const TravaCheckpoint &) = delete;
+
+    ~TravaCheckpoint()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+};
+
+/**
+ * @brief Soma o primeiro e o último bloco da parte já consumida do arquivo
+ */
+void somarExtremos(std::ifstream &arquivo, Cabecalho *cabecalho)
+{
+    ImpressaoArquivo::somarExtremos(arquivo, cabecalho->deslocamento, &cabecalho->somaInicio, &cabecalho->somaFim);
+}
+} // namespace
+
+std::string CheckpointCotahist::caminhoCheckpoint(const std::string &diretorioCheckpoints,
+                                                  const std::string &caminhoArquivo)
+{
+    size_t barra = caminhoArquivo.find_last_of('/');
+    return diretorioCheckpoints + "/" +
+           (barra == std::string::npos ? caminhoArquivo : caminhoArquivo.substr(barra + 1)) + ".ckpt";
+}
+
+/**
+ * @brief Lê os registros de um arquivo, aproveitando e atualizando o checkpoint
+ * @details Com checkpoint válido, os registros novos são acrescentados ao fim
+ *          do corpo e o cabeçalho é regravado por último: uma interrupção no
+ *          meio deixa bytesRegistros diferente do tamanho do corpo, e o
+ *          checkpoint é descartado na carga seguinte. Sem checkpoint válido, um
+ *          novo é montado em "<checkpoint>.<pid>.tmp" e renomeado ao final.
+ *          Processos que leem o mesmo arquivo são serializados por flock em
+ *          "<checkpoint>.lock", da leitura do cabeçalho até a regravação dele:
+ *          dois acréscimos no mesmo lugar do corpo corromperiam o checkpoint.
+ */
+bool CheckpointCotahist::ler(const std::string &caminhoArquivo, const std::string &diretorioCheckpoints,
+                             const std::function<void(const RegistroCotacao &)> &consumir, size_t *registrosNovos,
+                             ContagemLinhas *descartadas)
+{
+    struct stat informacoes;
+    std::ifstream arquivo(caminhoArquivo, std::ios::binary);
+    if (!arquivo.is_open() || stat(caminhoArquivo.c_str(), &informacoes) != 0)
+    {
+        return false;
+    }
+
+    bool usarCheckpoint = !diretorioCheckpoints.empty();
+    std::string caminhoCkpt = usarCheckpoint ? caminhoCheckpoint(diretorioCheckpoints, caminhoArquivo) : "";
+    uint64_t tamanhoArquivo = static_cast<uint64_t>(informacoes.st_size);
+    bool compactado = ArquivoZip::ehZip(caminhoArquivo);
+
+    Cabecalho cabecalho;
+    bool aproveitado = false;
+    std::ifstream entrada;
+    std::unique_ptr<TravaCheckpoint> trava;
+    if (usarCheckpoint)
+    {
+        trava = std::make_unique<TravaCheckpoint>(caminhoCkpt);
+        struct stat informacoesCkpt;
+        entrada.open(caminhoCkpt, std::ios::binary);
+        aproveitado = entrada.is_open() && stat(caminhoCkpt.c_str(), &informacoesCkpt) == 0 &&
+                      lerCabecalho(entrada, &cabecalho) &&
+                      static_cast<uint64_t>(informacoesCkpt.st_size) ==
+                          static_cast<uint64_t>(TAMANHO_CABECALHO) + cabecalho.bytesRegistros &&
+                      cabecalho.dispositivo == static_cast<uint64_t>(informacoes.st_dev) &&
+                      cabecalho.inode == static_cast<uint64_t>(informacoes.st_ino) &&
+                      cabecalho.deslocamento <= tamanhoArquivo;
+
+        if (aproveitado)
+        {
+            Cabecalho conferencia = cabecalho;
+            somarExtremos(arquivo, &conferencia);
+            aproveitado = conferencia.somaInicio == cabecalho.somaInicio && conferencia.somaFim == cabecalho.somaFim;
+        }
+
+        // Um ZIP não cresce por acréscimo: ou o checkpoint cobre o arquivo inteiro, ou é refeito
+        aproveitado = aproveitado && (!compactado || cabecalho.deslocamento == tamanhoArquivo);
+
+        if (!aproveitado && entrada.is_open())
+        {
+            std::cerr << "Aviso: checkpoint de " << caminhoArquivo
+                      << " não confere (arquivo regravado ou truncado); lendo o arquivo inteiro." << std::endl;
+        }
+    }
+
+    // O corpo inteiro é conferido antes de entregar qualquer registro: um checkpoint corrompido
+    // não pode deixar registros pela metade em quem consome, e então o arquivo é lido do início
+    if (aproveitado)
+    {
+        std::string corpo(cabecalho.bytesRegistros, '\0');
+        aproveitado = (corpo.empty() || entrada.read(&corpo[0], static_cast<std::streamsize>(corpo.size()))) &&
+                      lerRegistros(corpo, cabecalho.registros, nullptr);
+        if (aproveitado)
+        {
+            lerRegistros(corpo, cabecalho.registros, &consumir);
+        }
+        else
+        {
+            std::cerr << "Aviso: checkpoint de " << caminhoArquivo << " corrompido; lendo o arquivo inteiro."
+                      << std::endl;
+            std::remove(caminhoCkpt.c_str());
+        }
+    }
+
+    RegistroCotacao registro;
+    if (!aproveitado)
+    {
+        cabecalho = Cabecalho();
+        cabecalho.dispositivo = static_cast<uint64_t>(informacoes.st_dev);
+        cabecalho.inode = static_cast<uint64_t>(informacoes.st_ino);
+    }
+    entrada.close();
+
+    // Nada acrescentado desde o checkpoint: não há o que interpretar nem gravar
+    if (aproveitado && cabecalho.deslocamento == tamanhoArquivo)
+    {
+        if (registrosNovos)
+        {
+            *registrosNovos = 0;
+        }
+        if (descartadas)
+        {
+            descartadas->curtas = cabecalho.linhasCurtas;
+            descartadas->invalidas = cabecalho.linhasInvalidas;
+        }
+        return true;
+    }
+
+    std::string caminhoSaida = aproveitado ? caminhoCkpt : caminhoCkpt + "." + std::to_string(getpid()) + ".tmp";
+    std::fstream saida;
+    if (usarCheckpoint)
+    {
+        saida.open(caminhoSaida, aproveitado ? std::ios::binary | std::ios::in | std::ios::out
+                                             : std::ios::binary | std::ios::out | std::ios::trunc);
+        if (aproveitado)
+        {
+            saida.seekp(TAMANHO_CABECALHO + static_cast<std::streamoff>(cabecalho.bytesRegistros));
+        }
+        else
+        {
+            escreverCabecalho(saida, cabecalho);
+        }
+    }
+
+    // Uma leitura interrompida não pode deixar registros a mais no checkpoint: o acrescentado é desfeito
+    uint64_t bytesAnteriores = cabecalho.bytesRegistros;
+    auto descartarSaida = [&]() {
+        if (!saida.is_open())
+        {
+            return;
+        }
+        saida.close();
+        if (aproveitado)
+        {
+            truncate(caminhoSaida.c_str(), static_cast<off_t>(TAMANHO_CABECALHO + bytesAnteriores));
+        }
+        else
+        {
+            std::remove(caminhoSaida.c_str());
+        }
+    };
+
+    size_t novos = 0;
+    bool gravar = true;
+    auto interpretar = [&](const std::string &linha) {
+        if (LeitorCotahist::interpretarLinha(linha, &registro))
+        {
+            consumir(registro);
+            novos++;
+            if (saida.is_open() && gravar)
+            {
+                cabecalho.bytesRegistros += escreverRegistro(saida, registro);
+                cabecalho.registros++;
+            }
+            return;
+        }
+
+        // Registros de controle (00 cabeçalho, 99 trailer) não são cotações, mas também não são erros
+        size_t tamanho = linha.size() - (!linha.empty() && linha.back() == '\r' ? 1 : 0);
+        if (!gravar)
+        {
+            return;
+        }
+        if (tamanho > 0 && tamanho < LeitorCotahist::TAMANHO_MINIMO_LINHA)
+        {
+            cabecalho.linhasCurtas++;
+        }
+        else if (tamanho > 0 && linha.compare(0, 2, "00") != 0 && linha.compare(0, 2, "99") != 0)
+        {
+            cabecalho.linhasInvalidas++;
+        }
+    };
+
+    if (compactado)
+    {
+        if (!ArquivoZip::lerLinhas(caminhoArquivo, interpretar))
+        {
+            descartarSaida();
+            return false;
+        }
+        cabecalho.deslocamento = tamanhoArquivo;
+    }
+    else
+    {
+        // Uma última linha sem '\n' é entregue, mas não entra no checkpoint nem no deslocamento:
+        // se ainda está sendo escrita, a próxima carga a lê de novo por inteiro
+        uint64_t consumido = 0;
+        std::string linhaFinal;
+        if (!LeitorArquivo::lerLinhas(caminhoArquivo, cabecalho.deslocamento, interpretar, &consumido, &linhaFinal))
+        {
+            std::cerr << "Erro: leitura de " << caminhoArquivo << " interrompida em "
+                      << cabecalho.deslocamento + consumido << " bytes." << std::endl;
+            descartarSaida();
+            return false;
+        }
+        cabecalho.deslocamento += consumido;
+        if (!linhaFinal.empty())
+        {
+            gravar = false;
+            interpretar(linhaFinal);
+        }
+    }
+
+    if (registrosNovos)
+    {
+        *registrosNovos = novos;
+    }
+    if (descartadas)
+    {
+        descartadas->curtas = cabecalho.linhasCurtas;
+        descartadas->invalidas = cabecalho.linhasInvalidas;
+    }
+
+    if (saida.is_open())
+    {
+        somarExtremos(arquivo, &cabecalho);
+        saida.flush();
+        saida.seekp(0);
+        escreverCabecalho(saida, cabecalho);
+        saida.close();
+
+        if (!saida)
+        {
+            std::cerr << "Aviso: não foi possível gravar o checkpoint " << caminhoCkpt << std::endl;
+            std::remove(caminhoSaida.c_str());
+        }
+        else if (!aproveitado && std::rename(caminhoSaida.c_str(), caminhoCkpt.c_str()) != 0)
+        {
+            std::remove(caminhoSaida.c_str());
+        }
+    }
+    else if (usarCheckpoint)
+    {
+        std::cerr << "Aviso: não foi possível gravar o checkpoint " << caminhoCkpt << std::endl;
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef CHECKPOINTCOTAHIST_HPP_INCLUDED
+#define CHECKPOINTCOTAHIST_HPP_INCLUDED
+
+#include "LeitorCotahist.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Linhas de um arquivo que não viraram registro
+ *
+ * @details Os registros de controle da B3 (tipos 00 e 99, cabeçalho e trailer)
+ * não são contados como inválidos.
+ */
+struct ContagemLinhas
+{
+    uint64_t curtas = 0;    ///< Menores que LeitorCotahist::TAMANHO_MINIMO_LINHA, vazias à parte
+    uint64_t invalidas = 0; ///< Com tamanho suficiente, mas campos fora do formato
+};
+
+/**
+ * @brief Leitura incremental de arquivos COTAHIST com checkpoint em disco
+ *
+ * @details Arquivos que crescem por acréscimo (ex.: o diário durante o pregão)
+ * não precisam ser relidos desde o início a cada carga. Depois de ler um
+ * arquivo, grava-se ao lado dele, no diretório de checkpoints, o identificador
+ * do arquivo (dispositivo e inode), o deslocamento do fim da última linha
+ * completa, a quantidade de registros e de linhas descartadas, somas FNV-1a
+ * (ImpressaoArquivo) do primeiro e do último bloco consumidos e os próprios registros já
+ * interpretados. Na carga seguinte, se o checkpoint confere, os registros vêm
+ * dele e só os bytes acrescentados são interpretados.
+ *
+ * Um arquivo com outro inode, menor que o deslocamento salvo ou com blocos
+ * diferentes dos somados foi regravado ou truncado: o checkpoint é descartado
+ * e o arquivo é lido por inteiro. O mesmo vale para um checkpoint cujo corpo
+ * não se interpreta; o corpo é conferido antes de qualquer registro ser
+ * entregue.
+ *
+ * Cargas simultâneas do mesmo arquivo, em processos diferentes, se revezam
+ * por uma trava (flock) em "<checkpoint>.lock".
+ *
+ * Arquivos .zip são descompactados em fluxo por ArquivoZip; como não crescem
+ * por acréscimo, o checkpoint de um ZIP só é aproveitado se cobre o arquivo
+ * inteiro.
+ */
+class CheckpointCotahist
+{
+  public:
+    /**
+     * @brief Caminho do checkpoint de um arquivo
+     *
+     * @param diretorioCheckpoints Diretório onde ficam os checkpoints
+     * @param caminhoArquivo Arquivo COTAHIST
+     * @return std::string Caminho "<diretório>/<nome do arquivo>.ckpt"
+     */
+    static std::string caminhoCheckpoint(const std::string &diretorioCheckpoints, const std::string &caminhoArquivo);
+
+    /**
+     * @brief Lê os registros de um arquivo, aproveitando e atualizando o checkpoint
+     *
+     * @param caminhoArquivo Arquivo COTAHIST
+     * @param diretorioCheckpoints Diretório dos checkpoints; vazio para ler sem checkpoint
+     * @param consumir Chamada para cada registro, na ordem do arquivo
+     * @param registrosNovos Ponteiro para armazenar quantos registros foram interpretados do arquivo (opcional)
+     * @param descartadas Ponteiro para armazenar as linhas descartadas do arquivo inteiro (opcional)
+     * @return bool true se o arquivo foi lido até o fim; com false o checkpoint fica como estava
+     * @details Uma linha final sem terminador é entregue, mas pode ainda estar
+     * sendo escrita: não entra no checkpoint, e a próxima leitura a interpreta
+     * de novo a partir do último '\n'.
+     * Falhar ao gravar o checkpoint não impede a leitura.
+     */
+    static bool ler(const std::string &caminhoArquivo, const std::string &diretorioCheckpoints,
+                    const std::function<void(const RegistroCotacao &)> &consumir, size_t *registrosNovos = nullptr,
+                    ContagemLinhas *descartadas = nullptr);
+};
+
+#endif // CHECKPOINTCOTAHIST_HPP_INCLUDED
@@ -0,0 +1,457 @@
+#include "CotacoesCompartilhadas.hpp"
+#include "ImpressaoArquivo.hpp"
+#include "IndiceCotacoes.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <numeric>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+const std::string CotacoesCompartilhadas::DIRETORIO_SEGMENTOS = "/dev/shm";
+
+namespace
+{
+const char ASSINATURA[8] = {'S', 'H', 'M', 'C', 'O', 'T', '0', '2'};
+const size_t TAMANHO_CODIGO = 12;
+
+/**
+ * @brief Cabeçalho do segmento
+ * @details Seguido, cada bloco alinhado em 8 bytes, pela tabela de códigos
+ *          (papeis × 12 bytes, completados com espaços, em ordem crescente),
+ *          pelos inícios de faixa (papeis + 1 inteiros de 32 bits), pelas
+ *          datas e pelos preços médios (64 bits) de cada registro.
+ */
+struct Cabecalho
+{
+    char assinatura[8];
+    uint64_t dispositivo;
+    uint64_t inode;
+    uint64_t tamanhoArquivo;
+    int64_t modificacaoSegundos;
+    int64_t modificacaoNanossegundos;
+    uint64_t papeis;
+    uint64_t registros;
+};
+
+static_assert(sizeof(Cabecalho) == 64, "cabeçalho do segmento sem preenchimento");
+
+size_t alinhar(size_t deslocamento)
+{
+    return (deslocamento + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * @brief Posições dos blocos do segmento
+ */
+struct Disposicao
+{
+    size_t papeis;
+    size_t inicios;
+    size_t datas;
+    size_t precos;
+    size_t total;
+
+    Disposicao(uint64_t quantidadePapeis, uint64_t quantidadeRegistros)
+    {
+        papeis = sizeof(Cabecalho);
+        inicios = alinhar(papeis + static_cast<size_t>(quantidadePapeis) * TAMANHO_CODIGO);
+        datas = alinhar(inicios + static_cast<size_t>(quantidadePapeis + 1) * sizeof(uint32_t));
+        precos = alinhar(datas + static_cast<size_t>(quantidadeRegistros) * sizeof(uint32_t));
+        total = precos + static_cast<size_t>(quantidadeRegistros) * sizeof(int64_t);
+    }
+};
+
+void identificarArquivo(const struct stat &informacoes, Cabecalho *cabecalho)
+{
+    cabecalho->dispositivo = static_cast<uint64_t>(informacoes.st_dev);
+    cabecalho->inode = static_cast<uint64_t>(informacoes.st_ino);
+    cabecalho->tamanhoArquivo = static_cast<uint64_t>(informacoes.st_size);
+    cabecalho->modificacaoSegundos = static_cast<int64_t>(informacoes.st_mtim.tv_sec);
+    cabecalho->modificacaoNanossegundos = static_cast<int64_t>(informacoes.st_mtim.tv_nsec);
+}
+
+std::string codigoPreenchido(const std::string &codigo)
+{
+    std::string preenchido = codigo.substr(0, TAMANHO_CODIGO);
+    preenchido.resize(TAMANHO_CODIGO, ' ');
+    return preenchido;
+}
+} // namespace
+
+CotacoesCompartilhadas::CotacoesCompartilhadas()
+    : mapa(nullptr), tamanhoMapa(0), quantidadePapeisSegmento(0), quantidadeRegistrosSegmento(0),
+      tabelaPapeis(nullptr), inicioPapel(nullptr), colunaData(nullptr), colunaPreco(nullptr)
+{
+}
+
+CotacoesCompartilhadas::~CotacoesCompartilhadas()
+{
+    desanexar();
+}
+
+void CotacoesCompartilhadas::desanexar()
+{
+    if (mapa)
+    {
+        munmap(const_cast<unsigned char *>(mapa), tamanhoMapa);
+    }
+
+    mapa = nullptr;
+    tamanhoMapa = 0;
+    quantidadePapeisSegmento = 0;
+    quantidadeRegistrosSegmento = 0;
+    tabelaPapeis = nullptr;
+    inicioPapel = nullptr;
+    colunaData = nullptr;
+    colunaPreco = nullptr;
+    nome.clear();
+}
+
+/**
+ * @brief Nome do segmento de um arquivo de dados
+ * @details FNV-1a do caminho absoluto, para que processos que recebem o mesmo
+ *          arquivo por caminhos relativos diferentes usem o mesmo segmento.
+ */
+std::string CotacoesCompartilhadas::nomeSegmento(const std::string &caminhoArquivo)
+{
+    char absoluto[PATH_MAX];
+    std::string caminho = realpath(caminhoArquivo.c_str(), absoluto) ? std::string(absoluto) : caminhoArquivo;
+
+    uint64_t soma = ImpressaoArquivo::somarFnv(caminho.data(), caminho.size());
+
+    char nome[32];
+    std::snprintf(nome, sizeof(nome), "/cotacoes-%016llx", static_cast<unsigned long long>(soma));
+    return nome;
+}
+
+/**
+ * @brief Monta o segmento a partir do arquivo de dados e o publica
+ * @details O índice é carregado como de costume e copiado para um segmento
+ *          temporário exclusivo deste processo, que depois é renomeado para o
+ *          nome definitivo. Dentro de cada papel a ordem das datas é a do
+ *          índice, inclusive para registros repetidos, de modo que a busca
+ *          encontra o mesmo registro que o índice em memória.
+ */
+bool CotacoesCompartilhadas::montar(const std::string &caminhoArquivo, const std::string &nomeSegmento)
+{
+    struct stat informacoes;
+    if (stat(caminhoArquivo.c_str(), &informacoes) != 0)
+    {
+        return false;
+    }
+
+    IndiceCotacoes indice;
+    if (!indice.carregar(caminhoArquivo))
+    {
+        return false;
+    }
+
+    // Faixa de cada papel nas colunas do índice, com os papéis em ordem alfabética
+    std::vector<std::string> codigos;
+    std::vector<uint32_t> inicios;
+    std::string codigo;
+    for (size_t posicao = 0; posicao < indice.quantidadeRegistros(); posicao++)
+    {
+        indice.obterRegistro(posicao, &codigo, nullptr, nullptr);
+        if (codigos.empty() || codigos.back() != codigo)
+        {
+            codigos.push_back(codigo);
+            inicios.push_back(static_cast<uint32_t>(posicao));
+        }
+    }
+    inicios.push_back(static_cast<uint32_t>(indice.quantidadeRegistros()));
+
+    std::vector<uint32_t> ordem(codigos.size());
+    std::iota(ordem.begin(), ordem.end(), 0);
+    std::sort(ordem.begin(), ordem.end(),
+              [&](uint32_t a, uint32_t b) { return codigoPreenchido(codigos[a]) < codigoPreenchido(codigos[b]); });
+
+    Cabecalho cabecalho;
+    std::memset(&cabecalho, 0, sizeof(cabecalho));
+    std::memcpy(cabecalho.assinatura, ASSINATURA, sizeof(ASSINATURA));
+    identificarArquivo(informacoes, &cabecalho);
+    cabecalho.papeis = codigos.size();
+    cabecalho.registros = indice.quantidadeRegistros();
+    Disposicao disposicao(cabecalho.papeis, cabecalho.registros);
+
+    // Só o próprio usuário lê o segmento: as cotações são dele, e mapear() recusa segmentos de outro dono
+    std::string temporario = nomeSegmento + "." + std::to_string(getpid()) + ".tmp";
+    int fd = shm_open(temporario.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    void *endereco = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(disposicao.total)) == 0)
+    {
+        endereco = mmap(nullptr, disposicao.total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (endereco == MAP_FAILED)
+    {
+        shm_unlink(temporario.c_str());
+        return false;
+    }
+
+    unsigned char *destino = static_cast<unsigned char *>(endereco);
+    std::memcpy(destino, &cabecalho, sizeof(cabecalho));
+    char *tabela = reinterpret_cast<char *>(destino + disposicao.papeis);
+    uint32_t *novosInicios = reinterpret_cast<uint32_t *>(destino + disposicao.inicios);
+    uint32_t *datas = reinterpret_cast<uint32_t *>(destino + disposicao.datas);
+    int64_t *precos = reinterpret_cast<int64_t *>(destino + disposicao.precos);
+
+    uint32_t escrito = 0;
+    for (size_t i = 0; i < ordem.size(); i++)
+    {
+        uint32_t id = ordem[i];
+        std::memcpy(tabela + i * TAMANHO_CODIGO, codigoPreenchido(codigos[id]).data(), TAMANHO_CODIGO);
+        novosInicios[i] = escrito;
+        for (uint32_t posicao = inicios[id]; posicao < inicios[id + 1]; posicao++, escrito++)
+        {
+            long long preco;
+            indice.obterRegistro(posicao, nullptr, &datas[escrito], &preco);
+            precos[escrito] = preco;
+        }
+    }
+    novosInicios[ordem.size()] = escrito;
+    munmap(endereco, disposicao.total);
+
+    std::string origem = DIRETORIO_SEGMENTOS + temporario;
+    std::string destinoFinal = DIRETORIO_SEGMENTOS + nomeSegmento;
+    if (std::rename(origem.c_str(), destinoFinal.c_str()) != 0)
+    {
+        shm_unlink(temporario.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Mapeia o segmento e confere se ele corresponde ao arquivo de dados
+ * @details /dev/shm é compartilhado por todos os usuários: um segmento com o
+ *          nome esperado mas de outro dono é recusado (e remontado por cima).
+ *          As faixas dos papéis são conferidas uma vez aqui, para que as
+ *          consultas possam indexar as colunas sem verificar limites.
+ */
+bool CotacoesCompartilhadas::mapear(const std::string &nomeSegmento, const struct stat &arquivo)
+{
+    int fd = shm_open(nomeSegmento.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat informacoes;
+    void *endereco = MAP_FAILED;
+    if (fstat(fd, &informacoes) == 0 && informacoes.st_uid == geteuid() &&
+        static_cast<size_t>(informacoes.st_size) >= sizeof(Cabecalho))
+    {
+        endereco = mmap(nullptr, static_cast<size_t>(informacoes.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (endereco == MAP_FAILED)
+    {
+        return false;
+    }
+
+    Cabecalho gravado;
+    Cabecalho atual;
+    std::memcpy(&gravado, endereco, sizeof(gravado));
+    identificarArquivo(arquivo, &atual);
+    // Contagens maiores que o segmento fariam a conta da disposição transbordar
+    size_t tamanho = static_cast<size_t>(informacoes.st_size);
+    bool plausivel = gravado.papeis <= tamanho / TAMANHO_CODIGO && gravado.registros <= tamanho / sizeof(uint32_t);
+    Disposicao disposicao(plausivel ? gravado.papeis : 0, plausivel ? gravado.registros : 0);
+    bool confere = plausivel && std::memcmp(gravado.assinatura, ASSINATURA, sizeof(ASSINATURA)) == 0 &&
+                   gravado.dispositivo == atual.dispositivo && gravado.inode == atual.inode &&
+                   gravado.tamanhoArquivo == atual.tamanhoArquivo &&
+                   gravado.modificacaoSegundos == atual.modificacaoSegundos &&
+                   gravado.modificacaoNanossegundos == atual.modificacaoNanossegundos &&
+                   disposicao.total == tamanho;
+
+    // Inícios de faixa crescentes, começando em 0 e terminando no total de registros
+    const uint32_t *inicios = reinterpret_cast<const uint32_t *>(static_cast<const unsigned char *>(endereco) +
+                                                                 disposicao.inicios);
+    for (uint64_t papel = 0; confere && papel < gravado.papeis; papel++)
+    {
+        confere = inicios[papel] <= inicios[papel + 1];
+    }
+    confere = confere && inicios[0] == 0 && inicios[gravado.papeis] == gravado.registros;
+    if (!confere)
+    {
+        munmap(endereco, static_cast<size_t>(informacoes.st_size));
+        return false;
+    }
+
+    mapa = static_cast<const unsigned char *>(endereco);
+    tamanhoMapa = disposicao.total;
+    quantidadePapeisSegmento = gravado.papeis;
+    quantidadeRegistrosSegmento = gravado.registros;
+    tabelaPapeis = reinterpret_cast<const char *>(mapa + disposicao.papeis);
+    inicioPapel = reinterpret_cast<const uint32_t *>(mapa + disposicao.inicios);
+    colunaData = reinterpret_cast<const uint32_t *>(mapa + disposicao.datas);
+    colunaPreco = reinterpret_cast<const int64_t *>(mapa + disposicao.precos);
+    nome = nomeSegmento;
+    return true;
+}
+
+/**
+ * @brief Anexa o segmento do arquivo, montando-o se não existe ou está desatualizado
+ * @details Dois processos que montam ao mesmo tempo publicam segmentos
+ *          equivalentes; prevalece o último rename, e ambos anexam o que
+ *          estiver publicado.
+ */
+bool CotacoesCompartilhadas::anexar(const std::string &caminhoArquivo, bool *montado)
+{
+    desanexar();
+    if (montado)
+    {
+        *montado = false;
+    }
+
+    struct stat informacoes;
+    if (stat(caminhoArquivo.c_str(), &informacoes) != 0)
+    {
+        return false;
+    }
+
+    std::string nomeDoArquivo = nomeSegmento(caminhoArquivo);
+    if (mapear(nomeDoArquivo, informacoes))
+    {
+        return true;
+    }
+
+    std::cerr << "Montando cotações em memória compartilhada (" << DIRETORIO_SEGMENTOS << nomeDoArquivo << ")..."
+              << std::endl;
+    if (!montar(caminhoArquivo, nomeDoArquivo) || !mapear(nomeDoArquivo, informacoes))
+    {
+        std::cerr << "Erro: Não foi possível montar o segmento de cotações de " << caminhoArquivo << std::endl;
+        return false;
+    }
+
+    if (montado)
+    {
+        *montado = true;
+    }
+    return true;
+}
+
+bool CotacoesCompartilhadas::remover(const std::string &caminhoArquivo)
+{
+    return shm_unlink(nomeSegmento(caminhoArquivo).c_str()) == 0;
+}
+
+bool CotacoesCompartilhadas::localizarPapel(const std::string &codigoNegociacao, uint64_t *papel) const
+{
+    if (!mapa)
+    {
+        return false;
+    }
+
+    std::string codigo = LeitorCotahist::limparCampo(codigoNegociacao);
+    if (codigo.empty() || codigo.size() > TAMANHO_CODIGO)
+    {
+        return false;
+    }
+    std::string chave = codigoPreenchido(codigo);
+
+    uint64_t inicio = 0;
+    uint64_t fim = quantidadePapeisSegmento;
+    while (inicio < fim)
+    {
+        uint64_t meio = inicio + (fim - inicio) / 2;
+        if (std::memcmp(tabelaPapeis + meio * TAMANHO_CODIGO, chave.data(), TAMANHO_CODIGO) < 0)
+        {
+            inicio = meio + 1;
+        }
+        else
+        {
+            fim = meio;
+        }
+    }
+    if (inicio == quantidadePapeisSegmento ||
+        std::memcmp(tabelaPapeis + inicio * TAMANHO_CODIGO, chave.data(), TAMANHO_CODIGO) != 0)
+    {
+        return false;
+    }
+
+    *papel = inicio;
+    return true;
+}
+
+bool CotacoesCompartilhadas::buscarPreco(const std::string &codigoNegociacao, uint32_t data,
+                                         long long *precoCentavos) const
+{
+    uint64_t papel;
+    if (!localizarPapel(codigoNegociacao, &papel))
+    {
+        return false;
+    }
+
+    const uint32_t *primeira = colunaData + inicioPapel[papel];
+    const uint32_t *ultima = colunaData + inicioPapel[papel + 1];
+    const uint32_t *encontrada = std::lower_bound(primeira, ultima, data);
+    if (encontrada == ultima || *encontrada != data)
+    {
+        return false;
+    }
+
+    if (precoCentavos)
+    {
+        *precoCentavos = colunaPreco[encontrada - colunaData];
+    }
+    return true;
+}
+
+bool CotacoesCompartilhadas::obterDatas(const std::string &codigoNegociacao, DatasPapel *datas) const
+{
+    uint64_t papel;
+    if (!datas || !localizarPapel(codigoNegociacao, &papel))
+    {
+        return false;
+    }
+
+    datas->inicio = colunaData + inicioPapel[papel];
+    datas->fim = colunaData + inicioPapel[papel + 1];
+    return true;
+}
+
+bool CotacoesCompartilhadas::contem(const std::string &codigoNegociacao, uint32_t data) const
+{
+    return buscarPreco(codigoNegociacao, data, nullptr);
+}
+
+/**
+ * @brief Lê um papel da tabela de códigos do segmento
+ * @details A faixa do papel guarda os registros repetidos do índice; cada data
+ *          é contada uma vez.
+ */
+bool CotacoesCompartilhadas::obterPapel(size_t papel, std::string *codigoNegociacao, size_t *pregoes) const
+{
+    if (!mapa || papel >= quantidadePapeisSegmento)
+    {
+        return false;
+    }
+
+    if (codigoNegociacao)
+    {
+        *codigoNegociacao = LeitorCotahist::limparCampo(std::string(tabelaPapeis + papel * TAMANHO_CODIGO,
+                                                                    TAMANHO_CODIGO));
+    }
+    if (pregoes)
+    {
+        *pregoes = 0;
+        for (uint32_t i = inicioPapel[papel]; i < inicioPapel[papel + 1]; i++)
+        {
+            *pregoes += (i == inicioPapel[papel] || colunaData[i] != colunaData[i - 1]) ? 1 : 0;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,162 @@
+#ifndef COTACOESCOMPARTILHADAS_HPP_INCLUDED
+#define COTACOESCOMPARTILHADAS_HPP_INCLUDED
+
+#include "IndiceCotacoes.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/stat.h>
+
+/**
+ * @brief Cotações em memória compartilhada entre processos
+ *
+ * @details Cada sessão de terminal é um processo, e cada uma montaria seu
+ * próprio IndiceCotacoes. Aqui o primeiro processo monta as colunas (códigos
+ * ordenados, faixas por papel, datas e preços médios) em um segmento POSIX de
+ * memória compartilhada, e os seguintes apenas o mapeiam somente leitura: a
+ * memória fica constante qualquer que seja o número de sessões, e a
+ * inicialização vira um mmap.
+ *
+ * O segmento é montado com um nome temporário e publicado por rename em
+ * DIRETORIO_SEGMENTOS, de modo que nenhum processo enxerga um segmento pela
+ * metade e não há trava entre processos. O cabeçalho guarda dispositivo,
+ * inode, tamanho e data de modificação do arquivo de dados; se o arquivo
+ * mudou, o processo que percebe monta um segmento novo e o publica por cima.
+ * Processos que já tinham mapeado o anterior continuam com ele até encerrar.
+ *
+ * Depende de /dev/shm (Linux). Depois de anexado, pode ser consultado por
+ * várias threads.
+ */
+class CotacoesCompartilhadas
+{
+  private:
+    const unsigned char *mapa;
+    size_t tamanhoMapa;
+    uint64_t quantidadePapeisSegmento;
+    uint64_t quantidadeRegistrosSegmento;
+    const char *tabelaPapeis;
+    const uint32_t *inicioPapel;
+    const uint32_t *colunaData;
+    const int64_t *colunaPreco;
+    std::string nome;
+
+    void desanexar();
+    bool localizarPapel(const std::string &codigoNegociacao, uint64_t *papel) const;
+    bool mapear(const std::string &nomeSegmento, const struct stat &arquivo);
+    static bool montar(const std::string &caminhoArquivo, const std::string &nomeSegmento);
+
+  public:
+    /**
+     * @brief Diretório em que o Linux expõe os segmentos de shm_open
+     */
+    static const std::string DIRETORIO_SEGMENTOS;
+
+    CotacoesCompartilhadas();
+    ~CotacoesCompartilhadas();
+
+    CotacoesCompartilhadas(const CotacoesCompartilhadas &) = delete;
+    CotacoesCompartilhadas &operator=(const CotacoesCompartilhadas &) = delete;
+
+    /**
+     * @brief Nome do segmento de um arquivo de dados
+     *
+     * @param caminhoArquivo Arquivo COTAHIST
+     * @return std::string "/cotacoes-<hash do caminho absoluto>"
+     */
+    static std::string nomeSegmento(const std::string &caminhoArquivo);
+
+    /**
+     * @brief Anexa o segmento do arquivo, montando-o se não existe ou está desatualizado
+     *
+     * @param caminhoArquivo Arquivo COTAHIST (texto ou ZIP)
+     * @param montado Ponteiro para indicar se este processo montou o segmento (opcional)
+     * @return bool true se o segmento está anexado
+     */
+    bool anexar(const std::string &caminhoArquivo, bool *montado = nullptr);
+
+    /**
+     * @brief Remove o segmento do arquivo do sistema
+     *
+     * @param caminhoArquivo Arquivo COTAHIST
+     * @return bool true se havia segmento
+     * @details Processos anexados continuam com o mapeamento até encerrar.
+     */
+    static bool remover(const std::string &caminhoArquivo);
+
+    /**
+     * @brief Busca o preço médio de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param data Data no formato AAAAMMDD
+     * @param precoCentavos Ponteiro para armazenar o preço em centavos
+     * @return bool true se a combinação existe
+     */
+    bool buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos) const;
+
+    /**
+     * @brief Verifica se existe cotação para um papel em uma data
+     */
+    bool contem(const std::string &codigoNegociacao, uint32_t data) const;
+
+    /**
+     * @brief Datas em que um papel tem cotação, apontando direto para o segmento
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param datas Fatia da coluna de datas; o dono fica a cargo de quem segura o segmento
+     * @return bool true se o segmento conhece o papel
+     */
+    bool obterDatas(const std::string &codigoNegociacao, DatasPapel *datas) const;
+
+    /**
+     * @brief Lê um papel da tabela de códigos do segmento
+     *
+     * @param papel Papel entre 0 e quantidadePapeis() - 1, em ordem alfabética
+     * @param codigoNegociacao Ponteiro para armazenar o código (opcional)
+     * @param pregoes Ponteiro para armazenar a quantidade de datas distintas do papel (opcional)
+     * @return bool true se o papel existe
+     * @details O segmento não guarda o nome resumido.
+     */
+    bool obterPapel(size_t papel, std::string *codigoNegociacao, size_t *pregoes) const;
+
+    /**
+     * @brief Indica se há segmento anexado
+     */
+    bool estaAnexado() const
+    {
+        return mapa != nullptr;
+    }
+
+    /**
+     * @brief Nome do segmento anexado
+     */
+    const std::string &getNome() const
+    {
+        return nome;
+    }
+
+    /**
+     * @brief Tamanho do segmento anexado, em bytes
+     */
+    size_t getTamanho() const
+    {
+        return tamanhoMapa;
+    }
+
+    /**
+     * @brief Quantidade de registros no segmento
+     */
+    size_t quantidadeRegistros() const
+    {
+        return static_cast<size_t>(quantidadeRegistrosSegmento);
+    }
+
+    /**
+     * @brief Quantidade de papéis distintos no segmento
+     */
+    size_t quantidadePapeis() const
+    {
+        return static_cast<size_t>(quantidadePapeisSegmento);
+    }
+};
+
+#endif // COTACOESCOMPARTILHADAS_HPP_INCLUDED
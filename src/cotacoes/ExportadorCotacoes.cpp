@@ -0,0 +1,675 @@
+#include "ExportadorCotacoes.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+
+namespace
+{
+static_assert(sizeof(long long) == sizeof(int64_t), "colunas do índice gravadas direto como Int64 do Arrow");
+
+const int32_t CONTINUACAO_ARROW = -1;    ///< 0xFFFFFFFF antes de cada mensagem
+const uint16_t VERSAO_METADADOS_V5 = 4;  ///< MetadataVersion.V5
+const uint8_t CABECALHO_ESQUEMA = 1;     ///< MessageHeader.Schema
+const uint8_t CABECALHO_LOTE = 3;        ///< MessageHeader.RecordBatch
+const uint8_t TIPO_ARROW_INT = 2;        ///< Type.Int
+const uint8_t TIPO_ARROW_UTF8 = 5;       ///< Type.Utf8
+const uint8_t TIPO_ARROW_DATE = 8;       ///< Type.Date
+const size_t LIMITE_BUFFER_CSV = 1 << 16; ///< Bytes de texto acumulados antes de escrever no fluxo
+
+/**
+ * @brief Campo escalar de uma tabela flatbuffers
+ */
+struct Escalar
+{
+    uint16_t id;
+    uint8_t tamanho; ///< 1, 2, 4 ou 8 bytes
+    uint64_t valor;
+};
+
+/**
+ * @brief Montador mínimo de flatbuffers para os metadados do Arrow IPC
+ * @details Escreve de frente para trás: a raiz vem primeiro, cada tabela é
+ *          precedida da sua vtable e os objetos apontados (textos, vetores,
+ *          subtabelas) são escritos depois de quem aponta, de modo que todo
+ *          deslocamento é positivo, como o formato exige. Escalares são sempre
+ *          gravados, mesmo com o valor padrão do esquema (a unidade DAY de Date
+ *          é 0, e o padrão é MILLISECOND). Supõe máquina little-endian.
+ */
+class Flatbuffer
+{
+  public:
+    std::string dados;
+
+    Flatbuffer()
+    {
+        anexar<uint32_t>(0); // Deslocamento da raiz, preenchido por raiz()
+    }
+
+    void alinhar(size_t alinhamento, size_t adiante = 0)
+    {
+        while ((dados.size() + adiante) % alinhamento != 0)
+        {
+            dados.push_back('\0');
+        }
+    }
+
+    template <typename T> void anexar(T valor)
+    {
+        dados.append(reinterpret_cast<const char *>(&valor), sizeof(valor));
+    }
+
+    /**
+     * @brief Faz o campo de deslocamento em uma posição apontar para um objeto já escrito
+     */
+    void apontar(size_t campo, size_t alvo)
+    {
+        uint32_t deslocamento = static_cast<uint32_t>(alvo - campo);
+        std::memcpy(&dados[campo], &deslocamento, sizeof(deslocamento));
+    }
+
+    void raiz(size_t tabela)
+    {
+        apontar(0, tabela);
+    }
+
+    /**
+     * @brief Escreve uma tabela
+     * @param escalares Campos escalares com seus valores
+     * @param ponteiros Ids dos campos que apontam para outros objetos
+     * @param posicoes Posições desses campos, na ordem de ponteiros, para apontar() depois
+     * @return Posição da tabela
+     */
+    size_t tabela(std::initializer_list<Escalar> escalares, std::initializer_list<uint16_t> ponteiros = {},
+                  std::vector<size_t> *posicoes = nullptr)
+    {
+        struct Entrada
+        {
+            uint16_t id;
+            size_t tamanho;
+            uint64_t valor;
+            bool ponteiro;
+            size_t deslocamento;
+        };
+
+        std::vector<Entrada> entradas;
+        for (const Escalar &escalar : escalares)
+        {
+            entradas.push_back({escalar.id, escalar.tamanho, escalar.valor, false, 0});
+        }
+        for (uint16_t id : ponteiros)
+        {
+            entradas.push_back({id, sizeof(uint32_t), 0, true, 0});
+        }
+
+        // Maiores primeiro: cada campo fica alinhado ao próprio tamanho com o mínimo de preenchimento
+        std::vector<Entrada *> ordem;
+        for (Entrada &entrada : entradas)
+        {
+            ordem.push_back(&entrada);
+        }
+        std::stable_sort(ordem.begin(), ordem.end(),
+                         [](const Entrada *a, const Entrada *b) { return a->tamanho > b->tamanho; });
+
+        size_t tamanhoTabela = sizeof(int32_t);
+        uint16_t quantidadeCampos = 0;
+        for (Entrada *entrada : ordem)
+        {
+            tamanhoTabela = (tamanhoTabela + entrada->tamanho - 1) / entrada->tamanho * entrada->tamanho;
+            entrada->deslocamento = tamanhoTabela;
+            tamanhoTabela += entrada->tamanho;
+            quantidadeCampos = std::max<uint16_t>(quantidadeCampos, static_cast<uint16_t>(entrada->id + 1));
+        }
+
+        alinhar(sizeof(uint16_t));
+        size_t vtable = dados.size();
+        anexar<uint16_t>(static_cast<uint16_t>(sizeof(uint16_t) * (2 + quantidadeCampos)));
+        anexar<uint16_t>(static_cast<uint16_t>(tamanhoTabela));
+        for (uint16_t id = 0; id < quantidadeCampos; id++)
+        {
+            auto it = std::find_if(entradas.begin(), entradas.end(), [id](const Entrada &e) { return e.id == id; });
+            anexar<uint16_t>(it == entradas.end() ? 0 : static_cast<uint16_t>(it->deslocamento));
+        }
+
+        alinhar(sizeof(uint64_t));
+        size_t inicio = dados.size();
+        anexar<int32_t>(static_cast<int32_t>(inicio - vtable));
+        dados.resize(inicio + tamanhoTabela, '\0');
+        for (const Entrada &entrada : entradas)
+        {
+            if (!entrada.ponteiro)
+            {
+                std::memcpy(&dados[inicio + entrada.deslocamento], &entrada.valor, entrada.tamanho);
+            }
+        }
+        if (posicoes)
+        {
+            posicoes->clear();
+            for (uint16_t id : ponteiros)
+            {
+                auto it = std::find_if(entradas.begin(), entradas.end(),
+                                       [id](const Entrada &e) { return e.ponteiro && e.id == id; });
+                posicoes->push_back(inicio + it->deslocamento);
+            }
+        }
+        return inicio;
+    }
+
+    /**
+     * @brief Escreve um vetor de deslocamentos; o elemento i fica em posição + 4 + 4i
+     */
+    size_t vetorPonteiros(size_t quantidade)
+    {
+        alinhar(sizeof(uint32_t));
+        size_t inicio = dados.size();
+        anexar<uint32_t>(static_cast<uint32_t>(quantidade));
+        dados.resize(dados.size() + quantidade * sizeof(uint32_t), '\0');
+        return inicio;
+    }
+
+    /**
+     * @brief Escreve um vetor de estruturas de dois int64 (FieldNode e Buffer do Arrow)
+     */
+    size_t vetorPares(const std::vector<std::pair<int64_t, int64_t>> &pares)
+    {
+        alinhar(sizeof(int64_t), sizeof(uint32_t));
+        size_t inicio = dados.size();
+        anexar<uint32_t>(static_cast<uint32_t>(pares.size()));
+        for (const auto &par : pares)
+        {
+            anexar<int64_t>(par.first);
+            anexar<int64_t>(par.second);
+        }
+        return inicio;
+    }
+
+    size_t texto(const std::string &valor)
+    {
+        alinhar(sizeof(uint32_t));
+        size_t inicio = dados.size();
+        anexar<uint32_t>(static_cast<uint32_t>(valor.size()));
+        dados += valor;
+        dados.push_back('\0');
+        return inicio;
+    }
+};
+
+void completarOito(std::string *bytes)
+{
+    bytes->resize((bytes->size() + 7) / 8 * 8, '\0');
+}
+} // namespace
+
+const std::string ExportadorCotacoes::CAMPOS_PADRAO = "codneg,data,preabe,premax,premin,premed";
+
+ExportadorCotacoes::ExportadorCotacoes(std::ostream &saida, FormatoExportacao formato)
+    : saida(saida), formato(formato), registrosLote(0), registrosExportados(0), iniciado(false)
+{
+}
+
+bool ExportadorCotacoes::interpretarFormato(const std::string &nome, FormatoExportacao *formato)
+{
+    if (nome == "csv")
+    {
+        *formato = EXPORTACAO_CSV;
+        return true;
+    }
+    if (nome == "arrow")
+    {
+        *formato = EXPORTACAO_ARROW;
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::string> ExportadorCotacoes::separarLista(const std::string &lista)
+{
+    std::vector<std::string> itens;
+    size_t inicio = 0;
+    while (inicio <= lista.size())
+    {
+        size_t fim = std::min(lista.find(',', inicio), lista.size());
+        std::string item = LeitorCotahist::limparCampo(lista.substr(inicio, fim - inicio));
+        if (!item.empty())
+        {
+            itens.push_back(item);
+        }
+        inicio = fim + 1;
+    }
+    return itens;
+}
+
+/**
+ * @brief Converte uma data AAAAMMDD em dias desde 1970-01-01
+ * @details Contagem de dias do calendário gregoriano proléptico, em eras de 400 anos.
+ */
+int32_t ExportadorCotacoes::diasDesdeEpoca(long long data)
+{
+    long long ano = data / 10000;
+    long long mes = data / 100 % 100;
+    long long dia = data % 100;
+    ano -= mes <= 2 ? 1 : 0;
+    long long era = (ano >= 0 ? ano : ano - 399) / 400;
+    long long anoDaEra = ano - era * 400;
+    long long diaDoAno = (153 * (mes > 2 ? mes - 3 : mes + 9) + 2) / 5 + dia - 1;
+    long long diaDaEra = anoDaEra * 365 + anoDaEra / 4 - anoDaEra / 100 + diaDoAno;
+    return static_cast<int32_t>(era * 146097 + diaDaEra - 719468);
+}
+
+/**
+ * @brief Valida os campos e escreve o cabeçalho
+ * @details No Arrow, o esquema declara Int64 para os campos numéricos, Date32
+ *          (dias) para as datas e Utf8 para os textos. Datas e campos do
+ *          layout completo são anuláveis.
+ */
+bool ExportadorCotacoes::iniciar(const FiltroExportacao &filtro)
+{
+    struct DescricaoCampo
+    {
+        const char *nome;
+        CampoCotahist campo;
+        TipoCampo tipo;
+        bool soLayoutCompleto;
+    };
+    static const DescricaoCampo CAMPOS[] = {
+        {"codneg", CAMPO_CODNEG, TIPO_TEXTO, false},   {"nomres", CAMPO_NOMRES, TIPO_TEXTO, false},
+        {"codisi", CAMPO_CODISI, TIPO_TEXTO, false},   {"data", CAMPO_DATA, TIPO_DATA, false},
+        {"preabe", CAMPO_PREABE, TIPO_INTEIRO, false}, {"premax", CAMPO_PREMAX, TIPO_INTEIRO, false},
+        {"premin", CAMPO_PREMIN, TIPO_INTEIRO, false}, {"premed", CAMPO_PREMED, TIPO_INTEIRO, false},
+        {"preult", CAMPO_PREULT, TIPO_INTEIRO, true},  {"preofc", CAMPO_PREOFC, TIPO_INTEIRO, true},
+        {"preofv", CAMPO_PREOFV, TIPO_INTEIRO, true},  {"totneg", CAMPO_TOTNEG, TIPO_INTEIRO, true},
+        {"quatot", CAMPO_QUATOT, TIPO_INTEIRO, true},  {"voltot", CAMPO_VOLTOT, TIPO_INTEIRO, true},
+        {"preexe", CAMPO_PREEXE, TIPO_INTEIRO, true},  {"indopc", CAMPO_INDOPC, TIPO_INTEIRO, true},
+        {"datven", CAMPO_DATVEN, TIPO_DATA, true},     {"fatcot", CAMPO_FATCOT, TIPO_INTEIRO, true},
+        {"dismes", CAMPO_DISMES, TIPO_INTEIRO, true},  {"qualidade", QUANTIDADE_CAMPOS, TIPO_INTEIRO, false},
+    };
+
+    this->filtro = filtro;
+    colunas.clear();
+    for (std::string nome : filtro.campos.empty() ? separarLista(CAMPOS_PADRAO) : filtro.campos)
+    {
+        std::transform(nome.begin(), nome.end(), nome.begin(), [](unsigned char c) { return std::tolower(c); });
+        auto it = std::find_if(std::begin(CAMPOS), std::end(CAMPOS),
+                               [&nome](const DescricaoCampo &descricao) { return nome == descricao.nome; });
+        if (it == std::end(CAMPOS))
+        {
+            std::cerr << "Erro: campo de exportação desconhecido: " << nome << std::endl;
+            return false;
+        }
+
+        Coluna coluna;
+        coluna.nome = nome;
+        coluna.campo = it->campo;
+        coluna.tipo = it->tipo;
+        coluna.soLayoutCompleto = it->soLayoutCompleto;
+        coluna.deslocamentos.assign(1, 0);
+        colunas.push_back(std::move(coluna));
+    }
+
+    if (formato == EXPORTACAO_CSV)
+    {
+        for (size_t i = 0; i < colunas.size(); i++)
+        {
+            saida << (i == 0 ? "" : ",") << colunas[i].nome;
+        }
+        saida << '\n';
+    }
+    else
+    {
+        Flatbuffer fb;
+        std::vector<size_t> mensagem;
+        std::vector<size_t> esquema;
+        std::vector<size_t> campo;
+        fb.raiz(fb.tabela({{0, 2, VERSAO_METADADOS_V5}, {1, 1, CABECALHO_ESQUEMA}, {3, 8, 0}}, {2}, &mensagem));
+        fb.apontar(mensagem[0], fb.tabela({{0, 2, 0}}, {1}, &esquema)); // Endianness.Little
+        size_t campos = fb.vetorPonteiros(colunas.size());
+        fb.apontar(esquema[0], campos);
+
+        for (size_t i = 0; i < colunas.size(); i++)
+        {
+            const Coluna &coluna = colunas[i];
+            uint8_t tipo = coluna.tipo == TIPO_TEXTO ? TIPO_ARROW_UTF8
+                           : coluna.tipo == TIPO_DATA ? TIPO_ARROW_DATE
+                                                      : TIPO_ARROW_INT;
+            bool anulavel = coluna.tipo == TIPO_DATA || coluna.soLayoutCompleto;
+            fb.apontar(campos + 4 + 4 * i, fb.tabela({{1, 1, anulavel ? 1u : 0u}, {2, 1, tipo}}, {0, 3, 5}, &campo));
+            fb.apontar(campo[0], fb.texto(coluna.nome));
+            if (coluna.tipo == TIPO_TEXTO)
+            {
+                fb.apontar(campo[1], fb.tabela({}));
+            }
+            else if (coluna.tipo == TIPO_DATA)
+            {
+                fb.apontar(campo[1], fb.tabela({{0, 2, 0}})); // DateUnit.DAY
+            }
+            else
+            {
+                fb.apontar(campo[1], fb.tabela({{0, 4, 64}, {1, 1, 1}})); // Int64 com sinal
+            }
+            fb.apontar(campo[2], fb.vetorPonteiros(0)); // Sem filhos, mas o vetor é obrigatório
+        }
+        escreverMensagemArrow(fb.dados, "");
+    }
+
+    registrosLote = 0;
+    registrosExportados = 0;
+    iniciado = true;
+    return static_cast<bool>(saida);
+}
+
+void ExportadorCotacoes::escrever(const IndiceCotacoes &indice)
+{
+    if (!iniciado)
+    {
+        return;
+    }
+
+    std::vector<size_t> selecionados;
+    if (filtro.papeis.empty())
+    {
+        for (size_t papel = 0; papel < indice.quantidadePapeis(); papel++)
+        {
+            selecionados.push_back(papel);
+        }
+    }
+    for (const std::string &codigo : filtro.papeis)
+    {
+        size_t papel;
+        if (indice.localizarPapel(codigo, &papel))
+        {
+            selecionados.push_back(papel);
+        }
+    }
+
+    for (size_t papel : selecionados)
+    {
+        size_t inicio;
+        size_t fim;
+        if (!indice.obterFaixa(papel, filtro.dataInicial, filtro.dataFinal, &inicio, &fim))
+        {
+            continue;
+        }
+
+        while (inicio < fim)
+        {
+            size_t parte = std::min(fim - inicio, REGISTROS_POR_LOTE - registrosLote);
+            acrescentarTrecho(indice, papel, inicio, inicio + parte);
+            inicio += parte;
+            if (registrosLote == REGISTROS_POR_LOTE)
+            {
+                descarregar();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copia um trecho das colunas de um papel para o lote
+ * @details Colunas numéricas são copiadas em bloco; os textos são os do papel,
+ *          repetidos em cada registro do trecho. Se algum campo é do layout
+ *          completo, guarda também quais registros vieram nesse layout.
+ */
+void ExportadorCotacoes::acrescentarTrecho(const IndiceCotacoes &indice, size_t papel, size_t inicio, size_t fim)
+{
+    size_t quantidade = fim - inicio;
+    std::string textos[3];
+    bool textosLidos = false;
+
+    if (std::any_of(colunas.begin(), colunas.end(), [](const Coluna &coluna) { return coluna.soLayoutCompleto; }))
+    {
+        completos.resize(registrosLote + quantidade);
+        for (size_t i = 0; i < quantidade; i++)
+        {
+            completos[registrosLote + i] = indice.registroCompleto(inicio + i) ? 1 : 0;
+        }
+    }
+
+    for (Coluna &coluna : colunas)
+    {
+        if (coluna.tipo == TIPO_TEXTO)
+        {
+            if (!textosLidos)
+            {
+                indice.obterPapel(papel, &textos[0], &textos[1], nullptr, &textos[2]);
+                for (std::string &texto : textos)
+                {
+                    std::replace_if(texto.begin(), texto.end(), [](char c) { return (c & 0x80) != 0; }, '?');
+                }
+                textosLidos = true;
+            }
+
+            const std::string &valor = textos[coluna.campo == CAMPO_CODNEG ? 0 : coluna.campo == CAMPO_NOMRES ? 1 : 2];
+            for (size_t i = 0; i < quantidade; i++)
+            {
+                coluna.texto += valor;
+                coluna.deslocamentos.push_back(static_cast<int32_t>(coluna.texto.size()));
+            }
+            continue;
+        }
+
+        coluna.valores.resize(registrosLote + quantidade);
+        long long *destino = coluna.valores.data() + registrosLote;
+        if (coluna.campo == QUANTIDADE_CAMPOS)
+        {
+            for (size_t i = 0; i < quantidade; i++)
+            {
+                uint8_t marcas = 0;
+                indice.obterQualidade(inicio + i, &marcas);
+                destino[i] = marcas;
+            }
+        }
+        else
+        {
+            indice.copiarColuna(coluna.campo, inicio, fim, destino);
+        }
+    }
+
+    registrosLote += quantidade;
+    registrosExportados += quantidade;
+}
+
+void ExportadorCotacoes::descarregar()
+{
+    if (registrosLote == 0)
+    {
+        return;
+    }
+
+    if (formato == EXPORTACAO_CSV)
+    {
+        escreverCsv();
+    }
+    else
+    {
+        escreverLoteArrow();
+    }
+
+    for (Coluna &coluna : colunas)
+    {
+        coluna.valores.clear();
+        coluna.texto.clear();
+        coluna.deslocamentos.assign(1, 0);
+    }
+    completos.clear();
+    registrosLote = 0;
+}
+
+/**
+ * @brief Escreve o lote como linhas CSV
+ * @details Datas saem como AAAA-MM-DD (vazias se zero), que Python e DuckDB
+ *          reconhecem sozinhos; textos com vírgula ou aspas vão entre aspas.
+ *          Campos do layout completo ficam vazios nos registros sem ele.
+ */
+void ExportadorCotacoes::escreverCsv()
+{
+    std::string linhas;
+    linhas.reserve(LIMITE_BUFFER_CSV + 1024);
+    char numero[24];
+
+    for (size_t registro = 0; registro < registrosLote; registro++)
+    {
+        for (size_t i = 0; i < colunas.size(); i++)
+        {
+            const Coluna &coluna = colunas[i];
+            if (i > 0)
+            {
+                linhas.push_back(',');
+            }
+
+            if (coluna.tipo == TIPO_TEXTO)
+            {
+                int32_t inicio = coluna.deslocamentos[registro];
+                std::string valor = coluna.texto.substr(inicio, coluna.deslocamentos[registro + 1] - inicio);
+                if (valor.find_first_of(",\"\r\n") == std::string::npos)
+                {
+                    linhas += valor;
+                    continue;
+                }
+                linhas.push_back('"');
+                for (char c : valor)
+                {
+                    linhas += c == '"' ? "\"\"" : std::string(1, c);
+                }
+                linhas.push_back('"');
+                continue;
+            }
+
+            if (coluna.soLayoutCompleto && !completos[registro])
+            {
+                continue;
+            }
+
+            long long valor = coluna.valores[registro];
+            if (coluna.tipo == TIPO_DATA)
+            {
+                if (valor != 0)
+                {
+                    std::string data = std::to_string(valor);
+                    linhas += data.substr(0, 4) + "-" + data.substr(4, 2) + "-" + data.substr(6, 2);
+                }
+                continue;
+            }
+
+            char *fim = std::to_chars(numero, numero + sizeof(numero), valor).ptr;
+            linhas.append(numero, fim);
+        }
+        linhas.push_back('\n');
+
+        if (linhas.size() >= LIMITE_BUFFER_CSV)
+        {
+            saida.write(linhas.data(), static_cast<std::streamsize>(linhas.size()));
+            linhas.clear();
+        }
+    }
+    saida.write(linhas.data(), static_cast<std::streamsize>(linhas.size()));
+}
+
+/**
+ * @brief Escreve o lote como uma mensagem RecordBatch
+ * @details Cada coluna contribui com um FieldNode e com os buffers do seu
+ *          tipo: validade e valores (Int64 e Date32) ou validade, posições e
+ *          bytes (Utf8). A validade só tem bytes quando há nulos: datas zero e
+ *          campos do layout completo em registros sem ele. Todo buffer começa
+ *          em posição múltipla de 8 do corpo.
+ */
+void ExportadorCotacoes::escreverLoteArrow()
+{
+    std::string corpo;
+    std::vector<std::pair<int64_t, int64_t>> nos;
+    std::vector<std::pair<int64_t, int64_t>> buffers;
+    auto acrescentarBuffer = [&](const void *bytes, size_t tamanho) {
+        buffers.emplace_back(static_cast<int64_t>(corpo.size()), static_cast<int64_t>(tamanho));
+        corpo.append(static_cast<const char *>(bytes), tamanho);
+        completarOito(&corpo);
+    };
+
+    for (const Coluna &coluna : colunas)
+    {
+        if (coluna.tipo == TIPO_TEXTO)
+        {
+            nos.emplace_back(static_cast<int64_t>(registrosLote), 0);
+            acrescentarBuffer(nullptr, 0);
+            acrescentarBuffer(coluna.deslocamentos.data(), coluna.deslocamentos.size() * sizeof(int32_t));
+            acrescentarBuffer(coluna.texto.data(), coluna.texto.size());
+            continue;
+        }
+
+        std::string validade((registrosLote + 7) / 8, '\0');
+        size_t nulos = 0;
+        for (size_t i = 0; i < registrosLote; i++)
+        {
+            if ((coluna.soLayoutCompleto && !completos[i]) || (coluna.tipo == TIPO_DATA && coluna.valores[i] == 0))
+            {
+                nulos++;
+                continue;
+            }
+            validade[i / 8] = static_cast<char>(validade[i / 8] | (1 << (i % 8)));
+        }
+        nos.emplace_back(static_cast<int64_t>(registrosLote), static_cast<int64_t>(nulos));
+        acrescentarBuffer(validade.data(), nulos > 0 ? validade.size() : 0);
+
+        if (coluna.tipo == TIPO_DATA)
+        {
+            std::vector<int32_t> dias(registrosLote, 0);
+            for (size_t i = 0; i < registrosLote; i++)
+            {
+                if (validade[i / 8] & (1 << (i % 8)))
+                {
+                    dias[i] = diasDesdeEpoca(coluna.valores[i]);
+                }
+            }
+            acrescentarBuffer(dias.data(), dias.size() * sizeof(int32_t));
+        }
+        else
+        {
+            acrescentarBuffer(coluna.valores.data(), coluna.valores.size() * sizeof(int64_t));
+        }
+    }
+
+    Flatbuffer fb;
+    std::vector<size_t> mensagem;
+    std::vector<size_t> lote;
+    fb.raiz(fb.tabela({{0, 2, VERSAO_METADADOS_V5}, {1, 1, CABECALHO_LOTE}, {3, 8, corpo.size()}}, {2}, &mensagem));
+    fb.apontar(mensagem[0], fb.tabela({{0, 8, registrosLote}}, {1, 2}, &lote));
+    fb.apontar(lote[0], fb.vetorPares(nos));
+    fb.apontar(lote[1], fb.vetorPares(buffers));
+    escreverMensagemArrow(fb.dados, corpo);
+}
+
+/**
+ * @brief Enquadra uma mensagem no formato de fluxo
+ * @details Marca de continuação, tamanho dos metadados (completados para que o
+ *          corpo comece em múltiplo de 8), metadados e corpo.
+ */
+void ExportadorCotacoes::escreverMensagemArrow(const std::string &metadados, const std::string &corpo)
+{
+    std::string completos = metadados;
+    completarOito(&completos);
+    int32_t tamanho = static_cast<int32_t>(completos.size());
+    saida.write(reinterpret_cast<const char *>(&CONTINUACAO_ARROW), sizeof(CONTINUACAO_ARROW));
+    saida.write(reinterpret_cast<const char *>(&tamanho), sizeof(tamanho));
+    saida.write(completos.data(), static_cast<std::streamsize>(completos.size()));
+    saida.write(corpo.data(), static_cast<std::streamsize>(corpo.size()));
+}
+
+bool ExportadorCotacoes::finalizar()
+{
+    if (!iniciado)
+    {
+        return false;
+    }
+
+    descarregar();
+    if (formato == EXPORTACAO_ARROW)
+    {
+        // Fim de fluxo: continuação seguida de metadados vazios
+        int32_t zero = 0;
+        saida.write(reinterpret_cast<const char *>(&CONTINUACAO_ARROW), sizeof(CONTINUACAO_ARROW));
+        saida.write(reinterpret_cast<const char *>(&zero), sizeof(zero));
+    }
+    saida.flush();
+    iniciado = false;
+    return static_cast<bool>(saida);
+}
@@ -0,0 +1,158 @@
+#ifndef EXPORTADORCOTACOES_HPP_INCLUDED
+#define EXPORTADORCOTACOES_HPP_INCLUDED
+
+#include "IndiceCotacoes.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Formato de saída de ExportadorCotacoes
+ */
+enum FormatoExportacao
+{
+    EXPORTACAO_CSV,   ///< Texto separado por vírgulas, com cabeçalho
+    EXPORTACAO_ARROW, ///< Formato de fluxo do Arrow IPC (esquema, lotes de registros e fim de fluxo)
+};
+
+/**
+ * @brief Parte das cotações a exportar
+ */
+struct FiltroExportacao
+{
+    std::vector<std::string> papeis; ///< Códigos de negociação; vazio exporta todos os papéis
+    uint32_t dataInicial = 0;        ///< Primeira data (AAAAMMDD), inclusive
+    uint32_t dataFinal = 99999999;   ///< Última data (AAAAMMDD), inclusive
+    std::vector<std::string> campos; ///< Campos, na ordem das colunas; vazio usa CAMPOS_PADRAO
+};
+
+/**
+ * @brief Exporta cotações do índice em colunas para CSV ou Arrow IPC
+ *
+ * @details Feito para levar uma fatia dos dados históricos para Python ou
+ * DuckDB sem reinterpretar o texto de posições fixas. Os campos têm os nomes
+ * do layout da B3 em minúsculas (codneg, data, premed, voltot, ...), mais
+ * "qualidade", a máscara de MarcaQualidade do registro. Preços e volume saem
+ * em centavos, como no índice; data e datven são datas, vazias (nulas) quando
+ * o arquivo traz zero. Os campos que só existem no layout completo (preult a
+ * dismes, exceto codisi) são nulos nos registros lidos do layout truncado, em
+ * vez do zero que o índice guarda para eles.
+ *
+ * Os valores são copiados das colunas do IndiceCotacoes, trecho a trecho, para
+ * um lote de no máximo REGISTROS_POR_LOTE registros; cada lote cheio é escrito
+ * e reaproveitado, então a memória usada não depende do tamanho da exportação.
+ * No Arrow cada lote é uma mensagem RecordBatch; os metadados (flatbuffers)
+ * são montados aqui mesmo, sem depender da biblioteca do Arrow. Textos são
+ * gravados como estão no arquivo (NOMRES continua em UTF-7), com bytes fora
+ * do ASCII trocados por '?' para que a coluna seja UTF-8 válido.
+ *
+ * Uso: iniciar(), escrever() para cada índice (por exemplo, cada ano do
+ * catálogo) e finalizar().
+ */
+class ExportadorCotacoes
+{
+  private:
+    enum TipoCampo
+    {
+        TIPO_INTEIRO,
+        TIPO_DATA,
+        TIPO_TEXTO,
+    };
+
+    struct Coluna
+    {
+        std::string nome;
+        CampoCotahist campo; ///< QUANTIDADE_CAMPOS para a máscara de qualidade
+        TipoCampo tipo;
+        bool soLayoutCompleto; ///< Nulo (vazio no CSV) nos registros do layout truncado
+        std::vector<long long> valores;
+        std::vector<int32_t> deslocamentos; ///< Textos: início de cada valor em texto, mais o fim do último
+        std::string texto;
+    };
+
+    std::ostream &saida;
+    FormatoExportacao formato;
+    FiltroExportacao filtro;
+    std::vector<Coluna> colunas;
+    std::vector<uint8_t> completos; ///< 1 por registro do lote no layout completo; vazio se nenhum campo precisa
+    size_t registrosLote;
+    uint64_t registrosExportados;
+    bool iniciado;
+
+    void acrescentarTrecho(const IndiceCotacoes &indice, size_t papel, size_t inicio, size_t fim);
+    void descarregar();
+    void escreverCsv();
+    void escreverLoteArrow();
+    void escreverMensagemArrow(const std::string &metadados, const std::string &corpo);
+
+  public:
+    /**
+     * @brief Registros por lote, o limite de memória da exportação
+     */
+    static const size_t REGISTROS_POR_LOTE = 65536;
+
+    /**
+     * @brief Campos exportados quando o filtro não informa nenhum
+     */
+    static const std::string CAMPOS_PADRAO;
+
+    /**
+     * @brief Cria um exportador que escreve em um fluxo aberto em modo binário
+     */
+    ExportadorCotacoes(std::ostream &saida, FormatoExportacao formato);
+
+    ExportadorCotacoes(const ExportadorCotacoes &) = delete;
+    ExportadorCotacoes &operator=(const ExportadorCotacoes &) = delete;
+
+    /**
+     * @brief Interpreta o nome de um formato ("csv" ou "arrow")
+     *
+     * @return bool false se o nome não é conhecido
+     */
+    static bool interpretarFormato(const std::string &nome, FormatoExportacao *formato);
+
+    /**
+     * @brief Separa uma lista de itens separados por vírgula, ignorando itens vazios
+     */
+    static std::vector<std::string> separarLista(const std::string &lista);
+
+    /**
+     * @brief Converte uma data AAAAMMDD em dias desde 1970-01-01 (Date32 do Arrow)
+     */
+    static int32_t diasDesdeEpoca(long long data);
+
+    /**
+     * @brief Valida o filtro e escreve o cabeçalho (CSV) ou o esquema (Arrow)
+     *
+     * @param filtro Papéis, janela de datas e campos
+     * @return bool false se algum campo é desconhecido
+     */
+    bool iniciar(const FiltroExportacao &filtro);
+
+    /**
+     * @brief Escreve os registros de um índice que passam pelo filtro
+     *
+     * @details Os registros saem por papel (na ordem do filtro, ou na do índice
+     * se o filtro não lista papéis) e, dentro do papel, por data.
+     */
+    void escrever(const IndiceCotacoes &indice);
+
+    /**
+     * @brief Escreve o último lote e, no Arrow, a marca de fim de fluxo
+     *
+     * @return bool true se tudo foi escrito sem erro no fluxo
+     */
+    bool finalizar();
+
+    /**
+     * @brief Registros escritos até agora, inclusive os do lote ainda não descarregado
+     */
+    uint64_t getRegistrosExportados() const
+    {
+        return registrosExportados;
+    }
+};
+
+#endif // EXPORTADORCOTACOES_HPP_INCLUDED
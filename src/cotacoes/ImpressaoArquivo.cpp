@@ -0,0 +1,46 @@
+#include "ImpressaoArquivo.hpp"
+#include <algorithm>
+#include <unistd.h>
+
+namespace
+{
+const uint64_t PRIMO_FNV = 1099511628211ULL;
+} // namespace
+
+uint64_t ImpressaoArquivo::somarFnv(const void *dados, size_t tamanho, uint64_t soma)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(dados);
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        soma ^= bytes[i];
+        soma *= PRIMO_FNV;
+    }
+    return soma;
+}
+
+void ImpressaoArquivo::somarExtremos(int fd, uint64_t tamanho, uint64_t *somaInicio, uint64_t *somaFim)
+{
+    char bloco[TAMANHO_BLOCO];
+    size_t quantidade = static_cast<size_t>(std::min<uint64_t>(TAMANHO_BLOCO, tamanho));
+
+    ssize_t lidos = pread(fd, bloco, quantidade, 0);
+    *somaInicio = somarFnv(bloco, lidos > 0 ? static_cast<size_t>(lidos) : 0);
+    lidos = pread(fd, bloco, quantidade, static_cast<off_t>(tamanho - quantidade));
+    *somaFim = somarFnv(bloco, lidos > 0 ? static_cast<size_t>(lidos) : 0);
+}
+
+void ImpressaoArquivo::somarExtremos(std::istream &arquivo, uint64_t tamanho, uint64_t *somaInicio, uint64_t *somaFim)
+{
+    char bloco[TAMANHO_BLOCO];
+    size_t quantidade = static_cast<size_t>(std::min<uint64_t>(TAMANHO_BLOCO, tamanho));
+    uint64_t *somas[] = {somaInicio, somaFim};
+    uint64_t inicios[] = {0, tamanho - quantidade};
+
+    for (int i = 0; i < 2; i++)
+    {
+        arquivo.clear();
+        arquivo.seekg(static_cast<std::streamoff>(inicios[i]));
+        arquivo.read(bloco, static_cast<std::streamsize>(quantidade));
+        *somas[i] = somarFnv(bloco, static_cast<size_t>(arquivo.gcount()));
+    }
+}
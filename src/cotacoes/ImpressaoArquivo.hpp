@@ -0,0 +1,58 @@
+#ifndef IMPRESSAOARQUIVO_HPP_INCLUDED
+#define IMPRESSAOARQUIVO_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+
+/**
+ * @brief Somas FNV-1a de 64 bits e impressão digital do início e do fim de um arquivo
+ *
+ * @details O FNV-1a é usado onde o resultado precisa ser o mesmo em qualquer
+ * execução e em qualquer processo (std::hash não garante isso): nome do
+ * segmento de memória compartilhada, fragmento de um CPF, chave do cache de
+ * preços. A impressão digital soma os primeiros e os últimos TAMANHO_BLOCO
+ * bytes de uma parte do arquivo; IndiceDeslocamentos e CheckpointCotahist a
+ * gravam para perceber um arquivo regravado com o mesmo tamanho.
+ */
+class ImpressaoArquivo
+{
+  public:
+    /**
+     * @brief Tamanho dos blocos somados no início e no fim
+     */
+    static constexpr size_t TAMANHO_BLOCO = 4096;
+
+    /**
+     * @brief Valor inicial do FNV-1a de 64 bits
+     */
+    static constexpr uint64_t BASE_FNV = 14695981039346656037ULL;
+
+    /**
+     * @brief Soma FNV-1a de 64 bits
+     *
+     * @param dados Bytes a somar
+     * @param tamanho Quantidade de bytes
+     * @param soma Soma dos bytes anteriores, para continuar uma soma em partes
+     * @return uint64_t Soma incluindo os bytes informados
+     */
+    static uint64_t somarFnv(const void *dados, size_t tamanho, uint64_t soma = BASE_FNV);
+
+    /**
+     * @brief Soma o primeiro e o último bloco dos primeiros tamanho bytes de um arquivo
+     *
+     * @param fd Descritor aberto para leitura (lido com pread, sem mudar a posição)
+     * @param tamanho Fim da parte considerada; blocos menores se for menor que TAMANHO_BLOCO
+     * @param somaInicio Soma de [0, min(TAMANHO_BLOCO, tamanho))
+     * @param somaFim Soma dos últimos min(TAMANHO_BLOCO, tamanho) bytes antes de tamanho
+     */
+    static void somarExtremos(int fd, uint64_t tamanho, uint64_t *somaInicio, uint64_t *somaFim);
+
+    /**
+     * @brief O mesmo que somarExtremos(int, ...), para um arquivo aberto como fluxo
+     * @details Limpa o estado do fluxo e muda a posição de leitura.
+     */
+    static void somarExtremos(std::istream &arquivo, uint64_t tamanho, uint64_t *somaInicio, uint64_t *somaFim);
+};
+
+#endif // IMPRESSAOARQUIVO_HPP_INCLUDED
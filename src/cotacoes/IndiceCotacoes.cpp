@@ -0,0 +1,773 @@
+#include "IndiceCotacoes.hpp"
+#include "CheckpointCotahist.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+/**
+ * @brief Reordena uma coluna lida na ordem do arquivo para a ordem do índice
+ * @details Colunas vazias (layout completo ausente) são mantidas vazias.
+ */
+template <typename T> void reordenar(std::vector<T> *coluna, const std::vector<uint32_t> &ordem)
+{
+    if (coluna->empty())
+    {
+        return;
+    }
+
+    std::vector<T> ordenada(ordem.size());
+    for (size_t i = 0; i < ordem.size(); i++)
+    {
+        ordenada[i] = (*coluna)[ordem[i]];
+    }
+    coluna->swap(ordenada);
+}
+
+/**
+ * @brief Copia um trecho de coluna alargando para long long
+ * @details Uma coluna vazia (layout completo ausente) é copiada como o valor padrão.
+ */
+template <typename T>
+void copiarTrecho(const std::vector<T> &coluna, size_t inicio, size_t fim, long long padrao, long long *destino)
+{
+    if (coluna.empty())
+    {
+        std::fill(destino, destino + (fim - inicio), padrao);
+        return;
+    }
+    for (size_t i = inicio; i < fim; i++)
+    {
+        *destino++ = static_cast<long long>(coluna[i]);
+    }
+}
+} // namespace
+
+/**
+ * @brief Carrega o arquivo de dados históricos em colunas ordenadas
+ * @param caminho Caminho do arquivo COTAHIST
+ * @return true se o arquivo foi lido, false se não pôde ser aberto
+ */
+bool IndiceCotacoes::carregar(const std::string &caminho)
+{
+    return carregar(std::vector<std::string>{caminho});
+}
+
+/**
+ * @brief Carrega um ou mais arquivos de dados históricos em colunas ordenadas
+ * @param caminhos Caminhos dos arquivos COTAHIST
+ * @return true se todos os arquivos foram lidos, false se algum não pôde ser aberto
+ * @details Linhas inválidas são ignoradas. A ordenação é estável, então para
+ *          registros repetidos de um mesmo papel e data prevalece o primeiro
+ *          lido, como na leitura sequencial. Em caso de falha o índice fica vazio.
+ *          Com diretório de checkpoints, cada arquivo é lido por CheckpointCotahist
+ *          e só os bytes acrescentados desde a última carga são interpretados.
+ */
+bool IndiceCotacoes::carregar(const std::vector<std::string> &caminhos)
+{
+    std::vector<uint32_t> idLinha;
+    std::vector<uint8_t> nomeInvalidoPapel;
+    bool algumCompleto = false;
+
+    limpar();
+
+    auto consumir = [&](const RegistroCotacao &registro) {
+        auto resultado = idPorPapel.emplace(registro.codigoNegociacao, static_cast<uint32_t>(papeis.size()));
+        if (resultado.second)
+        {
+            papeis.push_back(registro.codigoNegociacao);
+            isinPapel.emplace_back();
+            nomePapel.emplace_back();
+            nomeInvalidoPapel.push_back(0);
+        }
+        if (isinPapel[resultado.first->second].empty())
+        {
+            isinPapel[resultado.first->second] = registro.codigoIsin;
+        }
+        if (nomePapel[resultado.first->second].empty() && !registro.nomeResumido.empty())
+        {
+            nomePapel[resultado.first->second] = registro.nomeResumido;
+            nomeInvalidoPapel[resultado.first->second] = AnalisadorQualidade::nomeValido(registro.nomeResumido) ? 0 : 1;
+        }
+
+        // O nome quase sempre é o já avaliado para o papel; só um nome diferente é conferido de novo
+        uint8_t marcas = AnalisadorQualidade::avaliarPrecos(registro);
+        bool nomeInvalido = registro.nomeResumido == nomePapel[resultado.first->second]
+                                ? nomeInvalidoPapel[resultado.first->second] != 0
+                                : !AnalisadorQualidade::nomeValido(registro.nomeResumido);
+        colunaQualidade.push_back(marcas | (nomeInvalido ? QUALIDADE_NOME_INVALIDO : 0));
+
+        idLinha.push_back(resultado.first->second);
+        colunaData.push_back(registro.data);
+        colunaPreco.push_back(registro.precoMedioCentavos);
+        colunaAbertura.push_back(registro.precoAberturaCentavos);
+        colunaMaximo.push_back(registro.precoMaximoCentavos);
+        colunaMinimo.push_back(registro.precoMinimoCentavos);
+
+        // Até o primeiro registro completo, as colunas do layout completo ficam vazias
+        if (registro.completo && !algumCompleto)
+        {
+            algumCompleto = true;
+            size_t anteriores = colunaData.size() - 1;
+            colunaUltimo.resize(anteriores, 0);
+            colunaOfertaCompra.resize(anteriores, 0);
+            colunaOfertaVenda.resize(anteriores, 0);
+            colunaNegocios.resize(anteriores, 0);
+            colunaQuantidade.resize(anteriores, 0);
+            colunaVolume.resize(anteriores, 0);
+            colunaExercicio.resize(anteriores, 0);
+            colunaIndicador.resize(anteriores, 0);
+            colunaVencimento.resize(anteriores, 0);
+            colunaFator.resize(anteriores, 1);
+            colunaDistribuicao.resize(anteriores, 0);
+            colunaCompleto.resize(anteriores, 0);
+        }
+        if (algumCompleto)
+        {
+            colunaUltimo.push_back(registro.precoUltimoCentavos);
+            colunaOfertaCompra.push_back(registro.precoOfertaCompraCentavos);
+            colunaOfertaVenda.push_back(registro.precoOfertaVendaCentavos);
+            colunaNegocios.push_back(registro.totalNegocios);
+            colunaQuantidade.push_back(registro.quantidadeTotal);
+            colunaVolume.push_back(registro.volumeTotalCentavos);
+            colunaExercicio.push_back(registro.precoExercicioCentavos);
+            colunaIndicador.push_back(registro.indicadorCorrecao);
+            colunaVencimento.push_back(registro.dataVencimento);
+            colunaFator.push_back(registro.fatorCotacao);
+            colunaDistribuicao.push_back(registro.numeroDistribuicao);
+            colunaCompleto.push_back(registro.completo ? 1 : 0);
+        }
+    };
+
+    for (const std::string &caminho : caminhos)
+    {
+        ContagemLinhas descartadas;
+        if (!CheckpointCotahist::ler(caminho, diretorioCheckpoints, consumir, nullptr, &descartadas))
+        {
+            limpar();
+            return false;
+        }
+        relatorioQualidade.linhasCurtas += descartadas.curtas;
+        relatorioQualidade.linhasInvalidas += descartadas.invalidas;
+    }
+
+    std::vector<uint32_t> ordem(idLinha.size());
+    std::iota(ordem.begin(), ordem.end(), 0);
+    std::stable_sort(ordem.begin(), ordem.end(), [&](uint32_t a, uint32_t b) {
+        if (idLinha[a] != idLinha[b])
+        {
+            return idLinha[a] < idLinha[b];
+        }
+        return colunaData[a] < colunaData[b];
+    });
+
+    inicioPapel.assign(papeis.size() + 1, 0);
+    for (uint32_t id : idLinha)
+    {
+        inicioPapel[id + 1]++;
+    }
+    for (size_t i = 1; i < inicioPapel.size(); i++)
+    {
+        inicioPapel[i] += inicioPapel[i - 1];
+    }
+
+    reordenar(&colunaData, ordem);
+    reordenar(&colunaPreco, ordem);
+    reordenar(&colunaAbertura, ordem);
+    reordenar(&colunaMaximo, ordem);
+    reordenar(&colunaMinimo, ordem);
+    reordenar(&colunaUltimo, ordem);
+    reordenar(&colunaOfertaCompra, ordem);
+    reordenar(&colunaOfertaVenda, ordem);
+    reordenar(&colunaNegocios, ordem);
+    reordenar(&colunaQuantidade, ordem);
+    reordenar(&colunaVolume, ordem);
+    reordenar(&colunaExercicio, ordem);
+    reordenar(&colunaIndicador, ordem);
+    reordenar(&colunaVencimento, ordem);
+    reordenar(&colunaFator, ordem);
+    reordenar(&colunaDistribuicao, ordem);
+    reordenar(&colunaCompleto, ordem);
+    reordenar(&colunaQualidade, ordem);
+    montarDatasPregao();
+    classificarQualidade();
+    calcularPrefixos();
+
+    caminhoArquivo = caminhos.empty() ? "" : caminhos.front();
+    return true;
+}
+
+void IndiceCotacoes::limpar()
+{
+    papeis.clear();
+    idPorPapel.clear();
+    inicioPapel.clear();
+    isinPapel.clear();
+    nomePapel.clear();
+    colunaData.clear();
+    colunaPreco.clear();
+    colunaAbertura.clear();
+    colunaMaximo.clear();
+    colunaMinimo.clear();
+    colunaUltimo.clear();
+    colunaOfertaCompra.clear();
+    colunaOfertaVenda.clear();
+    colunaNegocios.clear();
+    colunaQuantidade.clear();
+    colunaVolume.clear();
+    colunaExercicio.clear();
+    colunaIndicador.clear();
+    colunaVencimento.clear();
+    colunaFator.clear();
+    colunaDistribuicao.clear();
+    colunaCompleto.clear();
+    colunaQualidade.clear();
+    relatorioQualidade = RelatorioQualidade();
+    prefixoQuantidade.clear();
+    prefixoVolume.clear();
+    prefixoNegocios.clear();
+    prefixoPregoesNegociados.clear();
+    datasPregao.clear();
+    prefixoNegociosMercado.clear();
+    prefixoVolumeMercado.clear();
+    caminhoArquivo.clear();
+}
+
+/**
+ * @brief Monta a lista ordenada das datas distintas, os pregões do mercado
+ * @details Com as datas em um intervalo curto (o caso de uma partição anual),
+ *          marca as presentes em uma tabela indexada pela data, em O(n), em
+ *          vez de ordenar uma cópia da coluna.
+ */
+void IndiceCotacoes::montarDatasPregao()
+{
+    datasPregao.clear();
+    if (colunaData.empty())
+    {
+        return;
+    }
+
+    auto extremos = std::minmax_element(colunaData.begin(), colunaData.end());
+    uint32_t menor = *extremos.first;
+    size_t amplitude = static_cast<size_t>(*extremos.second - menor) + 1;
+    if (amplitude <= colunaData.size() * 4)
+    {
+        std::vector<uint8_t> presente(amplitude, 0);
+        for (uint32_t data : colunaData)
+        {
+            presente[data - menor] = 1;
+        }
+        for (size_t i = 0; i < amplitude; i++)
+        {
+            if (presente[i])
+            {
+                datasPregao.push_back(menor + static_cast<uint32_t>(i));
+            }
+        }
+    }
+    else
+    {
+        datasPregao = colunaData;
+        std::sort(datasPregao.begin(), datasPregao.end());
+        datasPregao.erase(std::unique(datasPregao.begin(), datasPregao.end()), datasPregao.end());
+    }
+    datasPregao.shrink_to_fit();
+}
+
+/**
+ * @brief Monta as somas prefixadas usadas por somarNegociacao
+ * @details Só há o que somar com o layout completo. As somas por papel seguem
+ *          a ordem das colunas; como cada papel ocupa uma faixa contígua, a
+ *          janela de um papel é uma diferença entre duas posições. As do
+ *          mercado são indexadas pelas datas distintas, em ordem. Registros
+ *          marcados como duplicados por classificarQualidade, que precisa rodar
+ *          antes, entram com zero: só o primeiro lido de cada (papel, data) conta.
+ */
+void IndiceCotacoes::calcularPrefixos()
+{
+    if (colunaCompleto.empty())
+    {
+        return;
+    }
+
+    size_t total = colunaData.size();
+    prefixoQuantidade.assign(total + 1, 0);
+    prefixoVolume.assign(total + 1, 0);
+    prefixoNegocios.assign(total + 1, 0);
+    prefixoPregoesNegociados.assign(total + 1, 0);
+    for (size_t i = 0; i < total; i++)
+    {
+        bool contado = !(colunaQualidade[i] & QUALIDADE_DUPLICADO);
+        prefixoQuantidade[i + 1] = prefixoQuantidade[i] + (contado ? colunaQuantidade[i] : 0);
+        prefixoVolume[i + 1] = prefixoVolume[i] + (contado ? colunaVolume[i] : 0);
+        prefixoNegocios[i + 1] = prefixoNegocios[i] + (contado ? colunaNegocios[i] : 0);
+        prefixoPregoesNegociados[i + 1] = prefixoPregoesNegociados[i] + (contado && colunaNegocios[i] > 0 ? 1 : 0);
+    }
+
+    prefixoNegociosMercado.assign(datasPregao.size() + 1, 0);
+    prefixoVolumeMercado.assign(datasPregao.size() + 1, 0);
+    for (size_t i = 0; i < total; i++)
+    {
+        if (colunaQualidade[i] & QUALIDADE_DUPLICADO)
+        {
+            continue;
+        }
+        size_t dia = static_cast<size_t>(std::lower_bound(datasPregao.begin(), datasPregao.end(), colunaData[i]) -
+                                         datasPregao.begin());
+        prefixoNegociosMercado[dia + 1] += colunaNegocios[i];
+        prefixoVolumeMercado[dia + 1] += colunaVolume[i];
+    }
+    for (size_t i = 1; i < prefixoNegociosMercado.size(); i++)
+    {
+        prefixoNegociosMercado[i] += prefixoNegociosMercado[i - 1];
+        prefixoVolumeMercado[i] += prefixoVolumeMercado[i - 1];
+    }
+}
+
+/**
+ * @brief Completa as marcas de qualidade que dependem dos vizinhos e monta o resumo
+ * @details Com as colunas ordenadas por (papel, data), um registro com a mesma
+ *          data do anterior é duplicado (a ordenação estável deixa o primeiro
+ *          lido na frente, e é ele que as buscas encontram). Uma lacuna é um
+ *          pregão do mercado entre dois registros consecutivos do papel; antes
+ *          do primeiro e depois do último registro o papel pode simplesmente
+ *          não existir, e isso não é contado. As lacunas ficam na ordem dos
+ *          papéis; ordená-las custaria mais que a passada inteira, e fica para
+ *          quem monta o relatório.
+ */
+void IndiceCotacoes::classificarQualidade()
+{
+    for (size_t papel = 0; papel < papeis.size(); papel++)
+    {
+        if (inicioPapel[papel] == inicioPapel[papel + 1])
+        {
+            continue;
+        }
+
+        // As datas do papel crescem: o pregão de cada uma é achado avançando a partir do anterior
+        LacunasPapel lacunas;
+        size_t dia = static_cast<size_t>(
+            std::lower_bound(datasPregao.begin(), datasPregao.end(), colunaData[inicioPapel[papel]]) -
+            datasPregao.begin());
+        size_t diaAnterior = dia;
+        for (size_t i = inicioPapel[papel]; i < inicioPapel[papel + 1]; i++)
+        {
+            while (datasPregao[dia] < colunaData[i])
+            {
+                dia++;
+            }
+            if (i > inicioPapel[papel] && colunaData[i] == colunaData[i - 1])
+            {
+                colunaQualidade[i] |= QUALIDADE_DUPLICADO;
+            }
+            else if (i > inicioPapel[papel] && dia > diaAnterior + 1)
+            {
+                colunaQualidade[i] |= QUALIDADE_LACUNA;
+                lacunas.pregoesAusentes += dia - diaAnterior - 1;
+            }
+            diaAnterior = dia;
+            relatorioQualidade.contar(colunaQualidade[i]);
+        }
+
+        if (lacunas.pregoesAusentes > 0)
+        {
+            lacunas.codigoNegociacao = papeis[papel];
+            lacunas.registros = inicioPapel[papel + 1] - inicioPapel[papel];
+            relatorioQualidade.pregoesAusentes += lacunas.pregoesAusentes;
+            relatorioQualidade.lacunasPorPapel.push_back(std::move(lacunas));
+        }
+    }
+}
+
+bool IndiceCotacoes::obterQualidade(size_t posicao, uint8_t *marcas) const
+{
+    if (posicao >= colunaQualidade.size() || !marcas)
+    {
+        return false;
+    }
+
+    *marcas = colunaQualidade[posicao];
+    return true;
+}
+
+bool IndiceCotacoes::localizar(const std::string &codigoNegociacao, uint32_t data, size_t *posicao) const
+{
+    auto it = idPorPapel.find(LeitorCotahist::limparCampo(codigoNegociacao));
+    if (it == idPorPapel.end())
+    {
+        return false;
+    }
+
+    auto inicio = colunaData.begin() + inicioPapel[it->second];
+    auto fim = colunaData.begin() + inicioPapel[it->second + 1];
+    auto encontrado = std::lower_bound(inicio, fim, data);
+    if (encontrado == fim || *encontrado != data)
+    {
+        return false;
+    }
+
+    *posicao = static_cast<size_t>(encontrado - colunaData.begin());
+    return true;
+}
+
+bool IndiceCotacoes::buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos) const
+{
+    size_t posicao;
+    if (!precoCentavos || !localizar(codigoNegociacao, data, &posicao))
+    {
+        return false;
+    }
+
+    *precoCentavos = colunaPreco[posicao];
+    return true;
+}
+
+bool IndiceCotacoes::contem(const std::string &codigoNegociacao, uint32_t data) const
+{
+    size_t posicao;
+    return localizar(codigoNegociacao, data, &posicao);
+}
+
+/**
+ * @brief Lê o registro em uma posição das colunas
+ * @details O papel é encontrado por busca binária nos inícios de faixa, pois as
+ *          colunas não guardam o identificador do papel por registro.
+ */
+bool IndiceCotacoes::obterRegistro(size_t posicao, std::string *codigoNegociacao, uint32_t *data,
+                                   long long *precoCentavos) const
+{
+    if (posicao >= colunaData.size())
+    {
+        return false;
+    }
+
+    if (codigoNegociacao)
+    {
+        *codigoNegociacao = papeis[papelNaPosicao(posicao)];
+    }
+    if (data)
+    {
+        *data = colunaData[posicao];
+    }
+    if (precoCentavos)
+    {
+        *precoCentavos = colunaPreco[posicao];
+    }
+    return true;
+}
+
+size_t IndiceCotacoes::papelNaPosicao(size_t posicao) const
+{
+    auto faixa = std::upper_bound(inicioPapel.begin(), inicioPapel.end(), static_cast<uint32_t>(posicao));
+    return static_cast<size_t>(faixa - inicioPapel.begin()) - 1;
+}
+
+bool IndiceCotacoes::obterPapel(size_t papel, std::string *codigoNegociacao, std::string *nomeResumido,
+                                size_t *pregoes, std::string *codigoIsin) const
+{
+    if (papel >= papeis.size())
+    {
+        return false;
+    }
+
+    if (codigoNegociacao)
+    {
+        *codigoNegociacao = papeis[papel];
+    }
+    if (nomeResumido)
+    {
+        *nomeResumido = nomePapel[papel];
+    }
+    // Registros repetidos do mesmo papel e data ficam lado a lado e contam um pregão só
+    if (pregoes)
+    {
+        *pregoes = 0;
+        for (size_t i = inicioPapel[papel]; i < inicioPapel[papel + 1]; i++)
+        {
+            *pregoes += (i == inicioPapel[papel] || colunaData[i] != colunaData[i - 1]) ? 1 : 0;
+        }
+    }
+    if (codigoIsin)
+    {
+        *codigoIsin = isinPapel[papel];
+    }
+    return true;
+}
+
+bool IndiceCotacoes::localizarPapel(const std::string &codigoNegociacao, size_t *papel) const
+{
+    auto it = idPorPapel.find(LeitorCotahist::limparCampo(codigoNegociacao));
+    if (!papel || it == idPorPapel.end())
+    {
+        return false;
+    }
+
+    *papel = it->second;
+    return true;
+}
+
+bool IndiceCotacoes::obterFaixa(size_t papel, uint32_t dataInicial, uint32_t dataFinal, size_t *inicio,
+                                size_t *fim) const
+{
+    if (papel >= papeis.size() || !inicio || !fim)
+    {
+        return false;
+    }
+
+    auto faixaInicio = colunaData.begin() + inicioPapel[papel];
+    auto faixaFim = colunaData.begin() + inicioPapel[papel + 1];
+    *inicio = static_cast<size_t>(std::lower_bound(faixaInicio, faixaFim, dataInicial) - colunaData.begin());
+    *fim = std::max(*inicio,
+                    static_cast<size_t>(std::upper_bound(faixaInicio, faixaFim, dataFinal) - colunaData.begin()));
+    return true;
+}
+
+bool IndiceCotacoes::copiarColuna(CampoCotahist campo, size_t inicio, size_t fim, long long *destino) const
+{
+    if (inicio > fim || fim > colunaData.size() || !destino)
+    {
+        return false;
+    }
+
+    switch (campo)
+    {
+    case CAMPO_DATA:
+        copiarTrecho(colunaData, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREABE:
+        copiarTrecho(colunaAbertura, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREMAX:
+        copiarTrecho(colunaMaximo, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREMIN:
+        copiarTrecho(colunaMinimo, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREMED:
+        copiarTrecho(colunaPreco, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREULT:
+        copiarTrecho(colunaUltimo, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREOFC:
+        copiarTrecho(colunaOfertaCompra, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREOFV:
+        copiarTrecho(colunaOfertaVenda, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_TOTNEG:
+        copiarTrecho(colunaNegocios, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_QUATOT:
+        copiarTrecho(colunaQuantidade, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_VOLTOT:
+        copiarTrecho(colunaVolume, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_PREEXE:
+        copiarTrecho(colunaExercicio, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_INDOPC:
+        copiarTrecho(colunaIndicador, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_DATVEN:
+        copiarTrecho(colunaVencimento, inicio, fim, 0, destino);
+        return true;
+    case CAMPO_FATCOT:
+        copiarTrecho(colunaFator, inicio, fim, 1, destino);
+        return true;
+    case CAMPO_DISMES:
+        copiarTrecho(colunaDistribuicao, inicio, fim, 0, destino);
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IndiceCotacoes::obterRegistroCompleto(size_t posicao, RegistroCotacao *registro) const
+{
+    if (posicao >= colunaData.size() || !registro)
+    {
+        return false;
+    }
+
+    size_t papel = papelNaPosicao(posicao);
+    RegistroCotacao lido;
+    lido.data = colunaData[posicao];
+    lido.codigoNegociacao = papeis[papel];
+    lido.codigoIsin = isinPapel[papel];
+    lido.nomeResumido = nomePapel[papel];
+    lido.precoAberturaCentavos = colunaAbertura[posicao];
+    lido.precoMaximoCentavos = colunaMaximo[posicao];
+    lido.precoMinimoCentavos = colunaMinimo[posicao];
+    lido.precoMedioCentavos = colunaPreco[posicao];
+
+    if (!colunaCompleto.empty())
+    {
+        lido.precoUltimoCentavos = colunaUltimo[posicao];
+        lido.precoOfertaCompraCentavos = colunaOfertaCompra[posicao];
+        lido.precoOfertaVendaCentavos = colunaOfertaVenda[posicao];
+        lido.totalNegocios = colunaNegocios[posicao];
+        lido.quantidadeTotal = colunaQuantidade[posicao];
+        lido.volumeTotalCentavos = colunaVolume[posicao];
+        lido.precoExercicioCentavos = colunaExercicio[posicao];
+        lido.indicadorCorrecao = colunaIndicador[posicao];
+        lido.dataVencimento = colunaVencimento[posicao];
+        lido.fatorCotacao = colunaFator[posicao];
+        lido.numeroDistribuicao = colunaDistribuicao[posicao];
+        lido.completo = colunaCompleto[posicao] != 0;
+    }
+
+    *registro = std::move(lido);
+    return true;
+}
+
+bool IndiceCotacoes::buscarRegistro(const std::string &codigoNegociacao, uint32_t data,
+                                    RegistroCotacao *registro) const
+{
+    size_t posicao;
+    return registro && localizar(codigoNegociacao, data, &posicao) && obterRegistroCompleto(posicao, registro);
+}
+
+bool IndiceCotacoes::obterDatas(const std::string &codigoNegociacao, DatasPapel *datas) const
+{
+    auto it = idPorPapel.find(LeitorCotahist::limparCampo(codigoNegociacao));
+    if (!datas || it == idPorPapel.end())
+    {
+        return false;
+    }
+
+    datas->inicio = colunaData.data() + inicioPapel[it->second];
+    datas->fim = colunaData.data() + inicioPapel[it->second + 1];
+    return true;
+}
+
+bool IndiceCotacoes::somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial, uint32_t dataFinal,
+                                     EstatisticasNegociacao *estatisticas) const
+{
+    auto it = idPorPapel.find(LeitorCotahist::limparCampo(codigoNegociacao));
+    if (!estatisticas || colunaCompleto.empty() || it == idPorPapel.end())
+    {
+        return false;
+    }
+
+    *estatisticas = EstatisticasNegociacao();
+    if (dataInicial > dataFinal)
+    {
+        return true;
+    }
+
+    auto faixaInicio = colunaData.begin() + inicioPapel[it->second];
+    auto faixaFim = colunaData.begin() + inicioPapel[it->second + 1];
+    size_t inicio = static_cast<size_t>(std::lower_bound(faixaInicio, faixaFim, dataInicial) - colunaData.begin());
+    size_t fim = static_cast<size_t>(std::upper_bound(faixaInicio, faixaFim, dataFinal) - colunaData.begin());
+
+    auto diaInicio = static_cast<size_t>(std::lower_bound(datasPregao.begin(), datasPregao.end(), dataInicial) -
+                                         datasPregao.begin());
+    auto diaFim = static_cast<size_t>(std::upper_bound(datasPregao.begin(), datasPregao.end(), dataFinal) -
+                                      datasPregao.begin());
+
+    estatisticas->pregoes = static_cast<uint32_t>(diaFim - diaInicio);
+    estatisticas->pregoesNegociados = prefixoPregoesNegociados[fim] - prefixoPregoesNegociados[inicio];
+    estatisticas->negocios = prefixoNegocios[fim] - prefixoNegocios[inicio];
+    estatisticas->quantidadeTotal = prefixoQuantidade[fim] - prefixoQuantidade[inicio];
+    estatisticas->volumeTotalCentavos = prefixoVolume[fim] - prefixoVolume[inicio];
+    estatisticas->negociosMercado = prefixoNegociosMercado[diaFim] - prefixoNegociosMercado[diaInicio];
+    estatisticas->volumeMercadoCentavos = prefixoVolumeMercado[diaFim] - prefixoVolumeMercado[diaInicio];
+    return true;
+}
+
+DatasPapel DatasPapel::janela(uint32_t dataInicial, uint32_t dataFinal) const
+{
+    DatasPapel parte;
+    parte.dono = dono;
+    parte.inicio = std::lower_bound(inicio, fim, dataInicial);
+    parte.fim = dataFinal < dataInicial ? parte.inicio : std::upper_bound(parte.inicio, fim, dataFinal);
+    return parte;
+}
+
+void EstatisticasNegociacao::acumular(const EstatisticasNegociacao &outra)
+{
+    pregoes += outra.pregoes;
+    pregoesNegociados += outra.pregoesNegociados;
+    negocios += outra.negocios;
+    quantidadeTotal += outra.quantidadeTotal;
+    volumeTotalCentavos += outra.volumeTotalCentavos;
+    negociosMercado += outra.negociosMercado;
+    volumeMercadoCentavos += outra.volumeMercadoCentavos;
+}
+
+long long EstatisticasNegociacao::vwapCentavos() const
+{
+    if (quantidadeTotal <= 0)
+    {
+        return 0;
+    }
+    return (volumeTotalCentavos + quantidadeTotal / 2) / quantidadeTotal;
+}
+
+double EstatisticasNegociacao::quantidadeMediaDiaria() const
+{
+    return pregoes == 0 ? 0.0 : static_cast<double>(quantidadeTotal) / pregoes;
+}
+
+double EstatisticasNegociacao::volumeMedioDiarioCentavos() const
+{
+    return pregoes == 0 ? 0.0 : static_cast<double>(volumeTotalCentavos) / pregoes;
+}
+
+double EstatisticasNegociacao::indiceNegociabilidade() const
+{
+    if (pregoes == 0 || negociosMercado <= 0 || volumeMercadoCentavos <= 0)
+    {
+        return 0.0;
+    }
+
+    double presenca = static_cast<double>(pregoesNegociados) / pregoes;
+    double fracaoNegocios = static_cast<double>(negocios) / static_cast<double>(negociosMercado);
+    double fracaoVolume = static_cast<double>(volumeTotalCentavos) / static_cast<double>(volumeMercadoCentavos);
+    return 100.0 * presenca * std::sqrt(fracaoNegocios * fracaoVolume);
+}
+
+/**
+ * @brief Memória aproximada ocupada pelo índice
+ * @details Soma a capacidade das colunas, os nomes dos papéis e uma estimativa
+ *          de três ponteiros por entrada da tabela hash. Usada pelo catálogo
+ *          para respeitar o orçamento de memória; não precisa ser exata.
+ */
+size_t IndiceCotacoes::memoriaEstimada() const
+{
+    size_t bytes = (colunaData.capacity() + colunaNegocios.capacity() + colunaVencimento.capacity() +
+                    colunaFator.capacity() + inicioPapel.capacity()) *
+                       sizeof(uint32_t) +
+                   (colunaPreco.capacity() + colunaAbertura.capacity() + colunaMaximo.capacity() +
+                    colunaMinimo.capacity() + colunaUltimo.capacity() + colunaOfertaCompra.capacity() +
+                    colunaOfertaVenda.capacity() + colunaQuantidade.capacity() + colunaVolume.capacity() +
+                    colunaExercicio.capacity()) *
+                       sizeof(long long) +
+                   colunaDistribuicao.capacity() * sizeof(uint16_t) + colunaIndicador.capacity() +
+                   colunaCompleto.capacity() + colunaQualidade.capacity() +
+                   (papeis.capacity() + isinPapel.capacity() + nomePapel.capacity()) * sizeof(std::string) +
+                   (prefixoQuantidade.capacity() + prefixoVolume.capacity() + prefixoNegocios.capacity() +
+                    prefixoNegociosMercado.capacity() + prefixoVolumeMercado.capacity()) *
+                       sizeof(long long) +
+                   (prefixoPregoesNegociados.capacity() + datasPregao.capacity()) * sizeof(uint32_t);
+    for (const std::string &papel : papeis)
+    {
+        bytes += papel.capacity() + sizeof(std::string) + sizeof(uint32_t) + 3 * sizeof(void *);
+    }
+    for (const std::string &isin : isinPapel)
+    {
+        bytes += isin.capacity();
+    }
+    for (const std::string &nome : nomePapel)
+    {
+        bytes += nome.capacity();
+    }
+    for (const LacunasPapel &lacunas : relatorioQualidade.lacunasPorPapel)
+    {
+        bytes += sizeof(LacunasPapel) + lacunas.codigoNegociacao.capacity();
+    }
+    return bytes;
+}
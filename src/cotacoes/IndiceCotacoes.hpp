@@ -0,0 +1,394 @@
+#ifndef INDICECOTACOES_HPP_INCLUDED
+#define INDICECOTACOES_HPP_INCLUDED
+
+#include "LeitorCotahist.hpp"
+#include "QualidadeCotacoes.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Somas de negociação de um papel em uma janela de datas
+ *
+ * @details Todos os campos são somas, de modo que janelas vindas de partições
+ * diferentes (ex.: anos do catálogo) se combinam com acumular(); as métricas
+ * derivadas são calculadas depois, sobre o total.
+ */
+struct EstatisticasNegociacao
+{
+    uint32_t pregoes = 0;               ///< Pregões do mercado na janela
+    uint32_t pregoesNegociados = 0;     ///< Pregões da janela em que o papel teve negócios
+    long long negocios = 0;             ///< Negócios do papel (TOTNEG)
+    long long quantidadeTotal = 0;      ///< Títulos negociados do papel (QUATOT)
+    long long volumeTotalCentavos = 0;  ///< Volume do papel em centavos (VOLTOT)
+    long long negociosMercado = 0;      ///< Negócios de todos os papéis na janela
+    long long volumeMercadoCentavos = 0; ///< Volume de todos os papéis na janela
+
+    /**
+     * @brief Soma outra janela a esta
+     */
+    void acumular(const EstatisticasNegociacao &outra);
+
+    /**
+     * @brief Preço médio ponderado por volume (VWAP), em centavos por título
+     *
+     * @return long long VOLTOT / QUATOT arredondado, ou 0 sem negócios
+     */
+    long long vwapCentavos() const;
+
+    /**
+     * @brief Quantidade média negociada por pregão do mercado
+     */
+    double quantidadeMediaDiaria() const;
+
+    /**
+     * @brief Volume médio negociado por pregão do mercado, em centavos
+     */
+    double volumeMedioDiarioCentavos() const;
+
+    /**
+     * @brief Índice de negociabilidade no critério da B3
+     *
+     * @return double 100 × (p/P) × √((n/N) × (v/V)), em que p/P é a fração dos
+     * pregões com negócios no papel, n/N a fração dos negócios e v/V a fração
+     * do volume do mercado; 0 se a janela não tem pregões
+     */
+    double indiceNegociabilidade() const;
+};
+
+/**
+ * @brief Datas de pregão de um papel (AAAAMMDD), em ordem crescente
+ *
+ * @details Fatia de uma coluna contígua de datas, sem cópia: percorrer ou
+ * contar as datas de um papel não lê o arquivo nem aloca. O campo dono mantém
+ * vivo quem guarda a coluna (índice do ano, segmento compartilhado) enquanto a
+ * fatia existir, mesmo que o catálogo descarte ou troque a versão publicada.
+ */
+struct DatasPapel
+{
+    const uint32_t *inicio = nullptr;
+    const uint32_t *fim = nullptr;
+    std::shared_ptr<const void> dono;
+
+    const uint32_t *begin() const
+    {
+        return inicio;
+    }
+
+    const uint32_t *end() const
+    {
+        return fim;
+    }
+
+    size_t size() const
+    {
+        return static_cast<size_t>(fim - inicio);
+    }
+
+    bool empty() const
+    {
+        return inicio == fim;
+    }
+
+    uint32_t operator[](size_t i) const
+    {
+        return inicio[i];
+    }
+
+    /**
+     * @brief Parte da fatia entre duas datas, inclusive, por busca binária
+     */
+    DatasPapel janela(uint32_t dataInicial, uint32_t dataFinal) const;
+};
+
+/**
+ * @brief Índice em memória das cotações históricas
+ *
+ * @details Carrega o arquivo de dados históricos uma única vez e organiza os
+ * registros em colunas ordenadas por (papel, data). Cada papel ocupa uma faixa
+ * contígua das colunas, de modo que a busca de preço é uma consulta em tabela
+ * hash seguida de busca binária na faixa do papel. Após a carga o índice é
+ * somente leitura e pode ser compartilhado entre threads.
+ *
+ * Abertura, máxima, mínima e média existem nos dois layouts e têm sempre uma
+ * coluna. Os demais campos do layout completo (última, ofertas, negócios,
+ * quantidade, volume, dados de opções, fator e distribuição) só ocupam memória
+ * quando ao menos um registro carregado veio nesse layout; o ISIN é guardado
+ * uma vez por papel, assim como o nome resumido da empresa.
+ *
+ * Com o layout completo, o índice mantém também somas prefixadas de
+ * quantidade, volume, negócios e pregões negociados, na mesma ordem das
+ * colunas, e somas por data do mercado inteiro. A estatística de qualquer
+ * janela sai de duas buscas binárias e subtrações, sem percorrer os registros.
+ *
+ * A carga também avalia a qualidade dos dados: cada registro ganha uma
+ * máscara de MarcaQualidade em uma coluna própria, e o resumo fica em
+ * obterRelatorioQualidade(). As verificações de preço e nome são feitas na
+ * leitura; duplicados e lacunas, em uma passada sobre as colunas já
+ * ordenadas.
+ */
+class IndiceCotacoes
+{
+  private:
+    std::string caminhoArquivo;
+    std::string diretorioCheckpoints;
+    std::vector<std::string> papeis;
+    std::unordered_map<std::string, uint32_t> idPorPapel;
+    std::vector<uint32_t> inicioPapel;
+    std::vector<std::string> isinPapel;
+    std::vector<std::string> nomePapel;
+    std::vector<uint32_t> colunaData;
+    std::vector<long long> colunaPreco;
+    std::vector<long long> colunaAbertura;
+    std::vector<long long> colunaMaximo;
+    std::vector<long long> colunaMinimo;
+
+    // Colunas do layout completo; vazias se nenhum arquivo carregado o usa
+    std::vector<long long> colunaUltimo;
+    std::vector<long long> colunaOfertaCompra;
+    std::vector<long long> colunaOfertaVenda;
+    std::vector<uint32_t> colunaNegocios;
+    std::vector<long long> colunaQuantidade;
+    std::vector<long long> colunaVolume;
+    std::vector<long long> colunaExercicio;
+    std::vector<uint8_t> colunaIndicador;
+    std::vector<uint32_t> colunaVencimento;
+    std::vector<uint32_t> colunaFator;
+    std::vector<uint16_t> colunaDistribuicao;
+    std::vector<uint8_t> colunaCompleto;
+
+    std::vector<uint8_t> colunaQualidade; ///< Máscara de MarcaQualidade de cada registro
+    RelatorioQualidade relatorioQualidade;
+
+    // Somas prefixadas: a posição i guarda a soma dos registros [0, i)
+    std::vector<long long> prefixoQuantidade;
+    std::vector<long long> prefixoVolume;
+    std::vector<long long> prefixoNegocios;
+    std::vector<uint32_t> prefixoPregoesNegociados;
+    std::vector<uint32_t> datasPregao;
+    std::vector<long long> prefixoNegociosMercado;
+    std::vector<long long> prefixoVolumeMercado;
+
+    void montarDatasPregao();
+    void calcularPrefixos();
+    void classificarQualidade();
+
+    void limpar();
+    size_t papelNaPosicao(size_t posicao) const;
+    bool localizar(const std::string &codigoNegociacao, uint32_t data, size_t *posicao) const;
+
+  public:
+    /**
+     * @brief Ativa os checkpoints de leitura incremental
+     *
+     * @param diretorio Diretório onde os checkpoints são gravados; vazio desativa
+     * @see CheckpointCotahist
+     */
+    void setDiretorioCheckpoints(const std::string &diretorio)
+    {
+        diretorioCheckpoints = diretorio;
+    }
+
+    /**
+     * @brief Carrega o arquivo de dados históricos
+     *
+     * @param caminho Caminho do arquivo no formato COTAHIST
+     * @return bool true se o arquivo foi aberto e lido
+     */
+    bool carregar(const std::string &caminho);
+
+    /**
+     * @brief Carrega vários arquivos de dados históricos em um único índice
+     *
+     * @param caminhos Arquivos no formato COTAHIST, na ordem de precedência
+     * @return bool true se todos os arquivos foram abertos e lidos
+     */
+    bool carregar(const std::vector<std::string> &caminhos);
+
+    /**
+     * @brief Busca o preço de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param data Data no formato AAAAMMDD
+     * @param precoCentavos Ponteiro para armazenar o preço em centavos
+     * @return bool true se a combinação papel+data existe
+     */
+    bool buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos) const;
+
+    /**
+     * @brief Verifica se existe cotação para um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param data Data no formato AAAAMMDD
+     * @return bool true se a combinação existe
+     */
+    bool contem(const std::string &codigoNegociacao, uint32_t data) const;
+
+    /**
+     * @brief Lê o registro em uma posição das colunas
+     *
+     * @param posicao Posição entre 0 e quantidadeRegistros() - 1
+     * @param codigoNegociacao Ponteiro para armazenar o código do papel (opcional)
+     * @param data Ponteiro para armazenar a data (opcional)
+     * @param precoCentavos Ponteiro para armazenar o preço (opcional)
+     * @return bool true se a posição é válida
+     */
+    bool obterRegistro(size_t posicao, std::string *codigoNegociacao, uint32_t *data, long long *precoCentavos) const;
+
+    /**
+     * @brief Lê todos os campos do registro em uma posição das colunas
+     *
+     * @param posicao Posição entre 0 e quantidadeRegistros() - 1
+     * @param registro Registro onde os campos são armazenados
+     * @return bool true se a posição é válida
+     */
+    bool obterRegistroCompleto(size_t posicao, RegistroCotacao *registro) const;
+
+    /**
+     * @brief Lê os dados de um papel
+     *
+     * @param papel Papel entre 0 e quantidadePapeis() - 1, na ordem das colunas
+     * @param codigoNegociacao Ponteiro para armazenar o código (opcional)
+     * @param nomeResumido Ponteiro para armazenar o nome resumido da empresa (opcional)
+     * @param pregoes Ponteiro para armazenar a quantidade de datas distintas do papel (opcional)
+     * @param codigoIsin Ponteiro para armazenar o ISIN, vazio no layout truncado (opcional)
+     * @return bool true se o papel existe
+     */
+    bool obterPapel(size_t papel, std::string *codigoNegociacao, std::string *nomeResumido, size_t *pregoes,
+                    std::string *codigoIsin = nullptr) const;
+
+    /**
+     * @brief Localiza um papel pelo código
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param papel Ponteiro para armazenar o papel, na ordem das colunas
+     * @return bool true se o índice conhece o papel
+     */
+    bool localizarPapel(const std::string &codigoNegociacao, size_t *papel) const;
+
+    /**
+     * @brief Trecho das colunas com os registros de um papel em uma janela de datas
+     *
+     * @param papel Papel entre 0 e quantidadePapeis() - 1
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param inicio Ponteiro para armazenar a primeira posição do trecho
+     * @param fim Ponteiro para armazenar a posição seguinte à última do trecho
+     * @return bool true se o papel existe; o trecho pode ser vazio
+     */
+    bool obterFaixa(size_t papel, uint32_t dataInicial, uint32_t dataFinal, size_t *inicio, size_t *fim) const;
+
+    /**
+     * @brief Copia um trecho de uma coluna numérica, sem montar registros
+     *
+     * @param campo CAMPO_DATA, CAMPO_DATVEN ou um campo de preço, negociação, opção, fator ou distribuição
+     * @param inicio Primeira posição do trecho
+     * @param fim Posição seguinte à última do trecho
+     * @param destino Espaço para fim - inicio valores
+     * @return bool true se o campo tem coluna no índice e o trecho é válido
+     * @details Campos do layout completo que não foram carregados saem como em
+     * obterRegistroCompleto: zero, e 1 no fator de cotação.
+     */
+    bool copiarColuna(CampoCotahist campo, size_t inicio, size_t fim, long long *destino) const;
+
+    /**
+     * @brief Busca todos os campos da cotação de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param data Data no formato AAAAMMDD
+     * @param registro Registro onde os campos são armazenados
+     * @return bool true se a combinação papel+data existe
+     */
+    bool buscarRegistro(const std::string &codigoNegociacao, uint32_t data, RegistroCotacao *registro) const;
+
+    /**
+     * @brief Datas em que um papel tem cotação
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param datas Fatia da coluna de datas do papel; o dono fica a cargo de quem segura o índice
+     * @return bool true se o índice conhece o papel
+     */
+    bool obterDatas(const std::string &codigoNegociacao, DatasPapel *datas) const;
+
+    /**
+     * @brief Soma a negociação de um papel em uma janela de datas
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param estatisticas Estrutura onde as somas são armazenadas
+     * @return bool true se o índice tem o layout completo e conhece o papel
+     * @details O(log n) para localizar a janela e O(1) para as somas. Registros
+     * duplicados de um (papel, data) não entram nas somas.
+     */
+    bool somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial, uint32_t dataFinal,
+                         EstatisticasNegociacao *estatisticas) const;
+
+    /**
+     * @brief Lê a máscara de qualidade do registro em uma posição das colunas
+     *
+     * @param posicao Posição entre 0 e quantidadeRegistros() - 1
+     * @param marcas Ponteiro para armazenar a combinação de MarcaQualidade (0 se o registro não tem problemas)
+     * @return bool true se a posição é válida
+     */
+    bool obterQualidade(size_t posicao, uint8_t *marcas) const;
+
+    /**
+     * @brief Resumo da qualidade dos arquivos carregados
+     */
+    const RelatorioQualidade &obterRelatorioQualidade() const
+    {
+        return relatorioQualidade;
+    }
+
+    /**
+     * @brief Indica se as colunas do layout completo estão carregadas
+     */
+    bool possuiLayoutCompleto() const
+    {
+        return !colunaCompleto.empty();
+    }
+
+    /**
+     * @brief Indica se o registro em uma posição das colunas veio do layout completo
+     *
+     * @return bool false também para posições inválidas e quando nenhum registro tem o layout completo
+     */
+    bool registroCompleto(size_t posicao) const
+    {
+        return posicao < colunaCompleto.size() && colunaCompleto[posicao] != 0;
+    }
+
+    /**
+     * @brief Caminho do arquivo carregado
+     */
+    const std::string &getCaminhoArquivo() const
+    {
+        return caminhoArquivo;
+    }
+
+    /**
+     * @brief Quantidade de registros carregados
+     */
+    size_t quantidadeRegistros() const
+    {
+        return colunaData.size();
+    }
+
+    /**
+     * @brief Quantidade de papéis distintos carregados
+     */
+    size_t quantidadePapeis() const
+    {
+        return papeis.size();
+    }
+
+    /**
+     * @brief Memória aproximada ocupada pelo índice, em bytes
+     */
+    size_t memoriaEstimada() const;
+};
+
+#endif // INDICECOTACOES_HPP_INCLUDED
@@ -0,0 +1,686 @@
+#include "IndiceDeslocamentos.hpp"
+#include "ArquivoZip.hpp"
+#include "ImpressaoArquivo.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+const char ASSINATURA[8] = {'I', 'D', 'X', 'C', 'O', 'T', '0', '3'};
+const size_t TAMANHO_CODIGO = 12;
+
+/**
+ * @brief Cabeçalho do arquivo auxiliar
+ * @details Seguido pela tabela de códigos (papeis × 12 bytes, completados com
+ *          espaços e em ordem crescente), preenchimento até múltiplo de 8, as
+ *          entradas ordenadas por (papel, data) e os trechos ordenados por
+ *          (data, início). Gravado no formato nativo da
+ *          máquina; um auxiliar de outra arquitetura não confere e é regerado.
+ */
+struct Cabecalho
+{
+    char assinatura[8];
+    uint64_t tamanhoArquivo;
+    int64_t modificacaoSegundos;
+    int64_t modificacaoNanossegundos;
+    uint64_t somaInicio;
+    uint64_t somaFim;
+    uint64_t papeis;
+    uint64_t registros;
+    uint64_t trechos;
+};
+
+struct Entrada
+{
+    uint32_t papel;
+    uint32_t data;
+    uint64_t deslocamento;
+};
+
+/**
+ * @brief Trecho contíguo do arquivo em que todas as linhas válidas têm a mesma data
+ */
+struct Trecho
+{
+    uint32_t data;
+    uint32_t reservado;
+    uint64_t inicio;
+    uint64_t fim;
+};
+
+static_assert(sizeof(Cabecalho) == 72, "cabeçalho do auxiliar sem preenchimento");
+static_assert(sizeof(Entrada) == 16, "entrada do auxiliar sem preenchimento");
+static_assert(sizeof(Trecho) == 24, "trecho do auxiliar sem preenchimento");
+
+/**
+ * @brief Distância máxima entre dois trechos lidos com um único pread
+ */
+const uint64_t DISTANCIA_JUNCAO = 64 * 1024;
+
+/**
+ * @brief Tamanho de cada leitura ao percorrer trechos
+ */
+const size_t TAMANHO_LEITURA_TRECHOS = 1 << 20;
+
+size_t inicioEntradas(uint64_t papeis)
+{
+    size_t fimTabela = sizeof(Cabecalho) + static_cast<size_t>(papeis) * TAMANHO_CODIGO;
+    return (fimTabela + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * @brief Preenche no cabeçalho a identificação do arquivo de dados
+ */
+bool identificarArquivo(int fd, Cabecalho *cabecalho)
+{
+    struct stat informacoes;
+    if (fstat(fd, &informacoes) != 0)
+    {
+        return false;
+    }
+
+    uint64_t tamanho = static_cast<uint64_t>(informacoes.st_size);
+    cabecalho->tamanhoArquivo = tamanho;
+    cabecalho->modificacaoSegundos = static_cast<int64_t>(informacoes.st_mtim.tv_sec);
+    cabecalho->modificacaoNanossegundos = static_cast<int64_t>(informacoes.st_mtim.tv_nsec);
+    ImpressaoArquivo::somarExtremos(fd, tamanho, &cabecalho->somaInicio, &cabecalho->somaFim);
+    return true;
+}
+
+std::string codigoPreenchido(const std::string &codigo)
+{
+    std::string preenchido = codigo.substr(0, TAMANHO_CODIGO);
+    preenchido.resize(TAMANHO_CODIGO, ' ');
+    return preenchido;
+}
+} // namespace
+
+IndiceDeslocamentos::IndiceDeslocamentos()
+    : fdArquivo(-1), mapa(nullptr), tamanhoMapa(0), quantidadePapeisIndice(0), quantidadeRegistrosIndice(0),
+      quantidadeTrechosIndice(0), tabelaPapeis(nullptr), entradas(nullptr), trechos(nullptr)
+{
+}
+
+IndiceDeslocamentos::~IndiceDeslocamentos()
+{
+    fechar();
+}
+
+void IndiceDeslocamentos::fechar()
+{
+    if (mapa)
+    {
+        munmap(const_cast<unsigned char *>(mapa), tamanhoMapa);
+    }
+    if (fdArquivo >= 0)
+    {
+        close(fdArquivo);
+    }
+
+    fdArquivo = -1;
+    mapa = nullptr;
+    tamanhoMapa = 0;
+    quantidadePapeisIndice = 0;
+    quantidadeRegistrosIndice = 0;
+    quantidadeTrechosIndice = 0;
+    tabelaPapeis = nullptr;
+    entradas = nullptr;
+    trechos = nullptr;
+    caminhoArquivo.clear();
+}
+
+std::string IndiceDeslocamentos::caminhoIndice(const std::string &caminhoArquivo)
+{
+    return caminhoArquivo + ".idx";
+}
+
+/**
+ * @brief Gera o arquivo auxiliar a partir do arquivo de dados
+ * @details Uma passada pelo arquivo registra o deslocamento de cada linha
+ *          válida; os papéis recebem identificadores na ordem alfabética dos
+ *          códigos, para que a tabela de códigos também seja pesquisável por
+ *          busca binária.
+ */
+bool IndiceDeslocamentos::gerar(const std::string &caminhoArquivo, const std::string &caminhoIndice)
+{
+    if (ArquivoZip::ehZip(caminhoArquivo))
+    {
+        std::cerr << "Erro: o índice de deslocamentos exige um arquivo de texto, não um ZIP: " << caminhoArquivo
+                  << std::endl;
+        return false;
+    }
+
+    std::ifstream arquivo(caminhoArquivo, std::ios::binary);
+    int fd = open(caminhoArquivo.c_str(), O_RDONLY | O_CLOEXEC);
+    if (!arquivo.is_open() || fd < 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+
+    Cabecalho cabecalho;
+    std::memset(&cabecalho, 0, sizeof(cabecalho));
+    std::memcpy(cabecalho.assinatura, ASSINATURA, sizeof(ASSINATURA));
+    bool identificado = identificarArquivo(fd, &cabecalho);
+    close(fd);
+    if (!identificado)
+    {
+        return false;
+    }
+
+    std::vector<std::string> papeis;
+    std::unordered_map<std::string, uint32_t> idPorPapel;
+    std::vector<Entrada> lidas;
+    std::vector<Trecho> trechos;
+    RegistroCotacao registro;
+    std::string linha;
+    uint64_t deslocamento = 0;
+    while (std::getline(arquivo, linha))
+    {
+        if (LeitorCotahist::interpretarLinha(linha, &registro))
+        {
+            // Uma data diferente da anterior fecha o trecho corrente
+            if (trechos.empty() || trechos.back().data != registro.data)
+            {
+                if (!trechos.empty())
+                {
+                    trechos.back().fim = deslocamento;
+                }
+                trechos.push_back({registro.data, 0, deslocamento, 0});
+            }
+
+            auto resultado = idPorPapel.emplace(registro.codigoNegociacao, static_cast<uint32_t>(papeis.size()));
+            if (resultado.second)
+            {
+                papeis.push_back(registro.codigoNegociacao);
+            }
+            lidas.push_back({resultado.first->second, registro.data, deslocamento});
+        }
+        deslocamento += linha.size() + 1;
+    }
+    // Sem '\n' no fim, a última linha não tem o byte a mais que a conta acima supõe
+    if (!trechos.empty())
+    {
+        trechos.back().fim = std::min(deslocamento, cabecalho.tamanhoArquivo);
+    }
+    std::stable_sort(trechos.begin(), trechos.end(), [](const Trecho &a, const Trecho &b) { return a.data < b.data; });
+
+    // Identificadores em ordem alfabética dos códigos preenchidos
+    std::vector<uint32_t> ordemPapeis(papeis.size());
+    std::iota(ordemPapeis.begin(), ordemPapeis.end(), 0);
+    std::sort(ordemPapeis.begin(), ordemPapeis.end(),
+              [&](uint32_t a, uint32_t b) { return codigoPreenchido(papeis[a]) < codigoPreenchido(papeis[b]); });
+    std::vector<uint32_t> novoId(papeis.size());
+    for (size_t i = 0; i < ordemPapeis.size(); i++)
+    {
+        novoId[ordemPapeis[i]] = static_cast<uint32_t>(i);
+    }
+    for (Entrada &entrada : lidas)
+    {
+        entrada.papel = novoId[entrada.papel];
+    }
+
+    std::stable_sort(lidas.begin(), lidas.end(), [](const Entrada &a, const Entrada &b) {
+        return a.papel != b.papel ? a.papel < b.papel : a.data < b.data;
+    });
+    lidas.erase(std::unique(lidas.begin(), lidas.end(),
+                            [](const Entrada &a, const Entrada &b) { return a.papel == b.papel && a.data == b.data; }),
+                lidas.end());
+
+    cabecalho.papeis = papeis.size();
+    cabecalho.registros = lidas.size();
+    cabecalho.trechos = trechos.size();
+
+    // Nome próprio do processo: dois processos montando o mesmo auxiliar não escrevem no mesmo temporário
+    std::string caminhoTemporario = caminhoIndice + "." + std::to_string(getpid()) + ".tmp";
+    std::ofstream saida(caminhoTemporario, std::ios::binary | std::ios::trunc);
+    saida.write(reinterpret_cast<const char *>(&cabecalho), sizeof(cabecalho));
+    for (uint32_t id : ordemPapeis)
+    {
+        saida.write(codigoPreenchido(papeis[id]).data(), TAMANHO_CODIGO);
+    }
+    const char preenchimento[8] = {0};
+    size_t tamanhoTabela = sizeof(Cabecalho) + papeis.size() * TAMANHO_CODIGO;
+    saida.write(preenchimento, static_cast<std::streamsize>(inicioEntradas(cabecalho.papeis) - tamanhoTabela));
+    saida.write(reinterpret_cast<const char *>(lidas.data()),
+                static_cast<std::streamsize>(lidas.size() * sizeof(Entrada)));
+    saida.write(reinterpret_cast<const char *>(trechos.data()),
+                static_cast<std::streamsize>(trechos.size() * sizeof(Trecho)));
+    saida.close();
+
+    if (!saida || std::rename(caminhoTemporario.c_str(), caminhoIndice.c_str()) != 0)
+    {
+        std::cerr << "Erro: Não foi possível gravar o índice de deslocamentos " << caminhoIndice << std::endl;
+        std::remove(caminhoTemporario.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Mapeia o auxiliar e confere se ele corresponde ao arquivo de dados aberto
+ */
+bool IndiceDeslocamentos::mapear(const std::string &caminhoIndice)
+{
+    int fd = open(caminhoIndice.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat informacoes;
+    void *endereco = MAP_FAILED;
+    if (fstat(fd, &informacoes) == 0 && static_cast<size_t>(informacoes.st_size) >= sizeof(Cabecalho))
+    {
+        endereco = mmap(nullptr, static_cast<size_t>(informacoes.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (endereco == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mapa = static_cast<const unsigned char *>(endereco);
+    tamanhoMapa = static_cast<size_t>(informacoes.st_size);
+
+    Cabecalho gravado;
+    Cabecalho atual;
+    std::memcpy(&gravado, mapa, sizeof(gravado));
+    bool confere = std::memcmp(gravado.assinatura, ASSINATURA, sizeof(ASSINATURA)) == 0 &&
+                   identificarArquivo(fdArquivo, &atual) && gravado.tamanhoArquivo == atual.tamanhoArquivo &&
+                   gravado.modificacaoSegundos == atual.modificacaoSegundos &&
+                   gravado.modificacaoNanossegundos == atual.modificacaoNanossegundos &&
+                   gravado.somaInicio == atual.somaInicio && gravado.somaFim == atual.somaFim &&
+                   tamanhoMapa == inicioEntradas(gravado.papeis) + gravado.registros * sizeof(Entrada) +
+                                      gravado.trechos * sizeof(Trecho);
+    if (!confere)
+    {
+        munmap(const_cast<unsigned char *>(mapa), tamanhoMapa);
+        mapa = nullptr;
+        tamanhoMapa = 0;
+        return false;
+    }
+
+    quantidadePapeisIndice = gravado.papeis;
+    quantidadeRegistrosIndice = gravado.registros;
+    quantidadeTrechosIndice = gravado.trechos;
+    tabelaPapeis = reinterpret_cast<const char *>(mapa + sizeof(Cabecalho));
+    entradas = mapa + inicioEntradas(gravado.papeis);
+    trechos = entradas + gravado.registros * sizeof(Entrada);
+    return true;
+}
+
+/**
+ * @brief Abre o arquivo de dados e seu auxiliar, regerando-o se necessário
+ * @details O auxiliar fica ao lado do arquivo de dados. Se ele não existe ou
+ *          não confere com o arquivo (tamanho, modificação ou blocos
+ *          extremos), é gerado de novo antes de ser mapeado.
+ */
+bool IndiceDeslocamentos::abrir(const std::string &caminho)
+{
+    fechar();
+
+    if (ArquivoZip::ehZip(caminho))
+    {
+        std::cerr << "Erro: o índice de deslocamentos exige um arquivo de texto, não um ZIP: " << caminho
+                  << std::endl;
+        return false;
+    }
+
+    fdArquivo = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fdArquivo < 0)
+    {
+        return false;
+    }
+    caminhoArquivo = caminho;
+
+    std::string auxiliar = caminhoIndice(caminho);
+    if (mapear(auxiliar))
+    {
+        return true;
+    }
+
+    std::cerr << "Gerando índice de deslocamentos " << auxiliar << "..." << std::endl;
+    if (!gerar(caminho, auxiliar) || !mapear(auxiliar))
+    {
+        fechar();
+        return false;
+    }
+    return true;
+}
+
+bool IndiceDeslocamentos::localizarPapel(const std::string &codigoNegociacao, uint32_t *papel) const
+{
+    if (!mapa)
+    {
+        return false;
+    }
+
+    std::string codigo = LeitorCotahist::limparCampo(codigoNegociacao);
+    if (codigo.empty() || codigo.size() > TAMANHO_CODIGO)
+    {
+        return false;
+    }
+    std::string chave = codigoPreenchido(codigo);
+
+    // Busca binária na tabela de códigos, de largura fixa
+    uint64_t inicio = 0;
+    uint64_t fim = quantidadePapeisIndice;
+    while (inicio < fim)
+    {
+        uint64_t meio = inicio + (fim - inicio) / 2;
+        if (std::memcmp(tabelaPapeis + meio * TAMANHO_CODIGO, chave.data(), TAMANHO_CODIGO) < 0)
+        {
+            inicio = meio + 1;
+        }
+        else
+        {
+            fim = meio;
+        }
+    }
+    if (inicio == quantidadePapeisIndice ||
+        std::memcmp(tabelaPapeis + inicio * TAMANHO_CODIGO, chave.data(), TAMANHO_CODIGO) != 0)
+    {
+        return false;
+    }
+
+    *papel = static_cast<uint32_t>(inicio);
+    return true;
+}
+
+bool IndiceDeslocamentos::localizar(const std::string &codigoNegociacao, uint32_t data,
+                                    uint64_t *deslocamento) const
+{
+    uint32_t papel;
+    if (!localizarPapel(codigoNegociacao, &papel))
+    {
+        return false;
+    }
+
+    const Entrada *primeira = reinterpret_cast<const Entrada *>(entradas);
+    const Entrada *ultima = primeira + quantidadeRegistrosIndice;
+    Entrada procurada = {papel, data, 0};
+    const Entrada *encontrada =
+        std::lower_bound(primeira, ultima, procurada, [](const Entrada &a, const Entrada &b) {
+            return a.papel != b.papel ? a.papel < b.papel : a.data < b.data;
+        });
+    if (encontrada == ultima || encontrada->papel != procurada.papel || encontrada->data != data)
+    {
+        return false;
+    }
+
+    *deslocamento = encontrada->deslocamento;
+    return true;
+}
+
+/**
+ * @brief Busca todos os campos da cotação de um papel em uma data
+ * @details Lê a linha com pread, que não altera a posição do descritor e pode
+ *          ser chamado por várias threads ao mesmo tempo. A linha lida precisa
+ *          ser do papel e da data pedidos; caso contrário o arquivo mudou sem
+ *          que o auxiliar percebesse, e a consulta falha.
+ */
+bool IndiceDeslocamentos::buscarRegistro(const std::string &codigoNegociacao, uint32_t data,
+                                         RegistroCotacao *registro) const
+{
+    uint64_t deslocamento;
+    if (!registro || !localizar(codigoNegociacao, data, &deslocamento))
+    {
+        return false;
+    }
+
+    char buffer[TAMANHO_MAXIMO_LINHA];
+    ssize_t lidos = pread(fdArquivo, buffer, sizeof(buffer), static_cast<off_t>(deslocamento));
+    if (lidos <= 0)
+    {
+        return false;
+    }
+
+    const char *quebra = static_cast<const char *>(std::memchr(buffer, '\n', static_cast<size_t>(lidos)));
+    std::string linha(buffer, quebra ? static_cast<size_t>(quebra - buffer) : static_cast<size_t>(lidos));
+    if (!LeitorCotahist::interpretarLinha(linha, registro) || registro->data != data ||
+        registro->codigoNegociacao != LeitorCotahist::limparCampo(codigoNegociacao))
+    {
+        std::cerr << "Erro: " << caminhoArquivo << " mudou desde a geração do índice de deslocamentos!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool IndiceDeslocamentos::buscarPreco(const std::string &codigoNegociacao, uint32_t data,
+                                      long long *precoCentavos) const
+{
+    RegistroCotacao registro;
+    if (!precoCentavos || !buscarRegistro(codigoNegociacao, data, &registro))
+    {
+        return false;
+    }
+
+    *precoCentavos = registro.precoMedioCentavos;
+    return true;
+}
+
+bool IndiceDeslocamentos::contem(const std::string &codigoNegociacao, uint32_t data) const
+{
+    uint64_t deslocamento;
+    return localizar(codigoNegociacao, data, &deslocamento);
+}
+
+/**
+ * @brief Lê um papel da tabela de códigos do auxiliar
+ * @details As entradas repetidas de um papel e data foram descartadas na
+ *          geração, então as entradas do papel são as suas datas. O nome vem
+ *          da linha da primeira delas, lida como em buscarRegistro().
+ */
+bool IndiceDeslocamentos::obterPapel(size_t papel, std::string *codigoNegociacao, std::string *nomeResumido,
+                                     size_t *pregoes) const
+{
+    if (!mapa || papel >= quantidadePapeisIndice)
+    {
+        return false;
+    }
+
+    std::string codigo =
+        LeitorCotahist::limparCampo(std::string(tabelaPapeis + papel * TAMANHO_CODIGO, TAMANHO_CODIGO));
+    const Entrada *primeira = reinterpret_cast<const Entrada *>(entradas);
+    const Entrada *ultima = primeira + quantidadeRegistrosIndice;
+    auto anterior = [](const Entrada &atual, uint32_t procurado) { return atual.papel < procurado; };
+    const Entrada *inicio = std::lower_bound(primeira, ultima, static_cast<uint32_t>(papel), anterior);
+    const Entrada *fim = std::lower_bound(inicio, ultima, static_cast<uint32_t>(papel + 1), anterior);
+
+    if (nomeResumido)
+    {
+        RegistroCotacao registro;
+        bool lido = inicio != fim && buscarRegistro(codigo, inicio->data, &registro);
+        *nomeResumido = lido ? registro.nomeResumido : "";
+    }
+    if (codigoNegociacao)
+    {
+        *codigoNegociacao = codigo;
+    }
+    if (pregoes)
+    {
+        *pregoes = static_cast<size_t>(fim - inicio);
+    }
+    return true;
+}
+
+/**
+ * @brief Percorre as linhas de uma janela de datas
+ * @details Os trechos da janela são localizados por busca binária e ordenados
+ *          pela posição no arquivo; trechos separados por menos de
+ *          DISTANCIA_JUNCAO bytes são lidos juntos, e as linhas de outras datas
+ *          que vierem no meio são descartadas pelo filtro de data.
+ */
+bool IndiceDeslocamentos::percorrerDatas(uint32_t dataInicial, uint32_t dataFinal,
+                                         const std::function<void(const RegistroCotacao &)> &consumir) const
+{
+    if (!mapa)
+    {
+        return false;
+    }
+
+    const Trecho *primeiro = reinterpret_cast<const Trecho *>(trechos);
+    const Trecho *ultimo = primeiro + quantidadeTrechosIndice;
+    const Trecho *inicioJanela = std::lower_bound(
+        primeiro, ultimo, dataInicial, [](const Trecho &trecho, uint32_t data) { return trecho.data < data; });
+
+    std::vector<Trecho> selecionados;
+    for (const Trecho *trecho = inicioJanela; trecho != ultimo && trecho->data <= dataFinal; trecho++)
+    {
+        selecionados.push_back(*trecho);
+    }
+    std::sort(selecionados.begin(), selecionados.end(),
+              [](const Trecho &a, const Trecho &b) { return a.inicio < b.inicio; });
+
+    std::vector<Trecho> leituras;
+    for (const Trecho &trecho : selecionados)
+    {
+        if (!leituras.empty() && trecho.inicio <= leituras.back().fim + DISTANCIA_JUNCAO)
+        {
+            leituras.back().fim = std::max(leituras.back().fim, trecho.fim);
+        }
+        else
+        {
+            leituras.push_back(trecho);
+        }
+    }
+
+    std::vector<char> buffer(TAMANHO_LEITURA_TRECHOS);
+    RegistroCotacao registro;
+    std::string pendente;
+    std::string linha;
+    for (const Trecho &leitura : leituras)
+    {
+        pendente.clear();
+        for (uint64_t posicao = leitura.inicio; posicao < leitura.fim;)
+        {
+            size_t pedir = static_cast<size_t>(std::min<uint64_t>(buffer.size(), leitura.fim - posicao));
+            ssize_t lidos = pread(fdArquivo, buffer.data(), pedir, static_cast<off_t>(posicao));
+            if (lidos <= 0)
+            {
+                std::cerr << "Erro: falha ao ler " << caminhoArquivo << std::endl;
+                return false;
+            }
+            posicao += static_cast<uint64_t>(lidos);
+
+            const char *inicio = buffer.data();
+            const char *limite = inicio + lidos;
+            while (inicio < limite)
+            {
+                const char *quebra =
+                    static_cast<const char *>(std::memchr(inicio, '\n', static_cast<size_t>(limite - inicio)));
+                if (!quebra)
+                {
+                    pendente.append(inicio, limite);
+                    break;
+                }
+
+                linha.assign(pendente);
+                linha.append(inicio, quebra);
+                pendente.clear();
+                if (LeitorCotahist::interpretarLinha(linha, &registro) && registro.data >= dataInicial &&
+                    registro.data <= dataFinal)
+                {
+                    consumir(registro);
+                }
+                inicio = quebra + 1;
+            }
+        }
+
+        // O último trecho do arquivo pode terminar sem '\n'
+        if (!pendente.empty() && LeitorCotahist::interpretarLinha(pendente, &registro) &&
+            registro.data >= dataInicial && registro.data <= dataFinal)
+        {
+            consumir(registro);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Soma a negociação de um papel em uma janela de datas
+ * @details Uma passada pelos trechos da janela soma o mercado e o papel. Os
+ *          pregões são as datas distintas lidas, como as datas de pregão de
+ *          IndiceCotacoes.
+ */
+bool IndiceDeslocamentos::somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial,
+                                          uint32_t dataFinal, EstatisticasNegociacao *estatisticas) const
+{
+    uint32_t papel;
+    if (!estatisticas || !localizarPapel(codigoNegociacao, &papel))
+    {
+        return false;
+    }
+
+    *estatisticas = EstatisticasNegociacao();
+    if (dataInicial > dataFinal)
+    {
+        return true;
+    }
+
+    std::string codigo = LeitorCotahist::limparCampo(codigoNegociacao);
+    std::set<std::pair<std::string, uint32_t>> lidos;
+    std::set<uint32_t> datas;
+    bool algumCompleto = false;
+    bool percorrido = percorrerDatas(dataInicial, dataFinal, [&](const RegistroCotacao &registro) {
+        algumCompleto = algumCompleto || registro.completo;
+        if (!lidos.emplace(registro.codigoNegociacao, registro.data).second)
+        {
+            return;
+        }
+
+        datas.insert(registro.data);
+        estatisticas->negociosMercado += registro.totalNegocios;
+        estatisticas->volumeMercadoCentavos += registro.volumeTotalCentavos;
+        if (registro.codigoNegociacao == codigo)
+        {
+            estatisticas->pregoesNegociados += registro.totalNegocios > 0 ? 1 : 0;
+            estatisticas->negocios += registro.totalNegocios;
+            estatisticas->quantidadeTotal += registro.quantidadeTotal;
+            estatisticas->volumeTotalCentavos += registro.volumeTotalCentavos;
+        }
+    });
+    estatisticas->pregoes = static_cast<uint32_t>(datas.size());
+    return percorrido && (algumCompleto || lidos.empty());
+}
+
+/**
+ * @brief Datas de um papel, copiadas das entradas do auxiliar
+ * @details As entradas de um papel são contíguas e ordenadas por data, mas
+ *          intercaladas com os deslocamentos; a cópia toca só as páginas do
+ *          papel e não lê o arquivo de dados.
+ */
+std::vector<uint32_t> IndiceDeslocamentos::listarDatas(const std::string &codigoNegociacao) const
+{
+    std::vector<uint32_t> datas;
+    uint32_t papel;
+    if (!localizarPapel(codigoNegociacao, &papel))
+    {
+        return datas;
+    }
+
+    const Entrada *primeira = reinterpret_cast<const Entrada *>(entradas);
+    const Entrada *ultima = primeira + quantidadeRegistrosIndice;
+    const Entrada *entrada = std::lower_bound(
+        primeira, ultima, papel, [](const Entrada &atual, uint32_t procurado) { return atual.papel < procurado; });
+    for (; entrada != ultima && entrada->papel == papel; entrada++)
+    {
+        datas.push_back(entrada->data);
+    }
+    return datas;
+}
@@ -0,0 +1,206 @@
+#ifndef INDICEDESLOCAMENTOS_HPP_INCLUDED
+#define INDICEDESLOCAMENTOS_HPP_INCLUDED
+
+#include "IndiceCotacoes.hpp"
+#include "LeitorCotahist.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Índice em disco de deslocamentos do arquivo de dados históricos
+ *
+ * @details Para implantações em que o arquivo texto continua sendo a fonte da
+ * verdade e não se quer manter as cotações em memória. Um arquivo auxiliar
+ * "<arquivo>.idx" guarda, ordenados, os códigos de negociação (12 bytes cada)
+ * e as entradas (papel, data, deslocamento da linha). O auxiliar é mapeado com
+ * mmap e consultado por busca binária; a cotação é obtida lendo uma única
+ * linha do arquivo original com pread. A memória residente se limita às
+ * páginas do auxiliar efetivamente tocadas, que ficam no cache do sistema.
+ *
+ * O auxiliar também guarda um índice esparso por data: cada trecho contíguo
+ * do arquivo cujas linhas têm a mesma data vira uma entrada (data, início,
+ * fim). Consultas restritas a uma janela de datas (somarNegociacao(), usada
+ * pelo catálogo no modo arquivo) leem só os trechos dela. Em
+ * um arquivo agrupado por data há um trecho por pregão; em um arquivo
+ * intercalado, como a amostra DADOS_HISTORICOS.txt, há mais trechos e a
+ * economia é menor, mas o resultado é o mesmo.
+ *
+ * O auxiliar guarda o tamanho, a data de modificação e somas FNV-1a do
+ * primeiro e do último bloco do arquivo original; se algum deles não confere,
+ * o auxiliar é regerado ao abrir. Arquivos ZIP não são suportados, pois não
+ * permitem acesso direto a uma linha.
+ *
+ * Depois de aberto, o índice é somente leitura e pode ser consultado por
+ * várias threads.
+ */
+class IndiceDeslocamentos
+{
+  private:
+    std::string caminhoArquivo;
+    int fdArquivo;
+    const unsigned char *mapa;
+    size_t tamanhoMapa;
+    uint64_t quantidadePapeisIndice;
+    uint64_t quantidadeRegistrosIndice;
+    uint64_t quantidadeTrechosIndice;
+    const char *tabelaPapeis;
+    const unsigned char *entradas;
+    const unsigned char *trechos;
+
+    void fechar();
+    bool mapear(const std::string &caminhoIndice);
+    bool localizarPapel(const std::string &codigoNegociacao, uint32_t *papel) const;
+    bool localizar(const std::string &codigoNegociacao, uint32_t data, uint64_t *deslocamento) const;
+
+  public:
+    /**
+     * @brief Tamanho máximo lido do arquivo original para uma linha
+     */
+    static const size_t TAMANHO_MAXIMO_LINHA = 512;
+
+    IndiceDeslocamentos();
+    ~IndiceDeslocamentos();
+
+    IndiceDeslocamentos(const IndiceDeslocamentos &) = delete;
+    IndiceDeslocamentos &operator=(const IndiceDeslocamentos &) = delete;
+
+    /**
+     * @brief Caminho do arquivo auxiliar de um arquivo de dados
+     *
+     * @param caminhoArquivo Arquivo COTAHIST
+     * @return std::string "<caminhoArquivo>.idx"
+     */
+    static std::string caminhoIndice(const std::string &caminhoArquivo);
+
+    /**
+     * @brief Gera o arquivo auxiliar a partir do arquivo de dados
+     *
+     * @param caminhoArquivo Arquivo COTAHIST em texto
+     * @param caminhoIndice Onde gravar o auxiliar (gravado em "<auxiliar>.<pid>.tmp" e renomeado)
+     * @return bool true se o auxiliar foi gravado
+     * @details Para registros repetidos de um mesmo papel e data prevalece o
+     * primeiro do arquivo, como no índice em memória.
+     */
+    static bool gerar(const std::string &caminhoArquivo, const std::string &caminhoIndice);
+
+    /**
+     * @brief Abre o arquivo de dados e seu auxiliar, regerando-o se necessário
+     *
+     * @param caminho Arquivo COTAHIST em texto
+     * @return bool true se o índice está pronto para consulta
+     */
+    bool abrir(const std::string &caminho);
+
+    /**
+     * @brief Busca todos os campos da cotação de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação (espaços finais são ignorados)
+     * @param data Data no formato AAAAMMDD
+     * @param registro Registro onde os campos são armazenados
+     * @return bool true se a combinação existe e a linha foi lida
+     */
+    bool buscarRegistro(const std::string &codigoNegociacao, uint32_t data, RegistroCotacao *registro) const;
+
+    /**
+     * @brief Busca o preço médio de um papel em uma data
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param data Data no formato AAAAMMDD
+     * @param precoCentavos Ponteiro para armazenar o preço em centavos
+     * @return bool true se a combinação existe
+     */
+    bool buscarPreco(const std::string &codigoNegociacao, uint32_t data, long long *precoCentavos) const;
+
+    /**
+     * @brief Verifica se existe cotação para um papel em uma data, sem ler o arquivo de dados
+     */
+    bool contem(const std::string &codigoNegociacao, uint32_t data) const;
+
+    /**
+     * @brief Percorre as cotações de uma janela de datas, lendo só os trechos dela
+     *
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param consumir Chamada para cada registro da janela, na ordem do arquivo
+     * @return bool true se os trechos foram lidos
+     */
+    bool percorrerDatas(uint32_t dataInicial, uint32_t dataFinal,
+                        const std::function<void(const RegistroCotacao &)> &consumir) const;
+
+    /**
+     * @brief Soma a negociação de um papel em uma janela de datas, lendo só os trechos dela
+     *
+     * @param codigoNegociacao Código de negociação
+     * @param dataInicial Primeira data da janela (AAAAMMDD), inclusive
+     * @param dataFinal Última data da janela (AAAAMMDD), inclusive
+     * @param estatisticas Estrutura onde as somas da janela são armazenadas
+     * @return bool true se o papel existe, os trechos foram lidos e a janela tem linhas do layout completo (ou nenhuma)
+     * @details As mesmas somas de IndiceCotacoes::somarNegociacao(); para
+     * registros repetidos de um mesmo papel e data vale só o primeiro.
+     */
+    bool somarNegociacao(const std::string &codigoNegociacao, uint32_t dataInicial, uint32_t dataFinal,
+                         EstatisticasNegociacao *estatisticas) const;
+
+    /**
+     * @brief Datas em que um papel tem cotação, em ordem crescente, sem ler o arquivo de dados
+     */
+    std::vector<uint32_t> listarDatas(const std::string &codigoNegociacao) const;
+
+    /**
+     * @brief Lê um papel da tabela de códigos do auxiliar
+     *
+     * @param papel Papel entre 0 e quantidadePapeis() - 1, em ordem alfabética
+     * @param codigoNegociacao Ponteiro para armazenar o código (opcional)
+     * @param nomeResumido Ponteiro para armazenar o nome resumido (opcional)
+     * @param pregoes Ponteiro para armazenar a quantidade de datas do papel (opcional)
+     * @return bool true se o papel existe
+     * @details O auxiliar não guarda o nome: pedi-lo lê a primeira linha do
+     * papel no arquivo de dados; se a leitura falha, o nome fica vazio.
+     */
+    bool obterPapel(size_t papel, std::string *codigoNegociacao, std::string *nomeResumido, size_t *pregoes) const;
+
+    /**
+     * @brief Quantidade de trechos do índice esparso por data
+     */
+    size_t quantidadeTrechos() const
+    {
+        return static_cast<size_t>(quantidadeTrechosIndice);
+    }
+
+    /**
+     * @brief Indica se abrir() teve sucesso
+     */
+    bool estaAberto() const
+    {
+        return mapa != nullptr;
+    }
+
+    /**
+     * @brief Caminho do arquivo de dados aberto
+     */
+    const std::string &getCaminhoArquivo() const
+    {
+        return caminhoArquivo;
+    }
+
+    /**
+     * @brief Quantidade de registros indexados
+     */
+    size_t quantidadeRegistros() const
+    {
+        return static_cast<size_t>(quantidadeRegistrosIndice);
+    }
+
+    /**
+     * @brief Quantidade de papéis distintos indexados
+     */
+    size_t quantidadePapeis() const
+    {
+        return static_cast<size_t>(quantidadePapeisIndice);
+    }
+};
+
+#endif // INDICEDESLOCAMENTOS_HPP_INCLUDED
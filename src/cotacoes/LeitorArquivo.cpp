@@ -0,0 +1,506 @@
+#include "LeitorArquivo.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/io_uring.h>
+#include <memory>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+std::atomic<int> backendPadrao{LEITURA_READ};
+
+/**
+ * @brief Separa em linhas blocos consecutivos do arquivo
+ * @details Uma linha que atravessa o fim de um bloco fica guardada em resto
+ *          até o bloco seguinte chegar; no fim do arquivo, o que sobrou em
+ *          resto é a última linha, sem '\n'.
+ */
+class SeparadorLinhas
+{
+  private:
+    const std::function<void(const std::string &)> &consumir;
+    std::string linha;
+    std::string resto;
+
+  public:
+    uint64_t consumido = 0;
+
+    explicit SeparadorLinhas(const std::function<void(const std::string &)> &consumir) : consumir(consumir)
+    {
+    }
+
+    void entregar(const char *dados, size_t tamanho)
+    {
+        const char *fim = dados + tamanho;
+        while (dados < fim)
+        {
+            const char *quebra = static_cast<const char *>(std::memchr(dados, '\n', static_cast<size_t>(fim - dados)));
+            if (!quebra)
+            {
+                resto.append(dados, static_cast<size_t>(fim - dados));
+                return;
+            }
+
+            if (resto.empty())
+            {
+                linha.assign(dados, static_cast<size_t>(quebra - dados));
+            }
+            else
+            {
+                linha.swap(resto);
+                linha.append(dados, static_cast<size_t>(quebra - dados));
+                resto.clear();
+            }
+            consumido += linha.size() + 1;
+            consumir(linha);
+            dados = quebra + 1;
+        }
+    }
+
+    /**
+     * @brief Entrega a última linha sem '\n' (ou a guarda em linhaFinal); ela não conta em consumido
+     */
+    void finalizar(std::string *linhaFinal)
+    {
+        if (linhaFinal)
+        {
+            linhaFinal->swap(resto);
+        }
+        else if (!resto.empty())
+        {
+            consumir(resto);
+        }
+        resto.clear();
+    }
+};
+
+bool lerComRead(int fd, uint64_t deslocamento, uint64_t tamanho, SeparadorLinhas &separador)
+{
+    std::vector<char> buffer(LeitorArquivo::TAMANHO_BLOCO);
+    while (deslocamento < tamanho)
+    {
+        ssize_t lidos = pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(deslocamento));
+        if (lidos < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (lidos <= 0)
+        {
+            return lidos == 0;
+        }
+        separador.entregar(buffer.data(), static_cast<size_t>(lidos));
+        deslocamento += static_cast<uint64_t>(lidos);
+    }
+    return true;
+}
+
+bool lerComMmap(int fd, uint64_t deslocamento, uint64_t tamanho, SeparadorLinhas &separador)
+{
+    void *mapa = mmap(nullptr, static_cast<size_t>(tamanho), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapa == MAP_FAILED)
+    {
+        return false;
+    }
+
+    madvise(mapa, static_cast<size_t>(tamanho), MADV_SEQUENTIAL);
+    separador.entregar(static_cast<const char *>(mapa) + deslocamento, static_cast<size_t>(tamanho - deslocamento));
+    munmap(mapa, static_cast<size_t>(tamanho));
+    return true;
+}
+
+/**
+ * @brief Anel io_uring mínimo: fila de submissão e de conclusão mapeadas do kernel
+ */
+class AnelIoUring
+{
+  private:
+    int fd = -1;
+    void *mapaSubmissao = MAP_FAILED;
+    size_t tamanhoSubmissao = 0;
+    void *mapaConclusao = MAP_FAILED;
+    size_t tamanhoConclusao = 0;
+    io_uring_sqe *entradas = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t tamanhoEntradas = 0;
+
+    unsigned *caudaSubmissao = nullptr;
+    unsigned *mascaraSubmissao = nullptr;
+    unsigned *indicesSubmissao = nullptr;
+    unsigned *cabecaConclusao = nullptr;
+    unsigned *caudaConclusao = nullptr;
+    unsigned *mascaraConclusao = nullptr;
+    io_uring_cqe *conclusoes = nullptr;
+    unsigned pendentes = 0;
+    unsigned emVoo = 0;
+
+  public:
+    AnelIoUring() = default;
+    AnelIoUring(const AnelIoUring &) = delete;
+    AnelIoUring &operator=(const AnelIoUring &) = delete;
+
+    /**
+     * @details Antes de fechar, espera toda leitura em voo: quem retorna no meio
+     * de uma carga (erro ou arquivo truncado) libera os buffers logo depois.
+     */
+    ~AnelIoUring()
+    {
+        io_uring_cqe concluida;
+        while (emVoo > 0 && esperar(&concluida))
+        {
+        }
+        if (entradas != MAP_FAILED)
+        {
+            munmap(entradas, tamanhoEntradas);
+        }
+        if (mapaConclusao != MAP_FAILED && mapaConclusao != mapaSubmissao)
+        {
+            munmap(mapaConclusao, tamanhoConclusao);
+        }
+        if (mapaSubmissao != MAP_FAILED)
+        {
+            munmap(mapaSubmissao, tamanhoSubmissao);
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    bool iniciar(unsigned profundidade)
+    {
+        io_uring_params parametros;
+        std::memset(&parametros, 0, sizeof(parametros));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, profundidade, &parametros));
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        tamanhoSubmissao = parametros.sq_off.array + parametros.sq_entries * sizeof(unsigned);
+        tamanhoConclusao = parametros.cq_off.cqes + parametros.cq_entries * sizeof(io_uring_cqe);
+        bool mapaUnico = (parametros.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (mapaUnico)
+        {
+            tamanhoSubmissao = std::max(tamanhoSubmissao, tamanhoConclusao);
+        }
+
+        mapaSubmissao = mmap(nullptr, tamanhoSubmissao, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                             IORING_OFF_SQ_RING);
+        if (mapaSubmissao == MAP_FAILED)
+        {
+            return false;
+        }
+        mapaConclusao = mapaUnico ? mapaSubmissao
+                                  : mmap(nullptr, tamanhoConclusao, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         fd, IORING_OFF_CQ_RING);
+        if (mapaConclusao == MAP_FAILED)
+        {
+            return false;
+        }
+        tamanhoEntradas = parametros.sq_entries * sizeof(io_uring_sqe);
+        entradas = static_cast<io_uring_sqe *>(mmap(nullptr, tamanhoEntradas, PROT_READ | PROT_WRITE,
+                                                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (entradas == MAP_FAILED)
+        {
+            return false;
+        }
+
+        char *submissao = static_cast<char *>(mapaSubmissao);
+        char *conclusao = static_cast<char *>(mapaConclusao);
+        caudaSubmissao = reinterpret_cast<unsigned *>(submissao + parametros.sq_off.tail);
+        mascaraSubmissao = reinterpret_cast<unsigned *>(submissao + parametros.sq_off.ring_mask);
+        indicesSubmissao = reinterpret_cast<unsigned *>(submissao + parametros.sq_off.array);
+        cabecaConclusao = reinterpret_cast<unsigned *>(conclusao + parametros.cq_off.head);
+        caudaConclusao = reinterpret_cast<unsigned *>(conclusao + parametros.cq_off.tail);
+        mascaraConclusao = reinterpret_cast<unsigned *>(conclusao + parametros.cq_off.ring_mask);
+        conclusoes = reinterpret_cast<io_uring_cqe *>(conclusao + parametros.cq_off.cqes);
+        return true;
+    }
+
+    /**
+     * @brief Registra os buffers no kernel para leituras IORING_OP_READ_FIXED
+     */
+    bool registrarBuffers(const std::vector<iovec> &buffers)
+    {
+        return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers.data(),
+                       static_cast<unsigned>(buffers.size())) == 0;
+    }
+
+    /**
+     * @brief Coloca uma leitura na fila de submissão (enviada no próximo esperar())
+     */
+    void lerEm(int fdArquivo, char *destino, unsigned tamanho, uint64_t deslocamento, int bufferFixo,
+               uint64_t identificador)
+    {
+        unsigned cauda = *caudaSubmissao;
+        unsigned posicao = cauda & *mascaraSubmissao;
+        io_uring_sqe *entrada = &entradas[posicao];
+        std::memset(entrada, 0, sizeof(*entrada));
+        entrada->opcode = bufferFixo >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        entrada->fd = fdArquivo;
+        entrada->addr = reinterpret_cast<uint64_t>(destino);
+        entrada->len = tamanho;
+        entrada->off = deslocamento;
+        entrada->buf_index = static_cast<uint16_t>(bufferFixo >= 0 ? bufferFixo : 0);
+        entrada->user_data = identificador;
+        indicesSubmissao[posicao] = posicao;
+        __atomic_store_n(caudaSubmissao, cauda + 1, __ATOMIC_RELEASE);
+        pendentes++;
+        emVoo++;
+    }
+
+    /**
+     * @brief Envia as leituras pendentes e espera ao menos uma conclusão
+     */
+    bool esperar(io_uring_cqe *concluida)
+    {
+        while (true)
+        {
+            unsigned cabeca = *cabecaConclusao;
+            if (cabeca != __atomic_load_n(caudaConclusao, __ATOMIC_ACQUIRE))
+            {
+                *concluida = conclusoes[cabeca & *mascaraConclusao];
+                __atomic_store_n(cabecaConclusao, cabeca + 1, __ATOMIC_RELEASE);
+                emVoo--;
+                return true;
+            }
+
+            long enviadas = syscall(__NR_io_uring_enter, fd, pendentes, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (enviadas < 0 && errno != EINTR)
+            {
+                return false;
+            }
+            if (enviadas > 0)
+            {
+                pendentes -= static_cast<unsigned>(enviadas);
+            }
+        }
+    }
+};
+
+bool lerComIoUring(int fd, uint64_t deslocamento, uint64_t tamanho, SeparadorLinhas &separador)
+{
+    const unsigned profundidade = LeitorArquivo::PROFUNDIDADE_ANEL;
+    const size_t bloco = LeitorArquivo::TAMANHO_BLOCO;
+
+    // Os buffers são liberados depois do anel, que ao fechar espera as leituras em voo (em qualquer retorno)
+    std::unique_ptr<char, decltype(&std::free)> area(nullptr, &std::free);
+    AnelIoUring anel;
+    if (!anel.iniciar(profundidade))
+    {
+        static std::once_flag aviso;
+        std::call_once(aviso, [] {
+            std::cerr << "Aviso: io_uring indisponível (" << std::strerror(errno) << "); usando read." << std::endl;
+        });
+        return lerComRead(fd, deslocamento, tamanho, separador);
+    }
+
+    void *memoria = nullptr;
+    if (posix_memalign(&memoria, 4096, profundidade * bloco) != 0)
+    {
+        return false;
+    }
+    area.reset(static_cast<char *>(memoria));
+
+    std::vector<iovec> buffers(profundidade);
+    for (unsigned i = 0; i < profundidade; i++)
+    {
+        buffers[i].iov_base = area.get() + i * bloco;
+        buffers[i].iov_len = bloco;
+    }
+    // Sem buffers registrados (ex.: limite de memória travada), as mesmas leituras usam IORING_OP_READ
+    bool fixos = anel.registrarBuffers(buffers);
+
+    // O bloco k vai para o buffer k % profundidade; cada buffer guarda início, tamanho pedido e bytes já lidos
+    struct Leitura
+    {
+        uint64_t inicio = 0;
+        size_t pedido = 0;
+        size_t lido = 0;
+        bool concluida = false;
+    };
+    std::vector<Leitura> leituras(profundidade);
+    uint64_t proximo = deslocamento;
+
+    auto submeter = [&](unsigned i) {
+        leituras[i].inicio = proximo;
+        leituras[i].pedido = static_cast<size_t>(std::min<uint64_t>(bloco, tamanho - proximo));
+        leituras[i].lido = 0;
+        leituras[i].concluida = false;
+        anel.lerEm(fd, area.get() + i * bloco, static_cast<unsigned>(leituras[i].pedido), proximo,
+                   fixos ? static_cast<int>(i) : -1, i);
+        proximo += leituras[i].pedido;
+    };
+
+    for (unsigned i = 0; i < profundidade && proximo < tamanho; i++)
+    {
+        submeter(i);
+    }
+
+    for (unsigned atual = 0; leituras[atual].pedido > 0; atual = (atual + 1) % profundidade)
+    {
+        while (!leituras[atual].concluida)
+        {
+            io_uring_cqe concluida;
+            if (!anel.esperar(&concluida))
+            {
+                return false;
+            }
+
+            unsigned i = static_cast<unsigned>(concluida.user_data);
+            Leitura &leitura = leituras[i];
+            if (concluida.res < 0)
+            {
+                std::cerr << "Erro: leitura por io_uring falhou: " << std::strerror(-concluida.res) << std::endl;
+                return false;
+            }
+
+            // Leitura curta: pede o restante no mesmo buffer; fim de arquivo antecipado encerra o bloco
+            leitura.lido += static_cast<size_t>(concluida.res);
+            if (concluida.res > 0 && leitura.lido < leitura.pedido)
+            {
+                anel.lerEm(fd, area.get() + i * bloco + leitura.lido,
+                           static_cast<unsigned>(leitura.pedido - leitura.lido), leitura.inicio + leitura.lido,
+                           fixos ? static_cast<int>(i) : -1, i);
+            }
+            else
+            {
+                leitura.concluida = true;
+            }
+        }
+
+        separador.entregar(area.get() + atual * bloco, leituras[atual].lido);
+        bool truncado = leituras[atual].lido < leituras[atual].pedido;
+        leituras[atual].pedido = 0;
+        if (truncado)
+        {
+            break;
+        }
+        if (proximo < tamanho)
+        {
+            submeter(atual);
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool LeitorArquivo::interpretarBackend(const std::string &nome, BackendLeitura *backend)
+{
+    if (nome == "read")
+    {
+        *backend = LEITURA_READ;
+    }
+    else if (nome == "mmap")
+    {
+        *backend = LEITURA_MMAP;
+    }
+    else if (nome == "io_uring")
+    {
+        *backend = LEITURA_IO_URING;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+const char *LeitorArquivo::nomeBackend(BackendLeitura backend)
+{
+    switch (backend)
+    {
+    case LEITURA_MMAP:
+        return "mmap";
+    case LEITURA_IO_URING:
+        return "io_uring";
+    default:
+        return "read";
+    }
+}
+
+void LeitorArquivo::setBackendPadrao(BackendLeitura backend)
+{
+    backendPadrao.store(backend, std::memory_order_relaxed);
+}
+
+BackendLeitura LeitorArquivo::getBackendPadrao()
+{
+    return static_cast<BackendLeitura>(backendPadrao.load(std::memory_order_relaxed));
+}
+
+bool LeitorArquivo::ioUringDisponivel()
+{
+    AnelIoUring anel;
+    return anel.iniciar(1);
+}
+
+bool LeitorArquivo::lerLinhas(const std::string &caminho, uint64_t deslocamento,
+                              const std::function<void(const std::string &)> &consumir, uint64_t *consumido,
+                              std::string *linhaFinal, BackendLeitura backend)
+{
+    if (linhaFinal)
+    {
+        linhaFinal->clear();
+    }
+
+    int fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat informacoes;
+    if (fstat(fd, &informacoes) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    SeparadorLinhas separador(consumir);
+    uint64_t tamanho = static_cast<uint64_t>(informacoes.st_size);
+    bool lido = true;
+    if (deslocamento < tamanho)
+    {
+        switch (backend)
+        {
+        case LEITURA_MMAP:
+            lido = lerComMmap(fd, deslocamento, tamanho, separador);
+            break;
+        case LEITURA_IO_URING:
+            lido = lerComIoUring(fd, deslocamento, tamanho, separador);
+            break;
+        default:
+            lido = lerComRead(fd, deslocamento, tamanho, separador);
+            break;
+        }
+    }
+    close(fd);
+
+    if (lido)
+    {
+        separador.finalizar(linhaFinal);
+    }
+    if (consumido)
+    {
+        *consumido = separador.consumido;
+    }
+    return lido;
+}
+
+bool LeitorArquivo::lerLinhas(const std::string &caminho, uint64_t deslocamento,
+                              const std::function<void(const std::string &)> &consumir, uint64_t *consumido,
+                              std::string *linhaFinal)
+{
+    return lerLinhas(caminho, deslocamento, consumir, consumido, linhaFinal, getBackendPadrao());
+}
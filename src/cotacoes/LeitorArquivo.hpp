@@ -0,0 +1,103 @@
+#ifndef LEITORARQUIVO_HPP_INCLUDED
+#define LEITORARQUIVO_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Forma de leitura de arquivos de dados em texto
+ */
+enum BackendLeitura
+{
+    LEITURA_READ,     ///< pread sequencial em um buffer
+    LEITURA_MMAP,     ///< Arquivo mapeado inteiro, com madvise(MADV_SEQUENTIAL)
+    LEITURA_IO_URING, ///< Leituras em lote por io_uring em um anel de buffers fixos
+};
+
+/**
+ * @brief Leitura de linhas de arquivos texto com backend selecionável
+ *
+ * @details Usado na carga de arquivos COTAHIST em texto. Os três backends
+ * entregam exatamente as mesmas linhas, na ordem do arquivo:
+ *
+ * - read: um pread de TAMANHO_BLOCO por vez, sem leitura antecipada própria;
+ * - mmap: o arquivo é mapeado e percorrido direto na memória, sem cópia;
+ * - io_uring: PROFUNDIDADE_ANEL leituras de TAMANHO_BLOCO ficam em voo ao
+ *   mesmo tempo, em buffers registrados no kernel (IORING_OP_READ_FIXED).
+ *   Enquanto a thread chamadora interpreta um bloco, os seguintes já estão
+ *   sendo lidos; ao terminar, o buffer volta ao anel com o próximo bloco.
+ *
+ * O io_uring é acessado pelas chamadas de sistema diretamente, sem liburing.
+ * Se o kernel não o oferece (ou está desativado), a leitura cai no backend
+ * read com um aviso.
+ */
+class LeitorArquivo
+{
+  public:
+    /**
+     * @brief Tamanho de cada leitura (e de cada buffer do anel)
+     */
+    static const size_t TAMANHO_BLOCO = 1 << 20;
+
+    /**
+     * @brief Quantidade de leituras simultâneas no backend io_uring
+     */
+    static const unsigned PROFUNDIDADE_ANEL = 4;
+
+    /**
+     * @brief Converte "read", "mmap" ou "io_uring" em backend
+     *
+     * @return bool true se o nome é conhecido
+     */
+    static bool interpretarBackend(const std::string &nome, BackendLeitura *backend);
+
+    /**
+     * @brief Nome de um backend, como aceito por interpretarBackend()
+     */
+    static const char *nomeBackend(BackendLeitura backend);
+
+    /**
+     * @brief Define o backend usado pela carga de arquivos do processo
+     */
+    static void setBackendPadrao(BackendLeitura backend);
+
+    /**
+     * @brief Backend usado pela carga de arquivos do processo (read, se não definido)
+     */
+    static BackendLeitura getBackendPadrao();
+
+    /**
+     * @brief Indica se o kernel permite criar um anel io_uring
+     */
+    static bool ioUringDisponivel();
+
+    /**
+     * @brief Entrega as linhas de um arquivo a partir de um deslocamento
+     *
+     * @param caminho Arquivo texto
+     * @param deslocamento Início da leitura, no começo de uma linha
+     * @param consumir Chamada para cada linha, sem o '\n', na thread chamadora
+     * @param consumido Ponteiro para os bytes entregues, até o '\n' da última linha terminada (opcional)
+     * @param linhaFinal Onde guardar a última linha se ela não termina em '\n' (opcional)
+     * @param backend Forma de leitura
+     * @return bool true se o arquivo foi lido até o fim
+     * @details Uma última linha sem '\n' nunca conta em consumido. Sem
+     *          linhaFinal ela é entregue a consumir como as demais; com
+     *          linhaFinal ela fica com quem chamou, que pode tratá-la como
+     *          ainda em escrita (o checkpoint não avança sobre ela).
+     */
+    static bool lerLinhas(const std::string &caminho, uint64_t deslocamento,
+                          const std::function<void(const std::string &)> &consumir, uint64_t *consumido,
+                          std::string *linhaFinal, BackendLeitura backend);
+
+    /**
+     * @brief Entrega as linhas de um arquivo com o backend padrão do processo
+     */
+    static bool lerLinhas(const std::string &caminho, uint64_t deslocamento,
+                          const std::function<void(const std::string &)> &consumir, uint64_t *consumido = nullptr,
+                          std::string *linhaFinal = nullptr);
+};
+
+#endif // LEITORARQUIVO_HPP_INCLUDED
@@ -0,0 +1,217 @@
+#include "LeitorCotahist.hpp"
+
+namespace
+{
+/**
+ * @brief Indica, em tempo de compilação, se um campo existe no layout
+ */
+template <const LayoutCotahist &L, CampoCotahist C> constexpr bool possuiCampo()
+{
+    return L.campos[C].tamanho > 0;
+}
+
+/**
+ * @brief Posição inicial de um campo em uma linha com o tamanho informado
+ */
+template <const LayoutCotahist &L, CampoCotahist C> inline size_t inicioCampo(size_t tamanhoLinha)
+{
+    constexpr PosicaoCampo posicao = L.campos[C];
+    return posicao.doFim ? tamanhoLinha - posicao.posicao : posicao.posicao;
+}
+
+/**
+ * @brief Lê um campo numérico de posição fixa
+ * @return false se o campo contém algo além de dígitos
+ */
+template <const LayoutCotahist &L, CampoCotahist C, typename T>
+inline bool lerNumero(const std::string &linha, size_t tamanhoLinha, T *valor)
+{
+    static_assert(possuiCampo<L, C>(), "campo ausente no layout");
+    size_t inicio = inicioCampo<L, C>(tamanhoLinha);
+    unsigned long long acumulado = 0;
+    for (size_t i = inicio; i < inicio + L.campos[C].tamanho; i++)
+    {
+        char c = linha[i];
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        acumulado = acumulado * 10 + static_cast<unsigned long long>(c - '0');
+    }
+    *valor = static_cast<T>(acumulado);
+    return true;
+}
+
+template <const LayoutCotahist &L, CampoCotahist C>
+inline std::string lerTexto(const std::string &linha, size_t tamanhoLinha)
+{
+    static_assert(possuiCampo<L, C>(), "campo ausente no layout");
+    return LeitorCotahist::limparCampo(linha.substr(inicioCampo<L, C>(tamanhoLinha), L.campos[C].tamanho));
+}
+
+/**
+ * @brief Converte um preço cotado por lote para preço por unidade
+ * @details Arredonda para o centavo mais próximo. Um preço positivo que
+ *          arredondaria para zero (lote de mil abaixo de R$ 5,00) fica em um
+ *          centavo, o menor Dinheiro aceito, para que o papel continue tendo
+ *          preço e ordens sobre ele possam ser criadas.
+ */
+inline long long precoPorUnidade(long long preco, uint32_t fator)
+{
+    if (fator <= 1)
+    {
+        return preco;
+    }
+    long long unitario = (preco + static_cast<long long>(fator / 2)) / static_cast<long long>(fator);
+    return unitario == 0 && preco > 0 ? 1 : unitario;
+}
+
+/**
+ * @brief Interpretador gerado a partir da tabela de um layout
+ * @details Cada campo só é lido se existe em L; a decisão é tomada em tempo de
+ *          compilação por if constexpr, de modo que o interpretador do layout
+ *          truncado não carrega nenhum dos testes dos campos que ele não tem.
+ */
+template <const LayoutCotahist &L>
+bool interpretar(const std::string &linha, size_t tamanho, RegistroCotacao *registro)
+{
+    RegistroCotacao lido;
+    lido.completo = possuiCampo<L, CAMPO_DISMES>();
+
+    if (!lerNumero<L, CAMPO_DATA>(linha, tamanho, &lido.data) ||
+        !lerNumero<L, CAMPO_PREABE>(linha, tamanho, &lido.precoAberturaCentavos) ||
+        !lerNumero<L, CAMPO_PREMAX>(linha, tamanho, &lido.precoMaximoCentavos) ||
+        !lerNumero<L, CAMPO_PREMIN>(linha, tamanho, &lido.precoMinimoCentavos) ||
+        !lerNumero<L, CAMPO_PREMED>(linha, tamanho, &lido.precoMedioCentavos))
+    {
+        return false;
+    }
+
+    if constexpr (possuiCampo<L, CAMPO_PREULT>() && possuiCampo<L, CAMPO_PREOFV>())
+    {
+        if (!lerNumero<L, CAMPO_PREULT>(linha, tamanho, &lido.precoUltimoCentavos) ||
+            !lerNumero<L, CAMPO_PREOFC>(linha, tamanho, &lido.precoOfertaCompraCentavos) ||
+            !lerNumero<L, CAMPO_PREOFV>(linha, tamanho, &lido.precoOfertaVendaCentavos))
+        {
+            return false;
+        }
+    }
+
+    if constexpr (possuiCampo<L, CAMPO_TOTNEG>() && possuiCampo<L, CAMPO_VOLTOT>())
+    {
+        if (!lerNumero<L, CAMPO_TOTNEG>(linha, tamanho, &lido.totalNegocios) ||
+            !lerNumero<L, CAMPO_QUATOT>(linha, tamanho, &lido.quantidadeTotal) ||
+            !lerNumero<L, CAMPO_VOLTOT>(linha, tamanho, &lido.volumeTotalCentavos))
+        {
+            return false;
+        }
+    }
+
+    if constexpr (possuiCampo<L, CAMPO_PREEXE>() && possuiCampo<L, CAMPO_FATCOT>())
+    {
+        if (!lerNumero<L, CAMPO_PREEXE>(linha, tamanho, &lido.precoExercicioCentavos) ||
+            !lerNumero<L, CAMPO_INDOPC>(linha, tamanho, &lido.indicadorCorrecao) ||
+            !lerNumero<L, CAMPO_DATVEN>(linha, tamanho, &lido.dataVencimento) ||
+            !lerNumero<L, CAMPO_FATCOT>(linha, tamanho, &lido.fatorCotacao))
+        {
+            return false;
+        }
+
+        // Preços de papéis cotados por lote passam a valer por unidade
+        if (lido.fatorCotacao == 0)
+        {
+            lido.fatorCotacao = 1;
+        }
+        lido.precoAberturaCentavos = precoPorUnidade(lido.precoAberturaCentavos, lido.fatorCotacao);
+        lido.precoMaximoCentavos = precoPorUnidade(lido.precoMaximoCentavos, lido.fatorCotacao);
+        lido.precoMinimoCentavos = precoPorUnidade(lido.precoMinimoCentavos, lido.fatorCotacao);
+        lido.precoMedioCentavos = precoPorUnidade(lido.precoMedioCentavos, lido.fatorCotacao);
+        lido.precoUltimoCentavos = precoPorUnidade(lido.precoUltimoCentavos, lido.fatorCotacao);
+        lido.precoOfertaCompraCentavos = precoPorUnidade(lido.precoOfertaCompraCentavos, lido.fatorCotacao);
+        lido.precoOfertaVendaCentavos = precoPorUnidade(lido.precoOfertaVendaCentavos, lido.fatorCotacao);
+    }
+
+    if constexpr (possuiCampo<L, CAMPO_CODISI>() && possuiCampo<L, CAMPO_DISMES>())
+    {
+        lido.codigoIsin = lerTexto<L, CAMPO_CODISI>(linha, tamanho);
+        if (!lerNumero<L, CAMPO_DISMES>(linha, tamanho, &lido.numeroDistribuicao))
+        {
+            return false;
+        }
+    }
+
+    if constexpr (possuiCampo<L, CAMPO_NOMRES>())
+    {
+        lido.nomeResumido = lerTexto<L, CAMPO_NOMRES>(linha, tamanho);
+    }
+
+    lido.codigoNegociacao = lerTexto<L, CAMPO_CODNEG>(linha, tamanho);
+    if (lido.codigoNegociacao.empty())
+    {
+        return false;
+    }
+
+    *registro = std::move(lido);
+    return true;
+}
+} // namespace
+
+/**
+ * @brief Interpreta uma linha do arquivo histórico
+ * @param linha Linha lida do arquivo
+ * @param registro Registro de saída
+ * @return true se a linha contém data, código de negociação e preços válidos
+ * @details Linhas com ao menos 245 caracteres usam o layout completo da B3;
+ *          as demais, o layout truncado de DADOS_HISTORICOS.txt, em que o
+ *          preço médio são os últimos 13 caracteres.
+ */
+bool LeitorCotahist::interpretarLinha(const std::string &linha, RegistroCotacao *registro)
+{
+    size_t tamanho = linha.length();
+    if (tamanho > 0 && linha[tamanho - 1] == '\r')
+    {
+        tamanho--;
+    }
+
+    if (tamanho < TAMANHO_MINIMO_LINHA || !registro)
+    {
+        return false;
+    }
+
+    if (tamanho >= LAYOUT_COTAHIST_COMPLETO.tamanhoMinimo)
+    {
+        return interpretar<LAYOUT_COTAHIST_COMPLETO>(linha, tamanho, registro);
+    }
+    return interpretar<LAYOUT_COTAHIST_TRUNCADO>(linha, tamanho, registro);
+}
+
+uint32_t LeitorCotahist::dataParaInteiro(const std::string &data)
+{
+    if (data.length() != 8)
+    {
+        return 0;
+    }
+
+    uint32_t valor = 0;
+    for (char c : data)
+    {
+        if (c < '0' || c > '9')
+        {
+            return 0;
+        }
+        valor = valor * 10 + static_cast<uint32_t>(c - '0');
+    }
+    return valor;
+}
+
+std::string LeitorCotahist::limparCampo(const std::string &campo)
+{
+    const std::string ESPACOS = " \r\n\t";
+    size_t inicio = campo.find_first_not_of(ESPACOS);
+    if (inicio == std::string::npos)
+    {
+        return "";
+    }
+    size_t fim = campo.find_last_not_of(ESPACOS);
+    return campo.substr(inicio, fim - inicio + 1);
+}
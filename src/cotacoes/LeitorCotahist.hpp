@@ -0,0 +1,212 @@
+#ifndef LEITORCOTAHIST_HPP_INCLUDED
+#define LEITORCOTAHIST_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Registro de cotação extraído de uma linha do arquivo histórico da B3
+ *
+ * @details Os preços já estão divididos pelo fator de cotação (FATCOT), isto é,
+ * são preços por unidade do papel em centavos, com no mínimo um centavo quando
+ * o preço publicado é positivo. Campos ausentes no layout truncado ficam em
+ * zero (ou vazios), exceto o fator, que vale 1. Volume e quantidade não
+ * dependem do fator e são mantidos como publicados.
+ */
+struct RegistroCotacao
+{
+    uint32_t data = 0;                    ///< DATA: data do pregão no formato AAAAMMDD
+    std::string codigoNegociacao;         ///< CODNEG: código de negociação sem espaços finais
+    std::string nomeResumido;             ///< NOMRES: nome resumido da empresa emissora
+    long long precoAberturaCentavos = 0;  ///< PREABE
+    long long precoMaximoCentavos = 0;    ///< PREMAX
+    long long precoMinimoCentavos = 0;    ///< PREMIN
+    long long precoMedioCentavos = 0;     ///< PREMED
+    long long precoUltimoCentavos = 0;    ///< PREULT
+    long long precoOfertaCompraCentavos = 0; ///< PREOFC: melhor oferta de compra
+    long long precoOfertaVendaCentavos = 0;  ///< PREOFV: melhor oferta de venda
+    uint32_t totalNegocios = 0;           ///< TOTNEG: número de negócios no pregão
+    long long quantidadeTotal = 0;        ///< QUATOT: quantidade de títulos negociados
+    long long volumeTotalCentavos = 0;    ///< VOLTOT: volume financeiro em centavos
+    long long precoExercicioCentavos = 0; ///< PREEXE: preço de exercício (opções e termo)
+    uint8_t indicadorCorrecao = 0;        ///< INDOPC: indicador de correção do preço de exercício
+    uint32_t dataVencimento = 0;          ///< DATVEN: vencimento (opções e termo), AAAAMMDD
+    uint32_t fatorCotacao = 1;            ///< FATCOT: 1 para cotação unitária, 1000 para lote de mil
+    std::string codigoIsin;               ///< CODISI: código ISIN do papel
+    uint16_t numeroDistribuicao = 0;      ///< DISMES: número de distribuição do papel
+    bool completo = false;                ///< true se a linha veio no layout completo de 245 bytes
+};
+
+/**
+ * @brief Campos de um registro tipo 01 do arquivo COTAHIST, na ordem do layout da B3
+ */
+enum CampoCotahist : size_t
+{
+    CAMPO_TIPREG,
+    CAMPO_DATA,
+    CAMPO_CODBDI,
+    CAMPO_CODNEG,
+    CAMPO_TPMERC,
+    CAMPO_NOMRES,
+    CAMPO_ESPECI,
+    CAMPO_PRAZOT,
+    CAMPO_MODREF,
+    CAMPO_PREABE,
+    CAMPO_PREMAX,
+    CAMPO_PREMIN,
+    CAMPO_PREMED,
+    CAMPO_PREULT,
+    CAMPO_PREOFC,
+    CAMPO_PREOFV,
+    CAMPO_TOTNEG,
+    CAMPO_QUATOT,
+    CAMPO_VOLTOT,
+    CAMPO_PREEXE,
+    CAMPO_INDOPC,
+    CAMPO_DATVEN,
+    CAMPO_FATCOT,
+    CAMPO_PTOEXE,
+    CAMPO_CODISI,
+    CAMPO_DISMES,
+    QUANTIDADE_CAMPOS
+};
+
+/**
+ * @brief Posição de um campo na linha
+ *
+ * @details A posição é contada do início da linha ou, com doFim, do fim dela
+ * (sem o terminador). Os campos depois de MODREF são ancorados no fim porque
+ * a moeda "R$" pode vir codificada em UTF-7 ("R+ACQ-"), deslocando o restante
+ * da linha. Um campo com tamanho zero não existe no layout.
+ */
+struct PosicaoCampo
+{
+    size_t posicao;
+    size_t tamanho;
+    bool doFim;
+};
+
+/**
+ * @brief Layout de linha do arquivo COTAHIST
+ */
+struct LayoutCotahist
+{
+    size_t tamanhoMinimo;                   ///< Linhas menores que isso não pertencem ao layout
+    PosicaoCampo campos[QUANTIDADE_CAMPOS]; ///< Indexado por CampoCotahist
+};
+
+/**
+ * @brief Layout completo de 245 bytes publicado pela B3
+ */
+constexpr LayoutCotahist LAYOUT_COTAHIST_COMPLETO = {245,
+                                                     {
+                                                         {0, 2, false},   // TIPREG
+                                                         {2, 8, false},   // DATA
+                                                         {10, 2, false},  // CODBDI
+                                                         {12, 12, false}, // CODNEG
+                                                         {24, 3, false},  // TPMERC
+                                                         {27, 12, false}, // NOMRES
+                                                         {39, 10, false}, // ESPECI
+                                                         {49, 3, false},  // PRAZOT
+                                                         {52, 4, false},  // MODREF
+                                                         {189, 13, true}, // PREABE
+                                                         {176, 13, true}, // PREMAX
+                                                         {163, 13, true}, // PREMIN
+                                                         {150, 13, true}, // PREMED
+                                                         {137, 13, true}, // PREULT
+                                                         {124, 13, true}, // PREOFC
+                                                         {111, 13, true}, // PREOFV
+                                                         {98, 5, true},   // TOTNEG
+                                                         {93, 18, true},  // QUATOT
+                                                         {75, 18, true},  // VOLTOT
+                                                         {57, 13, true},  // PREEXE
+                                                         {44, 1, true},   // INDOPC
+                                                         {43, 8, true},   // DATVEN
+                                                         {35, 7, true},   // FATCOT
+                                                         {28, 13, true},  // PTOEXE
+                                                         {15, 12, true},  // CODISI
+                                                         {3, 3, true},    // DISMES
+                                                     }};
+
+/**
+ * @brief Layout truncado de DADOS_HISTORICOS.txt, que termina em PREMED
+ *
+ * @details Nele o código de negociação vem seguido de 5 espaços a mais que no
+ * layout da B3, de modo que TPMERC começa na posição 29 e NOMRES na 32.
+ */
+constexpr LayoutCotahist LAYOUT_COTAHIST_TRUNCADO = {125,
+                                                     {
+                                                         {0, 2, false},   // TIPREG
+                                                         {2, 8, false},   // DATA
+                                                         {10, 2, false},  // CODBDI
+                                                         {12, 12, false}, // CODNEG
+                                                         {0, 0, false},   // TPMERC
+                                                         {32, 12, false}, // NOMRES
+                                                         {0, 0, false},   // ESPECI
+                                                         {0, 0, false},   // PRAZOT
+                                                         {0, 0, false},   // MODREF
+                                                         {52, 13, true},  // PREABE
+                                                         {39, 13, true},  // PREMAX
+                                                         {26, 13, true},  // PREMIN
+                                                         {13, 13, true},  // PREMED
+                                                         {0, 0, false},   // PREULT
+                                                         {0, 0, false},   // PREOFC
+                                                         {0, 0, false},   // PREOFV
+                                                         {0, 0, false},   // TOTNEG
+                                                         {0, 0, false},   // QUATOT
+                                                         {0, 0, false},   // VOLTOT
+                                                         {0, 0, false},   // PREEXE
+                                                         {0, 0, false},   // INDOPC
+                                                         {0, 0, false},   // DATVEN
+                                                         {0, 0, false},   // FATCOT
+                                                         {0, 0, false},   // PTOEXE
+                                                         {0, 0, false},   // CODISI
+                                                         {0, 0, false},   // DISMES
+                                                     }};
+
+/**
+ * @brief Interpretador de linhas do arquivo de dados históricos (formato COTAHIST)
+ *
+ * @details Centraliza a leitura das posições fixas do arquivo para que a camada
+ * de serviço, o validador de entradas e o índice em memória usem a mesma regra.
+ * Os dois layouts são descritos pelas tabelas constexpr acima, e o
+ * interpretador de cada um é instanciado em tempo de compilação a partir da
+ * sua tabela: campos ausentes não geram código e as posições são constantes.
+ * O layout é escolhido pelo tamanho da linha.
+ */
+class LeitorCotahist
+{
+  public:
+    /**
+     * @brief Tamanho mínimo de uma linha válida, sem o terminador de linha
+     */
+    static const size_t TAMANHO_MINIMO_LINHA = LAYOUT_COTAHIST_TRUNCADO.tamanhoMinimo;
+
+    /**
+     * @brief Interpreta uma linha do arquivo histórico
+     *
+     * @param linha Linha lida do arquivo (com ou sem '\r' final)
+     * @param registro Registro onde os campos extraídos são armazenados
+     * @return bool true se a linha é um registro de cotação válido
+     */
+    static bool interpretarLinha(const std::string &linha, RegistroCotacao *registro);
+
+    /**
+     * @brief Converte uma data AAAAMMDD textual para inteiro
+     *
+     * @param data Texto com 8 dígitos
+     * @return uint32_t Data como inteiro, ou 0 se o texto for inválido
+     */
+    static uint32_t dataParaInteiro(const std::string &data);
+
+    /**
+     * @brief Remove espaços e '\r' das extremidades de um campo
+     *
+     * @param campo Campo extraído da linha
+     * @return std::string Campo sem espaços nas extremidades
+     */
+    static std::string limparCampo(const std::string &campo);
+};
+
+#endif // LEITORCOTAHIST_HPP_INCLUDED
@@ -0,0 +1,273 @@
+#include "QualidadeCotacoes.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+/**
+ * @brief Valor de um caractere do base64 modificado do UTF-7, ou -1 se não pertence ao alfabeto
+ */
+inline int valorBase64(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+    {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z')
+    {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0' + 52;
+    }
+    if (c == '+')
+    {
+        return 62;
+    }
+    return c == '/' ? 63 : -1;
+}
+} // namespace
+
+void RelatorioQualidade::acumular(const RelatorioQualidade &outro)
+{
+    registros += outro.registros;
+    linhasCurtas += outro.linhasCurtas;
+    linhasInvalidas += outro.linhasInvalidas;
+    registrosComProblema += outro.registrosComProblema;
+    duplicados += outro.duplicados;
+    minimoAcimaMaximo += outro.minimoAcimaMaximo;
+    precoZero += outro.precoZero;
+    nomesInvalidos += outro.nomesInvalidos;
+    registrosComLacuna += outro.registrosComLacuna;
+    pregoesAusentes += outro.pregoesAusentes;
+
+    // Lacunas do mesmo papel em partições diferentes viram uma entrada só
+    std::unordered_map<std::string, size_t> posicao;
+    for (size_t i = 0; i < lacunasPorPapel.size(); i++)
+    {
+        posicao.emplace(lacunasPorPapel[i].codigoNegociacao, i);
+    }
+    for (const LacunasPapel &lacunas : outro.lacunasPorPapel)
+    {
+        auto it = posicao.find(lacunas.codigoNegociacao);
+        if (it == posicao.end())
+        {
+            posicao.emplace(lacunas.codigoNegociacao, lacunasPorPapel.size());
+            lacunasPorPapel.push_back(lacunas);
+            continue;
+        }
+        lacunasPorPapel[it->second].pregoesAusentes += lacunas.pregoesAusentes;
+        lacunasPorPapel[it->second].registros += lacunas.registros;
+    }
+    ordenarLacunas();
+}
+
+void RelatorioQualidade::contar(uint8_t marcas)
+{
+    registros++;
+    if (marcas == 0)
+    {
+        return;
+    }
+
+    registrosComProblema++;
+    duplicados += (marcas & QUALIDADE_DUPLICADO) ? 1 : 0;
+    minimoAcimaMaximo += (marcas & QUALIDADE_MINIMO_ACIMA_MAXIMO) ? 1 : 0;
+    precoZero += (marcas & QUALIDADE_PRECO_ZERO) ? 1 : 0;
+    registrosComLacuna += (marcas & QUALIDADE_LACUNA) ? 1 : 0;
+    nomesInvalidos += (marcas & QUALIDADE_NOME_INVALIDO) ? 1 : 0;
+}
+
+void RelatorioQualidade::ordenarLacunas()
+{
+    std::sort(lacunasPorPapel.begin(), lacunasPorPapel.end(), [](const LacunasPapel &a, const LacunasPapel &b) {
+        if (a.pregoesAusentes != b.pregoesAusentes)
+        {
+            return a.pregoesAusentes > b.pregoesAusentes;
+        }
+        return a.codigoNegociacao < b.codigoNegociacao;
+    });
+}
+
+uint8_t AnalisadorQualidade::avaliarPrecos(const RegistroCotacao &registro)
+{
+    uint8_t marcas = 0;
+    if (registro.precoMinimoCentavos > registro.precoMaximoCentavos)
+    {
+        marcas |= QUALIDADE_MINIMO_ACIMA_MAXIMO;
+    }
+    if (registro.precoAberturaCentavos == 0 || registro.precoMaximoCentavos == 0 ||
+        registro.precoMinimoCentavos == 0 || registro.precoMedioCentavos == 0)
+    {
+        marcas |= QUALIDADE_PRECO_ZERO;
+    }
+    return marcas;
+}
+
+/**
+ * @brief Verifica se um nome está em UTF-7 bem formado (RFC 2152)
+ * @details "+-" representa o próprio '+'. Fora disso, '+' abre um trecho em
+ *          base64 modificado que termina no primeiro caractere fora do
+ *          alfabeto; um '-' logo depois é absorvido, e o fim do texto também
+ *          fecha o trecho. Cada 16 bits decodificados são uma unidade UTF-16,
+ *          e substitutos precisam vir em pares. Ao fechar o trecho, sobram
+ *          menos de 6 bits, todos zero; sobrar mais indica um nome cortado no
+ *          meio de um caractere, comum quando NOMRES é truncado em 12 posições.
+ */
+bool AnalisadorQualidade::nomeValido(const std::string &nome)
+{
+    // Caminho comum: nenhum '+', basta conferir que tudo é ASCII imprimível, sem desvios por caractere
+    bool fora = false;
+    bool deslocado = false;
+    for (char c : nome)
+    {
+        fora |= static_cast<unsigned char>(c - 0x20) > 0x5E;
+        deslocado |= c == '+';
+    }
+    if (fora || !deslocado)
+    {
+        return !fora;
+    }
+
+    size_t i = 0;
+    while (i < nome.size())
+    {
+        if (nome[i++] != '+')
+        {
+            continue;
+        }
+        if (i < nome.size() && nome[i] == '-')
+        {
+            i++;
+            continue;
+        }
+
+        uint32_t bits = 0;
+        unsigned pendentes = 0;
+        unsigned sextetos = 0;
+        bool substitutoAlto = false;
+        for (int valor; i < nome.size() && (valor = valorBase64(nome[i])) >= 0; i++)
+        {
+            bits = (bits << 6) | static_cast<uint32_t>(valor);
+            pendentes += 6;
+            sextetos++;
+            if (pendentes < 16)
+            {
+                continue;
+            }
+
+            pendentes -= 16;
+            uint32_t unidade = (bits >> pendentes) & 0xFFFF;
+            bool alto = unidade >= 0xD800 && unidade <= 0xDBFF;
+            bool baixo = unidade >= 0xDC00 && unidade <= 0xDFFF;
+            if (baixo != substitutoAlto || (alto && substitutoAlto))
+            {
+                return false;
+            }
+            substitutoAlto = alto;
+        }
+
+        if (sextetos == 0 || substitutoAlto || pendentes >= 6 || (bits & ((1u << pendentes) - 1)) != 0)
+        {
+            return false;
+        }
+        if (i < nome.size() && nome[i] == '-')
+        {
+            i++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Avalia um registro e guarda o necessário para as verificações de vizinhos
+ * @details O nome é conferido como em IndiceCotacoes::carregar: o primeiro
+ *          nome não vazio de cada papel é avaliado uma vez, e só um nome
+ *          diferente dele é avaliado de novo.
+ */
+void AcumuladorQualidade::adicionar(const RegistroCotacao &registro)
+{
+    auto resultado = idPorPapel.emplace(registro.codigoNegociacao, static_cast<uint32_t>(papeis.size()));
+    uint32_t id = resultado.first->second;
+    if (resultado.second)
+    {
+        papeis.push_back(registro.codigoNegociacao);
+        nomePapel.emplace_back();
+        nomeInvalidoPapel.push_back(0);
+    }
+    if (nomePapel[id].empty() && !registro.nomeResumido.empty())
+    {
+        nomePapel[id] = registro.nomeResumido;
+        nomeInvalidoPapel[id] = AnalisadorQualidade::nomeValido(registro.nomeResumido) ? 0 : 1;
+    }
+
+    bool nomeInvalido = registro.nomeResumido == nomePapel[id]
+                            ? nomeInvalidoPapel[id] != 0
+                            : !AnalisadorQualidade::nomeValido(registro.nomeResumido);
+    idLinha.push_back(id);
+    colunaData.push_back(registro.data);
+    colunaQualidade.push_back(AnalisadorQualidade::avaliarPrecos(registro) |
+                              (nomeInvalido ? QUALIDADE_NOME_INVALIDO : 0));
+}
+
+/**
+ * @brief Marca duplicados e lacunas e conta as marcas de todos os registros
+ * @details Ordena (papel, data) de forma estável, como as colunas de
+ *          IndiceCotacoes, e percorre cada papel com as datas de pregão do
+ *          conjunto inteiro (IndiceCotacoes::classificarQualidade).
+ */
+RelatorioQualidade AcumuladorQualidade::montar() const
+{
+    RelatorioQualidade relatorio;
+    std::vector<uint32_t> ordem(idLinha.size());
+    std::iota(ordem.begin(), ordem.end(), 0);
+    std::stable_sort(ordem.begin(), ordem.end(), [this](uint32_t a, uint32_t b) {
+        return idLinha[a] != idLinha[b] ? idLinha[a] < idLinha[b] : colunaData[a] < colunaData[b];
+    });
+
+    std::vector<uint32_t> datasPregao(colunaData);
+    std::sort(datasPregao.begin(), datasPregao.end());
+    datasPregao.erase(std::unique(datasPregao.begin(), datasPregao.end()), datasPregao.end());
+
+    for (size_t inicio = 0; inicio < ordem.size();)
+    {
+        uint32_t papel = idLinha[ordem[inicio]];
+        LacunasPapel lacunas;
+        size_t dia = static_cast<size_t>(
+            std::lower_bound(datasPregao.begin(), datasPregao.end(), colunaData[ordem[inicio]]) - datasPregao.begin());
+        size_t diaAnterior = dia;
+        size_t i = inicio;
+        for (; i < ordem.size() && idLinha[ordem[i]] == papel; i++)
+        {
+            uint32_t data = colunaData[ordem[i]];
+            uint8_t marcas = colunaQualidade[ordem[i]];
+            while (datasPregao[dia] < data)
+            {
+                dia++;
+            }
+            if (i > inicio && data == colunaData[ordem[i - 1]])
+            {
+                marcas |= QUALIDADE_DUPLICADO;
+            }
+            else if (i > inicio && dia > diaAnterior + 1)
+            {
+                marcas |= QUALIDADE_LACUNA;
+                lacunas.pregoesAusentes += dia - diaAnterior - 1;
+            }
+            diaAnterior = dia;
+            relatorio.contar(marcas);
+        }
+
+        if (lacunas.pregoesAusentes > 0)
+        {
+            lacunas.codigoNegociacao = papeis[papel];
+            lacunas.registros = i - inicio;
+            relatorio.pregoesAusentes += lacunas.pregoesAusentes;
+            relatorio.lacunasPorPapel.push_back(std::move(lacunas));
+        }
+        inicio = i;
+    }
+    relatorio.ordenarLacunas();
+    return relatorio;
+}
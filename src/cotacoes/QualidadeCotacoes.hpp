@@ -0,0 +1,135 @@
+#ifndef QUALIDADECOTACOES_HPP_INCLUDED
+#define QUALIDADECOTACOES_HPP_INCLUDED
+
+#include "LeitorCotahist.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Problemas de qualidade de um registro, combinados em uma máscara de bits
+ */
+enum MarcaQualidade : uint8_t
+{
+    QUALIDADE_DUPLICADO = 1 << 0,           ///< Outro registro do mesmo papel e data veio antes; este não é usado
+    QUALIDADE_MINIMO_ACIMA_MAXIMO = 1 << 1, ///< PREMIN maior que PREMAX
+    QUALIDADE_PRECO_ZERO = 1 << 2,          ///< PREABE, PREMAX, PREMIN ou PREMED igual a zero
+    QUALIDADE_LACUNA = 1 << 3,              ///< Houve pregões do mercado entre o registro anterior do papel e este
+    QUALIDADE_NOME_INVALIDO = 1 << 4,       ///< NOMRES com sequência UTF-7 malformada
+};
+
+/**
+ * @brief Pregões ausentes de um papel entre a primeira e a última cotação
+ */
+struct LacunasPapel
+{
+    std::string codigoNegociacao;
+    uint64_t pregoesAusentes = 0;
+    uint64_t registros = 0;
+};
+
+/**
+ * @brief Resumo da qualidade dos dados carregados
+ *
+ * @details Os contadores são somas e se combinam com acumular(), como os das
+ * partições do catálogo. Um registro com mais de um problema conta em cada um
+ * deles e uma única vez em registrosComProblema.
+ */
+struct RelatorioQualidade
+{
+    uint64_t registros = 0;            ///< Registros interpretados, duplicados inclusive
+    uint64_t linhasCurtas = 0;         ///< Linhas descartadas por serem curtas demais para o layout truncado
+    uint64_t linhasInvalidas = 0;      ///< Linhas descartadas por campos fora do formato
+    uint64_t registrosComProblema = 0; ///< Registros com ao menos uma marca
+    uint64_t duplicados = 0;
+    uint64_t minimoAcimaMaximo = 0;
+    uint64_t precoZero = 0;
+    uint64_t nomesInvalidos = 0;
+    uint64_t registrosComLacuna = 0;
+    uint64_t pregoesAusentes = 0;               ///< Soma dos pregões ausentes de todos os papéis
+    std::vector<LacunasPapel> lacunasPorPapel; ///< Papéis com pregões ausentes; em ordem só após ordenarLacunas()
+
+    /**
+     * @brief Soma outro relatório a este, reunindo as lacunas do mesmo papel
+     * @details Deixa lacunasPorPapel ordenado.
+     */
+    void acumular(const RelatorioQualidade &outro);
+
+    /**
+     * @brief Conta as marcas de um registro
+     */
+    void contar(uint8_t marcas);
+
+    /**
+     * @brief Ordena lacunasPorPapel do papel com mais pregões ausentes para o com menos
+     */
+    void ordenarLacunas();
+};
+
+/**
+ * @brief Verificações de qualidade feitas durante a carga das cotações
+ *
+ * @details As verificações de um registro isolado (preços e nome) são feitas
+ * quando ele é lido. O nome se repete em todos os registros do papel, então
+ * quem carrega guarda o resultado de nomeValido() por papel e só volta a
+ * chamá-lo quando o nome muda. As verificações que dependem dos vizinhos
+ * (duplicados e lacunas) são feitas pelo IndiceCotacoes depois da ordenação
+ * por papel e data, quando os registros do mesmo papel já estão lado a lado.
+ */
+class AnalisadorQualidade
+{
+  public:
+    /**
+     * @brief Marcas de preço, que dependem só do próprio registro
+     *
+     * @param registro Registro interpretado
+     * @return uint8_t Combinação de QUALIDADE_MINIMO_ACIMA_MAXIMO e QUALIDADE_PRECO_ZERO
+     */
+    static uint8_t avaliarPrecos(const RegistroCotacao &registro);
+
+    /**
+     * @brief Verifica se um nome está em UTF-7 bem formado
+     *
+     * @param nome Nome como lido do arquivo (ex.: "P.ACUCAR+AC0-")
+     * @return bool true se só há ASCII imprimível e cada trecho "+...-" é base64 modificado
+     *              que decodifica para UTF-16 completo, sem bits sobrando nem substitutos soltos
+     */
+    static bool nomeValido(const std::string &nome);
+};
+
+/**
+ * @brief Relatório de qualidade montado em uma passada pelos registros, sem as colunas de cotações
+ *
+ * @details Para os modos em que o catálogo não carrega IndiceCotacoes (índice
+ * de deslocamentos e memória compartilhada). De cada registro ficam só o
+ * papel, a data e as marcas próprias; ao final, as verificações de vizinhos
+ * são as mesmas de IndiceCotacoes, e o relatório de um arquivo é igual ao da
+ * partição que o carregasse.
+ */
+class AcumuladorQualidade
+{
+  private:
+    std::unordered_map<std::string, uint32_t> idPorPapel;
+    std::vector<std::string> papeis;
+    std::vector<std::string> nomePapel;
+    std::vector<uint8_t> nomeInvalidoPapel;
+    std::vector<uint32_t> idLinha;
+    std::vector<uint32_t> colunaData;
+    std::vector<uint8_t> colunaQualidade;
+
+  public:
+    /**
+     * @brief Avalia um registro e guarda o necessário para as verificações de vizinhos
+     */
+    void adicionar(const RegistroCotacao &registro);
+
+    /**
+     * @brief Marca duplicados e lacunas e conta as marcas de todos os registros
+     *
+     * @return RelatorioQualidade Relatório sem as linhas descartadas, que são de quem leu o arquivo
+     */
+    RelatorioQualidade montar() const;
+};
+
+#endif // QUALIDADECOTACOES_HPP_INCLUDED
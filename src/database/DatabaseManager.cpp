@@ -1,11 +1,30 @@
 #include "DatabaseManager.hpp"
+#include "../metricas/Rastreamento.hpp"
+#include "../metricas/RegistroMetricas.hpp"
+#include "../utils/jsonUtils.hpp"
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <regex>
 #include <sstream>
+#include <sys/stat.h>
+
+/**
+ * @brief Histograma de latência de uma consulta do DatabaseManager
+ * @param consulta Nome do método
+ * @details Chamado uma única vez por método, para inicializar uma referência estática.
+ */
+static HistogramaLatencia &latenciaConsulta(const char *consulta)
+{
+    return RegistroMetricas::instancia().histograma("investimentos_banco_consulta_duracao_segundos",
+                                                    std::string("consulta=\"") + consulta + "\"",
+                                                    "Duração das consultas do DatabaseManager.");
+}
 
 /**
  * @brief Converte um objeto Dinheiro (formato "1.234,56") para um total de centavos (123456).
@@ -72,8 +91,15 @@ std::string DatabaseManager::centavosParaDinheiro(long long totalCentavos)
     return parteReais + "," + parteCentavos;
 }
 
-DatabaseManager::DatabaseManager(const std::string &caminhoBanco) : db(nullptr), dbPath(caminhoBanco), connected(false)
+DatabaseManager::DatabaseManager(const std::string &caminhoBanco)
+    : db(nullptr), dbPath(caminhoBanco), connected(false), acertosCacheStatements(0), faltasCacheStatements(0),
+      limiteConsultaLentaMs(100.0), analisandoPlano(false)
 {
+    const char *limite = std::getenv("INVESTIMENTOS_CONSULTA_LENTA_MS");
+    if (limite && *limite)
+    {
+        limiteConsultaLentaMs = std::atof(limite);
+    }
 }
 
 DatabaseManager::~DatabaseManager()
@@ -100,6 +126,11 @@ bool DatabaseManager::conectar()
         return false;
     }
 
+    // Aguarda locks de outras conexões (ex: trabalhadores do modo servidor) em vez de falhar imediatamente
+    sqlite3_busy_timeout(db, TEMPO_ESPERA_LOCK_MS);
+
+    sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, &DatabaseManager::callbackPerfil, this);
+
     connected = true;
     return true;
 }
@@ -108,6 +139,12 @@ void DatabaseManager::desconectar()
 {
     if (connected && db)
     {
+        for (auto &item : cacheStatements)
+        {
+            sqlite3_finalize(item.second);
+        }
+        cacheStatements.clear();
+
         sqlite3_close(db);
         db = nullptr;
         connected = false;
@@ -123,6 +160,7 @@ bool DatabaseManager::executarSQL(const std::string &sql)
 
     char *errorMsg = nullptr;
     int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errorMsg);
+    registrarConsultasLentas();
 
     if (rc != SQLITE_OK)
     {
@@ -134,6 +172,29 @@ bool DatabaseManager::executarSQL(const std::string &sql)
     return true;
 }
 
+/**
+ * @brief Lê um valor inteiro de um PRAGMA ou consulta de uma linha
+ */
+static long long consultarInteiro(sqlite3 *db, const char *sql)
+{
+    sqlite3_stmt *stmt = nullptr;
+    long long valor = 0;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        valor = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return valor;
+}
+
+/**
+ * @brief Cria as tabelas e as contagens de linhas mantidas por gatilhos
+ * @details A tabela contagens guarda o número de linhas de cada tabela, somado
+ *          e subtraído por gatilhos de INSERT e DELETE, para que
+ *          coletarEstatisticas() não percorra as tabelas a cada coleta. Em um
+ *          banco criado antes das contagens, elas são semeadas com COUNT(*) uma
+ *          única vez, na mesma transação que cria os gatilhos.
+ */
 bool DatabaseManager::inicializarBanco()
 {
     if (!conectar())
@@ -143,6 +204,8 @@ bool DatabaseManager::inicializarBanco()
     }
 
     std::string schema = R"(
+        PRAGMA journal_mode = WAL;
+
         CREATE TABLE IF NOT EXISTS contas (
             cpf TEXT PRIMARY KEY,
             nome TEXT NOT NULL,
@@ -166,13 +229,48 @@ bool DatabaseManager::inicializarBanco()
             codigo_carteira TEXT NOT NULL,
             FOREIGN KEY (codigo_carteira) REFERENCES carteiras(codigo)
         );
+
+        CREATE TABLE IF NOT EXISTS contagens (
+            tabela TEXT PRIMARY KEY,
+            linhas INTEGER NOT NULL
+        );
     )";
 
-    return executarSQL(schema);
+    if (!executarSQL(schema))
+    {
+        return false;
+    }
+    if (consultarInteiro(db, "SELECT COUNT(*) FROM contagens") == 3)
+    {
+        return true;
+    }
+
+    std::string contagens = "BEGIN IMMEDIATE;";
+    for (std::string tabela : {"contas", "carteiras", "ordens"})
+    {
+        std::string linhas = "UPDATE contagens SET linhas = linhas ";
+        std::string filtro = " WHERE tabela = '" + tabela + "'; END;";
+        contagens += "INSERT OR IGNORE INTO contagens SELECT '" + tabela + "', COUNT(*) FROM " + tabela + ";";
+        contagens += "CREATE TRIGGER IF NOT EXISTS contar_insercao_" + tabela + " AFTER INSERT ON " + tabela +
+                     " BEGIN " + linhas + "+ 1" + filtro;
+        contagens += "CREATE TRIGGER IF NOT EXISTS contar_remocao_" + tabela + " AFTER DELETE ON " + tabela +
+                     " BEGIN " + linhas + "- 1" + filtro;
+    }
+    contagens += "COMMIT;";
+
+    if (!executarSQL(contagens))
+    {
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
 }
 
 bool DatabaseManager::inserirConta(const Conta &conta)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("inserirConta");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -186,7 +284,7 @@ bool DatabaseManager::inserirConta(const Conta &conta)
     std::string sql = "INSERT INTO contas (cpf, nome, senha) VALUES (?, ?, ?)";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
@@ -204,12 +302,12 @@ bool DatabaseManager::inserirConta(const Conta &conta)
 
     if (rc != SQLITE_DONE)
     {
-        sqlite3_finalize(stmt);
+        finalizarStatement(stmt);
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
@@ -222,6 +320,9 @@ bool DatabaseManager::inserirConta(const Conta &conta)
 
 bool DatabaseManager::buscarConta(const Ncpf &cpf, Conta *conta)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("buscarConta");
+    MedidorLatencia medidor(latencia);
+
     if (!connected || !conta)
     {
         return false;
@@ -230,7 +331,7 @@ bool DatabaseManager::buscarConta(const Ncpf &cpf, Conta *conta)
     std::string sql = "SELECT cpf, nome, senha FROM contas WHERE cpf = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -263,12 +364,15 @@ bool DatabaseManager::buscarConta(const Ncpf &cpf, Conta *conta)
         }
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return found;
 }
 
 bool DatabaseManager::autenticarUsuario(const Ncpf &cpf, const Senha &senha)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("autenticarUsuario");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -277,7 +381,7 @@ bool DatabaseManager::autenticarUsuario(const Ncpf &cpf, const Senha &senha)
     std::string sql = "SELECT COUNT(*) FROM contas WHERE cpf = ? AND senha = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -295,12 +399,15 @@ bool DatabaseManager::autenticarUsuario(const Ncpf &cpf, const Senha &senha)
         authenticated = count > 0;
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return authenticated;
 }
 
 bool DatabaseManager::inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("inserirCarteira");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -309,7 +416,7 @@ bool DatabaseManager::inserirCarteira(const Carteira &carteira, const Ncpf &cpfP
     std::string sql = "INSERT INTO carteiras (codigo, nome, tipo_perfil, cpf_conta) VALUES (?, ?, ?, ?)";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -325,13 +432,16 @@ bool DatabaseManager::inserirCarteira(const Carteira &carteira, const Ncpf &cpfP
     sqlite3_bind_text(stmt, 4, cpfValor.c_str(), -1, SQLITE_STATIC);
 
     int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return rc == SQLITE_DONE;
 }
 
 bool DatabaseManager::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("listarCarteiras");
+    MedidorLatencia medidor(latencia);
+
     if (!connected || !listaCarteiras)
     {
         return false;
@@ -340,7 +450,7 @@ bool DatabaseManager::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *list
     std::string sql = "SELECT codigo, nome, tipo_perfil FROM carteiras WHERE cpf_conta = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -372,17 +482,21 @@ bool DatabaseManager::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *list
         catch (const std::exception &e)
         {
             std::cerr << "Erro ao criar carteira: " << e.what() << std::endl;
-            sqlite3_finalize(stmt);
+            finalizarStatement(stmt);
             return false;
         }
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return true;
 }
 
 bool DatabaseManager::buscarCarteira(const Codigo &codigo, Carteira *carteira)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("buscarCarteira");
+    MedidorLatencia medidor(latencia);
+    SpanRastreamento span("DatabaseManager::buscarCarteira", "banco");
+
     if (!connected || !carteira)
     {
         return false;
@@ -391,7 +505,7 @@ bool DatabaseManager::buscarCarteira(const Codigo &codigo, Carteira *carteira)
     std::string sql = "SELECT codigo, nome, tipo_perfil FROM carteiras WHERE codigo = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -430,12 +544,16 @@ bool DatabaseManager::buscarCarteira(const Codigo &codigo, Carteira *carteira)
         }
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return found;
 }
 
 bool DatabaseManager::inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("inserirOrdem");
+    MedidorLatencia medidor(latencia);
+    SpanRastreamento span("DatabaseManager::inserirOrdem", "banco");
+
     if (!connected)
     {
         return false;
@@ -445,7 +563,7 @@ bool DatabaseManager::inserirOrdem(const Ordem &ordem, const Codigo &codigoCarte
         "INSERT INTO ordens (codigo, codigo_neg, data, valor, quantidade, codigo_carteira) VALUES (?, ?, ?, ?, ?, ?)";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -465,13 +583,16 @@ bool DatabaseManager::inserirOrdem(const Ordem &ordem, const Codigo &codigoCarte
     sqlite3_bind_text(stmt, 6, codigoCarteiraValor.c_str(), -1, SQLITE_STATIC);
 
     int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return rc == SQLITE_DONE;
 }
 
 bool DatabaseManager::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("listarOrdens");
+    MedidorLatencia medidor(latencia);
+
     if (!connected || !listaOrdens)
     {
         return false;
@@ -480,7 +601,7 @@ bool DatabaseManager::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem
     std::string sql = "SELECT codigo, codigo_neg, data, valor, quantidade FROM ordens WHERE codigo_carteira = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -518,17 +639,20 @@ bool DatabaseManager::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem
         catch (const std::exception &e)
         {
             std::cerr << "Erro ao criar ordem: " << e.what() << std::endl;
-            sqlite3_finalize(stmt);
+            finalizarStatement(stmt);
             return false;
         }
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return true;
 }
 
 bool DatabaseManager::excluirOrdem(const Codigo &codigo)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("excluirOrdem");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -537,7 +661,7 @@ bool DatabaseManager::excluirOrdem(const Codigo &codigo)
     std::string sql = "DELETE FROM ordens WHERE codigo = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -546,13 +670,16 @@ bool DatabaseManager::excluirOrdem(const Codigo &codigo)
     sqlite3_bind_text(stmt, 1, codigoValor.c_str(), -1, SQLITE_STATIC);
 
     int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
 }
 
 bool DatabaseManager::excluirCarteira(const Codigo &codigo)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("excluirCarteira");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -566,7 +693,7 @@ bool DatabaseManager::excluirCarteira(const Codigo &codigo)
     std::string sql = "DELETE FROM carteiras WHERE codigo = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -575,13 +702,16 @@ bool DatabaseManager::excluirCarteira(const Codigo &codigo)
     sqlite3_bind_text(stmt, 1, codigoValor.c_str(), -1, SQLITE_STATIC);
 
     int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
 }
 
 bool DatabaseManager::calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("calcularSaldoCarteira");
+    MedidorLatencia medidor(latencia);
+
     if (!connected || !saldo)
     {
         return false;
@@ -638,6 +768,9 @@ bool DatabaseManager::calcularSaldoCarteira(const Codigo &codigoCarteira, Dinhei
 
 bool DatabaseManager::atualizarConta(const Conta &conta)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("atualizarConta");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -651,7 +784,7 @@ bool DatabaseManager::atualizarConta(const Conta &conta)
     std::string sql = "UPDATE contas SET nome = ?, senha = ? WHERE cpf = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
@@ -669,12 +802,12 @@ bool DatabaseManager::atualizarConta(const Conta &conta)
 
     if (rc != SQLITE_DONE)
     {
-        sqlite3_finalize(stmt);
+        finalizarStatement(stmt);
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
@@ -687,6 +820,9 @@ bool DatabaseManager::atualizarConta(const Conta &conta)
 
 bool DatabaseManager::excluirConta(const Ncpf &cpf)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("excluirConta");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -700,7 +836,7 @@ bool DatabaseManager::excluirConta(const Ncpf &cpf)
     std::string sql = "DELETE FROM contas WHERE cpf = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -709,13 +845,16 @@ bool DatabaseManager::excluirConta(const Ncpf &cpf)
     sqlite3_bind_text(stmt, 1, cpfValor.c_str(), -1, SQLITE_STATIC);
 
     int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return rc == SQLITE_DONE && sqlite3_changes(db) > 0;
 }
 
 bool DatabaseManager::atualizarCarteira(const Carteira &carteira)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("atualizarCarteira");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -729,7 +868,7 @@ bool DatabaseManager::atualizarCarteira(const Carteira &carteira)
     std::string sql = "UPDATE carteiras SET nome = ?, tipo_perfil = ? WHERE codigo = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
@@ -747,12 +886,12 @@ bool DatabaseManager::atualizarCarteira(const Carteira &carteira)
 
     if (rc != SQLITE_DONE)
     {
-        sqlite3_finalize(stmt);
+        finalizarStatement(stmt);
         sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     if (sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
     {
@@ -765,6 +904,10 @@ bool DatabaseManager::atualizarCarteira(const Carteira &carteira)
 
 bool DatabaseManager::buscarOrdem(const Codigo &codigo, Ordem *ordem)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("buscarOrdem");
+    MedidorLatencia medidor(latencia);
+    SpanRastreamento span("DatabaseManager::buscarOrdem", "banco");
+
     if (!connected || !ordem)
     {
         return false;
@@ -773,7 +916,7 @@ bool DatabaseManager::buscarOrdem(const Codigo &codigo, Ordem *ordem)
     std::string sql = "SELECT codigo, codigo_neg, data, valor, quantidade FROM ordens WHERE codigo = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -812,21 +955,189 @@ bool DatabaseManager::buscarOrdem(const Codigo &codigo, Ordem *ordem)
         }
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
     return found;
 }
 
+/**
+ * @brief Obtém um statement preparado, reaproveitando o cache da conexão
+ * @details Cada texto SQL é compilado uma única vez por conexão. Nas chamadas
+ *          seguintes o mesmo statement é devolvido, já reiniciado por
+ *          finalizarStatement().
+ */
 bool DatabaseManager::prepararStatement(const std::string &sql, sqlite3_stmt **stmt)
 {
-    return sqlite3_prepare_v2(db, sql.c_str(), -1, stmt, nullptr) == SQLITE_OK;
+    static std::atomic<uint64_t> &acertosGlobais = RegistroMetricas::instancia().contador(
+        "investimentos_banco_cache_statements_total", "resultado=\"acerto\"", "Consultas ao cache de statements.");
+    static std::atomic<uint64_t> &faltasGlobais = RegistroMetricas::instancia().contador(
+        "investimentos_banco_cache_statements_total", "resultado=\"falta\"", "Consultas ao cache de statements.");
+
+    auto it = cacheStatements.find(sql);
+    if (it != cacheStatements.end())
+    {
+        acertosCacheStatements++;
+        acertosGlobais.fetch_add(1, std::memory_order_relaxed);
+        *stmt = it->second;
+        return true;
+    }
+
+    faltasCacheStatements++;
+    faltasGlobais.fetch_add(1, std::memory_order_relaxed);
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, stmt, nullptr) != SQLITE_OK)
+    {
+        return false;
+    }
+
+    cacheStatements.emplace(sql, *stmt);
+    return true;
 }
 
+/**
+ * @brief Devolve um statement ao cache
+ * @details Reinicia o statement e limpa os parâmetros, que apontam para strings
+ *          locais do chamador (SQLITE_STATIC). A finalização ocorre apenas em desconectar().
+ */
 void DatabaseManager::finalizarStatement(sqlite3_stmt *stmt)
 {
     if (stmt)
     {
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+    registrarConsultasLentas();
+}
+
+/**
+ * @brief Callback de rastreamento do SQLite (SQLITE_TRACE_STMT e SQLITE_TRACE_PROFILE)
+ * @details O SQLite avisa o início (STMT) e o fim (PROFILE) de cada execução de
+ *          statement. A duração informada pelo PROFILE tem a resolução do relógio do
+ *          VFS, que no VFS unix é de milissegundos; por isso o início é marcado aqui
+ *          com o relógio monotônico e a duração é medida em nanossegundos. Os tempos
+ *          são agregados pelo texto SQL sem parâmetros expandidos.
+ *          O plano de consultas lentas não é obtido aqui, pois a conexão ainda está
+ *          executando o statement; elas ficam pendentes até registrarConsultasLentas().
+ */
+int DatabaseManager::callbackPerfil(unsigned tipo, void *contexto, void *statement, void *duracao)
+{
+    DatabaseManager *gerenciador = static_cast<DatabaseManager *>(contexto);
+    sqlite3_stmt *stmt = static_cast<sqlite3_stmt *>(statement);
+    if (gerenciador->analisandoPlano)
+    {
+        return 0;
+    }
+
+    uint64_t agora = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+
+    if (tipo == SQLITE_TRACE_STMT)
+    {
+        gerenciador->inicioStatements[stmt] = agora;
+        return 0;
+    }
+
+    uint64_t ns = static_cast<uint64_t>(*static_cast<sqlite3_int64 *>(duracao));
+    auto inicio = gerenciador->inicioStatements.find(stmt);
+    if (inicio != gerenciador->inicioStatements.end())
+    {
+        ns = agora - inicio->second;
+        gerenciador->inicioStatements.erase(inicio);
+    }
+
+    const char *textoSql = sqlite3_sql(stmt);
+    std::string sql = textoSql ? textoSql : "";
+
+    std::unique_ptr<HistogramaLatencia> &perfil = gerenciador->perfilStatements[sql];
+    if (!perfil)
+    {
+        perfil.reset(new HistogramaLatencia());
+    }
+    perfil->registrar(ns);
+
+    double ms = static_cast<double>(ns) / 1e6;
+    if (ms >= gerenciador->limiteConsultaLentaMs)
+    {
+        gerenciador->consultasLentasPendentes.emplace_back(sql, ms);
     }
+    return 0;
+}
+
+/**
+ * @brief Registra as consultas lentas pendentes com seu plano de execução
+ * @details Cada consulta é reportada em std::cerr e guardada entre as últimas
+ *          MAXIMO_CONSULTAS_LENTAS, para exibição em obterEstatisticas(). O plano
+ *          é obtido e impresso apenas na primeira ocorrência de cada texto SQL.
+ */
+void DatabaseManager::registrarConsultasLentas()
+{
+    if (consultasLentasPendentes.empty() || analisandoPlano)
+    {
+        return;
+    }
+
+    std::vector<std::pair<std::string, double>> pendentes;
+    pendentes.swap(consultasLentasPendentes);
+
+    for (const auto &pendente : pendentes)
+    {
+        auto plano = planosConsultasLentas.find(pendente.first);
+        bool primeiraOcorrencia = plano == planosConsultasLentas.end();
+        if (primeiraOcorrencia)
+        {
+            plano = planosConsultasLentas.emplace(pendente.first, planoConsulta(pendente.first)).first;
+        }
+
+        ConsultaLenta consulta{pendente.first, pendente.second, plano->second};
+        std::cerr << "Consulta lenta (" << std::fixed << std::setprecision(1) << consulta.duracaoMs
+                  << " ms): " << consulta.sql << std::endl;
+        if (primeiraOcorrencia)
+        {
+            std::cerr << consulta.plano;
+        }
+        std::cerr.unsetf(std::ios::floatfield);
+
+        consultasLentas.push_back(std::move(consulta));
+        if (consultasLentas.size() > MAXIMO_CONSULTAS_LENTAS)
+        {
+            consultasLentas.pop_front();
+        }
+    }
+}
+
+/**
+ * @brief Obtém o EXPLAIN QUERY PLAN de um texto SQL
+ * @return Uma linha por passo do plano, indentada pela profundidade, ou vazio
+ *         para comandos sem plano (BEGIN, COMMIT...)
+ */
+std::string DatabaseManager::planoConsulta(const std::string &sql)
+{
+    if (!connected || sql.empty())
+    {
+        return "";
+    }
+
+    analisandoPlano = true;
+    sqlite3_stmt *stmt = nullptr;
+    std::ostringstream plano;
+
+    if (sqlite3_prepare_v2(db, ("EXPLAIN QUERY PLAN " + sql).c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+    {
+        std::unordered_map<int, int> profundidade;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            int id = sqlite3_column_int(stmt, 0);
+            int pai = sqlite3_column_int(stmt, 1);
+            const unsigned char *detalhe = sqlite3_column_text(stmt, 3);
+            int nivel = profundidade.count(pai) ? profundidade[pai] + 1 : 1;
+            profundidade[id] = nivel;
+            plano << std::string(static_cast<size_t>(nivel) * 2, ' ') << (detalhe ? (const char *)detalhe : "")
+                  << std::endl;
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    analisandoPlano = false;
+    return plano.str();
 }
 
 std::string DatabaseManager::escaparString(const std::string &str)
@@ -846,23 +1157,237 @@ std::string DatabaseManager::escaparString(const std::string &str)
     return escaped;
 }
 
+/**
+ * @brief Normaliza espaços de um texto SQL para exibição em uma linha
+ */
+static std::string sqlEmUmaLinha(const std::string &texto)
+{
+    std::string sql;
+    for (char c : texto)
+    {
+        bool espaco = std::isspace(static_cast<unsigned char>(c)) != 0;
+        if (!espaco || (!sql.empty() && sql.back() != ' '))
+        {
+            sql += espaco ? ' ' : c;
+        }
+    }
+    if (!sql.empty() && sql.back() == ' ')
+    {
+        sql.pop_back();
+    }
+    return sql;
+}
+
+bool DatabaseManager::coletarEstatisticas(EstatisticasBanco *estatisticas)
+{
+    if (!connected || !estatisticas)
+    {
+        return false;
+    }
+
+    EstatisticasBanco &e = *estatisticas;
+    e = EstatisticasBanco();
+    e.arquivo = dbPath;
+
+    // As consultas de diagnóstico não entram no perfil de statements
+    analisandoPlano = true;
+    e.contas = consultarInteiro(db, "SELECT linhas FROM contagens WHERE tabela = 'contas'");
+    e.carteiras = consultarInteiro(db, "SELECT linhas FROM contagens WHERE tabela = 'carteiras'");
+    e.ordens = consultarInteiro(db, "SELECT linhas FROM contagens WHERE tabela = 'ordens'");
+    e.tamanhoPagina = consultarInteiro(db, "PRAGMA page_size");
+    e.paginas = consultarInteiro(db, "PRAGMA page_count");
+    e.paginasLivres = consultarInteiro(db, "PRAGMA freelist_count");
+    analisandoPlano = false;
+
+    struct stat infoWal;
+    if (stat((dbPath + "-wal").c_str(), &infoWal) == 0)
+    {
+        e.tamanhoWalBytes = static_cast<long long>(infoWal.st_size);
+    }
+
+    int pico = 0;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &e.acertosCachePaginas, &pico, 0);
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &e.faltasCachePaginas, &pico, 0);
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &e.escritasCachePaginas, &pico, 0);
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &e.memoriaCachePaginasBytes, &pico, 0);
+
+    sqlite3_int64 memoriaAtual = 0;
+    sqlite3_int64 memoriaPico = 0;
+    sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &memoriaAtual, &memoriaPico, 0);
+    e.memoriaSqliteBytes = memoriaAtual;
+    e.picoMemoriaSqliteBytes = memoriaPico;
+
+    e.acertosCacheStatements = acertosCacheStatements;
+    e.faltasCacheStatements = faltasCacheStatements;
+    e.limiteConsultaLentaMs = limiteConsultaLentaMs;
+
+    for (const auto &item : perfilStatements)
+    {
+        const HistogramaLatencia &h = *item.second;
+        e.statements.push_back({item.first, h.getContagem(), h.getSomaNs(), h.percentil(0.50), h.percentil(0.99),
+                                h.getMaximoNs()});
+    }
+    std::sort(e.statements.begin(), e.statements.end(),
+              [](const PerfilStatement &a, const PerfilStatement &b) { return a.totalNs > b.totalNs; });
+
+    e.consultasLentas.assign(consultasLentas.begin(), consultasLentas.end());
+    return true;
+}
+
+/**
+ * @brief Razão de acertos em porcentagem, ou 0 sem acessos
+ */
+static double taxaAcerto(unsigned long long acertos, unsigned long long faltas)
+{
+    unsigned long long total = acertos + faltas;
+    return total == 0 ? 0.0 : 100.0 * static_cast<double>(acertos) / static_cast<double>(total);
+}
+
 std::string DatabaseManager::obterEstatisticas()
 {
-    if (!connected)
+    EstatisticasBanco e;
+    if (!coletarEstatisticas(&e))
     {
         return "Não conectado ao banco";
     }
 
     std::ostringstream stats;
+    stats << std::fixed << std::setprecision(3);
     stats << "=== ESTATÍSTICAS DO BANCO ===" << std::endl;
     stats << "Banco SQLite conectado" << std::endl;
-    stats << "Arquivo: " << dbPath << std::endl;
+    stats << "Arquivo: " << e.arquivo << std::endl;
+    stats << "Registros: " << e.contas << " contas, " << e.carteiras << " carteiras, " << e.ordens << " ordens"
+          << std::endl;
+    stats << "Páginas: " << e.paginas << " de " << e.tamanhoPagina << " bytes (" << e.paginasLivres << " livres)"
+          << std::endl;
+    stats << "WAL: " << e.tamanhoWalBytes << " bytes" << std::endl;
+    stats << "Cache de páginas: " << e.acertosCachePaginas << " acertos, " << e.faltasCachePaginas << " faltas ("
+          << std::setprecision(1) << taxaAcerto(e.acertosCachePaginas, e.faltasCachePaginas) << "%), "
+          << e.escritasCachePaginas << " escritas, " << e.memoriaCachePaginasBytes << " bytes" << std::endl;
+    stats << "Cache de statements: " << e.acertosCacheStatements << " acertos, " << e.faltasCacheStatements
+          << " faltas (" << taxaAcerto(e.acertosCacheStatements, e.faltasCacheStatements) << "%)" << std::endl;
+    stats << "Memória SQLite (processo): " << e.memoriaSqliteBytes << " bytes, pico " << e.picoMemoriaSqliteBytes
+          << " bytes" << std::endl;
+    stats << std::setprecision(3);
+
+    std::string latencias = RegistroMetricas::instancia().resumirLatencias("investimentos_banco_consulta_duracao_segundos");
+    if (!latencias.empty())
+    {
+        stats << "Latência das consultas (processo):" << std::endl << latencias;
+    }
+
+    if (!e.statements.empty())
+    {
+        stats << "Statements SQL (por tempo total):" << std::endl;
+        for (const PerfilStatement &perfil : e.statements)
+        {
+            std::string sql = sqlEmUmaLinha(perfil.sql);
+            if (sql.size() > 80)
+            {
+                sql = sql.substr(0, 77) + "...";
+            }
+            stats << "  n=" << perfil.execucoes << " total=" << perfil.totalNs / 1e6 << "ms p50=" << perfil.p50Ns / 1e6
+                  << "ms p99=" << perfil.p99Ns / 1e6 << "ms max=" << perfil.maximoNs / 1e6 << "ms  " << sql
+                  << std::endl;
+        }
+    }
+
+    stats << "Consultas lentas (>= " << e.limiteConsultaLentaMs << " ms): " << e.consultasLentas.size() << std::endl;
+    for (const ConsultaLenta &consulta : e.consultasLentas)
+    {
+        stats << "  " << consulta.duracaoMs << "ms  " << sqlEmUmaLinha(consulta.sql) << std::endl;
+        std::istringstream linhasPlano(consulta.plano);
+        std::string passo;
+        while (std::getline(linhasPlano, passo))
+        {
+            stats << "  " << passo << std::endl;
+        }
+    }
 
     return stats.str();
 }
 
+std::string DatabaseManager::obterEstatisticasJson()
+{
+    EstatisticasBanco e;
+    if (!coletarEstatisticas(&e))
+    {
+        return "{\"conectado\":false}";
+    }
+
+    std::ostringstream json;
+    json << "{\"conectado\":true,\"arquivo\":" << jsonUtils::texto(e.arquivo);
+    json << ",\"registros\":{\"contas\":" << e.contas << ",\"carteiras\":" << e.carteiras << ",\"ordens\":" << e.ordens
+         << "}";
+    json << ",\"paginas\":{\"tamanho\":" << e.tamanhoPagina << ",\"total\":" << e.paginas
+         << ",\"livres\":" << e.paginasLivres << "}";
+    json << ",\"wal_bytes\":" << e.tamanhoWalBytes;
+    json << ",\"cache_paginas\":{\"acertos\":" << e.acertosCachePaginas << ",\"faltas\":" << e.faltasCachePaginas
+         << ",\"escritas\":" << e.escritasCachePaginas << ",\"bytes\":" << e.memoriaCachePaginasBytes << "}";
+    json << ",\"cache_statements\":{\"acertos\":" << e.acertosCacheStatements
+         << ",\"faltas\":" << e.faltasCacheStatements
+         << ",\"taxa_acerto\":" << taxaAcerto(e.acertosCacheStatements, e.faltasCacheStatements) / 100.0 << "}";
+    json << ",\"memoria_sqlite\":{\"bytes\":" << e.memoriaSqliteBytes << ",\"pico_bytes\":" << e.picoMemoriaSqliteBytes
+         << "}";
+
+    json << ",\"statements\":[";
+    for (size_t i = 0; i < e.statements.size(); i++)
+    {
+        const PerfilStatement &perfil = e.statements[i];
+        json << (i ? "," : "") << "{\"sql\":" << jsonUtils::texto(sqlEmUmaLinha(perfil.sql))
+             << ",\"execucoes\":" << perfil.execucoes << ",\"total_ns\":" << perfil.totalNs
+             << ",\"p50_ns\":" << perfil.p50Ns << ",\"p99_ns\":" << perfil.p99Ns << ",\"max_ns\":" << perfil.maximoNs
+             << "}";
+    }
+    json << "],\"limite_consulta_lenta_ms\":" << e.limiteConsultaLentaMs << ",\"consultas_lentas\":[";
+    for (size_t i = 0; i < e.consultasLentas.size(); i++)
+    {
+        const ConsultaLenta &consulta = e.consultasLentas[i];
+        json << (i ? "," : "") << "{\"sql\":" << jsonUtils::texto(sqlEmUmaLinha(consulta.sql))
+             << ",\"duracao_ms\":" << consulta.duracaoMs << ",\"plano\":" << jsonUtils::texto(consulta.plano) << "}";
+    }
+    json << "]}";
+
+    return json.str();
+}
+
+bool DatabaseManager::listarChaves(std::vector<std::string> *cpfs, std::vector<std::string> *codigosCarteiras,
+                                   std::vector<std::string> *codigosOrdens)
+{
+    if (!connected || !cpfs || !codigosCarteiras || !codigosOrdens)
+    {
+        return false;
+    }
+
+    const std::pair<const char *, std::vector<std::string> *> consultas[] = {
+        {"SELECT cpf FROM contas", cpfs},
+        {"SELECT codigo FROM carteiras", codigosCarteiras},
+        {"SELECT codigo FROM ordens", codigosOrdens},
+    };
+
+    for (const auto &consulta : consultas)
+    {
+        sqlite3_stmt *stmt;
+        if (!prepararStatement(consulta.first, &stmt))
+        {
+            return false;
+        }
+
+        consulta.second->clear();
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            consulta.second->push_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+        }
+        finalizarStatement(stmt);
+    }
+    return true;
+}
+
 bool DatabaseManager::limparTodasTabelas()
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("limparTodasTabelas");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -874,6 +1399,9 @@ bool DatabaseManager::limparTodasTabelas()
 
 bool DatabaseManager::carteiraTemOrdens(const Codigo &codigoCarteira)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("carteiraTemOrdens");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -882,7 +1410,7 @@ bool DatabaseManager::carteiraTemOrdens(const Codigo &codigoCarteira)
     std::string sql = "SELECT COUNT(*) FROM ordens WHERE codigo_carteira = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -898,13 +1426,16 @@ bool DatabaseManager::carteiraTemOrdens(const Codigo &codigoCarteira)
         count = sqlite3_column_int(stmt, 0);
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return count > 0;
 }
 
 bool DatabaseManager::contaTemCarteiras(const Ncpf &cpf)
 {
+    static HistogramaLatencia &latencia = latenciaConsulta("contaTemCarteiras");
+    MedidorLatencia medidor(latencia);
+
     if (!connected)
     {
         return false;
@@ -913,7 +1444,7 @@ bool DatabaseManager::contaTemCarteiras(const Ncpf &cpf)
     std::string sql = "SELECT COUNT(*) FROM carteiras WHERE cpf_conta = ?";
     sqlite3_stmt *stmt;
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    if (!prepararStatement(sql, &stmt))
     {
         return false;
     }
@@ -929,7 +1460,7 @@ bool DatabaseManager::contaTemCarteiras(const Ncpf &cpf)
         count = sqlite3_column_int(stmt, 0);
     }
 
-    sqlite3_finalize(stmt);
+    finalizarStatement(stmt);
 
     return count > 0;
 }
@@ -3,25 +3,101 @@
 
 #include "../dominios/dominios.hpp"
 #include "../entidades/entidades.hpp"
+#include "../metricas/HistogramaLatencia.hpp"
+#include "IRepositorio.hpp"
+#include <cstdint>
+#include <deque>
 #include <list>
 #include <memory>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+/**
+ * @brief Consulta acima do limite de tempo, com o plano de execução
+ */
+struct ConsultaLenta
+{
+    std::string sql;
+    double duracaoMs;
+    std::string plano;
+};
+
+/**
+ * @brief Tempos agregados de um texto SQL na conexão
+ */
+struct PerfilStatement
+{
+    std::string sql;
+    unsigned long long execucoes;
+    uint64_t totalNs;
+    uint64_t p50Ns;
+    uint64_t p99Ns;
+    uint64_t maximoNs;
+};
+
+/**
+ * @brief Instantâneo das estatísticas de uma conexão e do arquivo do banco
+ * @details Valores ausentes (ex.: arquivo WAL inexistente) ficam em zero.
+ */
+struct EstatisticasBanco
+{
+    std::string arquivo;
+    long long contas = 0;
+    long long carteiras = 0;
+    long long ordens = 0;
+    long long tamanhoPagina = 0;
+    long long paginas = 0;
+    long long paginasLivres = 0;
+    long long tamanhoWalBytes = 0;
+    int acertosCachePaginas = 0;          ///< SQLITE_DBSTATUS_CACHE_HIT
+    int faltasCachePaginas = 0;           ///< SQLITE_DBSTATUS_CACHE_MISS
+    int escritasCachePaginas = 0;         ///< SQLITE_DBSTATUS_CACHE_WRITE
+    int memoriaCachePaginasBytes = 0;     ///< SQLITE_DBSTATUS_CACHE_USED
+    unsigned long long acertosCacheStatements = 0;
+    unsigned long long faltasCacheStatements = 0;
+    long long memoriaSqliteBytes = 0;     ///< SQLITE_STATUS_MEMORY_USED (processo)
+    long long picoMemoriaSqliteBytes = 0; ///< Maior valor de SQLITE_STATUS_MEMORY_USED
+    double limiteConsultaLentaMs = 0;
+    std::vector<PerfilStatement> statements; ///< Do maior para o menor tempo total
+    std::vector<ConsultaLenta> consultasLentas;
+};
+
 /**
  * @class DatabaseManager
  * @brief Gerenciador de banco de dados SQLite para o sistema de investimentos
  * @details Responsável por todas as operações de persistência, abstraindo
  * o acesso ao SQLite e fornecendo métodos específicos para cada entidade.
+ * Implementação SQLite de IRepositorio.
  */
-class DatabaseManager
+class DatabaseManager : public IRepositorio
 {
   private:
     sqlite3 *db;
     std::string dbPath;
     bool connected;
 
+    static const int TEMPO_ESPERA_LOCK_MS = 5000;
+
+    std::unordered_map<std::string, sqlite3_stmt *> cacheStatements; ///< Statements preparados, por texto SQL
+    unsigned long long acertosCacheStatements;
+    unsigned long long faltasCacheStatements;
+
+    static const size_t MAXIMO_CONSULTAS_LENTAS = 20;
+
+    std::unordered_map<std::string, std::unique_ptr<HistogramaLatencia>> perfilStatements; ///< Tempos por texto SQL
+    std::vector<std::pair<std::string, double>> consultasLentasPendentes;
+    std::deque<ConsultaLenta> consultasLentas; ///< Últimas consultas lentas, mais recente no fim
+    std::unordered_map<std::string, std::string> planosConsultasLentas; ///< Plano já obtido, por texto SQL
+    std::unordered_map<sqlite3_stmt *, uint64_t> inicioStatements;       ///< Início em ns de cada execução em curso
+    double limiteConsultaLentaMs;
+    bool analisandoPlano;
+
+    static int callbackPerfil(unsigned tipo, void *contexto, void *statement, void *duracao);
+    void registrarConsultasLentas();
+    std::string planoConsulta(const std::string &sql);
+
     bool executarSQL(const std::string &sql);
     bool prepararStatement(const std::string &sql, sqlite3_stmt **stmt);
     void finalizarStatement(sqlite3_stmt *stmt);
@@ -40,30 +116,30 @@ class DatabaseManager
     /**
      * @brief Destrutor - fecha conexão automaticamente
      */
-    ~DatabaseManager();
+    ~DatabaseManager() override;
 
     /**
      * @brief Conecta ao banco de dados SQLite
      * @return true se conectou com sucesso, false caso contrário
      */
-    bool conectar();
+    bool conectar() override;
 
     /**
      * @brief Desconecta do banco de dados
      */
-    void desconectar();
+    void desconectar() override;
 
     /**
      * @brief Inicializa o banco criando as tabelas necessárias
      * @return true se inicializou com sucesso, false caso contrário
      */
-    bool inicializarBanco();
+    bool inicializarBanco() override;
 
     /**
      * @brief Verifica se está conectado ao banco
      * @return true se conectado, false caso contrário
      */
-    bool estaConectado() const
+    bool estaConectado() const override
     {
         return connected;
     }
@@ -73,7 +149,7 @@ class DatabaseManager
      * @param conta Objeto Conta a ser inserido
      * @return true se inseriu com sucesso, false caso contrário
      */
-    bool inserirConta(const Conta &conta);
+    bool inserirConta(const Conta &conta) override;
 
     /**
      * @brief Busca uma conta pelo CPF
@@ -81,21 +157,21 @@ class DatabaseManager
      * @param conta Ponteiro para objeto onde será armazenada a conta encontrada
      * @return true se encontrou a conta, false caso contrário
      */
-    bool buscarConta(const Ncpf &cpf, Conta *conta);
+    bool buscarConta(const Ncpf &cpf, Conta *conta) override;
 
     /**
      * @brief Atualiza uma conta existente
      * @param conta Objeto Conta com dados atualizados
      * @return true se atualizou com sucesso, false caso contrário
      */
-    bool atualizarConta(const Conta &conta);
+    bool atualizarConta(const Conta &conta) override;
 
     /**
      * @brief Exclui uma conta do banco
      * @param cpf CPF da conta a ser excluída
      * @return true se excluiu com sucesso, false caso contrário
      */
-    bool excluirConta(const Ncpf &cpf);
+    bool excluirConta(const Ncpf &cpf) override;
 
     /**
      * @brief Autentica um usuário
@@ -103,7 +179,7 @@ class DatabaseManager
      * @param senha Senha do usuário
      * @return true se autenticação bem-sucedida, false caso contrário
      */
-    bool autenticarUsuario(const Ncpf &cpf, const Senha &senha);
+    bool autenticarUsuario(const Ncpf &cpf, const Senha &senha) override;
 
     /**
      * @brief Insere uma nova carteira no banco
@@ -111,7 +187,7 @@ class DatabaseManager
      * @param cpfProprietario CPF do proprietário da carteira
      * @return true se inseriu com sucesso, false caso contrário
      */
-    bool inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario);
+    bool inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario) override;
 
     /**
      * @brief Lista todas as carteiras de um usuário
@@ -119,7 +195,7 @@ class DatabaseManager
      * @param listaCarteiras Ponteiro para lista onde serão armazenadas as carteiras
      * @return true se listou com sucesso, false caso contrário
      */
-    bool listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras);
+    bool listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras) override;
 
     /**
      * @brief Busca uma carteira pelo código
@@ -127,21 +203,21 @@ class DatabaseManager
      * @param carteira Ponteiro para objeto onde será armazenada a carteira
      * @return true se encontrou a carteira, false caso contrário
      */
-    bool buscarCarteira(const Codigo &codigo, Carteira *carteira);
+    bool buscarCarteira(const Codigo &codigo, Carteira *carteira) override;
 
     /**
      * @brief Atualiza uma carteira existente
      * @param carteira Objeto Carteira com dados atualizados
      * @return true se atualizou com sucesso, false caso contrário
      */
-    bool atualizarCarteira(const Carteira &carteira);
+    bool atualizarCarteira(const Carteira &carteira) override;
 
     /**
      * @brief Exclui uma carteira do banco
      * @param codigo Código da carteira a ser excluída
      * @return true se excluiu com sucesso, false caso contrário
      */
-    bool excluirCarteira(const Codigo &codigo);
+    bool excluirCarteira(const Codigo &codigo) override;
 
     /**
      * @brief Insere uma nova ordem no banco
@@ -149,7 +225,7 @@ class DatabaseManager
      * @param codigoCarteira Código da carteira proprietária
      * @return true se inseriu com sucesso, false caso contrário
      */
-    bool inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira);
+    bool inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira) override;
 
     /**
      * @brief Lista todas as ordens de uma carteira
@@ -157,7 +233,7 @@ class DatabaseManager
      * @param listaOrdens Ponteiro para lista onde serão armazenadas as ordens
      * @return true se listou com sucesso, false caso contrário
      */
-    bool listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens);
+    bool listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens) override;
 
     /**
      * @brief Busca uma ordem pelo código
@@ -165,14 +241,14 @@ class DatabaseManager
      * @param ordem Ponteiro para objeto onde será armazenada a ordem
      * @return true se encontrou a ordem, false caso contrário
      */
-    bool buscarOrdem(const Codigo &codigo, Ordem *ordem);
+    bool buscarOrdem(const Codigo &codigo, Ordem *ordem) override;
 
     /**
      * @brief Exclui uma ordem do banco
      * @param codigo Código da ordem a ser excluída
      * @return true se excluiu com sucesso, false caso contrário
      */
-    bool excluirOrdem(const Codigo &codigo);
+    bool excluirOrdem(const Codigo &codigo) override;
 
     /**
      * @brief Calcula o saldo total de uma carteira
@@ -180,19 +256,54 @@ class DatabaseManager
      * @param saldo Ponteiro para objeto onde será armazenado o saldo
      * @return true se calculou com sucesso, false caso contrário
      */
-    bool calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo);
+    bool calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo) override;
 
     /**
      * @brief Limpa todas as tabelas (usado para testes)
      * @return true se limpou com sucesso, false caso contrário
      */
-    bool limparTodasTabelas();
+    bool limparTodasTabelas() override;
+
+    /**
+     * @brief Lista as chaves primárias das três tabelas
+     * @param cpfs Vetor a preencher com os CPFs das contas
+     * @param codigosCarteiras Vetor a preencher com os códigos das carteiras
+     * @param codigosOrdens Vetor a preencher com os códigos das ordens
+     * @return true se listou com sucesso, false caso contrário
+     * @details Usado para reconstruir o diretório de RepositorioFragmentado.
+     */
+    bool listarChaves(std::vector<std::string> *cpfs, std::vector<std::string> *codigosCarteiras,
+                      std::vector<std::string> *codigosOrdens);
+
+    /**
+     * @brief Coleta as estatísticas da conexão e do arquivo do banco
+     * @param estatisticas Estrutura a preencher
+     * @return true se coletou com sucesso, false se não conectado
+     * @details As contagens de linhas vêm da tabela contagens, mantida por
+     * gatilhos, sem percorrer as tabelas.
+     */
+    bool coletarEstatisticas(EstatisticasBanco *estatisticas);
 
     /**
-     * @brief Obtém estatísticas do banco
-     * @return string com informações sobre número de registros
+     * @brief Obtém estatísticas do banco em texto legível
+     * @return string com contagens, páginas, caches, memória e perfil de statements
      */
-    std::string obterEstatisticas();
+    std::string obterEstatisticas() override;
+
+    /**
+     * @brief Obtém as mesmas estatísticas de obterEstatisticas() em JSON
+     * @return string com um objeto JSON, ou {"conectado":false}
+     */
+    std::string obterEstatisticasJson() override;
+
+    /**
+     * @brief Define a partir de quanto tempo uma consulta é registrada como lenta
+     * @param milissegundos Limite em milissegundos (o padrão vem de INVESTIMENTOS_CONSULTA_LENTA_MS, ou 100)
+     */
+    void setLimiteConsultaLenta(double milissegundos)
+    {
+        limiteConsultaLentaMs = milissegundos;
+    }
 
     /**
      * @brief Converte centavos para formato brasileiro de dinheiro
@@ -0,0 +1,184 @@
+#ifndef IREPOSITORIO_HPP_INCLUDED
+#define IREPOSITORIO_HPP_INCLUDED
+
+#include "../dominios/dominios.hpp"
+#include "../entidades/entidades.hpp"
+#include <list>
+#include <string>
+
+/**
+ * @class IRepositorio
+ * @brief Interface de persistência de contas, carteiras e ordens
+ * @details Contrato extraído dos métodos públicos do DatabaseManager, para que a
+ * camada de serviço funcione sobre qualquer backend de armazenamento. As
+ * implementações devem preservar as mesmas regras do SQLite: chaves únicas
+ * por CPF e por código, exclusão de conta/carteira recusada enquanto houver
+ * carteiras/ordens vinculadas e saldo de carteira vazia igual a "0,01".
+ * @see DatabaseManager
+ * @see RepositorioMemoria
+ */
+class IRepositorio
+{
+  public:
+    /**
+     * @brief Abre o armazenamento
+     * @return true se conectou com sucesso, false caso contrário
+     */
+    virtual bool conectar() = 0;
+
+    /**
+     * @brief Fecha o armazenamento
+     */
+    virtual void desconectar() = 0;
+
+    /**
+     * @brief Conecta e cria as estruturas necessárias
+     * @return true se inicializou com sucesso, false caso contrário
+     */
+    virtual bool inicializarBanco() = 0;
+
+    /**
+     * @brief Verifica se o armazenamento está aberto
+     * @return true se conectado, false caso contrário
+     */
+    virtual bool estaConectado() const = 0;
+
+    /**
+     * @brief Insere uma nova conta
+     * @param conta Conta a ser inserida
+     * @return true se inseriu, false se o CPF já existe ou em caso de erro
+     */
+    virtual bool inserirConta(const Conta &conta) = 0;
+
+    /**
+     * @brief Busca uma conta pelo CPF
+     * @param cpf CPF da conta
+     * @param conta Ponteiro para armazenar a conta encontrada
+     * @return true se encontrou, false caso contrário
+     */
+    virtual bool buscarConta(const Ncpf &cpf, Conta *conta) = 0;
+
+    /**
+     * @brief Atualiza nome e senha de uma conta existente
+     * @param conta Conta com os novos dados
+     * @return true se alguma conta foi atualizada, false caso contrário
+     */
+    virtual bool atualizarConta(const Conta &conta) = 0;
+
+    /**
+     * @brief Exclui uma conta sem carteiras
+     * @param cpf CPF da conta
+     * @return true se excluiu, false se não existe ou ainda possui carteiras
+     */
+    virtual bool excluirConta(const Ncpf &cpf) = 0;
+
+    /**
+     * @brief Verifica as credenciais de um usuário
+     * @param cpf CPF do usuário
+     * @param senha Senha informada
+     * @return true se CPF e senha conferem, false caso contrário
+     */
+    virtual bool autenticarUsuario(const Ncpf &cpf, const Senha &senha) = 0;
+
+    /**
+     * @brief Insere uma carteira para uma conta
+     * @param carteira Carteira a ser inserida
+     * @param cpfProprietario CPF da conta dona da carteira
+     * @return true se inseriu, false se o código já existe ou em caso de erro
+     */
+    virtual bool inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario) = 0;
+
+    /**
+     * @brief Lista as carteiras de uma conta, na ordem de inserção
+     * @param cpf CPF da conta
+     * @param listaCarteiras Lista a ser preenchida
+     * @return true se listou com sucesso, false caso contrário
+     */
+    virtual bool listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras) = 0;
+
+    /**
+     * @brief Busca uma carteira pelo código
+     * @param codigo Código da carteira
+     * @param carteira Ponteiro para armazenar a carteira encontrada
+     * @return true se encontrou, false caso contrário
+     */
+    virtual bool buscarCarteira(const Codigo &codigo, Carteira *carteira) = 0;
+
+    /**
+     * @brief Atualiza nome e perfil de uma carteira existente
+     * @param carteira Carteira com os novos dados
+     * @return true se alguma carteira foi atualizada, false caso contrário
+     */
+    virtual bool atualizarCarteira(const Carteira &carteira) = 0;
+
+    /**
+     * @brief Exclui uma carteira sem ordens
+     * @param codigo Código da carteira
+     * @return true se excluiu, false se não existe ou ainda possui ordens
+     */
+    virtual bool excluirCarteira(const Codigo &codigo) = 0;
+
+    /**
+     * @brief Insere uma ordem em uma carteira
+     * @param ordem Ordem a ser inserida
+     * @param codigoCarteira Código da carteira
+     * @return true se inseriu, false se o código já existe ou em caso de erro
+     */
+    virtual bool inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira) = 0;
+
+    /**
+     * @brief Lista as ordens de uma carteira, na ordem de inserção
+     * @param codigoCarteira Código da carteira
+     * @param listaOrdens Lista a ser preenchida
+     * @return true se listou com sucesso, false caso contrário
+     */
+    virtual bool listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens) = 0;
+
+    /**
+     * @brief Busca uma ordem pelo código
+     * @param codigo Código da ordem
+     * @param ordem Ponteiro para armazenar a ordem encontrada
+     * @return true se encontrou, false caso contrário
+     */
+    virtual bool buscarOrdem(const Codigo &codigo, Ordem *ordem) = 0;
+
+    /**
+     * @brief Exclui uma ordem
+     * @param codigo Código da ordem
+     * @return true se excluiu, false se não existe
+     */
+    virtual bool excluirOrdem(const Codigo &codigo) = 0;
+
+    /**
+     * @brief Soma o valor das ordens de uma carteira
+     * @param codigoCarteira Código da carteira
+     * @param saldo Ponteiro para armazenar o saldo
+     * @return true se calculou com sucesso, false caso contrário
+     */
+    virtual bool calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo) = 0;
+
+    /**
+     * @brief Remove todos os registros (usado para testes)
+     * @return true se limpou com sucesso, false caso contrário
+     */
+    virtual bool limparTodasTabelas() = 0;
+
+    /**
+     * @brief Estatísticas do armazenamento em texto legível
+     */
+    virtual std::string obterEstatisticas() = 0;
+
+    /**
+     * @brief Estatísticas do armazenamento em JSON
+     */
+    virtual std::string obterEstatisticasJson() = 0;
+
+    /**
+     * @brief Destrutor virtual para permitir herança
+     */
+    virtual ~IRepositorio()
+    {
+    }
+};
+
+#endif // IREPOSITORIO_HPP_INCLUDED
@@ -0,0 +1,365 @@
+#include "RepositorioFragmentado.hpp"
+#include "../cotacoes/ImpressaoArquivo.hpp"
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+
+RepositorioFragmentado::RepositorioFragmentado(const std::string &caminhoBase, size_t quantidade,
+                                               std::shared_ptr<DiretorioFragmentos> diretorio)
+    : caminhoBase(caminhoBase), diretorio(diretorio ? std::move(diretorio) : std::make_shared<DiretorioFragmentos>())
+{
+    if (quantidade == 0)
+    {
+        quantidade = 1;
+    }
+
+    for (size_t i = 0; i < quantidade; i++)
+    {
+        fragmentos.push_back(std::make_unique<DatabaseManager>(caminhoFragmento(caminhoBase, i)));
+    }
+}
+
+std::string RepositorioFragmentado::caminhoFragmento(const std::string &caminhoBase, size_t indice)
+{
+    size_t barra = caminhoBase.find_last_of('/');
+    size_t ponto = caminhoBase.find_last_of('.');
+    if (ponto == std::string::npos || (barra != std::string::npos && ponto < barra))
+    {
+        return caminhoBase + "." + std::to_string(indice);
+    }
+    return caminhoBase.substr(0, ponto) + "." + std::to_string(indice) + caminhoBase.substr(ponto);
+}
+
+/**
+ * @brief FNV-1a de 64 bits sobre os dígitos do CPF
+ * @details std::hash não serve: o resultado decide em que arquivo o dado está
+ *          gravado e precisa ser o mesmo em qualquer execução.
+ */
+size_t RepositorioFragmentado::fragmentoDoCpf(const std::string &cpf, size_t quantidade)
+{
+    std::string digitos;
+    for (char c : cpf)
+    {
+        if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            digitos += c;
+        }
+    }
+    uint64_t hash = ImpressaoArquivo::somarFnv(digitos.data(), digitos.size());
+    return quantidade > 0 ? static_cast<size_t>(hash % quantidade) : 0;
+}
+
+size_t RepositorioFragmentado::fragmentoDaConta(const Ncpf &cpf) const
+{
+    return fragmentoDoCpf(cpf.getValor(), fragmentos.size());
+}
+
+size_t RepositorioFragmentado::buscarFragmento(const std::unordered_map<std::string, size_t> &mapa,
+                                               const std::string &codigo)
+{
+    std::shared_lock<std::shared_mutex> trava(diretorio->mutex);
+    auto it = mapa.find(codigo);
+    return it == mapa.end() ? FRAGMENTO_INEXISTENTE : it->second;
+}
+
+/**
+ * @brief Reserva um código no diretório antes de inseri-lo no fragmento
+ * @return false se o código já existe em algum fragmento ou está sendo inserido
+ */
+bool RepositorioFragmentado::reservarCodigo(std::unordered_map<std::string, size_t> &mapa, const std::string &codigo,
+                                            size_t fragmento)
+{
+    std::unique_lock<std::shared_mutex> trava(diretorio->mutex);
+    return mapa.emplace(codigo, fragmento).second;
+}
+
+void RepositorioFragmentado::liberarCodigo(std::unordered_map<std::string, size_t> &mapa, const std::string &codigo)
+{
+    std::unique_lock<std::shared_mutex> trava(diretorio->mutex);
+    mapa.erase(codigo);
+}
+
+/**
+ * @brief Reconstrói o diretório a partir das chaves gravadas nos fragmentos
+ * @details Feito uma única vez por diretório compartilhado. Também detecta
+ *          arquivos abertos com outra quantidade de fragmentos: um CPF fora do
+ *          fragmento do seu hash ou a existência do fragmento de índice N.
+ */
+bool RepositorioFragmentado::carregarDiretorio()
+{
+    std::unique_lock<std::shared_mutex> trava(diretorio->mutex);
+    if (diretorio->carregado)
+    {
+        return true;
+    }
+
+    struct stat informacoes;
+    std::string excedente = caminhoFragmento(caminhoBase, fragmentos.size());
+    if (stat(excedente.c_str(), &informacoes) == 0)
+    {
+        std::cerr << "Erro: " << excedente << " existe; os arquivos foram criados com mais de " << fragmentos.size()
+                  << " fragmentos." << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> cpfs;
+    std::vector<std::string> codigosCarteiras;
+    std::vector<std::string> codigosOrdens;
+
+    for (size_t i = 0; i < fragmentos.size(); i++)
+    {
+        if (!fragmentos[i]->listarChaves(&cpfs, &codigosCarteiras, &codigosOrdens))
+        {
+            return false;
+        }
+
+        for (const std::string &cpf : cpfs)
+        {
+            if (fragmentoDoCpf(cpf, fragmentos.size()) != i)
+            {
+                std::cerr << "Erro: CPF " << cpf << " gravado no fragmento " << i
+                          << "; os arquivos foram criados com outra quantidade de fragmentos." << std::endl;
+                return false;
+            }
+        }
+
+        for (const std::string &codigo : codigosCarteiras)
+        {
+            diretorio->fragmentoCarteira[codigo] = i;
+        }
+        for (const std::string &codigo : codigosOrdens)
+        {
+            diretorio->fragmentoOrdem[codigo] = i;
+        }
+    }
+
+    diretorio->carregado = true;
+    return true;
+}
+
+bool RepositorioFragmentado::conectar()
+{
+    for (auto &fragmento : fragmentos)
+    {
+        if (!fragmento->conectar())
+        {
+            desconectar();
+            return false;
+        }
+    }
+    return true;
+}
+
+void RepositorioFragmentado::desconectar()
+{
+    for (auto &fragmento : fragmentos)
+    {
+        fragmento->desconectar();
+    }
+}
+
+bool RepositorioFragmentado::inicializarBanco()
+{
+    for (auto &fragmento : fragmentos)
+    {
+        if (!fragmento->inicializarBanco())
+        {
+            desconectar();
+            return false;
+        }
+    }
+    return carregarDiretorio();
+}
+
+bool RepositorioFragmentado::estaConectado() const
+{
+    for (const auto &fragmento : fragmentos)
+    {
+        if (!fragmento->estaConectado())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RepositorioFragmentado::inserirConta(const Conta &conta)
+{
+    return fragmentos[fragmentoDaConta(conta.getNcpf())]->inserirConta(conta);
+}
+
+bool RepositorioFragmentado::buscarConta(const Ncpf &cpf, Conta *conta)
+{
+    return fragmentos[fragmentoDaConta(cpf)]->buscarConta(cpf, conta);
+}
+
+bool RepositorioFragmentado::atualizarConta(const Conta &conta)
+{
+    return fragmentos[fragmentoDaConta(conta.getNcpf())]->atualizarConta(conta);
+}
+
+bool RepositorioFragmentado::excluirConta(const Ncpf &cpf)
+{
+    return fragmentos[fragmentoDaConta(cpf)]->excluirConta(cpf);
+}
+
+bool RepositorioFragmentado::autenticarUsuario(const Ncpf &cpf, const Senha &senha)
+{
+    return fragmentos[fragmentoDaConta(cpf)]->autenticarUsuario(cpf, senha);
+}
+
+bool RepositorioFragmentado::inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario)
+{
+    size_t fragmento = fragmentoDaConta(cpfProprietario);
+    std::string codigo = carteira.getCodigo().getValor();
+    if (!reservarCodigo(diretorio->fragmentoCarteira, codigo, fragmento))
+    {
+        return false;
+    }
+
+    if (!fragmentos[fragmento]->inserirCarteira(carteira, cpfProprietario))
+    {
+        liberarCodigo(diretorio->fragmentoCarteira, codigo);
+        return false;
+    }
+    return true;
+}
+
+bool RepositorioFragmentado::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras)
+{
+    return fragmentos[fragmentoDaConta(cpf)]->listarCarteiras(cpf, listaCarteiras);
+}
+
+bool RepositorioFragmentado::buscarCarteira(const Codigo &codigo, Carteira *carteira)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, codigo.getValor());
+    return fragmento != FRAGMENTO_INEXISTENTE && fragmentos[fragmento]->buscarCarteira(codigo, carteira);
+}
+
+bool RepositorioFragmentado::atualizarCarteira(const Carteira &carteira)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, carteira.getCodigo().getValor());
+    return fragmento != FRAGMENTO_INEXISTENTE && fragmentos[fragmento]->atualizarCarteira(carteira);
+}
+
+bool RepositorioFragmentado::excluirCarteira(const Codigo &codigo)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, codigo.getValor());
+    if (fragmento == FRAGMENTO_INEXISTENTE || !fragmentos[fragmento]->excluirCarteira(codigo))
+    {
+        return false;
+    }
+
+    liberarCodigo(diretorio->fragmentoCarteira, codigo.getValor());
+    return true;
+}
+
+bool RepositorioFragmentado::inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, codigoCarteira.getValor());
+    if (fragmento == FRAGMENTO_INEXISTENTE)
+    {
+        return false;
+    }
+
+    std::string codigo = ordem.getCodigo().getValor();
+    if (!reservarCodigo(diretorio->fragmentoOrdem, codigo, fragmento))
+    {
+        return false;
+    }
+
+    if (!fragmentos[fragmento]->inserirOrdem(ordem, codigoCarteira))
+    {
+        liberarCodigo(diretorio->fragmentoOrdem, codigo);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lista as ordens de uma carteira
+ * @details Para uma carteira inexistente, qualquer fragmento dá a mesma resposta
+ *          (lista vazia); usa-se o primeiro.
+ */
+bool RepositorioFragmentado::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, codigoCarteira.getValor());
+    return fragmentos[fragmento == FRAGMENTO_INEXISTENTE ? 0 : fragmento]->listarOrdens(codigoCarteira, listaOrdens);
+}
+
+bool RepositorioFragmentado::buscarOrdem(const Codigo &codigo, Ordem *ordem)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoOrdem, codigo.getValor());
+    return fragmento != FRAGMENTO_INEXISTENTE && fragmentos[fragmento]->buscarOrdem(codigo, ordem);
+}
+
+bool RepositorioFragmentado::excluirOrdem(const Codigo &codigo)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoOrdem, codigo.getValor());
+    if (fragmento == FRAGMENTO_INEXISTENTE || !fragmentos[fragmento]->excluirOrdem(codigo))
+    {
+        return false;
+    }
+
+    liberarCodigo(diretorio->fragmentoOrdem, codigo.getValor());
+    return true;
+}
+
+bool RepositorioFragmentado::calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo)
+{
+    size_t fragmento = buscarFragmento(diretorio->fragmentoCarteira, codigoCarteira.getValor());
+    return fragmentos[fragmento == FRAGMENTO_INEXISTENTE ? 0 : fragmento]->calcularSaldoCarteira(codigoCarteira,
+                                                                                                  saldo);
+}
+
+bool RepositorioFragmentado::limparTodasTabelas()
+{
+    std::unique_lock<std::shared_mutex> trava(diretorio->mutex);
+    bool sucesso = true;
+    for (auto &fragmento : fragmentos)
+    {
+        sucesso = fragmento->limparTodasTabelas() && sucesso;
+    }
+    diretorio->fragmentoCarteira.clear();
+    diretorio->fragmentoOrdem.clear();
+    return sucesso;
+}
+
+std::string RepositorioFragmentado::obterEstatisticas()
+{
+    std::ostringstream stats;
+    stats << "=== REPOSITÓRIO FRAGMENTADO ===" << std::endl;
+    {
+        std::shared_lock<std::shared_mutex> trava(diretorio->mutex);
+        stats << "Fragmentos: " << fragmentos.size() << " (diretório: " << diretorio->fragmentoCarteira.size()
+              << " carteiras, " << diretorio->fragmentoOrdem.size() << " ordens)" << std::endl;
+    }
+
+    for (size_t i = 0; i < fragmentos.size(); i++)
+    {
+        stats << std::endl << "--- Fragmento " << i << " ---" << std::endl;
+        stats << fragmentos[i]->obterEstatisticas();
+    }
+    return stats.str();
+}
+
+std::string RepositorioFragmentado::obterEstatisticasJson()
+{
+    std::ostringstream json;
+    {
+        std::shared_lock<std::shared_mutex> trava(diretorio->mutex);
+        json << "{\"fragmentos\":" << fragmentos.size() << ",\"diretorio\":{\"carteiras\":"
+             << diretorio->fragmentoCarteira.size() << ",\"ordens\":" << diretorio->fragmentoOrdem.size() << "}";
+    }
+
+    json << ",\"bancos\":[";
+    for (size_t i = 0; i < fragmentos.size(); i++)
+    {
+        json << (i ? "," : "") << fragmentos[i]->obterEstatisticasJson();
+    }
+    json << "]}";
+    return json.str();
+}
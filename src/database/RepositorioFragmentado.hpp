@@ -0,0 +1,128 @@
+#ifndef REPOSITORIOFRAGMENTADO_HPP_INCLUDED
+#define REPOSITORIOFRAGMENTADO_HPP_INCLUDED
+
+#include "DatabaseManager.hpp"
+#include "IRepositorio.hpp"
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Diretório global código → fragmento de carteiras e ordens
+ * @details Contas são roteadas pelo hash do CPF, mas os códigos de carteira e de
+ * ordem são escolhidos pelo usuário, não carregam o fragmento e precisam ser
+ * únicos em todos os arquivos. O diretório guarda o fragmento de cada código e
+ * serve de reserva durante a inserção. Não é persistido: é reconstruído a partir
+ * das chaves dos próprios fragmentos na primeira inicialização, de modo que não
+ * há um arquivo extra a manter consistente com os dados.
+ *
+ * Uma instância deve ser compartilhada por todos os RepositorioFragmentado do
+ * processo que abrem os mesmos arquivos (ex.: um por trabalhador do servidor).
+ */
+struct DiretorioFragmentos
+{
+    std::shared_mutex mutex;
+    bool carregado = false;
+    std::unordered_map<std::string, size_t> fragmentoCarteira;
+    std::unordered_map<std::string, size_t> fragmentoOrdem;
+};
+
+/**
+ * @class RepositorioFragmentado
+ * @brief IRepositorio distribuído em N arquivos SQLite pelo hash do CPF
+ * @details Cada fragmento é um DatabaseManager com o esquema completo. A conta,
+ * suas carteiras e as ordens dessas carteiras ficam no mesmo fragmento, escolhido
+ * por FNV-1a dos dígitos do CPF; assim as regras de exclusão e o saldo continuam
+ * sendo consultas locais a um único arquivo. Operações por código de carteira ou
+ * de ordem consultam o DiretorioFragmentos.
+ *
+ * Escritas em fragmentos diferentes usam arquivos e travas de WAL diferentes e
+ * prosseguem em paralelo. A quantidade de fragmentos faz parte do formato: abrir
+ * os mesmos arquivos com outro N é recusado por inicializarBanco().
+ *
+ * Diferente do SQLite sem foreign_keys, inserirOrdem() exige que a carteira
+ * exista, pois é ela que define o fragmento da ordem.
+ */
+class RepositorioFragmentado : public IRepositorio
+{
+  private:
+    std::string caminhoBase;
+    std::vector<std::unique_ptr<DatabaseManager>> fragmentos;
+    std::shared_ptr<DiretorioFragmentos> diretorio;
+
+    static const size_t FRAGMENTO_INEXISTENTE = static_cast<size_t>(-1);
+
+    size_t fragmentoDaConta(const Ncpf &cpf) const;
+    size_t buscarFragmento(const std::unordered_map<std::string, size_t> &mapa, const std::string &codigo);
+    bool reservarCodigo(std::unordered_map<std::string, size_t> &mapa, const std::string &codigo, size_t fragmento);
+    void liberarCodigo(std::unordered_map<std::string, size_t> &mapa, const std::string &codigo);
+    bool carregarDiretorio();
+
+  public:
+    /**
+     * @brief Construtor
+     * @param caminhoBase Caminho do banco; cada fragmento usa caminhoFragmento(caminhoBase, i)
+     * @param quantidade Quantidade de fragmentos (mínimo 1)
+     * @param diretorio Diretório compartilhado com outras instâncias sobre os mesmos arquivos
+     *                  (nulo para um diretório próprio)
+     */
+    RepositorioFragmentado(const std::string &caminhoBase, size_t quantidade,
+                           std::shared_ptr<DiretorioFragmentos> diretorio = nullptr);
+
+    /**
+     * @brief Caminho do arquivo de um fragmento
+     * @param caminhoBase Caminho do banco (ex.: "dados/investimentos.db")
+     * @param indice Índice do fragmento
+     * @return Caminho com o índice antes da extensão (ex.: "dados/investimentos.2.db")
+     */
+    static std::string caminhoFragmento(const std::string &caminhoBase, size_t indice);
+
+    /**
+     * @brief Fragmento de um CPF
+     * @param cpf CPF em qualquer formatação (só os dígitos entram no hash)
+     * @param quantidade Quantidade de fragmentos
+     * @return Índice do fragmento, estável entre execuções e plataformas
+     */
+    static size_t fragmentoDoCpf(const std::string &cpf, size_t quantidade);
+
+    size_t quantidadeFragmentos() const
+    {
+        return fragmentos.size();
+    }
+
+    bool conectar() override;
+    void desconectar() override;
+
+    /**
+     * @brief Inicializa todos os fragmentos e carrega o diretório
+     * @return true se todos inicializaram e os dados estão no fragmento esperado
+     */
+    bool inicializarBanco() override;
+    bool estaConectado() const override;
+
+    bool inserirConta(const Conta &conta) override;
+    bool buscarConta(const Ncpf &cpf, Conta *conta) override;
+    bool atualizarConta(const Conta &conta) override;
+    bool excluirConta(const Ncpf &cpf) override;
+    bool autenticarUsuario(const Ncpf &cpf, const Senha &senha) override;
+
+    bool inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario) override;
+    bool listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras) override;
+    bool buscarCarteira(const Codigo &codigo, Carteira *carteira) override;
+    bool atualizarCarteira(const Carteira &carteira) override;
+    bool excluirCarteira(const Codigo &codigo) override;
+
+    bool inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira) override;
+    bool listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens) override;
+    bool buscarOrdem(const Codigo &codigo, Ordem *ordem) override;
+    bool excluirOrdem(const Codigo &codigo) override;
+    bool calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo) override;
+
+    bool limparTodasTabelas() override;
+    std::string obterEstatisticas() override;
+    std::string obterEstatisticasJson() override;
+};
+
+#endif // REPOSITORIOFRAGMENTADO_HPP_INCLUDED
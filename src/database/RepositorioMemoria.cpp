@@ -0,0 +1,392 @@
+#include "RepositorioMemoria.hpp"
+#include "DatabaseManager.hpp"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+RepositorioMemoria::RepositorioMemoria() : conectado(false)
+{
+}
+
+void RepositorioMemoria::removerCodigo(std::vector<std::string> &codigos, const std::string &codigo)
+{
+    auto it = std::find(codigos.begin(), codigos.end(), codigo);
+    if (it != codigos.end())
+    {
+        codigos.erase(it);
+    }
+}
+
+bool RepositorioMemoria::conectar()
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    conectado = true;
+    return true;
+}
+
+/**
+ * @brief Marca o repositório como desconectado
+ * @details Os dados são mantidos; uma nova conexão volta a enxergá-los.
+ */
+void RepositorioMemoria::desconectar()
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    conectado = false;
+}
+
+bool RepositorioMemoria::inicializarBanco()
+{
+    return conectar();
+}
+
+bool RepositorioMemoria::estaConectado() const
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    return conectado;
+}
+
+bool RepositorioMemoria::inserirConta(const Conta &conta)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    return contas.emplace(conta.getNcpf().getValor(), conta).second;
+}
+
+bool RepositorioMemoria::buscarConta(const Ncpf &cpf, Conta *conta)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado || !conta)
+    {
+        return false;
+    }
+
+    auto it = contas.find(cpf.getValor());
+    if (it == contas.end())
+    {
+        return false;
+    }
+
+    *conta = it->second;
+    return true;
+}
+
+bool RepositorioMemoria::atualizarConta(const Conta &conta)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto it = contas.find(conta.getNcpf().getValor());
+    if (it == contas.end())
+    {
+        return false;
+    }
+
+    it->second.setNome(conta.getNome());
+    it->second.setSenha(conta.getSenha());
+    return true;
+}
+
+bool RepositorioMemoria::excluirConta(const Ncpf &cpf)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto carteirasDaConta = carteirasPorConta.find(cpf.getValor());
+    if (carteirasDaConta != carteirasPorConta.end() && !carteirasDaConta->second.empty())
+    {
+        return false;
+    }
+
+    carteirasPorConta.erase(cpf.getValor());
+    return contas.erase(cpf.getValor()) > 0;
+}
+
+bool RepositorioMemoria::autenticarUsuario(const Ncpf &cpf, const Senha &senha)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto it = contas.find(cpf.getValor());
+    return it != contas.end() && it->second.getSenha().getValor() == senha.getValor();
+}
+
+/**
+ * @brief Insere uma carteira
+ * @details Assim como o esquema SQLite (sem PRAGMA foreign_keys), não verifica se
+ *          a conta existe; essa regra fica na camada de serviço.
+ */
+bool RepositorioMemoria::inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    std::string codigo = carteira.getCodigo().getValor();
+    if (!carteiras.emplace(codigo, RegistroCarteira{carteira, cpfProprietario.getValor()}).second)
+    {
+        return false;
+    }
+
+    carteirasPorConta[cpfProprietario.getValor()].push_back(codigo);
+    return true;
+}
+
+bool RepositorioMemoria::listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado || !listaCarteiras)
+    {
+        return false;
+    }
+
+    listaCarteiras->clear();
+    auto codigos = carteirasPorConta.find(cpf.getValor());
+    if (codigos != carteirasPorConta.end())
+    {
+        for (const std::string &codigo : codigos->second)
+        {
+            listaCarteiras->push_back(carteiras.at(codigo).carteira);
+        }
+    }
+    return true;
+}
+
+bool RepositorioMemoria::buscarCarteira(const Codigo &codigo, Carteira *carteira)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado || !carteira)
+    {
+        return false;
+    }
+
+    auto it = carteiras.find(codigo.getValor());
+    if (it == carteiras.end())
+    {
+        return false;
+    }
+
+    *carteira = it->second.carteira;
+    return true;
+}
+
+bool RepositorioMemoria::atualizarCarteira(const Carteira &carteira)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto it = carteiras.find(carteira.getCodigo().getValor());
+    if (it == carteiras.end())
+    {
+        return false;
+    }
+
+    it->second.carteira.setNome(carteira.getNome());
+    it->second.carteira.setTipoPerfil(carteira.getTipoPerfil());
+    return true;
+}
+
+bool RepositorioMemoria::excluirCarteira(const Codigo &codigo)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto ordensDaCarteira = ordensPorCarteira.find(codigo.getValor());
+    if (ordensDaCarteira != ordensPorCarteira.end() && !ordensDaCarteira->second.empty())
+    {
+        return false;
+    }
+
+    auto it = carteiras.find(codigo.getValor());
+    if (it == carteiras.end())
+    {
+        return false;
+    }
+
+    removerCodigo(carteirasPorConta[it->second.cpfConta], codigo.getValor());
+    ordensPorCarteira.erase(codigo.getValor());
+    carteiras.erase(it);
+    return true;
+}
+
+bool RepositorioMemoria::inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira)
+{
+    long long valorCentavos = DatabaseManager::dinheiroParaCentavos(ordem.getDinheiro());
+
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    std::string codigo = ordem.getCodigo().getValor();
+    if (!ordens.emplace(codigo, RegistroOrdem{ordem, codigoCarteira.getValor(), valorCentavos}).second)
+    {
+        return false;
+    }
+
+    ordensPorCarteira[codigoCarteira.getValor()].push_back(codigo);
+    return true;
+}
+
+bool RepositorioMemoria::listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado || !listaOrdens)
+    {
+        return false;
+    }
+
+    listaOrdens->clear();
+    auto codigos = ordensPorCarteira.find(codigoCarteira.getValor());
+    if (codigos != ordensPorCarteira.end())
+    {
+        for (const std::string &codigo : codigos->second)
+        {
+            listaOrdens->push_back(ordens.at(codigo).ordem);
+        }
+    }
+    return true;
+}
+
+bool RepositorioMemoria::buscarOrdem(const Codigo &codigo, Ordem *ordem)
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado || !ordem)
+    {
+        return false;
+    }
+
+    auto it = ordens.find(codigo.getValor());
+    if (it == ordens.end())
+    {
+        return false;
+    }
+
+    *ordem = it->second.ordem;
+    return true;
+}
+
+bool RepositorioMemoria::excluirOrdem(const Codigo &codigo)
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    auto it = ordens.find(codigo.getValor());
+    if (it == ordens.end())
+    {
+        return false;
+    }
+
+    removerCodigo(ordensPorCarteira[it->second.codigoCarteira], codigo.getValor());
+    ordens.erase(it);
+    return true;
+}
+
+/**
+ * @brief Soma os valores das ordens da carteira
+ * @details Mesma regra do DatabaseManager: carteira sem ordens tem saldo "0,01",
+ *          o menor valor aceito pelo domínio Dinheiro.
+ */
+bool RepositorioMemoria::calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo)
+{
+    long long saldoTotalCentavos = 0;
+    bool vazia = true;
+    {
+        std::shared_lock<std::shared_mutex> trava(mutex);
+        if (!conectado || !saldo)
+        {
+            return false;
+        }
+
+        auto codigos = ordensPorCarteira.find(codigoCarteira.getValor());
+        if (codigos != ordensPorCarteira.end())
+        {
+            for (const std::string &codigo : codigos->second)
+            {
+                saldoTotalCentavos += ordens.at(codigo).valorCentavos;
+                vazia = false;
+            }
+        }
+    }
+
+    try
+    {
+        saldo->setValor(vazia ? "0,01" : DatabaseManager::centavosParaDinheiro(saldoTotalCentavos));
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        return false;
+    }
+}
+
+bool RepositorioMemoria::limparTodasTabelas()
+{
+    std::unique_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return false;
+    }
+
+    ordens.clear();
+    carteiras.clear();
+    contas.clear();
+    carteirasPorConta.clear();
+    ordensPorCarteira.clear();
+    return true;
+}
+
+std::string RepositorioMemoria::obterEstatisticas()
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return "Não conectado ao banco";
+    }
+
+    std::ostringstream stats;
+    stats << "=== ESTATÍSTICAS DO BANCO ===" << std::endl;
+    stats << "Repositório em memória" << std::endl;
+    stats << "Registros: " << contas.size() << " contas, " << carteiras.size() << " carteiras, " << ordens.size()
+          << " ordens" << std::endl;
+    return stats.str();
+}
+
+std::string RepositorioMemoria::obterEstatisticasJson()
+{
+    std::shared_lock<std::shared_mutex> trava(mutex);
+    if (!conectado)
+    {
+        return "{\"conectado\":false}";
+    }
+
+    std::ostringstream json;
+    json << "{\"conectado\":true,\"arquivo\":\":memoria:\",\"registros\":{\"contas\":" << contas.size()
+         << ",\"carteiras\":" << carteiras.size() << ",\"ordens\":" << ordens.size() << "}}";
+    return json.str();
+}
@@ -0,0 +1,81 @@
+#ifndef REPOSITORIOMEMORIA_HPP_INCLUDED
+#define REPOSITORIOMEMORIA_HPP_INCLUDED
+
+#include "IRepositorio.hpp"
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class RepositorioMemoria
+ * @brief Implementação de IRepositorio inteiramente em memória
+ * @details Contas, carteiras e ordens ficam em tabelas hash indexadas pela chave
+ * primária, e cada conta/carteira mantém um vetor com os códigos de suas
+ * carteiras/ordens na ordem de inserção, como as consultas do SQLite devolvem.
+ * O valor de cada ordem é guardado também em centavos, para o saldo não
+ * precisar reinterpretar o texto monetário.
+ *
+ * Uma única instância pode ser compartilhada entre threads (ex.: trabalhadores
+ * do modo servidor ou do gerador de carga): leituras usam trava compartilhada
+ * e escritas, trava exclusiva. Os dados não sobrevivem ao processo.
+ */
+class RepositorioMemoria : public IRepositorio
+{
+  private:
+    struct RegistroCarteira
+    {
+        Carteira carteira;
+        std::string cpfConta;
+    };
+
+    struct RegistroOrdem
+    {
+        Ordem ordem;
+        std::string codigoCarteira;
+        long long valorCentavos;
+    };
+
+    mutable std::shared_mutex mutex;
+    bool conectado;
+
+    std::unordered_map<std::string, Conta> contas;
+    std::unordered_map<std::string, RegistroCarteira> carteiras;
+    std::unordered_map<std::string, RegistroOrdem> ordens;
+    std::unordered_map<std::string, std::vector<std::string>> carteirasPorConta;
+    std::unordered_map<std::string, std::vector<std::string>> ordensPorCarteira;
+
+    static void removerCodigo(std::vector<std::string> &codigos, const std::string &codigo);
+
+  public:
+    RepositorioMemoria();
+
+    bool conectar() override;
+    void desconectar() override;
+    bool inicializarBanco() override;
+    bool estaConectado() const override;
+
+    bool inserirConta(const Conta &conta) override;
+    bool buscarConta(const Ncpf &cpf, Conta *conta) override;
+    bool atualizarConta(const Conta &conta) override;
+    bool excluirConta(const Ncpf &cpf) override;
+    bool autenticarUsuario(const Ncpf &cpf, const Senha &senha) override;
+
+    bool inserirCarteira(const Carteira &carteira, const Ncpf &cpfProprietario) override;
+    bool listarCarteiras(const Ncpf &cpf, std::list<Carteira> *listaCarteiras) override;
+    bool buscarCarteira(const Codigo &codigo, Carteira *carteira) override;
+    bool atualizarCarteira(const Carteira &carteira) override;
+    bool excluirCarteira(const Codigo &codigo) override;
+
+    bool inserirOrdem(const Ordem &ordem, const Codigo &codigoCarteira) override;
+    bool listarOrdens(const Codigo &codigoCarteira, std::list<Ordem> *listaOrdens) override;
+    bool buscarOrdem(const Codigo &codigo, Ordem *ordem) override;
+    bool excluirOrdem(const Codigo &codigo) override;
+    bool calcularSaldoCarteira(const Codigo &codigoCarteira, Dinheiro *saldo) override;
+
+    bool limparTodasTabelas() override;
+    std::string obterEstatisticas() override;
+    std::string obterEstatisticasJson() override;
+};
+
+#endif // REPOSITORIOMEMORIA_HPP_INCLUDED
@@ -377,6 +377,14 @@ void Quantidade::setValor(const string &valor)
     this->valor = valor;
 }
 //---------------------------------------------------------------------
+// Metodo que retorna a quantidade como numero, removendo os pontos do formato brasileiro.
+long long Quantidade::getUnidades() const
+{
+    string numeroValor = valor;
+    numeroValor.erase(remove(numeroValor.begin(), numeroValor.end(), '.'), numeroValor.end());
+    return numeroValor.empty() ? 0 : stoll(numeroValor);
+}
+//---------------------------------------------------------------------
 
 //  Dominio Senha
 //---------------------------------------------------------------------
@@ -628,6 +628,7 @@ inline string Dinheiro::getValor() const
  * Metodos disponiveis:
  * - `setValor`: Metodo publico que define a quantidade apos validacao.
  * - `getValor`: Metodo publico que retorna a quantidade armazenada como string.
+ * - `getUnidades`: Metodo publico que retorna a quantidade como numero, sem separadores.
  *
  * Em caso de valor invalido, lanca `std::invalid_argument`.
  */
@@ -681,6 +682,13 @@ class Quantidade
      * @return std::string Valor atual da quantidade como numero inteiro simples.
      */
     string getValor() const;
+
+    /**
+     * @brief Metodo publico que retorna a quantidade como numero, sem os separadores de milhar.
+     *
+     * @return long long Quantidade de unidades (ex: 1000 para "1.000").
+     */
+    long long getUnidades() const;
 };
 //---------------------------------------------------------------------
 /**
@@ -1,18 +1,396 @@
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <sys/stat.h>
 
+#include "CatalogoCotacoes.hpp"
+#include "ExportadorCotacoes.hpp"
+#include "IndiceCotacoes.hpp"
+#include "LeitorArquivo.hpp"
+#include "ProcessadorLote.hpp"
+#include "RegistroMetricas.hpp"
+#include "RepositorioFragmentado.hpp"
+#include "RepositorioMemoria.hpp"
+#include "ServidorServicos.hpp"
 #include "controladorasApresentacao.hpp"
 #include "controladorasServico.hpp"
 #include "interfaces.hpp"
 
-int main()
+/**
+ * @brief Executa o modo lote sobre a camada de serviço
+ * @param cntrServico Controladora de serviço já inicializada
+ * @param caminhoComandos Arquivo de comandos, ou "-" para a entrada padrão
+ * @return Código de saída do processo (0 se todos os comandos tiveram sucesso)
+ */
+static int executarLote(ControladoraServico &cntrServico, const std::string &caminhoComandos)
 {
-    ControladoraApresentacaoAutenticacao cntrApresentacaoAutenticacao;
-    ControladoraApresentacaoUsuario cntrApresentacaoUsuario;
-    ControladoraApresentacaoInvestimento cntrApresentacaoInvestimento;
-    ControladoraServico cntrServico;
+    ProcessadorLote processador(&cntrServico, &cntrServico, &cntrServico);
+
+    if (caminhoComandos == "-")
+    {
+        return processador.executar(std::cin, std::cout) == 0 ? 0 : 2;
+    }
+
+    std::ifstream arquivoComandos(caminhoComandos);
+    if (!arquivoComandos.is_open())
+    {
+        std::cerr << "Erro: Não foi possível abrir o arquivo de comandos " << caminhoComandos << std::endl;
+        return 1;
+    }
+
+    return processador.executar(arquivoComandos, std::cout) == 0 ? 0 : 2;
+}
+
+/**
+ * @brief Executa o modo servidor, compartilhando um índice de cotações entre os trabalhadores
+ * @param caminhoBanco Caminho do banco SQLite
+ * @param caminhoDados Caminho do arquivo ou diretório de dados históricos
+ * @param diretorioCheckpoints Diretório dos checkpoints de leitura incremental (vazio desativa)
+ * @param modoArquivo Consultar o arquivo pelo índice de deslocamentos em vez de carregá-lo
+ * @param modoCompartilhado Consultar o segmento de memória compartilhada em vez de carregar o arquivo
+ * @param endereco "unix:/caminho" ou "tcp:PORTA"
+ * @param trabalhadores Quantidade de threads trabalhadoras
+ * @param fabricaRepositorio Cria (ou compartilha) o repositório de cada trabalhador
+ * @return Código de saída do processo
+ */
+static int executarServidor(const std::string &caminhoBanco, const std::string &caminhoDados,
+                            const std::string &diretorioCheckpoints, bool modoArquivo, bool modoCompartilhado,
+                            const std::string &endereco, int trabalhadores,
+                            std::function<std::shared_ptr<IRepositorio>()> fabricaRepositorio)
+{
+    // Um diretório com vários anos fica no catálogo, carregado sob demanda;
+    // um arquivo único é indexado inteiro antes de aceitar conexões
+    std::shared_ptr<IndiceCotacoes> indice;
+    struct stat informacoes;
+    if (stat(caminhoDados.c_str(), &informacoes) == 0 && S_ISDIR(informacoes.st_mode))
+    {
+        std::cerr << "Catálogo de cotações: " << CatalogoCotacoes::instancia().listarArquivos().size()
+                  << " arquivos em " << caminhoDados << ", carregados por ano sob demanda." << std::endl;
+    }
+    else if (modoArquivo)
+    {
+        std::cerr << "Cotações lidas diretamente de " << caminhoDados << " pelo índice de deslocamentos."
+                  << std::endl;
+    }
+    else if (modoCompartilhado)
+    {
+        std::cerr << "Cotações consultadas no segmento de memória compartilhada de " << caminhoDados << "."
+                  << std::endl;
+    }
+    else
+    {
+        indice = std::make_shared<IndiceCotacoes>();
+        indice->setDiretorioCheckpoints(diretorioCheckpoints);
+        if (!indice->carregar(caminhoDados))
+        {
+            std::cerr << "Erro: Não foi possível carregar o arquivo " << caminhoDados << std::endl;
+            return 1;
+        }
+        std::cerr << "Índice de cotações carregado: " << indice->quantidadeRegistros() << " registros, "
+                  << indice->quantidadePapeis() << " papéis." << std::endl;
+    }
+
+    ServidorServicos servidor(caminhoBanco, indice, trabalhadores);
+    servidor.setFabricaRepositorio(std::move(fabricaRepositorio));
+    if (!servidor.iniciar(endereco))
+    {
+        std::cerr << "Erro: Não foi possível iniciar o servidor em " << endereco << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Servidor atendendo em " << endereco << " com " << trabalhadores << " trabalhadores." << std::endl;
+    return servidor.executar();
+}
+
+/**
+ * @brief Exporta uma fatia das cotações do catálogo e encerra
+ * @param catalogo Catálogo já aberto
+ * @param caminhoSaida Arquivo de saída, ou "-" para a saída padrão
+ * @param nomeFormato "csv", "arrow" ou vazio para deduzir da extensão (.arrow/.arrows é Arrow, o resto CSV)
+ * @param filtro Papéis, período e campos
+ * @return Código de saída do processo
+ */
+static int executarExportacao(CatalogoCotacoes &catalogo, const std::string &caminhoSaida,
+                              const std::string &nomeFormato, const FiltroExportacao &filtro)
+{
+    FormatoExportacao formato = EXPORTACAO_CSV;
+    if (nomeFormato.empty())
+    {
+        size_t ponto = caminhoSaida.rfind('.');
+        std::string extensao = ponto == std::string::npos ? "" : caminhoSaida.substr(ponto);
+        formato = (extensao == ".arrow" || extensao == ".arrows") ? EXPORTACAO_ARROW : EXPORTACAO_CSV;
+    }
+    else if (!ExportadorCotacoes::interpretarFormato(nomeFormato, &formato))
+    {
+        std::cerr << "Erro: formato de exportação desconhecido: " << nomeFormato << std::endl;
+        return 1;
+    }
+
+    std::ofstream arquivoSaida;
+    if (caminhoSaida != "-")
+    {
+        arquivoSaida.open(caminhoSaida, std::ios::binary | std::ios::trunc);
+        if (!arquivoSaida.is_open())
+        {
+            std::cerr << "Erro: Não foi possível criar o arquivo de exportação " << caminhoSaida << std::endl;
+            return 1;
+        }
+    }
+
+    ExportadorCotacoes exportador(caminhoSaida == "-" ? std::cout : arquivoSaida, formato);
+    if (!exportador.iniciar(filtro))
+    {
+        return 1;
+    }
+    catalogo.percorrerParticoes(filtro.dataInicial, filtro.dataFinal,
+                                [&exportador](const IndiceCotacoes &indice) { exportador.escrever(indice); });
+    if (!exportador.finalizar())
+    {
+        std::cerr << "Erro: Falha ao escrever a exportação em " << caminhoSaida << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Exportados " << exportador.getRegistrosExportados() << " registros." << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string caminhoBanco = "../database/sistema_investimentos.db";
+    std::string caminhoDados = "../data/DADOS_HISTORICOS.txt";
+    std::string caminhoLote;
+    std::string enderecoServidor;
+    std::string caminhoMetricas;
+    std::string formatoEstatisticas;
+    std::string tipoRepositorio = "sqlite";
+    int intervaloMetricas = 10;
+    int trabalhadores = 4;
+    int quantidadeFragmentos = 1;
+    long orcamentoCotacoesMb = 0;
+    long capacidadeCachePrecos = -1;
+    std::string diretorioCheckpoints;
+    bool modoLote = false;
+    bool modoArquivo = false;
+    bool modoCompartilhado = false;
+    BackendLeitura backendLeitura = LEITURA_READ;
+    std::string caminhoExportacao;
+    std::string formatoExportacao;
+    FiltroExportacao filtroExportacao;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--batch") == 0)
+        {
+            // Sem operando, ou seguido de outra opção, lê da entrada padrão; um arquivo "--x" entra como "./--x"
+            modoLote = true;
+            caminhoLote = (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) ? argv[++i] : "-";
+        }
+        else if (std::strcmp(argv[i], "--banco") == 0 && i + 1 < argc)
+        {
+            caminhoBanco = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--repositorio") == 0 && i + 1 < argc &&
+                 (std::strcmp(argv[i + 1], "sqlite") == 0 || std::strcmp(argv[i + 1], "memoria") == 0))
+        {
+            tipoRepositorio = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--fragmentos") == 0 && i + 1 < argc)
+        {
+            quantidadeFragmentos = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--dados") == 0 && i + 1 < argc)
+        {
+            caminhoDados = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--orcamento-cotacoes") == 0 && i + 1 < argc)
+        {
+            orcamentoCotacoesMb = std::atol(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--checkpoints") == 0 && i + 1 < argc)
+        {
+            diretorioCheckpoints = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--indice-arquivo") == 0)
+        {
+            modoArquivo = true;
+        }
+        else if (std::strcmp(argv[i], "--cache-cotacoes") == 0 && i + 1 < argc)
+        {
+            capacidadeCachePrecos = std::atol(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--memoria-compartilhada") == 0)
+        {
+            modoCompartilhado = true;
+        }
+        else if (std::strcmp(argv[i], "--leitura") == 0 && i + 1 < argc &&
+                 LeitorArquivo::interpretarBackend(argv[i + 1], &backendLeitura))
+        {
+            i++;
+        }
+        else if (std::strcmp(argv[i], "--exportar") == 0 && i + 1 < argc)
+        {
+            caminhoExportacao = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--formato-exportacao") == 0 && i + 1 < argc)
+        {
+            formatoExportacao = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--papeis") == 0 && i + 1 < argc)
+        {
+            filtroExportacao.papeis = ExportadorCotacoes::separarLista(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--campos") == 0 && i + 1 < argc)
+        {
+            filtroExportacao.campos = ExportadorCotacoes::separarLista(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--periodo") == 0 && i + 1 < argc && std::strchr(argv[i + 1], ':'))
+        {
+            // AAAAMMDD:AAAAMMDD; um lado vazio deixa a janela aberta
+            std::string periodo = argv[++i];
+            size_t separador = periodo.find(':');
+            if (separador > 0)
+            {
+                filtroExportacao.dataInicial = static_cast<uint32_t>(std::atol(periodo.substr(0, separador).c_str()));
+            }
+            if (separador + 1 < periodo.size())
+            {
+                filtroExportacao.dataFinal = static_cast<uint32_t>(std::atol(periodo.substr(separador + 1).c_str()));
+            }
+        }
+        else if (std::strcmp(argv[i], "--servidor") == 0 && i + 1 < argc)
+        {
+            enderecoServidor = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--trabalhadores") == 0 && i + 1 < argc)
+        {
+            trabalhadores = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--estatisticas") == 0)
+        {
+            bool temFormato =
+                i + 1 < argc && (std::strcmp(argv[i + 1], "json") == 0 || std::strcmp(argv[i + 1], "texto") == 0);
+            formatoEstatisticas = temFormato ? argv[++i] : "texto";
+        }
+        else if (std::strcmp(argv[i], "--metricas") == 0 && i + 1 < argc)
+        {
+            caminhoMetricas = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--intervalo-metricas") == 0 && i + 1 < argc)
+        {
+            intervaloMetricas = std::atoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Uso: " << argv[0] << " [--banco ARQUIVO.db] [--repositorio sqlite|memoria]" << std::endl;
+            std::cerr << "       [--dados ARQUIVO.txt|DIRETORIO] [--orcamento-cotacoes MB] [--checkpoints DIRETORIO]"
+                      << std::endl;
+            std::cerr << "       [--indice-arquivo] [--cache-cotacoes ENTRADAS] [--memoria-compartilhada]" << std::endl;
+            std::cerr << "       [--leitura read|mmap|io_uring]" << std::endl;
+            std::cerr << "       [--fragmentos N] [--batch ARQUIVO|-]" << std::endl;
+            std::cerr << "       [--exportar ARQUIVO|- [--formato-exportacao csv|arrow] [--papeis A,B]" << std::endl;
+            std::cerr << "        [--periodo AAAAMMDD:AAAAMMDD] [--campos a,b]]" << std::endl;
+            std::cerr << "       [--servidor unix:/CAMINHO|tcp:PORTA] [--trabalhadores N]" << std::endl;
+            std::cerr << "       [--metricas ARQUIVO.prom] [--intervalo-metricas SEGUNDOS]" << std::endl;
+            std::cerr << "       [--estatisticas [texto|json]]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Com --metricas, o arquivo é regravado periodicamente e uma última vez na saída
+    if (!caminhoMetricas.empty())
+    {
+        RegistroMetricas::instancia().iniciarExportacaoPeriodica(caminhoMetricas, intervaloMetricas);
+    }
+
+    // Definido antes de qualquer carga de cotações
+    LeitorArquivo::setBackendPadrao(backendLeitura);
+    CatalogoCotacoes &catalogo = CatalogoCotacoes::instancia();
+    catalogo.setDiretorioCheckpoints(diretorioCheckpoints);
+    if (caminhoDados != CatalogoCotacoes::CAMINHO_PADRAO && !catalogo.abrir(caminhoDados))
+    {
+        std::cerr << "Aviso: Nenhum arquivo de dados históricos encontrado em " << caminhoDados << std::endl;
+    }
+    if (orcamentoCotacoesMb > 0)
+    {
+        catalogo.setOrcamentoMemoria(static_cast<size_t>(orcamentoCotacoesMb) * 1024 * 1024);
+    }
+
+    // Com --exportar, o processo só escreve a fatia pedida e termina, sem banco nem observação
+    if (!caminhoExportacao.empty())
+    {
+        return executarExportacao(catalogo, caminhoExportacao, formatoExportacao, filtroExportacao);
+    }
+
+    // Em um diretório, arquivos novos ou regravados entram sem reiniciar o processo; um arquivo único não é observado
+    catalogo.iniciarObservacao();
+
+    // Com --indice-arquivo, o arquivo texto continua sendo a fonte e só o auxiliar .idx é mapeado
+    if (capacidadeCachePrecos >= 0)
+    {
+        catalogo.setCapacidadeCachePrecos(static_cast<size_t>(capacidadeCachePrecos));
+    }
+    if (modoArquivo)
+    {
+        struct stat informacoes;
+        auto deslocamentos = std::make_shared<IndiceDeslocamentos>();
+        if (stat(caminhoDados.c_str(), &informacoes) != 0 || S_ISDIR(informacoes.st_mode) ||
+            !deslocamentos->abrir(caminhoDados))
+        {
+            std::cerr << "Erro: --indice-arquivo exige um arquivo de dados em texto: " << caminhoDados << std::endl;
+            return 1;
+        }
+        catalogo.setIndiceDeslocamentos(deslocamentos);
+    }
+
+    // Com --memoria-compartilhada, o primeiro processo monta o segmento e os seguintes só o anexam
+    if (modoCompartilhado)
+    {
+        struct stat informacoes;
+        auto compartilhadas = std::make_shared<CotacoesCompartilhadas>();
+        bool montado = false;
+        if (stat(caminhoDados.c_str(), &informacoes) != 0 || S_ISDIR(informacoes.st_mode) ||
+            !compartilhadas->anexar(caminhoDados, &montado))
+        {
+            std::cerr << "Erro: --memoria-compartilhada exige um arquivo de dados: " << caminhoDados << std::endl;
+            return 1;
+        }
+        std::cerr << "Cotações " << (montado ? "montadas" : "anexadas") << " em " << compartilhadas->getNome()
+                  << ": " << compartilhadas->quantidadeRegistros() << " registros, "
+                  << compartilhadas->getTamanho() / 1024 << " KB." << std::endl;
+        catalogo.setCotacoesCompartilhadas(compartilhadas);
+    }
+
+    // O repositório em memória é único no processo; o SQLite abre uma conexão por controladora,
+    // e com --fragmentos N cada controladora abre os N arquivos, compartilhando o diretório de códigos
+    std::function<std::shared_ptr<IRepositorio>()> fabricaRepositorio;
+    if (tipoRepositorio == "memoria")
+    {
+        auto repositorioMemoria = std::make_shared<RepositorioMemoria>();
+        fabricaRepositorio = [repositorioMemoria]() { return repositorioMemoria; };
+    }
+    else if (quantidadeFragmentos > 1)
+    {
+        auto diretorio = std::make_shared<DiretorioFragmentos>();
+        fabricaRepositorio = [caminhoBanco, quantidadeFragmentos, diretorio]() {
+            return std::make_shared<RepositorioFragmentado>(caminhoBanco, quantidadeFragmentos, diretorio);
+        };
+    }
+    else
+    {
+        fabricaRepositorio = [caminhoBanco]() { return std::make_shared<DatabaseManager>(caminhoBanco); };
+    }
+
+    if (!enderecoServidor.empty())
+    {
+        return executarServidor(caminhoBanco, caminhoDados, diretorioCheckpoints, modoArquivo, modoCompartilhado,
+                                enderecoServidor, trabalhadores, fabricaRepositorio);
+    }
+
+    ControladoraServico cntrServico(fabricaRepositorio());
 
     if (!cntrServico.inicializar())
     {
@@ -22,6 +400,21 @@ int main()
         return 1;
     }
 
+    if (!formatoEstatisticas.empty())
+    {
+        std::cout << cntrServico.obterEstatisticasBanco(formatoEstatisticas == "json") << std::endl;
+        return 0;
+    }
+
+    if (modoLote)
+    {
+        return executarLote(cntrServico, caminhoLote);
+    }
+
+    ControladoraApresentacaoAutenticacao cntrApresentacaoAutenticacao;
+    ControladoraApresentacaoUsuario cntrApresentacaoUsuario;
+    ControladoraApresentacaoInvestimento cntrApresentacaoInvestimento;
+
     cntrApresentacaoAutenticacao.setControladoraServico(&cntrServico);
     cntrApresentacaoUsuario.setControladoraServico(&cntrServico);
     cntrApresentacaoInvestimento.setControladoraServico(&cntrServico);
@@ -33,4 +426,4 @@ int main()
 
     std::cout << "Sistema encerrado. Banco de dados desconectado." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,90 @@
+#include "HistogramaLatencia.hpp"
+#include <cmath>
+
+HistogramaLatencia::HistogramaLatencia() : contagem(0), somaNs(0), maximoNs(0)
+{
+    for (auto &balde : baldes)
+    {
+        balde.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Índice log-linear de um valor
+ * @details Valores abaixo de 16 ocupam um balde cada. Acima disso, o expoente
+ *          (posição do bit mais significativo) escolhe o bloco e os 4 bits
+ *          seguintes escolhem a sub-faixa dentro do bloco.
+ */
+size_t HistogramaLatencia::indiceBalde(uint64_t ns)
+{
+    if (ns < static_cast<uint64_t>(SUBFAIXAS))
+    {
+        return static_cast<size_t>(ns);
+    }
+
+    int expoente = 63 - __builtin_clzll(ns);
+    if (expoente > EXPOENTE_MAXIMO)
+    {
+        return QUANTIDADE_BALDES - 1;
+    }
+
+    size_t subfaixa = static_cast<size_t>((ns >> (expoente - BITS_SUBFAIXA)) & (SUBFAIXAS - 1));
+    return static_cast<size_t>(expoente - BITS_SUBFAIXA + 1) * SUBFAIXAS + subfaixa;
+}
+
+uint64_t HistogramaLatencia::limiteSuperior(size_t indice)
+{
+    if (indice < static_cast<size_t>(SUBFAIXAS))
+    {
+        return indice;
+    }
+
+    int deslocamento = static_cast<int>(indice / SUBFAIXAS) - 1;
+    uint64_t subfaixa = indice % SUBFAIXAS;
+    uint64_t inicio = (static_cast<uint64_t>(SUBFAIXAS) + subfaixa) << deslocamento;
+    return inicio + (1ULL << deslocamento) - 1;
+}
+
+void HistogramaLatencia::registrar(uint64_t ns)
+{
+    baldes[indiceBalde(ns)].fetch_add(1, std::memory_order_relaxed);
+    contagem.fetch_add(1, std::memory_order_relaxed);
+    somaNs.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t atual = maximoNs.load(std::memory_order_relaxed);
+    while (ns > atual && !maximoNs.compare_exchange_weak(atual, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint64_t HistogramaLatencia::percentil(double fracao) const
+{
+    uint64_t total = 0;
+    for (const auto &balde : baldes)
+    {
+        total += balde.load(std::memory_order_relaxed);
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t alvo = static_cast<uint64_t>(std::ceil(fracao * static_cast<double>(total)));
+    if (alvo == 0)
+    {
+        alvo = 1;
+    }
+
+    uint64_t acumulado = 0;
+    for (size_t i = 0; i < QUANTIDADE_BALDES; i++)
+    {
+        acumulado += baldes[i].load(std::memory_order_relaxed);
+        if (acumulado >= alvo)
+        {
+            uint64_t maximo = getMaximoNs();
+            uint64_t limite = limiteSuperior(i);
+            return limite < maximo ? limite : maximo;
+        }
+    }
+    return getMaximoNs();
+}
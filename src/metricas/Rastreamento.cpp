@@ -0,0 +1,153 @@
+#include "Rastreamento.hpp"
+#include "jsonUtils.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+struct Evento
+{
+    const char *nome;
+    const char *categoria;
+    uint64_t inicioNs;
+    uint64_t duracaoNs;
+};
+
+/**
+ * @brief Buffer circular de uma thread
+ * @details A trava só é disputada durante a gravação do arquivo; no caminho de
+ *          registro ela é sempre adquirida pela própria thread dona do buffer.
+ */
+struct BufferThread
+{
+    std::mutex mutex;
+    std::vector<Evento> eventos;
+    uint64_t registrados = 0;
+    uint32_t idThread = 0;
+};
+
+std::mutex mutexBuffers;
+std::vector<std::shared_ptr<BufferThread>> buffers;
+std::string caminhoSaida;
+const std::chrono::steady_clock::time_point origem = std::chrono::steady_clock::now();
+
+thread_local std::shared_ptr<BufferThread> bufferLocal;
+
+BufferThread &obterBufferLocal()
+{
+    if (!bufferLocal)
+    {
+        bufferLocal = std::make_shared<BufferThread>();
+        bufferLocal->eventos.resize(Rastreamento::CAPACIDADE_BUFFER);
+
+        std::lock_guard<std::mutex> trava(mutexBuffers);
+        bufferLocal->idThread = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.push_back(bufferLocal);
+    }
+    return *bufferLocal;
+}
+
+/**
+ * @brief Liga o rastreamento a partir do ambiente e grava o arquivo na saída
+ */
+struct InicializadorRastreamento
+{
+    InicializadorRastreamento()
+    {
+        const char *caminho = std::getenv("INVESTIMENTOS_TRACE");
+        if (caminho && *caminho)
+        {
+            Rastreamento::habilitar(caminho);
+        }
+    }
+
+    ~InicializadorRastreamento()
+    {
+        if (Rastreamento::ativo() && !caminhoSaida.empty())
+        {
+            Rastreamento::gravar(caminhoSaida);
+        }
+    }
+};
+
+InicializadorRastreamento inicializador;
+} // namespace
+
+std::atomic<bool> Rastreamento::habilitado(false);
+
+void Rastreamento::habilitar(const std::string &caminho)
+{
+    {
+        std::lock_guard<std::mutex> trava(mutexBuffers);
+        caminhoSaida = caminho;
+    }
+    habilitado.store(true, std::memory_order_relaxed);
+}
+
+uint64_t Rastreamento::agoraNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origem).count());
+}
+
+void Rastreamento::registrar(const char *nome, const char *categoria, uint64_t inicioNs, uint64_t duracaoNs)
+{
+    BufferThread &buffer = obterBufferLocal();
+    std::lock_guard<std::mutex> trava(buffer.mutex);
+    buffer.eventos[buffer.registrados % CAPACIDADE_BUFFER] = {nome, categoria, inicioNs, duracaoNs};
+    buffer.registrados++;
+}
+
+/**
+ * @brief Grava os buffers no formato JSON de trace do Chrome
+ * @details Usa eventos completos ("ph":"X"), com tempos em microssegundos.
+ *          Cada buffer ganha um evento de metadados com o nome da thread.
+ */
+bool Rastreamento::gravar(const std::string &caminho)
+{
+    std::ofstream arquivo(caminho, std::ios::trunc);
+    if (!arquivo.is_open())
+    {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<BufferThread>> copia;
+    {
+        std::lock_guard<std::mutex> trava(mutexBuffers);
+        copia = buffers;
+    }
+
+    long pid = static_cast<long>(getpid());
+    arquivo << std::fixed << std::setprecision(3);
+    arquivo << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool primeiro = true;
+
+    for (const auto &buffer : copia)
+    {
+        std::lock_guard<std::mutex> trava(buffer->mutex);
+
+        arquivo << (primeiro ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->idThread << ",\"args\":{\"name\":\"thread " << buffer->idThread << "\"}}";
+        primeiro = false;
+
+        uint64_t quantidade = buffer->registrados < CAPACIDADE_BUFFER ? buffer->registrados : CAPACIDADE_BUFFER;
+        uint64_t primeiroIndice = buffer->registrados - quantidade;
+        for (uint64_t i = primeiroIndice; i < buffer->registrados; i++)
+        {
+            const Evento &evento = buffer->eventos[i % CAPACIDADE_BUFFER];
+            arquivo << ",\n{\"name\":" << jsonUtils::texto(evento.nome)
+                    << ",\"cat\":" << jsonUtils::texto(evento.categoria) << ",\"ph\":\"X\",\"ts\":"
+                    << evento.inicioNs / 1000.0 << ",\"dur\":" << evento.duracaoNs / 1000.0 << ",\"pid\":" << pid
+                    << ",\"tid\":" << buffer->idThread << "}";
+        }
+    }
+
+    arquivo << "\n]}\n";
+    return arquivo.good();
+}
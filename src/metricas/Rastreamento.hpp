@@ -0,0 +1,107 @@
+#ifndef RASTREAMENTO_HPP_INCLUDED
+#define RASTREAMENTO_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Rastreamento de trechos (spans) no formato Chrome/Perfetto
+ *
+ * @details Habilitado pela variável de ambiente INVESTIMENTOS_TRACE, que indica
+ * o arquivo JSON gerado na saída do processo:
+ * @code
+ * INVESTIMENTOS_TRACE=trace.json ./T2_TP1_241004686 --batch comandos.txt
+ * @endcode
+ * O arquivo pode ser aberto em chrome://tracing ou ui.perfetto.dev.
+ *
+ * Cada thread grava seus eventos em um buffer circular próprio, de capacidade
+ * fixa; quando o buffer enche, os eventos mais antigos são sobrescritos. Com o
+ * rastreamento desligado, um SpanRastreamento custa uma leitura atômica relaxada.
+ * Os nomes e categorias devem ser literais (ou ter duração estática), pois
+ * apenas o ponteiro é guardado.
+ */
+class Rastreamento
+{
+  private:
+    static std::atomic<bool> habilitado;
+
+  public:
+    /**
+     * @brief Capacidade do buffer circular de cada thread, em eventos
+     */
+    static const size_t CAPACIDADE_BUFFER = 1 << 16;
+
+    /**
+     * @brief Indica se o rastreamento está ligado
+     */
+    static bool ativo()
+    {
+        return habilitado.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Liga o rastreamento, gravando o arquivo indicado na saída do processo
+     *
+     * @param caminhoSaida Arquivo JSON de destino
+     */
+    static void habilitar(const std::string &caminhoSaida);
+
+    /**
+     * @brief Instante atual em nanossegundos desde o início do rastreamento
+     */
+    static uint64_t agoraNs();
+
+    /**
+     * @brief Registra um evento completo no buffer da thread atual
+     *
+     * @param nome Nome do trecho (literal)
+     * @param categoria Camada do trecho (literal): apresentacao, servico, cotacoes, banco...
+     * @param inicioNs Início retornado por agoraNs()
+     * @param duracaoNs Duração em nanossegundos
+     */
+    static void registrar(const char *nome, const char *categoria, uint64_t inicioNs, uint64_t duracaoNs);
+
+    /**
+     * @brief Grava os eventos de todas as threads em JSON de trace do Chrome
+     *
+     * @param caminho Arquivo de destino
+     * @return bool true se o arquivo foi gravado
+     */
+    static bool gravar(const std::string &caminho);
+};
+
+/**
+ * @brief Trecho rastreado com duração igual ao escopo do objeto
+ */
+class SpanRastreamento
+{
+  private:
+    const char *nome;
+    const char *categoria;
+    uint64_t inicio;
+    bool ativo;
+
+  public:
+    SpanRastreamento(const char *nome, const char *categoria)
+        : nome(nome), categoria(categoria), inicio(0), ativo(Rastreamento::ativo())
+    {
+        if (ativo)
+        {
+            inicio = Rastreamento::agoraNs();
+        }
+    }
+
+    ~SpanRastreamento()
+    {
+        if (ativo)
+        {
+            Rastreamento::registrar(nome, categoria, inicio, Rastreamento::agoraNs() - inicio);
+        }
+    }
+
+    SpanRastreamento(const SpanRastreamento &) = delete;
+    SpanRastreamento &operator=(const SpanRastreamento &) = delete;
+};
+
+#endif // RASTREAMENTO_HPP_INCLUDED
@@ -0,0 +1,232 @@
+#include "RegistroMetricas.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+const std::vector<double> RegistroMetricas::LIMITES_EXPORTACAO = {
+    0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+    0.025,   0.05,     0.1,     0.25,   0.5,     1.0,    2.5,   5.0,    10.0};
+
+RegistroMetricas::RegistroMetricas() : exportando(false)
+{
+}
+
+RegistroMetricas::~RegistroMetricas()
+{
+    pararExportacaoPeriodica();
+}
+
+RegistroMetricas &RegistroMetricas::instancia()
+{
+    static RegistroMetricas registro;
+    return registro;
+}
+
+/**
+ * @brief Registra a família na primeira vez em que ela aparece
+ * @details Deve ser chamado com mutexRegistro travado.
+ */
+void RegistroMetricas::registrarFamilia(const std::string &nome, const std::string &ajuda, bool histograma)
+{
+    for (const Familia &familia : familias)
+    {
+        if (familia.nome == nome)
+        {
+            return;
+        }
+    }
+    familias.push_back({nome, ajuda, histograma});
+}
+
+HistogramaLatencia &RegistroMetricas::histograma(const std::string &familia, const std::string &rotulos,
+                                                 const std::string &ajuda)
+{
+    std::lock_guard<std::mutex> trava(mutexRegistro);
+    for (auto &serie : histogramas)
+    {
+        if (serie->familia == familia && serie->rotulos == rotulos)
+        {
+            return serie->histograma;
+        }
+    }
+
+    registrarFamilia(familia, ajuda, true);
+    histogramas.emplace_back(new SerieHistograma());
+    histogramas.back()->familia = familia;
+    histogramas.back()->rotulos = rotulos;
+    return histogramas.back()->histograma;
+}
+
+std::atomic<uint64_t> &RegistroMetricas::contador(const std::string &familia, const std::string &rotulos,
+                                                  const std::string &ajuda)
+{
+    std::lock_guard<std::mutex> trava(mutexRegistro);
+    for (auto &serie : contadores)
+    {
+        if (serie->familia == familia && serie->rotulos == rotulos)
+        {
+            return serie->valor;
+        }
+    }
+
+    registrarFamilia(familia, ajuda, false);
+    contadores.emplace_back(new SerieContador());
+    contadores.back()->familia = familia;
+    contadores.back()->rotulos = rotulos;
+    return contadores.back()->valor;
+}
+
+/**
+ * @brief Exporta no formato texto do Prometheus
+ * @details Os baldes log-lineares são agregados nos limites de LIMITES_EXPORTACAO.
+ *          Um balde fino entra no limite se todo o seu intervalo cabe nele, então
+ *          a contagem de cada limite tem a mesma resolução do histograma (6,25%).
+ *          _count é a soma do mesmo instantâneo, e portanto igual ao balde +Inf.
+ */
+void RegistroMetricas::exportarPrometheus(std::ostream &saida) const
+{
+    std::lock_guard<std::mutex> trava(mutexRegistro);
+
+    for (const Familia &familia : familias)
+    {
+        saida << "# HELP " << familia.nome << " " << familia.ajuda << "\n";
+        saida << "# TYPE " << familia.nome << (familia.histograma ? " histogram" : " counter") << "\n";
+
+        if (!familia.histograma)
+        {
+            for (const auto &serie : contadores)
+            {
+                if (serie->familia == familia.nome)
+                {
+                    saida << familia.nome << "{" << serie->rotulos << "} "
+                          << serie->valor.load(std::memory_order_relaxed) << "\n";
+                }
+            }
+            continue;
+        }
+
+        for (const auto &serie : histogramas)
+        {
+            if (serie->familia != familia.nome)
+            {
+                continue;
+            }
+
+            const HistogramaLatencia &histograma = serie->histograma;
+            std::string prefixoRotulos = serie->rotulos.empty() ? "" : serie->rotulos + ",";
+            uint64_t acumulado = 0;
+            size_t balde = 0;
+
+            for (double limite : LIMITES_EXPORTACAO)
+            {
+                uint64_t limiteNs = static_cast<uint64_t>(limite * 1e9);
+                while (balde < HistogramaLatencia::QUANTIDADE_BALDES &&
+                       HistogramaLatencia::limiteSuperior(balde) <= limiteNs)
+                {
+                    acumulado += histograma.getBalde(balde);
+                    balde++;
+                }
+                saida << familia.nome << "_bucket{" << prefixoRotulos << "le=\"" << limite << "\"} " << acumulado
+                      << "\n";
+            }
+            for (; balde < HistogramaLatencia::QUANTIDADE_BALDES; balde++)
+            {
+                acumulado += histograma.getBalde(balde);
+            }
+
+            saida << familia.nome << "_bucket{" << prefixoRotulos << "le=\"+Inf\"} " << acumulado << "\n";
+            saida << familia.nome << "_sum{" << serie->rotulos << "} " << std::setprecision(9)
+                  << static_cast<double>(histograma.getSomaNs()) / 1e9 << std::setprecision(6) << "\n";
+            saida << familia.nome << "_count{" << serie->rotulos << "} " << acumulado << "\n";
+        }
+    }
+}
+
+bool RegistroMetricas::gravarArquivo(const std::string &caminho) const
+{
+    std::string temporario = caminho + ".tmp";
+    {
+        std::ofstream arquivo(temporario, std::ios::trunc);
+        if (!arquivo.is_open())
+        {
+            return false;
+        }
+        exportarPrometheus(arquivo);
+        if (!arquivo.good())
+        {
+            return false;
+        }
+    }
+    return std::rename(temporario.c_str(), caminho.c_str()) == 0;
+}
+
+std::string RegistroMetricas::resumirLatencias(const std::string &familia) const
+{
+    std::lock_guard<std::mutex> trava(mutexRegistro);
+    std::ostringstream resumo;
+    resumo << std::fixed << std::setprecision(3);
+
+    for (const auto &serie : histogramas)
+    {
+        if (serie->familia != familia || serie->histograma.getContagem() == 0)
+        {
+            continue;
+        }
+
+        const HistogramaLatencia &histograma = serie->histograma;
+        resumo << "  " << std::left << std::setw(40) << serie->rotulos << std::right
+               << " n=" << histograma.getContagem() << " p50=" << histograma.percentil(0.50) / 1e6
+               << "ms p99=" << histograma.percentil(0.99) / 1e6 << "ms max=" << histograma.getMaximoNs() / 1e6
+               << "ms" << std::endl;
+    }
+
+    return resumo.str();
+}
+
+bool RegistroMetricas::iniciarExportacaoPeriodica(const std::string &caminho, int intervaloSegundos)
+{
+    std::lock_guard<std::mutex> trava(mutexExportacao);
+    if (exportando)
+    {
+        return false;
+    }
+
+    exportando = true;
+    threadExportacao = std::thread(&RegistroMetricas::executarExportacaoPeriodica, this, caminho,
+                                   std::max(1, intervaloSegundos));
+    return true;
+}
+
+void RegistroMetricas::pararExportacaoPeriodica()
+{
+    {
+        std::lock_guard<std::mutex> trava(mutexExportacao);
+        if (!exportando)
+        {
+            return;
+        }
+        exportando = false;
+    }
+    condicaoExportacao.notify_all();
+
+    if (threadExportacao.joinable())
+    {
+        threadExportacao.join();
+    }
+}
+
+void RegistroMetricas::executarExportacaoPeriodica(std::string caminho, int intervaloSegundos)
+{
+    std::unique_lock<std::mutex> trava(mutexExportacao);
+    while (exportando)
+    {
+        condicaoExportacao.wait_for(trava, std::chrono::seconds(intervaloSegundos));
+
+        trava.unlock();
+        gravarArquivo(caminho);
+        trava.lock();
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef REGISTROMETRICAS_HPP_INCLUDED
+#define REGISTROMETRICAS_HPP_INCLUDED
+
+#include "HistogramaLatencia.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Registro global de métricas do processo
+ *
+ * @details Mantém histogramas de latência e contadores identificados por nome
+ * de família e rótulos no formato Prometheus (ex.: operacao="criarOrdem").
+ * O registro de uma série usa trava, mas acontece uma vez por ponto de
+ * instrumentação; a referência devolvida é estável e as atualizações
+ * posteriores são apenas operações atômicas.
+ *
+ * A exportação segue o formato texto de exposição do Prometheus e pode ser
+ * feita sob demanda (exportarPrometheus) ou periodicamente para um arquivo.
+ */
+class RegistroMetricas
+{
+  private:
+    struct SerieHistograma
+    {
+        std::string familia;
+        std::string rotulos;
+        HistogramaLatencia histograma;
+    };
+
+    struct SerieContador
+    {
+        std::string familia;
+        std::string rotulos;
+        std::atomic<uint64_t> valor{0};
+    };
+
+    struct Familia
+    {
+        std::string nome;
+        std::string ajuda;
+        bool histograma;
+    };
+
+    mutable std::mutex mutexRegistro;
+    std::vector<Familia> familias;
+    std::vector<std::unique_ptr<SerieHistograma>> histogramas;
+    std::vector<std::unique_ptr<SerieContador>> contadores;
+
+    std::thread threadExportacao;
+    std::mutex mutexExportacao;
+    std::condition_variable condicaoExportacao;
+    bool exportando;
+
+    RegistroMetricas();
+    void registrarFamilia(const std::string &nome, const std::string &ajuda, bool histograma);
+    void executarExportacaoPeriodica(std::string caminho, int intervaloSegundos);
+
+  public:
+    /**
+     * @brief Limites dos baldes exportados, em segundos
+     */
+    static const std::vector<double> LIMITES_EXPORTACAO;
+
+    ~RegistroMetricas();
+
+    RegistroMetricas(const RegistroMetricas &) = delete;
+    RegistroMetricas &operator=(const RegistroMetricas &) = delete;
+
+    /**
+     * @brief Acessa o registro do processo
+     *
+     * @return RegistroMetricas& Instância única
+     */
+    static RegistroMetricas &instancia();
+
+    /**
+     * @brief Obtém (criando se preciso) um histograma de latência
+     *
+     * @param familia Nome da métrica, terminado em _segundos
+     * @param rotulos Rótulos da série, ex.: operacao="criarOrdem"
+     * @param ajuda Texto de ajuda da família
+     * @return HistogramaLatencia& Referência válida por toda a execução
+     */
+    HistogramaLatencia &histograma(const std::string &familia, const std::string &rotulos, const std::string &ajuda);
+
+    /**
+     * @brief Obtém (criando se preciso) um contador monotônico
+     *
+     * @param familia Nome da métrica, terminado em _total
+     * @param rotulos Rótulos da série
+     * @param ajuda Texto de ajuda da família
+     * @return std::atomic<uint64_t>& Contador válido por toda a execução
+     */
+    std::atomic<uint64_t> &contador(const std::string &familia, const std::string &rotulos, const std::string &ajuda);
+
+    /**
+     * @brief Escreve todas as métricas no formato de exposição do Prometheus
+     *
+     * @param saida Fluxo de destino
+     */
+    void exportarPrometheus(std::ostream &saida) const;
+
+    /**
+     * @brief Grava as métricas em um arquivo, substituindo-o atomicamente
+     *
+     * @param caminho Arquivo de destino
+     * @return bool true se o arquivo foi gravado
+     */
+    bool gravarArquivo(const std::string &caminho) const;
+
+    /**
+     * @brief Resume em texto os histogramas de uma família
+     *
+     * @param familia Nome da família
+     * @return std::string Uma linha por série com contagem, p50, p99 e máximo
+     */
+    std::string resumirLatencias(const std::string &familia) const;
+
+    /**
+     * @brief Inicia a gravação periódica das métricas em arquivo
+     *
+     * @param caminho Arquivo de destino
+     * @param intervaloSegundos Intervalo entre gravações
+     * @return bool false se a exportação periódica já estava ativa
+     */
+    bool iniciarExportacaoPeriodica(const std::string &caminho, int intervaloSegundos);
+
+    /**
+     * @brief Encerra a gravação periódica, gravando o arquivo uma última vez
+     */
+    void pararExportacaoPeriodica();
+};
+
+#endif // REGISTROMETRICAS_HPP_INCLUDED
@@ -0,0 +1,912 @@
+#include "ServidorServicos.hpp"
+#include "ProcessadorLote.hpp"
+#include "controladorasServico.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+// Identificadores reservados no epoll para os descritores internos do servidor
+const uint64_t ID_ESCUTA = 0;
+const uint64_t ID_EVENTO = 1;
+const uint64_t ID_SINAL = 2;
+const uint64_t PRIMEIRO_ID_CONEXAO = 16;
+
+void pularEspacos(const std::string &texto, size_t &pos)
+{
+    while (pos < texto.size() && (texto[pos] == ' ' || texto[pos] == '\t' || texto[pos] == '\r' || texto[pos] == '\n'))
+    {
+        pos++;
+    }
+}
+
+/**
+ * @brief Lê os quatro dígitos hexadecimais de um escape \\uXXXX
+ */
+bool lerHexadecimalJson(const std::string &texto, size_t &pos, uint32_t &unidade)
+{
+    if (pos + 4 > texto.size())
+    {
+        return false;
+    }
+
+    unidade = 0;
+    for (size_t fim = pos + 4; pos < fim; pos++)
+    {
+        char c = texto[pos];
+        uint32_t digito;
+        if (c >= '0' && c <= '9')
+        {
+            digito = static_cast<uint32_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            digito = static_cast<uint32_t>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            digito = static_cast<uint32_t>(c - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+        unidade = (unidade << 4) | digito;
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta um escape \\uXXXX (já depois do 'u') e acrescenta o caractere em UTF-8
+ * @details Um substituto alto precisa ser seguido de \\u com o substituto baixo.
+ *          U+0000 e substitutos soltos são recusados, para que nenhum NUL ou
+ *          UTF-8 inválido chegue aos domínios.
+ */
+bool lerEscapeUnicodeJson(const std::string &texto, size_t &pos, std::string &valor)
+{
+    uint32_t ponto;
+    if (!lerHexadecimalJson(texto, pos, ponto) || ponto == 0 || (ponto >= 0xDC00 && ponto <= 0xDFFF))
+    {
+        return false;
+    }
+
+    if (ponto >= 0xD800 && ponto <= 0xDBFF)
+    {
+        uint32_t baixo;
+        if (texto.compare(pos, 2, "\\u") != 0)
+        {
+            return false;
+        }
+        pos += 2;
+        if (!lerHexadecimalJson(texto, pos, baixo) || baixo < 0xDC00 || baixo > 0xDFFF)
+        {
+            return false;
+        }
+        ponto = 0x10000 + ((ponto - 0xD800) << 10) + (baixo - 0xDC00);
+    }
+
+    if (ponto < 0x80)
+    {
+        valor += static_cast<char>(ponto);
+    }
+    else if (ponto < 0x800)
+    {
+        valor += static_cast<char>(0xC0 | (ponto >> 6));
+        valor += static_cast<char>(0x80 | (ponto & 0x3F));
+    }
+    else if (ponto < 0x10000)
+    {
+        valor += static_cast<char>(0xE0 | (ponto >> 12));
+        valor += static_cast<char>(0x80 | ((ponto >> 6) & 0x3F));
+        valor += static_cast<char>(0x80 | (ponto & 0x3F));
+    }
+    else
+    {
+        valor += static_cast<char>(0xF0 | (ponto >> 18));
+        valor += static_cast<char>(0x80 | ((ponto >> 12) & 0x3F));
+        valor += static_cast<char>(0x80 | ((ponto >> 6) & 0x3F));
+        valor += static_cast<char>(0x80 | (ponto & 0x3F));
+    }
+    return true;
+}
+
+bool lerTextoJson(const std::string &texto, size_t &pos, std::string &valor)
+{
+    if (pos >= texto.size() || texto[pos] != '"')
+    {
+        return false;
+    }
+    pos++;
+    valor.clear();
+
+    while (pos < texto.size())
+    {
+        char c = texto[pos++];
+        if (c == '"')
+        {
+            return true;
+        }
+        if (c != '\\')
+        {
+            valor += c;
+            continue;
+        }
+        if (pos >= texto.size())
+        {
+            return false;
+        }
+
+        char escape = texto[pos++];
+        switch (escape)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            valor += escape;
+            break;
+        case 'n':
+            valor += '\n';
+            break;
+        case 't':
+            valor += '\t';
+            break;
+        case 'r':
+            valor += '\r';
+            break;
+        case 'u':
+            if (!lerEscapeUnicodeJson(texto, pos, valor))
+            {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Remove o socket Unix deixado por um servidor que terminou sem apagá-lo
+ * @return true se o caminho está livre para bind()
+ * @details Só um socket que recusa conexão é removido. Um caminho que não é
+ *          socket, ou um socket com outro servidor atendendo, é mantido, e o
+ *          servidor não inicia.
+ */
+bool liberarSocketAbandonado(const sockaddr_un &endereco)
+{
+    struct stat informacoes;
+    if (lstat(endereco.sun_path, &informacoes) != 0)
+    {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(informacoes.st_mode))
+    {
+        std::cerr << "Erro: " << endereco.sun_path << " já existe e não é um socket." << std::endl;
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool conectou = fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&endereco), sizeof(endereco)) == 0;
+    bool abandonado = fd >= 0 && !conectou && errno == ECONNREFUSED;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (!abandonado)
+    {
+        std::cerr << "Erro: o socket " << endereco.sun_path << " está em uso por outro processo." << std::endl;
+        return false;
+    }
+    return unlink(endereco.sun_path) == 0 || errno == ENOENT;
+}
+} // namespace
+
+ServidorServicos::ServidorServicos(const std::string &caminhoBanco, std::shared_ptr<const IndiceCotacoes> indice,
+                                   int trabalhadores)
+    : caminhoBanco(caminhoBanco), indiceCotacoes(std::move(indice)),
+      quantidadeTrabalhadores(trabalhadores > 0 ? trabalhadores : 1), fdEscuta(-1), fdEpoll(-1), fdEvento(-1),
+      fdSinal(-1), proximoIdConexao(PRIMEIRO_ID_CONEXAO), executando(false), trabalhadoresProntos(0),
+      trabalhadoresComFalha(0)
+{
+}
+
+void ServidorServicos::setFabricaRepositorio(std::function<std::shared_ptr<IRepositorio>()> fabrica)
+{
+    fabricaRepositorio = std::move(fabrica);
+}
+
+ServidorServicos::~ServidorServicos()
+{
+    encerrarTrabalhadores();
+    for (auto &trabalhador : trabalhadores)
+    {
+        if (trabalhador.joinable())
+        {
+            trabalhador.join();
+        }
+    }
+
+    for (auto &item : conexoes)
+    {
+        close(item.second.fd);
+    }
+
+    for (int fd : {fdEscuta, fdEpoll, fdEvento, fdSinal})
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    if (!caminhoSocketUnix.empty())
+    {
+        unlink(caminhoSocketUnix.c_str());
+    }
+}
+
+/**
+ * @brief Abre o socket de escuta, o epoll e inicia os trabalhadores
+ * @param endereco "unix:/caminho" ou "tcp:PORTA"
+ * @return true se todos os trabalhadores conectaram ao banco e o socket está ouvindo
+ * @details SIGINT e SIGTERM são bloqueados antes da criação das threads e tratados
+ *          pelo laço de eventos via signalfd, garantindo um encerramento ordenado.
+ */
+bool ServidorServicos::iniciar(const std::string &endereco)
+{
+    sigset_t sinais;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sinais, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    fdSinal = signalfd(-1, &sinais, SFD_NONBLOCK | SFD_CLOEXEC);
+    fdEvento = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+    if (fdSinal < 0 || fdEvento < 0 || fdEpoll < 0)
+    {
+        std::cerr << "Erro: Não foi possível criar os descritores do servidor: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!abrirEscuta(endereco))
+    {
+        return false;
+    }
+
+    epoll_event evento{};
+    evento.events = EPOLLIN;
+    evento.data.u64 = ID_ESCUTA;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdEscuta, &evento);
+    evento.data.u64 = ID_EVENTO;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdEvento, &evento);
+    evento.data.u64 = ID_SINAL;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdSinal, &evento);
+
+    iniciarTrabalhadores();
+    return trabalhadoresComFalha == 0;
+}
+
+bool ServidorServicos::abrirEscuta(const std::string &endereco)
+{
+    if (endereco.rfind("unix:", 0) == 0)
+    {
+        std::string caminho = endereco.substr(5);
+        sockaddr_un enderecoUnix{};
+        if (caminho.empty() || caminho.size() >= sizeof(enderecoUnix.sun_path))
+        {
+            std::cerr << "Erro: Caminho de socket Unix inválido: " << caminho << std::endl;
+            return false;
+        }
+
+        enderecoUnix.sun_family = AF_UNIX;
+        std::strncpy(enderecoUnix.sun_path, caminho.c_str(), sizeof(enderecoUnix.sun_path) - 1);
+        if (!liberarSocketAbandonado(enderecoUnix))
+        {
+            return false;
+        }
+
+        fdEscuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        if (fdEscuta < 0 || bind(fdEscuta, reinterpret_cast<sockaddr *>(&enderecoUnix), sizeof(enderecoUnix)) != 0)
+        {
+            std::cerr << "Erro: Não foi possível abrir o socket " << caminho << ": " << std::strerror(errno)
+                      << std::endl;
+            return false;
+        }
+        caminhoSocketUnix = caminho;
+    }
+    else if (endereco.rfind("tcp:", 0) == 0)
+    {
+        int porta = 0;
+        try
+        {
+            porta = std::stoi(endereco.substr(4));
+        }
+        catch (const std::exception &e)
+        {
+        }
+        if (porta <= 0 || porta > 65535)
+        {
+            std::cerr << "Erro: Porta TCP inválida: " << endereco.substr(4) << std::endl;
+            return false;
+        }
+
+        fdEscuta = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reutilizar = 1;
+        setsockopt(fdEscuta, SOL_SOCKET, SO_REUSEADDR, &reutilizar, sizeof(reutilizar));
+
+        sockaddr_in enderecoTcp{};
+        enderecoTcp.sin_family = AF_INET;
+        enderecoTcp.sin_port = htons(static_cast<uint16_t>(porta));
+        enderecoTcp.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (fdEscuta < 0 || bind(fdEscuta, reinterpret_cast<sockaddr *>(&enderecoTcp), sizeof(enderecoTcp)) != 0)
+        {
+            std::cerr << "Erro: Não foi possível abrir a porta " << porta << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        std::cerr << "Erro: Endereço deve ser 'unix:/caminho' ou 'tcp:PORTA'." << std::endl;
+        return false;
+    }
+
+    if (listen(fdEscuta, SOMAXCONN) != 0)
+    {
+        std::cerr << "Erro: Falha ao escutar no endereço " << endereco << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cria as threads trabalhadoras e aguarda todas conectarem ao banco
+ */
+void ServidorServicos::iniciarTrabalhadores()
+{
+    {
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        executando = true;
+    }
+    for (int i = 0; i < quantidadeTrabalhadores; i++)
+    {
+        trabalhadores.emplace_back(&ServidorServicos::executarTrabalhador, this);
+    }
+
+    std::unique_lock<std::mutex> trava(mutexTarefas);
+    condicaoTrabalhadores.wait(
+        trava, [this] { return trabalhadoresProntos + trabalhadoresComFalha >= quantidadeTrabalhadores; });
+}
+
+/**
+ * @brief Avisa os trabalhadores que o servidor está encerrando
+ * @details A marca é trocada sob mutexTarefas, a mesma trava do predicado de
+ *          espera, para que um trabalhador entre a verificação e o wait não
+ *          perca o notify_all().
+ */
+void ServidorServicos::encerrarTrabalhadores()
+{
+    {
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        executando = false;
+    }
+    condicaoTarefas.notify_all();
+}
+
+/**
+ * @brief Laço de uma thread trabalhadora
+ * @details Cada trabalhador possui sua própria controladora de serviço. Apenas o
+ *          índice de cotações, somente leitura, e o que a fábrica de
+ *          setFabricaRepositorio() devolver são compartilhados entre eles.
+ */
+void ServidorServicos::executarTrabalhador()
+{
+    ControladoraServico cntrServico(fabricaRepositorio ? fabricaRepositorio()
+                                                       : std::make_shared<DatabaseManager>(caminhoBanco));
+    bool inicializado = cntrServico.inicializar();
+    if (inicializado)
+    {
+        cntrServico.setIndiceCotacoes(indiceCotacoes);
+    }
+    {
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        if (inicializado)
+        {
+            trabalhadoresProntos++;
+        }
+        else
+        {
+            trabalhadoresComFalha++;
+        }
+    }
+    condicaoTrabalhadores.notify_all();
+    if (!inicializado)
+    {
+        return;
+    }
+    ProcessadorLote processador(&cntrServico, &cntrServico, &cntrServico);
+
+    while (true)
+    {
+        Tarefa tarefa;
+        {
+            std::unique_lock<std::mutex> trava(mutexTarefas);
+            condicaoTarefas.wait(trava, [this] { return !executando || !filaTarefas.empty(); });
+            if (!executando)
+            {
+                return;
+            }
+            tarefa = std::move(filaTarefas.front());
+            filaTarefas.pop_front();
+        }
+
+        Resultado resultado;
+        resultado.idConexao = tarefa.idConexao;
+
+        size_t inicio = tarefa.requisicao.find_first_not_of(" \t\r");
+        if (inicio != std::string::npos && tarefa.requisicao[inicio] == '{')
+        {
+            std::vector<std::string> args;
+            if (interpretarRequisicaoJson(tarefa.requisicao, args))
+            {
+                processador.processarComando(std::move(args), resultado.resposta);
+            }
+            else
+            {
+                resultado.resposta = "{\"comando\":\"\",\"ok\":false,\"erro\":\"requisicao JSON invalida\"}";
+            }
+        }
+        else
+        {
+            processador.processarLinha(tarefa.requisicao, resultado.resposta);
+            if (resultado.resposta.empty())
+            {
+                resultado.resposta = "{\"comando\":\"\",\"ok\":false,\"erro\":\"comando vazio\"}";
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> trava(mutexResultados);
+            filaResultados.push_back(std::move(resultado));
+        }
+        uint64_t sinal = 1;
+        ssize_t escrito = write(fdEvento, &sinal, sizeof(sinal));
+        (void)escrito;
+    }
+}
+
+/**
+ * @brief Executa o laço de eventos
+ * @return 0 em encerramento normal, 1 em caso de erro do epoll
+ */
+int ServidorServicos::executar()
+{
+    std::vector<epoll_event> eventos(64);
+
+    while (executando)
+    {
+        int quantidade = epoll_wait(fdEpoll, eventos.data(), static_cast<int>(eventos.size()), -1);
+        if (quantidade < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Erro no laço de eventos: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        for (int i = 0; i < quantidade; i++)
+        {
+            uint64_t id = eventos[i].data.u64;
+            if (id == ID_ESCUTA)
+            {
+                aceitarConexoes();
+            }
+            else if (id == ID_EVENTO)
+            {
+                coletarResultados();
+            }
+            else if (id == ID_SINAL)
+            {
+                encerrarTrabalhadores();
+            }
+            else
+            {
+                if (eventos[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                {
+                    lerConexao(id, (eventos[i].events & (EPOLLHUP | EPOLLERR)) != 0);
+                }
+                if (eventos[i].events & EPOLLOUT)
+                {
+                    escreverConexao(id);
+                }
+            }
+        }
+    }
+
+    encerrarTrabalhadores();
+    return 0;
+}
+
+void ServidorServicos::aceitarConexoes()
+{
+    while (true)
+    {
+        int fd = accept4(fdEscuta, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        uint64_t id = proximoIdConexao++;
+        Conexao &conexao = conexoes[id];
+        conexao.fd = fd;
+        conexaoPorFd[fd] = id;
+
+        atualizarInteresse(conexao);
+    }
+}
+
+/**
+ * @brief Lê dados disponíveis de uma conexão e enfileira as requisições completas
+ * @param desligada true com EPOLLHUP/EPOLLERR: lê até o fim mesmo com a fila cheia
+ * @details Requisições de uma mesma conexão são executadas uma de cada vez, o que
+ *          preserva a ordem das respostas sem exigir identificadores no protocolo.
+ *          Com a conexão saturada (fila cheia ou respostas acumuladas), a
+ *          leitura para e o EPOLLIN é desligado; o que chegar fica no socket, e
+ *          o cliente que envia sem ler as respostas é contido pela janela do
+ *          TCP. Sem isso, a fila e as respostas cresceriam sem limite. Uma conexão
+ *          desligada não recebe mais nada e é lida até o fim, para que o
+ *          epoll não a reporte de novo a cada volta.
+ */
+void ServidorServicos::lerConexao(uint64_t idConexao, bool desligada)
+{
+    auto it = conexoes.find(idConexao);
+    if (it == conexoes.end())
+    {
+        return;
+    }
+    Conexao &conexao = it->second;
+
+    char buffer[16 * 1024];
+    while (desligada || !saturada(conexao))
+    {
+        ssize_t lidos = read(conexao.fd, buffer, sizeof(buffer));
+        if (lidos > 0)
+        {
+            conexao.entrada.append(buffer, static_cast<size_t>(lidos));
+            separarRequisicoes(conexao);
+            continue;
+        }
+        if (lidos == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            conexao.encerrando = true;
+        }
+        if (lidos < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        break;
+    }
+
+    // Só a linha ainda sem '\n' conta; linhas completas além do limite da fila esperam vez
+    size_t ultimoFim = conexao.entrada.rfind('\n');
+    size_t incompleta =
+        ultimoFim == std::string::npos ? conexao.entrada.size() : conexao.entrada.size() - ultimoFim - 1;
+    if (incompleta > TAMANHO_MAXIMO_REQUISICAO)
+    {
+        conexao.saida += "{\"comando\":\"\",\"ok\":false,\"erro\":\"requisicao excede o tamanho maximo\"}\n";
+        conexao.entrada.clear();
+        conexao.pendentes.clear();
+        conexao.encerrando = true;
+    }
+
+    despacharProxima(conexao, idConexao);
+    escreverConexao(idConexao);
+}
+
+/**
+ * @brief true se a conexão não deve ser lida até a fila ou a saída esvaziarem
+ */
+bool ServidorServicos::saturada(const Conexao &conexao)
+{
+    return conexao.pendentes.size() >= MAXIMO_PENDENTES_CONEXAO || conexao.saida.size() >= MAXIMO_SAIDA_CONEXAO;
+}
+
+/**
+ * @brief Move as linhas completas da entrada para a fila, até MAXIMO_PENDENTES_CONEXAO
+ */
+void ServidorServicos::separarRequisicoes(Conexao &conexao)
+{
+    size_t inicio = 0;
+    size_t fimLinha;
+    while (conexao.pendentes.size() < MAXIMO_PENDENTES_CONEXAO &&
+           (fimLinha = conexao.entrada.find('\n', inicio)) != std::string::npos)
+    {
+        std::string linha = conexao.entrada.substr(inicio, fimLinha - inicio);
+        inicio = fimLinha + 1;
+        if (linha.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            conexao.pendentes.push_back(std::move(linha));
+        }
+    }
+    conexao.entrada.erase(0, inicio);
+}
+
+/**
+ * @brief Entrega ao trabalhador a próxima requisição da conexão, se ela está livre
+ * @details A fila é completada antes com as linhas que ficaram na entrada
+ *          enquanto ela estava cheia.
+ */
+void ServidorServicos::despacharProxima(Conexao &conexao, uint64_t idConexao)
+{
+    separarRequisicoes(conexao);
+    if (conexao.ocupada || conexao.pendentes.empty())
+    {
+        return;
+    }
+
+    conexao.ocupada = true;
+    {
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        filaTarefas.push_back(Tarefa{idConexao, std::move(conexao.pendentes.front())});
+    }
+    conexao.pendentes.pop_front();
+    condicaoTarefas.notify_one();
+}
+
+void ServidorServicos::coletarResultados()
+{
+    uint64_t contador;
+    ssize_t lidos = read(fdEvento, &contador, sizeof(contador));
+    (void)lidos;
+
+    std::deque<Resultado> prontos;
+    {
+        std::lock_guard<std::mutex> trava(mutexResultados);
+        prontos.swap(filaResultados);
+    }
+
+    for (auto &resultado : prontos)
+    {
+        auto it = conexoes.find(resultado.idConexao);
+        if (it == conexoes.end())
+        {
+            continue;
+        }
+
+        Conexao &conexao = it->second;
+        conexao.saida += resultado.resposta;
+        conexao.saida += '\n';
+        conexao.ocupada = false;
+        despacharProxima(conexao, resultado.idConexao);
+        escreverConexao(resultado.idConexao);
+    }
+}
+
+void ServidorServicos::escreverConexao(uint64_t idConexao)
+{
+    auto it = conexoes.find(idConexao);
+    if (it == conexoes.end())
+    {
+        return;
+    }
+    Conexao &conexao = it->second;
+
+    while (!conexao.saida.empty())
+    {
+        ssize_t escritos = send(conexao.fd, conexao.saida.data(), conexao.saida.size(), MSG_NOSIGNAL);
+        if (escritos > 0)
+        {
+            conexao.saida.erase(0, static_cast<size_t>(escritos));
+            continue;
+        }
+        if (escritos < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (escritos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        conexao.encerrando = true;
+        conexao.saida.clear();
+        conexao.entrada.clear();
+        conexao.pendentes.clear();
+        break;
+    }
+
+    if (conexao.encerrando && conexao.saida.empty() && !conexao.ocupada && conexao.pendentes.empty())
+    {
+        fecharConexao(idConexao);
+        return;
+    }
+
+    atualizarInteresse(conexao);
+}
+
+/**
+ * @brief Ajusta os eventos observados de uma conexão
+ * @details EPOLLIN fica desligado enquanto a conexão está saturada e volta
+ *          quando um trabalhador ou o envio das respostas libera espaço.
+ *          Uma conexão encerrando sem nada a escrever sai do epoll: mesmo sem
+ *          eventos pedidos, EPOLLHUP e EPOLLERR continuariam sendo reportados a
+ *          cada epoll_wait enquanto o trabalhador responde. Ela volta quando a
+ *          resposta não couber no socket de uma vez.
+ */
+void ServidorServicos::atualizarInteresse(Conexao &conexao)
+{
+    epoll_event evento{};
+    bool lendo = !conexao.encerrando && !saturada(conexao);
+    evento.events = (lendo ? static_cast<uint32_t>(EPOLLIN) : 0u) |
+                    (conexao.saida.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT));
+    evento.data.u64 = conexaoPorFd[conexao.fd];
+
+    if (evento.events == 0)
+    {
+        if (conexao.registrada)
+        {
+            epoll_ctl(fdEpoll, EPOLL_CTL_DEL, conexao.fd, nullptr);
+            conexao.registrada = false;
+        }
+        return;
+    }
+
+    epoll_ctl(fdEpoll, conexao.registrada ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, conexao.fd, &evento);
+    conexao.registrada = true;
+}
+
+void ServidorServicos::fecharConexao(uint64_t idConexao)
+{
+    auto it = conexoes.find(idConexao);
+    if (it == conexoes.end())
+    {
+        return;
+    }
+
+    if (it->second.registrada)
+    {
+        epoll_ctl(fdEpoll, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    }
+    close(it->second.fd);
+    conexaoPorFd.erase(it->second.fd);
+    conexoes.erase(it);
+}
+
+/**
+ * @brief Converte uma requisição JSON em lista de argumentos
+ * @param requisicao Objeto JSON, ex: {"comando":"balance","args":["11111"]}
+ * @param args Comando seguido dos argumentos
+ * @return true se a requisição contém "comando" e, opcionalmente, "args" com textos
+ * @details Aceita apenas o subconjunto de JSON usado pelo protocolo: um objeto
+ *          com valores de texto ou listas de textos. Outras chaves são ignoradas
+ *          desde que tenham valor de texto.
+ */
+bool ServidorServicos::interpretarRequisicaoJson(const std::string &requisicao, std::vector<std::string> &args)
+{
+    std::string comando;
+    std::vector<std::string> argumentos;
+    size_t pos = 0;
+
+    pularEspacos(requisicao, pos);
+    if (pos >= requisicao.size() || requisicao[pos++] != '{')
+    {
+        return false;
+    }
+
+    pularEspacos(requisicao, pos);
+    if (pos < requisicao.size() && requisicao[pos] == '}')
+    {
+        return false;
+    }
+
+    while (pos < requisicao.size())
+    {
+        std::string chave;
+        pularEspacos(requisicao, pos);
+        if (!lerTextoJson(requisicao, pos, chave))
+        {
+            return false;
+        }
+
+        pularEspacos(requisicao, pos);
+        if (pos >= requisicao.size() || requisicao[pos++] != ':')
+        {
+            return false;
+        }
+        pularEspacos(requisicao, pos);
+
+        if (pos < requisicao.size() && requisicao[pos] == '[')
+        {
+            pos++;
+            pularEspacos(requisicao, pos);
+            std::vector<std::string> lista;
+            if (pos < requisicao.size() && requisicao[pos] == ']')
+            {
+                pos++;
+            }
+            else
+            {
+                while (true)
+                {
+                    std::string item;
+                    pularEspacos(requisicao, pos);
+                    if (!lerTextoJson(requisicao, pos, item))
+                    {
+                        return false;
+                    }
+                    lista.push_back(item);
+                    pularEspacos(requisicao, pos);
+                    if (pos < requisicao.size() && requisicao[pos] == ',')
+                    {
+                        pos++;
+                        continue;
+                    }
+                    if (pos < requisicao.size() && requisicao[pos] == ']')
+                    {
+                        pos++;
+                        break;
+                    }
+                    return false;
+                }
+            }
+            if (chave == "args")
+            {
+                argumentos = std::move(lista);
+            }
+        }
+        else
+        {
+            std::string valor;
+            if (!lerTextoJson(requisicao, pos, valor))
+            {
+                return false;
+            }
+            if (chave == "comando")
+            {
+                comando = valor;
+            }
+        }
+
+        pularEspacos(requisicao, pos);
+        if (pos < requisicao.size() && requisicao[pos] == ',')
+        {
+            pos++;
+            continue;
+        }
+        if (pos < requisicao.size() && requisicao[pos] == '}')
+        {
+            break;
+        }
+        return false;
+    }
+
+    if (comando.empty())
+    {
+        return false;
+    }
+
+    args.clear();
+    args.push_back(comando);
+    args.insert(args.end(), argumentos.begin(), argumentos.end());
+    return true;
+}
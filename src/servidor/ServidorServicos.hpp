@@ -0,0 +1,166 @@
+#ifndef SERVIDORSERVICOS_HPP_INCLUDED
+#define SERVIDORSERVICOS_HPP_INCLUDED
+
+#include "IRepositorio.hpp"
+#include "IndiceCotacoes.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Servidor local que expõe as interfaces de serviço por socket
+ *
+ * @details Um único processo mantém o índice de cotações carregado e um conjunto
+ * de trabalhadores, cada um com sua própria ControladoraServico (e portanto sua
+ * própria conexão SQLite e cache de statements). Um laço epoll aceita conexões
+ * em socket Unix ou TCP de loopback e distribui as requisições aos trabalhadores.
+ *
+ * Protocolo (JSON-lines): cada requisição é uma linha terminada por '\n', e cada
+ * resposta é um objeto JSON em uma linha, na mesma ordem das requisições da conexão.
+ * A requisição pode ser um objeto JSON no formato
+ * {"comando":"create-order","args":["11111","22222","JBSS3","20250102","100"]}
+ * ou uma linha de texto na gramática do modo lote (ver ProcessadorLote).
+ *
+ * Endereços aceitos: "unix:/caminho/do/socket" ou "tcp:PORTA" (apenas 127.0.0.1).
+ */
+class ServidorServicos
+{
+  private:
+    struct Conexao
+    {
+        int fd = -1;
+        std::string entrada;
+        std::string saida;
+        std::deque<std::string> pendentes;
+        bool ocupada = false;
+        bool encerrando = false;
+        bool registrada = false; ///< Presente no epoll
+    };
+
+    struct Tarefa
+    {
+        uint64_t idConexao;
+        std::string requisicao;
+    };
+
+    struct Resultado
+    {
+        uint64_t idConexao;
+        std::string resposta;
+    };
+
+    static const size_t TAMANHO_MAXIMO_REQUISICAO = 64 * 1024;
+
+    /**
+     * @brief Requisições aguardando vez por conexão; no limite, a conexão deixa de ser lida (sem EPOLLIN)
+     */
+    static const size_t MAXIMO_PENDENTES_CONEXAO = 64;
+
+    /**
+     * @brief Bytes de resposta ainda não enviados a partir dos quais a conexão deixa de ser lida
+     */
+    static const size_t MAXIMO_SAIDA_CONEXAO = 1024 * 1024;
+
+    std::string caminhoBanco;
+    std::shared_ptr<const IndiceCotacoes> indiceCotacoes;
+    std::function<std::shared_ptr<IRepositorio>()> fabricaRepositorio;
+    int quantidadeTrabalhadores;
+
+    int fdEscuta;
+    int fdEpoll;
+    int fdEvento;
+    int fdSinal;
+    std::string caminhoSocketUnix;
+
+    std::unordered_map<uint64_t, Conexao> conexoes;
+    std::unordered_map<int, uint64_t> conexaoPorFd;
+    uint64_t proximoIdConexao;
+
+    std::vector<std::thread> trabalhadores;
+    std::mutex mutexTarefas;
+    std::condition_variable condicaoTarefas;
+    std::condition_variable condicaoTrabalhadores; ///< Sinaliza trabalhadores prontos ou com falha, sob mutexTarefas
+    std::deque<Tarefa> filaTarefas;
+    std::mutex mutexResultados;
+    std::deque<Resultado> filaResultados;
+    std::atomic<bool> executando; ///< Alterado só sob mutexTarefas, para que nenhum trabalhador perca o aviso
+    int trabalhadoresProntos;     ///< Protegido por mutexTarefas
+    int trabalhadoresComFalha;    ///< Protegido por mutexTarefas
+
+    bool abrirEscuta(const std::string &endereco);
+    void iniciarTrabalhadores();
+    void encerrarTrabalhadores();
+    void executarTrabalhador();
+    void aceitarConexoes();
+    void lerConexao(uint64_t idConexao, bool desligada);
+    void separarRequisicoes(Conexao &conexao);
+    static bool saturada(const Conexao &conexao);
+    void escreverConexao(uint64_t idConexao);
+    void despacharProxima(Conexao &conexao, uint64_t idConexao);
+    void coletarResultados();
+    void fecharConexao(uint64_t idConexao);
+    void atualizarInteresse(Conexao &conexao);
+
+  public:
+    /**
+     * @brief Construtor
+     *
+     * @param caminhoBanco Caminho do banco SQLite usado pelos trabalhadores
+     * @param indice Índice de cotações compartilhado (pode ser nulo)
+     * @param trabalhadores Quantidade de threads trabalhadoras
+     */
+    ServidorServicos(const std::string &caminhoBanco, std::shared_ptr<const IndiceCotacoes> indice,
+                     int trabalhadores);
+
+    /**
+     * @brief Destrutor - encerra trabalhadores e fecha sockets
+     */
+    ~ServidorServicos();
+
+    ServidorServicos(const ServidorServicos &) = delete;
+    ServidorServicos &operator=(const ServidorServicos &) = delete;
+
+    /**
+     * @brief Define como cada trabalhador obtém seu repositório
+     *
+     * @param fabrica Chamada uma vez por trabalhador; pode devolver sempre a mesma
+     * instância, se ela for segura para uso concorrente (ex.: RepositorioMemoria)
+     * @details Deve ser chamado antes de iniciar(). Sem ele, cada trabalhador abre
+     * sua própria conexão SQLite em caminhoBanco.
+     */
+    void setFabricaRepositorio(std::function<std::shared_ptr<IRepositorio>()> fabrica);
+
+    /**
+     * @brief Abre o socket de escuta e inicia os trabalhadores
+     *
+     * @param endereco "unix:/caminho" ou "tcp:PORTA"
+     * @return bool true se o servidor está pronto para atender
+     */
+    bool iniciar(const std::string &endereco);
+
+    /**
+     * @brief Executa o laço de eventos até receber SIGINT ou SIGTERM
+     *
+     * @return int Código de saída do processo
+     */
+    int executar();
+
+    /**
+     * @brief Converte uma requisição JSON em lista de argumentos
+     *
+     * @param requisicao Objeto JSON com "comando" e "args"
+     * @param args Comando seguido dos argumentos
+     * @return bool true se a requisição está no formato esperado
+     */
+    static bool interpretarRequisicaoJson(const std::string &requisicao, std::vector<std::string> &args);
+};
+
+#endif // SERVIDORSERVICOS_HPP_INCLUDED
@@ -0,0 +1,299 @@
+#include "testesCotacoes.hpp"
+#include "../cotacoes/CheckpointCotahist.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+//Teste Unitario cotacoes: AnalisadorQualidade::nomeValido
+void TUNomeValido::setUp() {
+    estado = SUCESSO;
+}
+
+void TUNomeValido::tearDown() {
+}
+
+void TUNomeValido::testarCenarioNomeValido() {
+    if (!AnalisadorQualidade::nomeValido(NOME_VALIDO))
+        estado = FALHA;
+    if (!AnalisadorQualidade::nomeValido(NOME_PAR_SUBSTITUTOS))
+        estado = FALHA;
+}
+
+void TUNomeValido::testarCenarioSequenciaCortada() {
+    // "+AC" tem 12 bits: nem uma unidade UTF-16 completa
+    if (AnalisadorQualidade::nomeValido(NOME_CORTADO))
+        estado = FALHA;
+}
+
+void TUNomeValido::testarCenarioSubstitutoSolto() {
+    // U+D800 sem o substituto baixo e U+DC00 sem o alto
+    if (AnalisadorQualidade::nomeValido(NOME_SUBSTITUTO_ALTO))
+        estado = FALHA;
+    if (AnalisadorQualidade::nomeValido(NOME_SUBSTITUTO_BAIXO))
+        estado = FALHA;
+}
+
+int TUNomeValido::run() {
+    setUp();
+    testarCenarioNomeValido();
+    testarCenarioSequenciaCortada();
+    testarCenarioSubstitutoSolto();
+    tearDown();
+    return estado;
+}
+
+//Teste Unitario cotacoes: CachePrecos
+bool TUCachePrecos::mesmaFatia(const string &a, const string &b) {
+    // Com uma entrada por fatia, guardar b só descarta a se os dois caem na mesma fatia
+    CachePrecos sonda(1);
+    bool encontrado;
+    sonda.guardar(a, DATA, true, 100);
+    sonda.guardar(b, DATA, true, 200);
+    return !sonda.consultar(a, DATA, &encontrado, nullptr);
+}
+
+void TUCachePrecos::setUp() {
+    estado = SUCESSO;
+    papeisMesmaFatia.clear();
+    for (int i = 0; i < 1000 && papeisMesmaFatia.size() < 2; i++) {
+        string papel = "T" + to_string(i);
+        if (mesmaFatia(PAPEL_REFERENCIADO, papel))
+            papeisMesmaFatia.push_back(papel);
+    }
+    if (papeisMesmaFatia.size() < 2)
+        estado = FALHA;
+}
+
+void TUCachePrecos::tearDown() {
+}
+
+void TUCachePrecos::testarCenarioSegundaChance() {
+    if (papeisMesmaFatia.size() < 2)
+        return;
+
+    // Duas entradas por fatia: a consultada ganha a segunda chance e a outra sai
+    CachePrecos cache(2 * CachePrecos::QUANTIDADE_FATIAS);
+    bool encontrado = false;
+    long long preco = 0;
+    cache.guardar(PAPEL_REFERENCIADO, DATA, true, 100);
+    cache.guardar(papeisMesmaFatia[0], DATA, true, 200);
+    cache.consultar(PAPEL_REFERENCIADO, DATA, &encontrado, &preco);
+    cache.guardar(papeisMesmaFatia[1], DATA, true, 300);
+
+    if (!cache.consultar(PAPEL_REFERENCIADO, DATA, &encontrado, &preco) || !encontrado || preco != 100)
+        estado = FALHA;
+    if (cache.consultar(papeisMesmaFatia[0], DATA, &encontrado, &preco))
+        estado = FALHA;
+    if (!cache.consultar(papeisMesmaFatia[1], DATA, &encontrado, &preco) || preco != 300)
+        estado = FALHA;
+    if (cache.obterEstatisticas().descartes != 1)
+        estado = FALHA;
+}
+
+void TUCachePrecos::testarCenarioCapacidade() {
+    // Ao menos uma entrada por fatia; o resto da divisão entre as fatias é descartado
+    if (CachePrecos(1).obterEstatisticas().capacidade != CachePrecos::QUANTIDADE_FATIAS)
+        estado = FALHA;
+    if (CachePrecos(3 * CachePrecos::QUANTIDADE_FATIAS - 1).obterEstatisticas().capacidade !=
+        2 * CachePrecos::QUANTIDADE_FATIAS)
+        estado = FALHA;
+}
+
+int TUCachePrecos::run() {
+    setUp();
+    testarCenarioSegundaChance();
+    testarCenarioCapacidade();
+    tearDown();
+    return estado;
+}
+
+//Teste Unitario cotacoes: ExportadorCotacoes
+const string TUExportadorCotacoes::LINHA_COMPLETA =
+    "012024022902PETR4       010PETROBRAS   PN      N2   R$  000000000370000000000038"
+    "00000000000360000000000037100000000003750000000000374000000000037601234500000000"
+    "0000100000000000000371000000000000000000009999123100000010000000000000BRPETRACNP"
+    "R6123";
+
+void TUExportadorCotacoes::setUp() {
+    estado = SUCESSO;
+    char modelo[] = "/tmp/testesCotacoesXXXXXX";
+    int fd = mkstemp(modelo);
+    if (fd < 0) {
+        estado = FALHA;
+        return;
+    }
+    close(fd);
+    caminhoDados = modelo;
+    ofstream(caminhoDados, ios::binary) << LINHA_COMPLETA << "\r\n";
+}
+
+void TUExportadorCotacoes::tearDown() {
+    if (!caminhoDados.empty())
+        remove(caminhoDados.c_str());
+}
+
+void TUExportadorCotacoes::testarCenarioDiasDesdeEpoca() {
+    if (ExportadorCotacoes::diasDesdeEpoca(19700101) != 0)
+        estado = FALHA;
+    if (ExportadorCotacoes::diasDesdeEpoca(19691231) != -1)
+        estado = FALHA;
+    if (ExportadorCotacoes::diasDesdeEpoca(20240229) != DIAS_REGISTRO)
+        estado = FALHA;
+    if (ExportadorCotacoes::diasDesdeEpoca(20240301) != DIAS_REGISTRO + 1)
+        estado = FALHA;
+}
+
+void TUExportadorCotacoes::testarCenarioFluxoArrow() {
+    IndiceCotacoes indice;
+    if (caminhoDados.empty() || !indice.carregar(caminhoDados)) {
+        estado = FALHA;
+        return;
+    }
+
+    ostringstream saida;
+    ExportadorCotacoes exportador(saida, EXPORTACAO_ARROW);
+    FiltroExportacao filtro;
+    filtro.campos = {"data", "preult"};
+    if (!exportador.iniciar(filtro)) {
+        estado = FALHA;
+        return;
+    }
+    exportador.escrever(indice);
+    if (!exportador.finalizar() || exportador.getRegistrosExportados() != 1) {
+        estado = FALHA;
+        return;
+    }
+
+    // Sem nulos, o corpo do lote é só [Date32 completado a 8 bytes][Int64], seguido do fim de fluxo
+    string fluxo = saida.str();
+    const char FIM_FLUXO[8] = {'\xFF', '\xFF', '\xFF', '\xFF', 0, 0, 0, 0};
+    int32_t dias = 0;
+    long long preult = 0;
+    if (fluxo.size() < 24 || memcmp(fluxo.data() + fluxo.size() - 8, FIM_FLUXO, 8) != 0) {
+        estado = FALHA;
+        return;
+    }
+    memcpy(&dias, fluxo.data() + fluxo.size() - 24, sizeof(dias));
+    memcpy(&preult, fluxo.data() + fluxo.size() - 16, sizeof(preult));
+    if (dias != DIAS_REGISTRO || preult != PREULT_REGISTRO)
+        estado = FALHA;
+}
+
+int TUExportadorCotacoes::run() {
+    setUp();
+    testarCenarioDiasDesdeEpoca();
+    testarCenarioFluxoArrow();
+    tearDown();
+    return estado;
+}
+
+//Teste Unitario cotacoes: BuscaPapeis (busca aproximada)
+bool TUBuscaPapeis::sugere(const string &texto, const string &codigo, unsigned distancia) {
+    for (const SugestaoPapel &sugestao : busca->sugerir(texto)) {
+        if (sugestao.codigoNegociacao == codigo)
+            return sugestao.tipo == SUGESTAO_APROXIMADA && sugestao.distancia == distancia;
+    }
+    return false;
+}
+
+void TUBuscaPapeis::setUp() {
+    busca = new BuscaPapeis();
+    busca->adicionar("PETR4", "PETROBRAS", 100);
+    busca->adicionar("VALE3", "VALE", 100);
+    busca->adicionar("ITUB4", "ITAUUNIBANCO", 100);
+    busca->montar();
+    estado = SUCESSO;
+}
+
+void TUBuscaPapeis::tearDown() {
+    delete busca;
+}
+
+void TUBuscaPapeis::testarCenarioTransposicao() {
+    // Vizinhos trocados custam uma edição, não duas
+    if (!sugere("PERT4", "PETR4", 1))
+        estado = FALHA;
+    if (!sugere("VAEL3", "VALE3", 1))
+        estado = FALHA;
+}
+
+void TUBuscaPapeis::testarCenarioLimiteEdicoes() {
+    // Limite de 0 edições até 2 caracteres, 1 até 5 e 2 acima
+    if (sugere("PX", "PETR4", 1))
+        estado = FALHA;
+    if (sugere("VXXE3", "VALE3", 2))
+        estado = FALHA;
+    if (!sugere("ITXB4", "ITUB4", 1))
+        estado = FALHA;
+    if (!sugere("PXTR4X", "PETR4", 2))
+        estado = FALHA;
+}
+
+int TUBuscaPapeis::run() {
+    setUp();
+    testarCenarioTransposicao();
+    testarCenarioLimiteEdicoes();
+    tearDown();
+    return estado;
+}
+
+//Teste Unitario cotacoes: LeitorArquivo e CheckpointCotahist (última linha sem '\n')
+void TULeitorArquivo::setUp() {
+    estado = SUCESSO;
+    char modelo[] = "/tmp/testesCotacoesXXXXXX";
+    int fd = mkstemp(modelo);
+    if (fd < 0) {
+        estado = FALHA;
+        return;
+    }
+    close(fd);
+    caminhoDados = modelo;
+    ofstream(caminhoDados, ios::binary) << CONTEUDO;
+}
+
+void TULeitorArquivo::tearDown() {
+    if (!caminhoDados.empty())
+        remove(caminhoDados.c_str());
+}
+
+void TULeitorArquivo::testarCenarioUltimaLinhaEntregue() {
+    for (BackendLeitura backend : {LEITURA_READ, LEITURA_MMAP, LEITURA_IO_URING}) {
+        vector<string> linhas;
+        uint64_t consumido = 0;
+        bool lido = LeitorArquivo::lerLinhas(
+            caminhoDados, 0, [&linhas](const string &linha) { linhas.push_back(linha); }, &consumido, nullptr,
+            backend);
+        if (!lido || linhas != vector<string>{"A", "B"} || consumido != 2)
+            estado = FALHA;
+    }
+}
+
+void TULeitorArquivo::testarCenarioUltimaLinhaGuardada() {
+    vector<string> linhas;
+    string linhaFinal;
+    bool lido = LeitorArquivo::lerLinhas(
+        caminhoDados, 0, [&linhas](const string &linha) { linhas.push_back(linha); }, nullptr, &linhaFinal);
+    if (!lido || linhas != vector<string>{"A"} || linhaFinal != "B")
+        estado = FALHA;
+}
+
+void TULeitorArquivo::testarCenarioRegistroSemQuebra() {
+    // Um arquivo de um único registro, sem '\n' no fim, ainda tem um registro
+    ofstream(caminhoDados, ios::binary | ios::trunc) << TUExportadorCotacoes::LINHA_COMPLETA;
+    size_t registros = 0;
+    bool lido = CheckpointCotahist::ler(caminhoDados, "", [&registros](const RegistroCotacao &) { registros++; });
+    if (!lido || registros != 1)
+        estado = FALHA;
+}
+
+int TULeitorArquivo::run() {
+    setUp();
+    testarCenarioUltimaLinhaEntregue();
+    testarCenarioUltimaLinhaGuardada();
+    testarCenarioRegistroSemQuebra();
+    tearDown();
+    return estado;
+}
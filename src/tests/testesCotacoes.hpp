@@ -0,0 +1,110 @@
+#ifndef TESTESCOTACOES_HPP_INCLUDED
+#define TESTESCOTACOES_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../cotacoes/BuscaPapeis.hpp"
+#include "../cotacoes/CachePrecos.hpp"
+#include "../cotacoes/ExportadorCotacoes.hpp"
+#include "../cotacoes/LeitorArquivo.hpp"
+#include "../cotacoes/QualidadeCotacoes.hpp"
+
+using namespace std;
+
+//Teste Unitario cotacoes: AnalisadorQualidade::nomeValido
+class TUNomeValido {
+    private:
+        string NOME_VALIDO = "R+ACQ-";
+        string NOME_PAR_SUBSTITUTOS = "A+2D3eAA-";
+        string NOME_CORTADO = "P.ACUCAR+AC";
+        string NOME_SUBSTITUTO_ALTO = "A+2AA-";
+        string NOME_SUBSTITUTO_BAIXO = "A+3AA-";
+        int estado;
+        void setUp();
+        void tearDown();
+        void testarCenarioNomeValido();
+        void testarCenarioSequenciaCortada();
+        void testarCenarioSubstitutoSolto();
+
+    public:
+        const static int SUCESSO = 0;
+        const static int FALHA = -1;
+        int run();
+};
+
+//Teste Unitario cotacoes: CachePrecos
+class TUCachePrecos {
+    private:
+        const static uint32_t DATA = 20250102;
+        string PAPEL_REFERENCIADO = "PETR4";
+        vector<string> papeisMesmaFatia;
+        int estado;
+        bool mesmaFatia(const string &a, const string &b);
+        void setUp();
+        void tearDown();
+        void testarCenarioSegundaChance();
+        void testarCenarioCapacidade();
+
+    public:
+        const static int SUCESSO = 0;
+        const static int FALHA = -1;
+        int run();
+};
+
+//Teste Unitario cotacoes: ExportadorCotacoes
+class TUExportadorCotacoes {
+    private:
+        const static int32_t DIAS_REGISTRO = 19782;          // 2024-02-29
+        const static long long PREULT_REGISTRO = 3750;
+        string caminhoDados;
+        int estado;
+        void setUp();
+        void tearDown();
+        void testarCenarioDiasDesdeEpoca();
+        void testarCenarioFluxoArrow();
+
+    public:
+        const static string LINHA_COMPLETA;
+        const static int SUCESSO = 0;
+        const static int FALHA = -1;
+        int run();
+};
+
+//Teste Unitario cotacoes: BuscaPapeis (busca aproximada)
+class TUBuscaPapeis {
+    private:
+        BuscaPapeis *busca;
+        int estado;
+        bool sugere(const string &texto, const string &codigo, unsigned distancia);
+        void setUp();
+        void tearDown();
+        void testarCenarioTransposicao();
+        void testarCenarioLimiteEdicoes();
+
+    public:
+        const static int SUCESSO = 0;
+        const static int FALHA = -1;
+        int run();
+};
+
+//Teste Unitario cotacoes: LeitorArquivo e CheckpointCotahist (última linha sem '\n')
+class TULeitorArquivo {
+    private:
+        string CONTEUDO = "A\nB";
+        string caminhoDados;
+        int estado;
+        void setUp();
+        void tearDown();
+        void testarCenarioUltimaLinhaEntregue();
+        void testarCenarioUltimaLinhaGuardada();
+        void testarCenarioRegistroSemQuebra();
+
+    public:
+        const static int SUCESSO = 0;
+        const static int FALHA = -1;
+        int run();
+};
+
+#endif // TESTESCOTACOES_HPP_INCLUDED
@@ -295,6 +295,8 @@ void TUQuantidade::testarCenarioValorValido() {
         quantidade->setValor(VALOR_VALIDO);
         if (quantidade->getValor() != VALOR_VALIDO)
             estado = FALHA;
+        if (quantidade->getUnidades() != UNIDADES_VALIDO)
+            estado = FALHA;
     }
     catch (invalid_argument &excecao) {
         estado = FALHA;
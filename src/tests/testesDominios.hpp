@@ -139,6 +139,7 @@ class TUDinheiro {
 class TUQuantidade {
     private:
         string VALOR_VALIDO = "1.000";
+        long long UNIDADES_VALIDO = 1000;
         string VALOR_INVALIDO = "01";
         Quantidade *quantidade;
         int estado;
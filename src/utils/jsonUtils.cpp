@@ -0,0 +1,48 @@
+#include "jsonUtils.hpp"
+#include <cstdio>
+
+std::string jsonUtils::escapar(const std::string &texto)
+{
+    std::string escapado;
+    escapado.reserve(texto.size() + 2);
+
+    for (char c : texto)
+    {
+        switch (c)
+        {
+        case '"':
+            escapado += "\\\"";
+            break;
+        case '\\':
+            escapado += "\\\\";
+            break;
+        case '\n':
+            escapado += "\\n";
+            break;
+        case '\r':
+            escapado += "\\r";
+            break;
+        case '\t':
+            escapado += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                escapado += buffer;
+            }
+            else
+            {
+                escapado += c;
+            }
+        }
+    }
+
+    return escapado;
+}
+
+std::string jsonUtils::texto(const std::string &texto)
+{
+    return "\"" + escapar(texto) + "\"";
+}
@@ -0,0 +1,32 @@
+#ifndef JSONUTILS_HPP_INCLUDED
+#define JSONUTILS_HPP_INCLUDED
+
+#include <string>
+
+/**
+ * @brief Utilitários para geração de saída JSON legível por máquina
+ *
+ * @details Usado pelos modos não interativos (lote, servidor, relatórios)
+ * para montar respostas JSON sem depender de bibliotecas externas.
+ */
+class jsonUtils
+{
+  public:
+    /**
+     * @brief Escapa uma string para uso dentro de aspas em JSON
+     *
+     * @param texto Texto original
+     * @return std::string Texto com aspas, barras e caracteres de controle escapados
+     */
+    static std::string escapar(const std::string &texto);
+
+    /**
+     * @brief Retorna o texto escapado e delimitado por aspas duplas
+     *
+     * @param texto Texto original
+     * @return std::string Literal JSON do texto
+     */
+    static std::string texto(const std::string &texto);
+};
+
+#endif // JSONUTILS_HPP_INCLUDED